@@ -0,0 +1,75 @@
+// Heap cost of an account pool, by subsystem: loads a synthetic pool into
+// an AccountStore the way AccountData.json is loaded and reports the live
+// bytes charged to each MemoryTag, plus bytes per account. Rerun after
+// changing the Account layout to see what it saved.
+//
+// Usage: ram_memory_bench [accounts=50000] [seed]
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "account_pool.h"
+#include "ram/account_store.h"
+#include "ram/ini_file.h"
+#include "ram/memory_accounting.h"
+
+namespace {
+
+std::string pool_json(size_t count, uint64_t seed) {
+    nlohmann::json array = nlohmann::json::array();
+    ram::bench::AccountPoolGenerator generator(seed);
+    for (size_t i = 0; i < count; ++i) array.push_back(generator.next().to_json());
+    return array.dump();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t accounts = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0x52414d;
+    if (!ram::memory_report().hooked) {
+        std::fprintf(stderr, "ram_memory_hook is not linked\n");
+        return 1;
+    }
+
+    std::string json = pool_json(accounts, seed);
+    ram::MemoryReport before = ram::memory_report();
+
+    ram::AccountStore store;
+    store.load_json(json);
+    std::istringstream settings(
+        "[General]\nCheckForUpdates=true\nAccountJoinDelay=8\nAsyncJoin=false\n"
+        "[Developer]\nDevMode=false\nEnableTracing=false\n"
+        "[WebServer]\nEnableWebServer=false\nWebServerPort=7963\n");
+    ram::IniFile ini(settings);
+    ram::MemoryReport after = ram::memory_report();
+
+    std::printf("accounts=%zu json=%zu bytes sizeof(Account)=%zu\n", accounts, json.size(),
+                sizeof(ram::Account));
+    std::printf("%-9s %14s %12s %14s\n", "tag", "live bytes", "blocks", "bytes/account");
+    int64_t total = 0;
+    for (const auto& usage : after.tags) {
+        const auto& base = before[usage.tag];
+        int64_t bytes = usage.live_bytes - base.live_bytes;
+        int64_t blocks = usage.live_blocks - base.live_blocks;
+        if (usage.tag == ram::MemoryTag::Untagged) continue;  // json text, stdio, ...
+        total += bytes;
+        std::printf("%-9s %14lld %12lld %14.1f\n", ram::to_string(usage.tag),
+                    static_cast<long long>(bytes), static_cast<long long>(blocks),
+                    accounts ? static_cast<double>(bytes) / static_cast<double>(accounts) : 0.0);
+    }
+    int64_t per_account = after[ram::MemoryTag::Accounts].live_bytes -
+                          before[ram::MemoryTag::Accounts].live_bytes +
+                          after[ram::MemoryTag::Fields].live_bytes -
+                          before[ram::MemoryTag::Fields].live_bytes;
+    std::printf("tagged total %lld bytes; accounts+fields %.1f bytes/account\n",
+                static_cast<long long>(total),
+                accounts ? static_cast<double>(per_account) / static_cast<double>(accounts) : 0.0);
+    std::printf("peak accounts %lld bytes (includes the parsed JSON document)\n",
+                static_cast<long long>(after[ram::MemoryTag::Accounts].peak_bytes));
+    return 0;
+}
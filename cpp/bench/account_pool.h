@@ -0,0 +1,95 @@
+#pragma once
+
+// Deterministic synthetic account pools for benchmarks. The same (size,
+// seed) gives the same accounts on every platform and standard library:
+// only mt19937_64's raw output is used, never std distributions.
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ram/account.h"
+
+namespace ram::bench {
+
+class AccountPoolGenerator {
+public:
+    explicit AccountPoolGenerator(uint64_t seed = 0x52414d) : rng_(seed) {}
+
+    /// One account with the field sizes seen in real AccountData files:
+    /// a ~900 character cookie, a 12-13 digit tracker id, mostly-empty
+    /// alias/description/password and a couple of custom fields.
+    Account next() {
+        Account acc(cookie());
+        acc.valid = below(50) != 0;
+        acc.username = username();
+        next_user_id_ += 1 + below(50000);
+        acc.user_id = next_user_id_;
+        acc.browser_tracker_id = digits(12 + below(2));
+        static const char* const kGroups[] = {"Default", "Main", "Alts", "Farm", "Trading"};
+        acc.group = kGroups[below(4) == 0 ? 1 + below(4) : 0];
+        if (below(4) == 0) acc.set_alias(word(4 + below(12)));
+        if (below(10) == 0) acc.set_description(sentence(5 + below(40)));
+        if (below(3) == 0) acc.set_password(word(8 + below(16)));
+        for (size_t i = below(4); i > 0; --i) {
+            acc.fields["Field" + std::to_string(i)] = word(1 + below(24));
+        }
+        auto epoch = std::chrono::system_clock::time_point(std::chrono::seconds(1'700'000'000));
+        acc.last_use = epoch + std::chrono::seconds(below(90 * 86400));
+        acc.last_attempted_refresh = acc.last_use - std::chrono::seconds(below(86400));
+        return acc;
+    }
+
+    std::vector<Account> pool(size_t count) {
+        std::vector<Account> out;
+        out.reserve(count);
+        for (size_t i = 0; i < count; ++i) out.push_back(next());
+        return out;
+    }
+
+private:
+    uint64_t below(uint64_t n) { return rng_() % n; }
+
+    std::string pick(const char* alphabet, size_t alphabet_size, size_t length) {
+        std::string out(length, ' ');
+        for (auto& c : out) c = alphabet[below(alphabet_size)];
+        return out;
+    }
+
+    std::string digits(size_t length) {
+        std::string out = pick("0123456789", 10, length);
+        if (out[0] == '0') out[0] = '1';
+        return out;
+    }
+
+    std::string word(size_t length) {
+        return pick("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", 62, length);
+    }
+
+    std::string sentence(size_t words) {
+        std::string out;
+        for (size_t i = 0; i < words; ++i) {
+            if (i) out += ' ';
+            out += pick("abcdefghijklmnopqrstuvwxyz", 26, 2 + below(8));
+        }
+        return out;
+    }
+
+    std::string username() {
+        return pick("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_", 63,
+                    3 + below(18));
+    }
+
+    std::string cookie() {
+        return "_|WARNING:-DO-NOT-SHARE-THIS.--Sharing-this-will-allow-someone-to-log-in-as-you-"
+               "and-to-steal-your-ROBUX-and-items.|_" +
+               pick("0123456789ABCDEF", 16, 700 + below(200));
+    }
+
+    std::mt19937_64 rng_;
+    int64_t next_user_id_ = 100'000'000;
+};
+
+}  // namespace ram::bench
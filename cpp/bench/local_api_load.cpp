@@ -0,0 +1,147 @@
+// Load generator for the local API: keep-alive clients hammer a LocalApi
+// backed by a synthetic account list and report throughput and latency.
+//
+// Usage: ram_api_load [accounts=1000] [connections=16] [seconds=5] [mode=single|batch]
+//
+// "batch" sends the same store reads as one Batch request of 100
+// operations, the way a script would, instead of one request per call.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/histogram.h"
+#include "ram/local_api.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Requests cycled by every client: store reads, a field lookup, a
+// preformatted error and the liveness probe.
+std::vector<std::string> request_mix(size_t accounts) {
+    std::vector<std::string> out;
+    for (size_t i = 0; i < 64; ++i) {
+        std::string name = "user" + std::to_string((i * 7919) % accounts);
+        out.push_back("GET /GetAlias?Account=" + name + " HTTP/1.1\r\nHost: x\r\n\r\n");
+        out.push_back("GET /v2/GetField?Account=" + name +
+                      "&Field=SavedPlaceId HTTP/1.1\r\nHost: x\r\n\r\n");
+    }
+    out.push_back("GET /GetAlias?Account=nobody HTTP/1.1\r\nHost: x\r\n\r\n");
+    out.push_back("GET /Running HTTP/1.1\r\nHost: x\r\n\r\n");
+    return out;
+}
+
+// One Batch request carrying `ops` GetAlias/GetField operations.
+std::vector<std::string> batch_mix(size_t accounts, size_t ops) {
+    std::string body = "[";
+    for (size_t i = 0; i < ops; ++i) {
+        std::string name = "user" + std::to_string((i * 7919) % accounts);
+        if (i != 0) body += ',';
+        body += i % 2 == 0 ? R"({"Method":"GetAlias","Account":")" + name + "\"}"
+                           : R"({"Method":"GetField","Account":")" + name +
+                                 R"(","Params":{"Field":"SavedPlaceId"}})";
+    }
+    body += "]";
+    return {"POST /v2/Batch HTTP/1.1\r\nHost: x\r\nContent-Length: " +
+            std::to_string(body.size()) + "\r\n\r\n" + body};
+}
+
+// Read until one full response has arrived; leftovers stay in `buffer`.
+bool read_response(const ram::Socket& sock, std::string& buffer) {
+    char chunk[16384];
+    while (true) {
+        ram::HttpResponse response;
+        size_t consumed = 0;
+        auto status = ram::parse_http_response(buffer, false, response, consumed);
+        if (status == ram::ParseStatus::Complete) {
+            buffer.erase(0, consumed);
+            return true;
+        }
+        if (status == ram::ParseStatus::Error) return false;
+        ptrdiff_t n = sock.recv_some(chunk, sizeof(chunk), std::chrono::milliseconds(5000));
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t accounts = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    size_t connections = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 5;
+    bool batch = argc > 4 && std::string(argv[4]) == "batch";
+    const size_t ops_per_request = batch ? 100 : 1;
+    if (accounts == 0) accounts = 1;
+
+    ram::AccountStore store;
+    for (size_t i = 0; i < accounts; ++i) {
+        ram::Account acc("cookie-" + std::to_string(i));
+        acc.username = "user" + std::to_string(i);
+        acc.user_id = static_cast<int64_t>(i) + 1;
+        acc.set_alias("alias " + std::to_string(i));
+        acc.fields["SavedPlaceId"] = std::to_string(1000 + i);
+        store.add(std::move(acc));
+    }
+
+    ram::LocalApiSettings settings;
+    settings.port = 0;
+    ram::LocalApi api(store, settings);
+    api.start();
+
+    const auto mix = batch ? batch_mix(accounts, ops_per_request) : request_mix(accounts);
+    ram::Histogram latency;
+    std::atomic<uint64_t> errors{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c] {
+            ram::Socket sock =
+                ram::Socket::connect("127.0.0.1", api.port(), std::chrono::milliseconds(2000));
+            if (!sock.valid()) {
+                ++errors;
+                return;
+            }
+            std::string buffer;
+            for (size_t i = c; !stop.load(std::memory_order_relaxed); ++i) {
+                const std::string& req = mix[i % mix.size()];
+                auto start = Clock::now();
+                if (!sock.send_all(req.data(), req.size(), std::chrono::milliseconds(5000)) ||
+                    !read_response(sock, buffer)) {
+                    ++errors;
+                    return;
+                }
+                latency.record(Clock::now() - start);
+            }
+        });
+    }
+
+    auto started = Clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+    for (auto& t : clients) t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    api.stop();
+
+    auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    std::printf("mode=%s accounts=%zu connections=%zu duration=%.2fs\n",
+                batch ? "batch" : "single", accounts, connections, elapsed);
+    std::printf("requests=%llu errors=%llu rps=%.0f ops/s=%.0f\n",
+                static_cast<unsigned long long>(latency.count()),
+                static_cast<unsigned long long>(errors.load()),
+                static_cast<double>(latency.count()) / elapsed,
+                static_cast<double>(latency.count() * ops_per_request) / elapsed);
+    std::printf("latency_us p50=%.1f p99=%.1f max=%.1f\n", us(latency.percentile(50)),
+                us(latency.percentile(99)), us(latency.max()));
+    // A 100 call script issued sequentially, one round trip per call or
+    // one per batch.
+    std::printf("script_100_ops_us p50=%.1f\n",
+                us(latency.percentile(50)) * (100.0 / static_cast<double>(ops_per_request)));
+    return errors.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// Marker scanning throughput on Roblox-style log text: MarkerMatcher over
+// whole chunks against splitting into lines and searching each line for
+// every marker, which is what RobloxProcess.ReadLogFile did (with regexes).
+//
+// Usage: ram_log_scan_bench [megabytes=64] [marker_every=500]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ram/log_tailer.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string make_log(size_t bytes, size_t marker_every) {
+    std::string out;
+    out.reserve(bytes + 256);
+    for (size_t line = 0; out.size() < bytes; ++line) {
+        out += "2024-01-01T00:00:01.123Z,2.345678,1a2b,6 ";
+        if (marker_every != 0 && line % marker_every == marker_every - 1) {
+            out += "[FLog::Network] Sending disconnect with reason: 277\n";
+        } else {
+            out += "[FLog::Graphics] frame " + std::to_string(line) +
+                   " present took 16ms, queue depth 2\n";
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    size_t marker_every = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+    std::string log = make_log(megabytes << 20, marker_every);
+
+    std::vector<std::string> patterns;
+    for (const auto& marker : ram::roblox_log_markers()) patterns.push_back(marker.text);
+
+    ram::MarkerMatcher matcher(patterns);
+    std::vector<ram::MarkerMatcher::Hit> hits;
+    const size_t chunk = 64 << 10;
+    auto started = Clock::now();
+    size_t matched = 0;
+    // Whole lines at a time, as the tailer scans them.
+    for (size_t at = 0; at < log.size();) {
+        size_t end = std::min(log.size(), at + chunk);
+        if (end < log.size()) end = log.rfind('\n', end - 1) + 1;
+        hits.clear();
+        matcher.scan(std::string_view(log).substr(at, end - at), hits);
+        matched += hits.size();
+        at = end;
+    }
+    double matcher_s = std::chrono::duration<double>(Clock::now() - started).count();
+
+    started = Clock::now();
+    size_t found = 0;
+    std::string_view rest(log);
+    while (!rest.empty()) {
+        size_t end = rest.find('\n');
+        std::string_view line = rest.substr(0, end);
+        for (const auto& p : patterns) {
+            if (line.find(p) != std::string_view::npos) ++found;
+        }
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+    }
+    double lines_s = std::chrono::duration<double>(Clock::now() - started).count();
+
+    double mb = static_cast<double>(log.size()) / (1 << 20);
+    std::printf("log=%.0fMB markers=%zu hits=%zu/%zu\n", mb, patterns.size(), matched, found);
+    std::printf("marker_matcher  %8.0f MB/s\n", mb / matcher_s);
+    std::printf("per_line_find   %8.0f MB/s\n", mb / lines_s);
+    return matched == found ? 0 : 1;
+}
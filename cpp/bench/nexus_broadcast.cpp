@@ -0,0 +1,155 @@
+// Fan-out benchmark for the Nexus server: many loopback websocket clients
+// receive a stream of messages and the delivered rate is reported.
+//
+// Usage: ram_nexus_bench [clients=1000] [seconds=5] [payload=64] [mode=broadcast|unicast]
+//
+// "broadcast" frames each message once for every client; "unicast" sends
+// it to each client separately, as the C# server did.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "ram/nexus_server.h"
+#include "ram/poller.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void raise_fd_limit() {
+#ifndef _WIN32
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+ram::Socket connect_client(uint16_t port, size_t index) {
+    ram::Socket sock = ram::Socket::connect("127.0.0.1", port, std::chrono::milliseconds(5000));
+    if (!sock.valid()) return sock;
+    std::string req = "GET /Nexus?name=bench" + std::to_string(index) +
+                      "&id=1 HTTP/1.1\r\nHost: x\r\nUpgrade: websocket\r\n"
+                      "Connection: Upgrade\r\nSec-WebSocket-Version: 13\r\n"
+                      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n";
+    if (!sock.send_all(req.data(), req.size(), std::chrono::milliseconds(5000))) return {};
+
+    std::string head;
+    char c;
+    while (head.size() < 4 || head.compare(head.size() - 4, 4, "\r\n\r\n") != 0) {
+        if (sock.recv_some(&c, 1, std::chrono::milliseconds(5000)) != 1) return {};
+        head += c;
+    }
+    if (head.rfind("HTTP/1.1 101", 0) != 0) return {};
+    sock.set_nonblocking(true);
+    return sock;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t client_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 5;
+    size_t payload_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+    bool unicast = argc > 4 && std::string(argv[4]) == "unicast";
+    raise_fd_limit();
+
+    ram::NexusServerOptions options;
+    options.ping_interval = std::chrono::minutes(10);
+    options.timeout = std::chrono::minutes(20);
+    ram::NexusServer server(options);
+    std::mutex ids_mutex;
+    std::vector<uint64_t> ids;
+    server.on_connect([&](const ram::NexusClient& c) {
+        std::lock_guard<std::mutex> lock(ids_mutex);
+        ids.push_back(c.id);
+        return true;
+    });
+    server.start();
+
+    std::vector<ram::Socket> clients;
+    for (size_t i = 0; i < client_count; ++i) {
+        ram::Socket sock = connect_client(server.port(), i);
+        if (!sock.valid()) {
+            std::fprintf(stderr, "client %zu failed to connect\n", i);
+            return 1;
+        }
+        clients.push_back(std::move(sock));
+    }
+
+    // One thread drains every client socket.
+    std::atomic<uint64_t> received{0};
+    std::atomic<bool> stop{false};
+    std::thread reader([&] {
+        ram::Poller poller;
+        for (size_t i = 0; i < clients.size(); ++i) poller.add(clients[i].handle(), i);
+        std::vector<ram::Poller::Event> events;
+        std::vector<char> chunk(1 << 16);
+        while (!stop) {
+            poller.wait(std::chrono::milliseconds(50), events);
+            for (const auto& ev : events) {
+                for (;;) {
+                    ptrdiff_t n = clients[ev.id].recv_nowait(chunk.data(), chunk.size());
+                    if (n <= 0) break;
+                    received.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+                }
+            }
+        }
+    });
+
+    std::string payload(payload_size, 'x');
+    ram::WebSocketFrame frame = ram::encode_websocket_frame(ram::WsOpcode::Text, payload);
+    const uint64_t per_message = frame->size() * client_count;
+    // Keep a bounded amount in flight so the benchmark measures throughput
+    // rather than slow-consumer eviction.
+    const uint64_t window = per_message * 64;
+
+    uint64_t messages = 0;
+    auto started = Clock::now();
+    auto deadline = started + std::chrono::seconds(seconds);
+    while (Clock::now() < deadline) {
+        if (messages * per_message - received.load(std::memory_order_relaxed) > window) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (unicast) {
+            for (uint64_t id : ids) server.send(id, payload);
+        } else {
+            server.send_frame({}, frame);
+        }
+        ++messages;
+    }
+    auto drain_deadline = Clock::now() + std::chrono::seconds(5);
+    while (received.load() < messages * per_message && Clock::now() < drain_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    stop = true;
+    reader.join();
+
+    auto stats = server.stats();
+    uint64_t deliveries = received.load() / frame->size();
+    std::printf("mode=%s clients=%zu payload=%zuB duration=%.2fs\n",
+                unicast ? "unicast" : "broadcast", client_count, payload_size, elapsed);
+    std::printf("messages=%llu deliveries=%llu msgs/s=%.0f deliveries/s=%.0f MB/s=%.1f\n",
+                static_cast<unsigned long long>(messages),
+                static_cast<unsigned long long>(deliveries), messages / elapsed,
+                deliveries / elapsed, received.load() / elapsed / 1e6);
+    std::printf("send calls=%llu frames per call=%.1f evicted=%llu\n",
+                static_cast<unsigned long long>(stats.writes),
+                stats.writes ? static_cast<double>(stats.frames_queued) / stats.writes : 0.0,
+                static_cast<unsigned long long>(stats.slow_consumers_evicted));
+    server.stop();
+    return stats.slow_consumers_evicted == 0 ? 0 : 1;
+}
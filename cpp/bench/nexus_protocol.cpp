@@ -0,0 +1,124 @@
+// Encode/decode benchmark for Nexus commands: JSON text, one command per
+// message, against the binary protocol with commands batched per frame.
+//
+// Usage: ram_nexus_protocol_bench [commands=1000000] [batch=32]
+//
+// Reports time, wire bytes and heap allocations per command.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ram/nexus_protocol.h"
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+using Clock = std::chrono::steady_clock;
+
+// What Nexus.lua sends in steady state: heartbeats, logs and status.
+std::vector<ram::NexusCommand> sample_commands() {
+    return {
+        {"ping", {}},
+        {"Log", {{"Content", "Teleported to place 1818 server 7f3c"}}},
+        {"Status", {{"Place", "1818"}, {"Job", "7f3c9a2e"}, {"Health", "100"}}},
+        {"SetJobId", {{"Content", "7f3c9a2e-51d4-4b61-a0f5-3c2e1d0b9a87"}}},
+    };
+}
+
+struct Result {
+    double ns = 0;
+    double bytes = 0;
+    double allocations = 0;
+};
+
+void report(const char* name, const Result& r) {
+    std::printf("%-7s %8.1f ns/command %7.1f bytes/command %6.2f allocations/command\n", name,
+                r.ns, r.bytes, r.allocations);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+    size_t total = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t batch = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+    if (batch == 0) batch = 1;
+    const auto commands = sample_commands();
+    volatile size_t sink = 0;
+
+    Result json;
+    {
+        uint64_t bytes = 0;
+        uint64_t before = g_allocations.load();
+        auto started = Clock::now();
+        for (size_t i = 0; i < total; ++i) {
+            std::string text = ram::serialize_json_command(commands[i % commands.size()]);
+            bytes += text.size();
+            auto parsed = ram::parse_json_command(text);
+            sink = sink + parsed->payload.size();
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+        json = {elapsed / total, static_cast<double>(bytes) / total,
+                static_cast<double>(g_allocations.load() - before) / total};
+    }
+
+    Result binary;
+    {
+        // Field arrays for the encoder, built once outside the timed loop.
+        std::vector<std::vector<ram::NexusField>> fields;
+        for (const auto& command : commands) {
+            auto& f = fields.emplace_back();
+            for (const auto& [key, value] : command.payload) f.push_back({key, value});
+        }
+        ram::NexusBinaryEncoder encoder;
+        ram::NexusArena arena;
+        // Warm the buffers so steady state is measured.
+        encoder.begin();
+        for (size_t i = 0; i < batch; ++i) {
+            const auto& f = fields[i % fields.size()];
+            encoder.add(commands[i % commands.size()].name, f.data(), f.size());
+        }
+
+        uint64_t bytes = 0;
+        uint64_t before = g_allocations.load();
+        auto started = Clock::now();
+        for (size_t done = 0; done < total;) {
+            encoder.begin();
+            size_t n = std::min(batch, total - done);
+            for (size_t i = 0; i < n; ++i) {
+                size_t k = (done + i) % commands.size();
+                encoder.add(commands[k].name, fields[k].data(), fields[k].size());
+            }
+            bytes += encoder.frame().size();
+
+            arena.reset();
+            ram::NexusFrameReader reader(encoder.frame());
+            ram::NexusCommandView view;
+            while (reader.next(arena, view)) sink = sink + view.field_count;
+            done += n;
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+        binary = {elapsed / total, static_cast<double>(bytes) / total,
+                  static_cast<double>(g_allocations.load() - before) / total};
+    }
+
+    std::printf("commands=%zu batch=%zu\n", total, batch);
+    report("json", json);
+    report("binary", binary);
+    std::printf("speedup=%.1fx size=%.0f%%\n", json.ns / binary.ns,
+                100.0 * binary.bytes / json.bytes);
+    return 0;
+}
@@ -0,0 +1,290 @@
+// Hot-path microbenchmarks (Google Benchmark): hashing, INI parsing,
+// account JSON round trips over synthetic pools, and file encryption.
+//
+// Usage: ram_bench [--benchmark_filter=regex]
+//                  [--benchmark_out=results.json --benchmark_out_format=json]
+//
+// The JSON export carries the library version and pool seed in its
+// "context" block, so runs from different versions can be compared with
+// Google Benchmark's tools/compare.py.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "account_pool.h"
+#include "ram/account.h"
+#include "ram/account_import.h"
+#include "ram/account_merge.h"
+#include "ram/account_store.h"
+#include "ram/cryptography.h"
+#include "ram/ini_file.h"
+#include "ram/metrics.h"
+#include "ram/tracing.h"
+#include "ram/utilities.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr uint64_t kPoolSeed = 0x52414d;
+
+const std::vector<ram::Account>& account_pool(size_t count) {
+    static std::map<size_t, std::vector<ram::Account>> pools;
+    auto it = pools.find(count);
+    if (it == pools.end()) {
+        it = pools.emplace(count, ram::bench::AccountPoolGenerator(kPoolSeed).pool(count)).first;
+    }
+    return it->second;
+}
+
+std::string pool_json(size_t count) {
+    nlohmann::json array = nlohmann::json::array();
+    for (const auto& acc : account_pool(count)) array.push_back(acc.to_json());
+    return array.dump();
+}
+
+std::string filler(size_t bytes) {
+    std::string out(bytes, ' ');
+    for (size_t i = 0; i < bytes; ++i) out[i] = static_cast<char>('a' + (i * 7 + i / 13) % 26);
+    return out;
+}
+
+// A settings file shaped like RAMSettings.ini, `sections` sections deep.
+std::string ini_text(size_t sections) {
+    std::string out;
+    for (size_t s = 0; s < sections; ++s) {
+        out += "# section " + std::to_string(s) + "\n[Section" + std::to_string(s) + "]\n";
+        out += "Enabled=true\nInterval=" + std::to_string(s * 10) + "\nRatio=0.75\n";
+        out += "Name=Value number " + std::to_string(s) + "\n";
+        for (int p = 0; p < 6; ++p) {
+            out += "Key" + std::to_string(p) + "=" + std::to_string(s * 31 + p) + "\n";
+        }
+        out += "\n";
+    }
+    return out;
+}
+
+// A temporary file removed when the benchmark ends.
+struct TempFile {
+    std::string path;
+
+    explicit TempFile(const std::string& content) {
+        path = (fs::temp_directory_path() /
+                ("ram_bench_" +
+                 std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())))
+                   .string();
+        std::ofstream(path, std::ios::binary) << content;
+    }
+    ~TempFile() {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+};
+
+void BM_Md5(benchmark::State& state) {
+    std::string input = filler(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(ram::md5(input));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Md5)->Arg(16)->Arg(1 << 10)->Arg(1 << 16);
+
+void BM_FileSha256(benchmark::State& state) {
+    TempFile file(filler(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) benchmark::DoNotOptimize(ram::file_sha256(file.path));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_FileSha256)->Arg(4 << 10)->Arg(1 << 20)->Arg(16 << 20);
+
+void BM_IniLoad(benchmark::State& state) {
+    std::string text = ini_text(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::istringstream stream(text);
+        ram::IniFile ini(stream);
+        benchmark::DoNotOptimize(ini);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_IniLoad)->Arg(10)->Arg(1000);
+
+void BM_IniSave(benchmark::State& state) {
+    std::istringstream source(ini_text(static_cast<size_t>(state.range(0))));
+    ram::IniFile ini(source);
+    ini.set_preserve_formatting(state.range(1) != 0);
+    ini.section("Section0").set("Interval", "999");
+    for (auto _ : state) {
+        std::ostringstream out;
+        ini.save(out);
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_IniSave)->ArgNames({"sections", "lossless"})->ArgsProduct({{10, 1000}, {0, 1}});
+
+void BM_IniGetAs(benchmark::State& state) {
+    std::istringstream source(ini_text(1));
+    ram::IniFile ini(source);
+    const ram::IniSection& section = ini.section("Section0");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(section.get_as<bool>("Enabled"));
+        benchmark::DoNotOptimize(section.get_as<int>("Interval"));
+        benchmark::DoNotOptimize(section.get_as<double>("Ratio"));
+        benchmark::DoNotOptimize(section.get_as<std::string>("Name"));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 4);
+}
+BENCHMARK(BM_IniGetAs);
+
+// Serialize a pool to the JSON text AccountData holds and back. Stops at
+// 256k accounts: a million-account DOM needs several GB.
+void BM_AccountJsonRoundTrip(benchmark::State& state) {
+    const auto& pool = account_pool(static_cast<size_t>(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        nlohmann::json array = nlohmann::json::array();
+        for (const auto& acc : pool) array.push_back(acc.to_json());
+        std::string text = array.dump();
+        bytes += text.size();
+        std::vector<ram::Account> loaded;
+        loaded.reserve(pool.size());
+        for (const auto& j : nlohmann::json::parse(text)) {
+            loaded.push_back(ram::Account::from_json(j));
+        }
+        benchmark::DoNotOptimize(loaded);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pool.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AccountJsonRoundTrip)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_AccountStoreRoundTrip(benchmark::State& state) {
+    std::string json = pool_json(static_cast<size_t>(state.range(0)));
+    ram::AccountStore store;
+    for (auto _ : state) {
+        store.load_json(json);
+        benchmark::DoNotOptimize(store.to_json());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_AccountStoreRoundTrip)->Arg(1 << 10)->Arg(1 << 15)->Unit(benchmark::kMillisecond);
+
+// A pasted cookie dump into a store already holding half of it, so every
+// other line is a duplicate. Arg is the number of parser threads.
+void BM_ImportAccounts(benchmark::State& state) {
+    const auto& pool = account_pool(1 << 15);
+    std::string dump;
+    for (const auto& acc : pool) dump += acc.security_token + '\n';
+    std::vector<ram::Account> existing(pool.begin(), pool.begin() + pool.size() / 2);
+    ram::ImportOptions options;
+    options.threads = static_cast<size_t>(state.range(0));
+    ram::AccountStore store;
+    for (auto _ : state) {
+        state.PauseTiming();
+        store.update_all([&](std::vector<ram::Account>& accounts) { accounts = existing; });
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(ram::import_accounts(store, dump, options));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pool.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * dump.size()));
+}
+BENCHMARK(BM_ImportAccounts)->ArgName("threads")->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// Two machines' AccountData files sharing half their accounts.
+void BM_AccountMerge(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    const auto& pool = account_pool(count + count / 2);
+    auto json_of = [](auto begin, auto end) {
+        nlohmann::json array = nlohmann::json::array();
+        for (auto it = begin; it != end; ++it) array.push_back(it->to_json());
+        return array.dump();
+    };
+    std::string a = json_of(pool.begin(), pool.begin() + count);
+    std::string b = json_of(pool.begin() + count / 2, pool.end());
+    for (auto _ : state) {
+        ram::AccountMerger merger;
+        merger.add_json(a);
+        merger.add_json(b);
+        benchmark::DoNotOptimize(merger.accounts().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2 * count));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (a.size() + b.size())));
+}
+BENCHMARK(BM_AccountMerge)->Arg(1 << 10)->Arg(1 << 15)->Unit(benchmark::kMillisecond);
+
+// Encryption is dominated by the Argon2 key derivation, so pool size
+// barely matters; one realistic pool is enough.
+void BM_Encrypt(benchmark::State& state) {
+    std::string json = pool_json(static_cast<size_t>(state.range(0)));
+    std::vector<uint8_t> password = {'h', 'u', 'n', 't', 'e', 'r', '2'};
+    if (ram::encrypt("probe", password).empty()) {
+        state.SkipWithError("encryption unavailable (built without libsodium)");
+        return;
+    }
+    for (auto _ : state) benchmark::DoNotOptimize(ram::encrypt(json, password));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+BENCHMARK(BM_Encrypt)->Arg(1 << 10)->Unit(benchmark::kMillisecond);
+
+void BM_Decrypt(benchmark::State& state) {
+    std::string json = pool_json(static_cast<size_t>(state.range(0)));
+    std::vector<uint8_t> password = {'h', 'u', 'n', 't', 'e', 'r', '2'};
+    std::vector<uint8_t> encrypted = ram::encrypt(json, password);
+    if (encrypted.empty()) {
+        state.SkipWithError("encryption unavailable (built without libsodium)");
+        return;
+    }
+    for (auto _ : state) benchmark::DoNotOptimize(ram::decrypt(encrypted, password));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+BENCHMARK(BM_Decrypt)->Arg(1 << 10)->Unit(benchmark::kMillisecond);
+
+// Per-event recording cost; the thread counts show whether shards contend.
+void BM_CounterAdd(benchmark::State& state) {
+    static ram::Counter counter;
+    for (auto _ : state) counter.add();
+}
+BENCHMARK(BM_CounterAdd)->Threads(1)->Threads(4);
+
+void BM_LatencyRecord(benchmark::State& state) {
+    static ram::LatencyHistogram histogram;
+    int64_t ns = 1000;
+    for (auto _ : state) histogram.record(std::chrono::nanoseconds(ns++ & 0xffff));
+}
+BENCHMARK(BM_LatencyRecord)->Threads(1)->Threads(4);
+
+// Span cost with tracing off (the normal case) and on.
+void BM_TraceSpan(benchmark::State& state) {
+    if (state.range(0) != 0) {
+        ram::Tracer::global().enable();
+    } else {
+        ram::Tracer::global().disable();
+    }
+    for (auto _ : state) ram::TraceSpan span("bench");
+    ram::Tracer::global().disable();
+    ram::Tracer::global().clear();
+}
+BENCHMARK(BM_TraceSpan)->ArgName("enabled")->Arg(0)->Arg(1);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::AddCustomContext("ram_version", RAM_VERSION);
+    benchmark::AddCustomContext("ram_libsodium", RAM_HAS_LIBSODIUM ? "yes" : "no");
+    benchmark::AddCustomContext("pool_seed", std::to_string(kPoolSeed));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
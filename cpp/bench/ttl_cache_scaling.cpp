@@ -0,0 +1,89 @@
+// Read scaling of TtlCache against one mutex-guarded map, the shape of
+// Batch.cs's PlaceDetails dictionary: threads look up random place IDs in a
+// warm cache and the aggregate lookups per second are reported for 1..N
+// threads.
+//
+// Usage: ram_cache_bench [max_threads=hardware] [keys=10000] [ms_per_step=500]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/ttl_cache.h"
+
+namespace {
+
+struct PlaceDetails {
+    int64_t universe_id = 0;
+    std::string name;
+};
+
+template <typename Lookup>
+double run(size_t threads, size_t keys, int ms, Lookup lookup) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            uint64_t x = 0x9E3779B97F4A7C15ULL * (t + 1);
+            uint64_t count = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i) {
+                    x ^= x << 13;
+                    x ^= x >> 7;
+                    x ^= x << 17;
+                    lookup(static_cast<int64_t>(x % keys));
+                }
+                count += 256;
+            }
+            total += count;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    stop = true;
+    for (auto& w : workers) w.join();
+    return static_cast<double>(total.load()) / (ms / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                  : std::max(1u, std::thread::hardware_concurrency());
+    size_t keys = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000;
+    int ms = argc > 3 ? std::atoi(argv[3]) : 500;
+    if (keys == 0) keys = 1;
+
+    ram::TtlCacheOptions options;
+    options.capacity = keys * 2;
+    options.shards = 64;
+    ram::TtlCache<int64_t, PlaceDetails> cache(options);
+    std::mutex mutex;
+    std::unordered_map<int64_t, PlaceDetails> map;
+    for (size_t i = 0; i < keys; ++i) {
+        PlaceDetails details{static_cast<int64_t>(i), "Place " + std::to_string(i)};
+        cache.put(static_cast<int64_t>(i), details);
+        map.emplace(static_cast<int64_t>(i), details);
+    }
+
+    std::printf("%8s %16s %16s\n", "threads", "ttl_cache/s", "mutex_map/s");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double sharded = run(threads, keys, ms, [&](int64_t id) {
+            PlaceDetails out;
+            cache.lookup(id, out);
+        });
+        double locked = run(threads, keys, ms, [&](int64_t id) {
+            std::lock_guard<std::mutex> lock(mutex);
+            PlaceDetails out = map.find(id)->second;
+        });
+        std::printf("%8zu %16.0f %16.0f\n", threads, sharded, locked);
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ram/account.h"
+#include "ram/account_store.h"
+
+namespace ram {
+
+struct ImportOptions {
+    /// Parser threads; 0 uses std::thread::hardware_concurrency().
+    size_t threads = 0;
+    /// Input is split into chunks of about this many bytes, cut at line ends.
+    size_t chunk_bytes = 256 << 10;
+    /// Group given to every imported account.
+    std::string group = "Default";
+    /// Optional check run on the parser threads for each parsed account,
+    /// e.g. to resolve the user ID behind a cookie. Return false to reject
+    /// the line.
+    std::function<bool(Account&)> validate;
+    /// Saved once after the accounts are added; empty skips the save.
+    std::string save_path;
+};
+
+struct ImportError {
+    size_t line = 0;  // 1-based
+    std::string message;
+};
+
+struct ImportResult {
+    size_t added = 0;
+    size_t duplicates = 0;  // already in the store or earlier in the input
+    std::vector<ImportError> errors;  // in line order
+    bool saved = false;
+};
+
+/// Parse one pasted line, as accepted by import_accounts(). Returns false
+/// with `error` set if the line is neither a cookie nor a user:pass pair.
+bool parse_import_line(std::string_view line, Account& account, std::string& error);
+
+/// Bulk import for the ImportForm cookie list and the "user:pass" dialog.
+/// Each non-blank line (lines starting with '#' are comments) is one of:
+///
+///   _|WARNING:...|_<token>             a .ROBLOSECURITY cookie, possibly
+///                                      inside other text such as a
+///                                      ".ROBLOSECURITY=" header
+///   username:password:_|WARNING:...    both
+///   username:password
+///
+/// Lines are parsed and validated in parallel chunks. Duplicates - the
+/// same cookie, username (ignoring case) or user ID as an account in the
+/// store or on an earlier line - are counted and skipped by comparing
+/// 64-bit fingerprints. The rest are appended in input order under one
+/// exclusive store lock, then the store is saved once.
+ImportResult import_accounts(AccountStore& store, std::string_view text,
+                             const ImportOptions& options = {});
+
+}  // namespace ram
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/account.h"
+
+namespace ram {
+
+struct MergeStats {
+    size_t inputs = 0;     // files or JSON texts added
+    size_t read = 0;       // accounts read from them
+    size_t merged = 0;     // accounts folded into an earlier record
+    size_t replaced = 0;   // of those, newer by last_use than the record
+};
+
+/// Combines AccountData files from several machines into one list.
+///
+/// Records are matched by user ID, falling back to a fingerprint of the
+/// security token for accounts without one. On a match the record with
+/// the newest last_use wins (the earlier one on a tie); the loser's custom
+/// fields are kept where the winner has no value, and its user ID fills
+/// in a missing one. Output keeps the order accounts were first seen.
+///
+/// Each add is O(accounts added) with hashing. Files are read one array
+/// element at a time, so only accounts are held in memory (the merged ones
+/// plus those of the input being read), not a JSON document per input.
+class AccountMerger {
+public:
+    AccountMerger() = default;
+
+    /// Fold in the accounts in `path`, decrypting with `key` if the file
+    /// starts with the RAM header. A missing or empty file adds nothing.
+    /// Throws std::runtime_error if it cannot be decrypted or parsed.
+    void add_file(const std::string& path, const std::vector<uint8_t>& key = {});
+
+    /// Fold in a JSON array of accounts. Throws std::runtime_error if the
+    /// text is not one, in which case none of its accounts are merged.
+    void add_json(std::string_view json);
+
+    void add(Account account);
+
+    /// Write the merged list to `path` atomically, encrypted with `key` if
+    /// one is given. Plain output is streamed to disk one account at a
+    /// time. Returns false if encryption or the write failed.
+    bool save(const std::string& path, const std::vector<uint8_t>& key = {}) const;
+
+    const std::vector<Account>& accounts() const { return accounts_; }
+    std::vector<Account> take();
+    MergeStats stats() const { return stats_; }
+
+private:
+    /// Index of the record `account` matches, or accounts_.size().
+    size_t find(const Account& account) const;
+    void index(size_t i);
+
+    std::vector<Account> accounts_;
+    std::unordered_map<int64_t, size_t> by_id_;
+    std::unordered_map<uint64_t, size_t> by_token_;
+    MergeStats stats_;
+};
+
+}  // namespace ram
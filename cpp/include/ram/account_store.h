@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/account.h"
+
+namespace ram {
+
+/// The account list (AccountData.json) shared by the UI, the local API and
+/// background jobs. Accounts are looked up by username or user ID through
+/// an index; readers share a lock and every mutation bumps version().
+class AccountStore {
+public:
+    /// Lookups and edits made under one exclusive lock; see transact().
+    class Transaction {
+    public:
+        /// The account matching `name_or_id`, or nullptr.
+        Account* find(const std::string& name_or_id);
+        /// Record that an account was edited.
+        void touch() { modified_ = true; }
+
+    private:
+        friend class AccountStore;
+        explicit Transaction(AccountStore& store) : store_(store) {}
+
+        AccountStore& store_;
+        bool modified_ = false;
+    };
+
+    AccountStore() = default;
+
+    AccountStore(const AccountStore&) = delete;
+    AccountStore& operator=(const AccountStore&) = delete;
+
+    /// Replace the contents with the accounts in `path`. Files starting
+    /// with the RAM header are decrypted with `key`, which is then kept for
+    /// save(). A missing or empty file loads no accounts. Throws
+    /// std::runtime_error if the file cannot be decrypted or parsed.
+    void load(const std::string& path, const std::vector<uint8_t>& key = {});
+
+    /// Replace the contents with accounts parsed from a JSON array.
+    /// Throws std::runtime_error if the text is not one.
+    void load_json(const std::string& json);
+
+    /// Write all accounts to `path` atomically, encrypted when a key is
+    /// set. Returns false if encryption or the write failed.
+    bool save(const std::string& path) const;
+
+    /// JSON array of every account, as written by save().
+    std::string to_json() const;
+
+    /// Key used to encrypt on save; empty saves plain JSON.
+    void set_encryption_key(std::vector<uint8_t> key);
+
+    /// Append an account. Returns false if one with the same user ID (or,
+    /// without one, the same security token) already exists.
+    bool add(Account account);
+
+    /// Remove the account matching `name_or_id`. Returns false if absent.
+    bool remove(const std::string& name_or_id);
+
+    /// Run `fn` on the account whose username or user ID is `name_or_id`
+    /// under the shared lock. Returns false if there is none.
+    bool read(const std::string& name_or_id,
+              const std::function<void(const Account&)>& fn) const;
+
+    /// Run `fn` on the matching account under the exclusive lock and bump
+    /// the version. Returns false if there is none.
+    bool update(const std::string& name_or_id,
+                const std::function<void(Account&)>& fn);
+
+    /// Visit every account in order under the shared lock.
+    void for_each(const std::function<void(const Account&)>& fn) const;
+
+    /// Run `fn` under the exclusive lock so that many lookups and edits pay
+    /// for it once. If `fn` touched the transaction the index is rebuilt and
+    /// the version bumped once. Returns whether anything was touched.
+    bool transact(const std::function<void(Transaction&)>& fn);
+
+    /// Mutate the whole list under the exclusive lock (reorder, bulk edits).
+    void update_all(const std::function<void(std::vector<Account>&)>& fn);
+
+    std::vector<Account> snapshot() const;
+    size_t size() const;
+
+    /// Incremented by every mutation; readers can use it to detect change.
+    uint64_t version() const;
+
+private:
+    const Account* find_locked(const std::string& name_or_id) const;
+    void reindex_locked();
+
+    mutable std::shared_mutex mutex_;
+    std::vector<Account> accounts_;
+    std::unordered_map<std::string, size_t> by_name_;
+    std::unordered_map<std::string, size_t> by_id_;
+    std::vector<uint8_t> key_;
+    std::atomic<uint64_t> version_{0};
+};
+
+}  // namespace ram
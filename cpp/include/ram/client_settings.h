@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/ini_file.h"
+
+namespace ram {
+
+/// The [General] settings ClientSettingsPatcher.PatchSettings acts on.
+struct ClientSettingsConfig {
+    /// CustomClientSettings: a file copied over ClientAppSettings.json.
+    /// Takes precedence over unlock_fps when it can be read.
+    std::string custom_file;
+    bool unlock_fps = false;
+    int max_fps = 240;
+
+    static ClientSettingsConfig from_ini(const IniSection& general);
+};
+
+enum class PatchResult {
+    Unchanged,  // the target already had the desired content
+    Written,
+    Skipped,    // nothing configured to patch
+    Failed,
+};
+
+struct ClientSettingsStats {
+    uint64_t patches = 0;
+    uint64_t unchanged = 0;
+    uint64_t writes = 0;
+    uint64_t failures = 0;
+    uint64_t generations = 0;  // times the desired content was computed
+};
+
+/// Keeps <version dir>/ClientSettings/ClientAppSettings.json in line with
+/// the configured settings without rewriting it on every launch.
+///
+/// The desired content is computed once per configure() (a generation)
+/// rather than per launch. Each patch hashes the target and returns
+/// Unchanged if it matches what this generation last wrote or verified
+/// there, so a mass launch costs one small read per account and no
+/// writes. Changes are written with write_file_atomic. Thread-safe.
+class ClientSettingsPatcher {
+public:
+    static constexpr const char* kFpsKey = "DFIntTaskSchedulerTargetFps";
+
+    explicit ClientSettingsPatcher(ClientSettingsConfig config = {});
+
+    /// Replace the settings and start a new generation.
+    void configure(ClientSettingsConfig config);
+    uint64_t generation() const;
+
+    /// Patch one install directory (a version-* folder).
+    PatchResult patch(const std::string& version_dir);
+
+    /// Patch several install directories on up to `threads` threads.
+    /// Results are in input order.
+    std::vector<PatchResult> patch_all(const std::vector<std::string>& version_dirs,
+                                       size_t threads = 4);
+
+    /// version-* folders under `root` that contain a player executable.
+    static std::vector<std::string> find_version_dirs(const std::string& root);
+
+    static std::string settings_path(const std::string& version_dir);
+
+    ClientSettingsStats stats() const;
+
+private:
+    /// What a generation writes. In Replace mode `content` is the whole
+    /// file; in Merge mode only kFpsKey is set in whatever JSON is there.
+    struct Desired {
+        enum class Mode { None, Replace, Merge } mode = Mode::None;
+        uint64_t generation = 0;
+        std::string content;
+        std::string content_hash;  // SHA-256 of content, uppercase hex
+        int fps = 0;
+    };
+
+    struct Verified {
+        uint64_t generation = 0;
+        std::string hash;  // target's SHA-256 when last written or checked
+    };
+
+    std::shared_ptr<const Desired> desired();
+    PatchResult apply(const Desired& desired, const std::string& target);
+    void remember(const std::string& target, uint64_t generation, std::string hash);
+
+    mutable std::mutex mutex_;
+    ClientSettingsConfig config_;
+    uint64_t generation_ = 1;
+    std::shared_ptr<const Desired> desired_;  // for generation_, built lazily
+    std::unordered_map<std::string, Verified> verified_;  // by target path
+    ClientSettingsStats stats_;
+};
+
+}  // namespace ram
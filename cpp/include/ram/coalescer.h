@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ram {
+
+/// Options controlling when a Coalescer flushes its pending batch.
+struct CoalescerOptions {
+    /// Flush as soon as this many distinct keys are pending.
+    size_t max_batch_size = 100;
+    /// Flush this long after the first key of a batch was submitted.
+    std::chrono::milliseconds window{50};
+};
+
+/// Counters describing how well requests are being coalesced.
+struct CoalescerStats {
+    uint64_t submitted = 0;         // submit() calls
+    uint64_t merged = 0;            // submits that joined an existing key
+    uint64_t batches = 0;           // backend calls
+    uint64_t batched_keys = 0;      // keys sent to the backend
+    uint64_t size_flushes = 0;      // batches flushed because they were full
+    uint64_t deadline_flushes = 0;  // batches flushed by the window deadline
+    uint64_t failed_batches = 0;    // backend calls that threw
+
+    /// Average fraction of max_batch_size used per backend call.
+    double fill_ratio(size_t max_batch_size) const {
+        if (batches == 0 || max_batch_size == 0) return 0.0;
+        return static_cast<double>(batched_keys) /
+               (static_cast<double>(batches) * max_batch_size);
+    }
+};
+
+/// Collects keys submitted over a short time window into one backend call,
+/// the C++ counterpart of Batch.cs. Each submit() returns a future for that
+/// key's result; concurrent submits of the same key share one future.
+///
+/// The backend receives the distinct keys of a batch and returns a map of
+/// results. Keys missing from the map fail with std::out_of_range; if the
+/// backend throws, every waiter of that batch receives the exception.
+template <typename Key, typename Result, typename Hash = std::hash<Key>>
+class Coalescer {
+public:
+    using ResultMap = std::unordered_map<Key, Result, Hash>;
+    using Backend = std::function<ResultMap(const std::vector<Key>&)>;
+
+    explicit Coalescer(Backend backend, CoalescerOptions options = {})
+        : backend_(std::move(backend)), options_(options) {
+        if (options_.max_batch_size == 0) options_.max_batch_size = 1;
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~Coalescer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    Coalescer(const Coalescer&) = delete;
+    Coalescer& operator=(const Coalescer&) = delete;
+
+    /// Queue a key for the next batch and return a future for its result.
+    std::shared_future<Result> submit(const Key& key) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++stats_.submitted;
+
+        if (auto it = in_flight_.find(key); it != in_flight_.end()) {
+            ++stats_.merged;
+            return it->second;
+        }
+        if (auto it = pending_.find(key); it != pending_.end()) {
+            ++stats_.merged;
+            return it->second.future;
+        }
+
+        if (pending_.empty()) {
+            deadline_ = std::chrono::steady_clock::now() + options_.window;
+        }
+        Pending entry;
+        entry.future = entry.promise.get_future().share();
+        auto future = entry.future;
+        pending_.emplace(key, std::move(entry));
+        order_.push_back(key);
+
+        // The worker only needs waking to arm the deadline (first key) or to
+        // flush a full batch; other submits ride along silently.
+        bool wake = order_.size() == 1 ||
+                    order_.size() >= options_.max_batch_size;
+        lock.unlock();
+        if (wake) cv_.notify_one();
+        return future;
+    }
+
+    /// Flush whatever is pending without waiting for the window to elapse.
+    void flush() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            flush_requested_ = true;
+        }
+        cv_.notify_one();
+    }
+
+    CoalescerStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    const CoalescerOptions& options() const { return options_; }
+
+private:
+    struct Pending {
+        std::promise<Result> promise;
+        std::shared_future<Result> future;
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this] {
+                return stopping_ || flush_requested_ || !order_.empty();
+            });
+            if (order_.empty()) {
+                flush_requested_ = false;
+                if (stopping_) return;
+                continue;
+            }
+
+            bool full = false;
+            while (!stopping_ && !flush_requested_) {
+                full = order_.size() >= options_.max_batch_size;
+                if (full) break;
+                if (cv_.wait_until(lock, deadline_) == std::cv_status::timeout) {
+                    break;
+                }
+            }
+            full = order_.size() >= options_.max_batch_size;
+            flush_requested_ = false;
+
+            // Take at most one batch worth of keys; the rest stay pending.
+            size_t count = std::min(order_.size(), options_.max_batch_size);
+            std::vector<Key> keys(order_.begin(), order_.begin() + count);
+            order_.erase(order_.begin(), order_.begin() + count);
+
+            std::vector<std::pair<Key, std::promise<Result>>> waiters;
+            waiters.reserve(count);
+            for (const auto& key : keys) {
+                auto node = pending_.extract(key);
+                in_flight_.emplace(key, node.mapped().future);
+                waiters.emplace_back(key, std::move(node.mapped().promise));
+            }
+            if (!order_.empty()) {
+                deadline_ = std::chrono::steady_clock::now() + options_.window;
+            }
+
+            ++stats_.batches;
+            stats_.batched_keys += count;
+            if (full) {
+                ++stats_.size_flushes;
+            } else {
+                ++stats_.deadline_flushes;
+            }
+
+            lock.unlock();
+            dispatch(keys, waiters);
+            lock.lock();
+
+            for (const auto& key : keys) in_flight_.erase(key);
+        }
+    }
+
+    void dispatch(const std::vector<Key>& keys,
+                  std::vector<std::pair<Key, std::promise<Result>>>& waiters) {
+        ResultMap results;
+        try {
+            results = backend_(keys);
+        } catch (...) {
+            auto error = std::current_exception();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.failed_batches;
+            }
+            for (auto& [key, promise] : waiters) promise.set_exception(error);
+            return;
+        }
+
+        for (auto& [key, promise] : waiters) {
+            auto it = results.find(key);
+            if (it == results.end()) {
+                promise.set_exception(std::make_exception_ptr(
+                    std::out_of_range("Coalescer: no result for key")));
+            } else {
+                promise.set_value(std::move(it->second));
+            }
+        }
+    }
+
+    Backend backend_;
+    CoalescerOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    bool flush_requested_ = false;
+    std::chrono::steady_clock::time_point deadline_{};
+    std::vector<Key> order_;
+    std::unordered_map<Key, Pending, Hash> pending_;
+    std::unordered_map<Key, std::shared_future<Result>, Hash> in_flight_;
+    CoalescerStats stats_;
+
+    std::thread worker_;
+};
+
+}  // namespace ram
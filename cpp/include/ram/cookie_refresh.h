@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/account.h"
+#include "ram/rate_limiter.h"
+
+namespace ram {
+
+struct CookieRefreshOptions {
+    /// An account becomes eligible once it has been unused this long...
+    std::chrono::milliseconds stale_after{std::chrono::hours(24 * 20)};
+    /// ...and no refresh was attempted for this long.
+    std::chrono::milliseconds retry_after{std::chrono::hours(24 * 7)};
+    /// Refreshes running at once.
+    size_t max_in_flight = 2;
+    /// Refreshes started per second and burst; the C# timer slept 5s
+    /// between accounts.
+    double refreshes_per_second = 0.2;
+    double burst = 1.0;
+};
+
+struct CookieRefreshStats {
+    uint64_t attempted = 0;
+    uint64_t succeeded = 0;
+    uint64_t failed = 0;
+    uint64_t wakeups = 0;  // dispatcher wakeups; idle while nothing is due
+};
+
+/// Automatic cookie refresh. Each account is keyed by the time it next
+/// becomes eligible (see CookieRefreshOptions) in an indexed min-heap, so
+/// updates are O(log n) and the dispatcher sleeps until the earliest one
+/// is due instead of rescanning every account on a timer. Accounts with
+/// the NoCookieRefresh field set to "true" are never scheduled.
+class CookieRefreshScheduler {
+public:
+    using Clock = std::chrono::system_clock;
+
+    /// Refresh one account; return true on success. Called on a worker
+    /// thread with the time the attempt was made, which the caller should
+    /// store as the account's last_attempted_refresh.
+    using Refresher =
+        std::function<bool(const std::string& key, Clock::time_point attempted_at)>;
+
+    explicit CookieRefreshScheduler(Refresher refresher,
+                                    CookieRefreshOptions options = {});
+    ~CookieRefreshScheduler();
+
+    CookieRefreshScheduler(const CookieRefreshScheduler&) = delete;
+    CookieRefreshScheduler& operator=(const CookieRefreshScheduler&) = delete;
+
+    /// Add or reschedule an account from its timestamps and fields.
+    void update(const std::string& key, const Account& account);
+    void remove(const std::string& key);
+
+    /// When the account is next eligible, or std::nullopt if it is not
+    /// scheduled (unknown, opted out, or currently refreshing).
+    std::optional<Clock::time_point> due_at(const std::string& key) const;
+    /// Earliest due time across all accounts.
+    std::optional<Clock::time_point> next_due() const;
+    size_t scheduled() const;
+
+    /// Eligibility time for an account, or std::nullopt if it opted out.
+    std::optional<Clock::time_point> eligible_at(const Account& account) const;
+
+    void start();
+    void stop();
+
+    CookieRefreshStats stats() const;
+
+private:
+    static constexpr size_t kNotQueued = static_cast<size_t>(-1);
+
+    struct Entry {
+        Clock::time_point last_use{};
+        Clock::time_point last_attempted{};
+        Clock::time_point due{};
+        size_t heap_index = kNotQueued;
+        bool in_flight = false;
+        bool removed = false;  // removed while in flight
+    };
+
+    using EntryMap = std::unordered_map<std::string, Entry>;
+    // Map nodes are stable across rehashing, unlike iterators.
+    using Node = EntryMap::value_type;
+
+    Clock::time_point due_for(const Entry& entry) const;
+
+    // Heap of map nodes ordered by due time; each entry records its index.
+    void heap_push(Node& node);
+    void heap_erase(size_t index);
+    void heap_fix(size_t index);
+    void sift_up(size_t index);
+    void sift_down(size_t index);
+    void heap_swap(size_t a, size_t b);
+
+    void dispatch_loop();
+    void worker_loop();
+    void finish(const std::string& key, Clock::time_point attempted_at, bool ok);
+
+    Refresher refresher_;
+    CookieRefreshOptions options_;
+    TokenBucket budget_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable dispatch_cv_;
+    std::condition_variable worker_cv_;
+    EntryMap entries_;
+    std::vector<Node*> heap_;
+    std::deque<std::string> ready_;
+    size_t in_flight_ = 0;
+    bool running_ = false;
+    CookieRefreshStats stats_;
+
+    std::thread dispatcher_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace ram
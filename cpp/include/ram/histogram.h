@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ram {
+
+/// Lock-free log-linear histogram (HDR style): every power of two is split
+/// into 8 linear sub-buckets, so any recorded value is reported within
+/// ~12.5% of its true value. Values are unitless; latency helpers record
+/// nanoseconds.
+class Histogram {
+public:
+    static constexpr int kSubBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    Histogram() = default;
+    Histogram(const Histogram& other);
+    Histogram& operator=(const Histogram& other);
+
+    void record(uint64_t value);
+    void record(std::chrono::nanoseconds duration) {
+        record(static_cast<uint64_t>(duration.count() < 0 ? 0 : duration.count()));
+    }
+
+    /// Add every sample of `other` into this histogram.
+    void merge(const Histogram& other);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    /// Upper bound of the bucket holding the p-th percentile (0-100).
+    uint64_t percentile(double p) const;
+
+    uint64_t bucket_count(size_t index) const {
+        return buckets_[index].load(std::memory_order_relaxed);
+    }
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower_bound(size_t index);
+    static uint64_t bucket_upper_bound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+}  // namespace ram
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ram/socket.h"
+#include "ram/tls.h"
+
+namespace ram {
+
+using HttpHeaders = std::vector<std::pair<std::string, std::string>>;
+
+/// Case-insensitive header lookup. Returns nullptr if not present.
+const std::string* find_header(const HttpHeaders& headers,
+                               std::string_view name);
+
+/// Cookies sent with every request that references the jar. Values are
+/// shared, immutable strings so one account's .ROBLOSECURITY token is
+/// written straight from the jar into each request buffer without copies.
+/// Thread-safe; Set-Cookie responses replace values atomically.
+class CookieJar {
+public:
+    CookieJar() = default;
+
+    /// Jar holding a single .ROBLOSECURITY cookie.
+    static std::shared_ptr<CookieJar> for_security_token(std::string token);
+
+    void set(const std::string& name, std::string value);
+    void set(const std::string& name, std::shared_ptr<const std::string> value);
+    void remove(const std::string& name);
+
+    std::shared_ptr<const std::string> get(const std::string& name) const;
+
+    /// Append "name=value; name2=value2" to `out`.
+    void append_to(std::string& out) const;
+
+    /// Apply Set-Cookie headers from a response (name=value only; attributes
+    /// are ignored). An empty value removes the cookie.
+    void update_from(const HttpHeaders& headers);
+
+    bool empty() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const std::string>> cookies_;
+};
+
+/// An HTTP request. On the client side `url` is absolute
+/// ("http://host:port/path"); when parsed by a server it holds the
+/// request target ("/path?query").
+struct HttpRequest {
+    std::string method = "GET";
+    std::string url;
+    HttpHeaders headers;
+    std::string body;
+    /// Optional per-account cookies merged into the Cookie header.
+    std::shared_ptr<CookieJar> cookies;
+
+    const std::string* header(std::string_view name) const {
+        return find_header(headers, name);
+    }
+};
+
+struct HttpResponse {
+    int status = 0;
+    std::string reason;
+    HttpHeaders headers;
+    std::string body;
+
+    bool ok() const { return status >= 200 && status < 300; }
+
+    const std::string* header(std::string_view name) const {
+        return find_header(headers, name);
+    }
+};
+
+/// Components of an absolute http:// or https:// URL.
+struct Url {
+    std::string scheme;
+    std::string host;
+    uint16_t port = 80;
+    std::string target = "/";
+
+    /// Parse an absolute URL. Returns std::nullopt if malformed.
+    static std::optional<Url> parse(const std::string& url);
+
+    /// "host:port", used in error messages.
+    std::string authority() const;
+
+    /// "scheme://host:port", used to key connections and TLS sessions.
+    std::string origin() const;
+};
+
+/// Thrown when a request cannot be delivered (DNS, connect, timeout or a
+/// malformed response). HTTP error statuses are returned, not thrown.
+class HttpError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// Decode %XX escapes and '+' (as a space) in a URL component.
+std::string url_decode(std::string_view in);
+
+/// Parse "a=1&b=2" into decoded key/value pairs. The first value wins
+/// when a key repeats.
+std::map<std::string, std::string> parse_query(std::string_view query);
+
+enum class ParseStatus { Incomplete, Complete, Error };
+
+/// Parse one request from the front of `data`. On Complete, `consumed` is
+/// the length of the message so pipelined requests can follow. A body
+/// (Content-Length or chunked) longer than `max_body` is an Error.
+ParseStatus parse_http_request(std::string_view data, HttpRequest& out,
+                               size_t& consumed,
+                               size_t max_body = std::string_view::npos);
+
+/// Parse one response from the front of `data`. Responses without a
+/// Content-Length or chunked body are only Complete once `eof` is true.
+/// A body longer than `max_body`, however delimited, is an Error. Interim
+/// 1xx responses are skipped and counted in `consumed`. Pass
+/// `body_expected` false for replies to HEAD, which carry no body whatever
+/// their headers say.
+ParseStatus parse_http_response(std::string_view data, bool eof,
+                                HttpResponse& out, size_t& consumed,
+                                size_t max_body = std::string_view::npos,
+                                bool body_expected = true);
+
+/// Serialize a response, adding Content-Length.
+std::string serialize_http_response(const HttpResponse& response);
+
+/// Serialize only the status line and headers (ending in the blank line),
+/// with a Content-Length for the body, so the body can be sent separately.
+std::string serialize_http_response_head(const HttpResponse& response);
+
+struct HttpClientOptions {
+    std::chrono::milliseconds connect_timeout{5000};
+    std::chrono::milliseconds request_timeout{15000};
+    /// Upper bound on open connections per host:port.
+    size_t max_connections_per_host = 8;
+    /// Idle keep-alive connections older than this are closed, not reused.
+    std::chrono::milliseconds idle_timeout{30000};
+    /// Threads serving send_async. Started on first use.
+    size_t async_threads = 4;
+    /// Certificate checks for https:// connections.
+    TlsOptions tls{};
+    /// Responses whose body exceeds this fail with HttpError instead of
+    /// being buffered.
+    size_t max_response_bytes = 64 * 1024 * 1024;
+};
+
+struct HttpClientStats {
+    uint64_t requests = 0;
+    uint64_t connections_opened = 0;
+    uint64_t connections_reused = 0;
+    uint64_t stale_retries = 0;
+    uint64_t tls_handshakes = 0;
+    /// Handshakes that resumed a cached session instead of a full one.
+    uint64_t tls_resumed = 0;
+};
+
+/// HTTP/1.1 client with a bounded keep-alive connection pool per origin.
+/// https:// uses TlsStream and resumes sessions across new connections;
+/// builds without OpenSSL throw HttpError for https:// URLs.
+class HttpClient {
+public:
+    explicit HttpClient(HttpClientOptions options = {});
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    /// Send a request and wait for the full response.
+    HttpResponse send(const HttpRequest& request);
+
+    /// Send requests to the same host back-to-back on one connection and
+    /// read the responses in order (HTTP/1.1 pipelining). Requests for
+    /// different hosts are pipelined per host. Responses match input order.
+    std::vector<HttpResponse> send_pipelined(
+        const std::vector<HttpRequest>& requests);
+
+    /// Queue a request on the client's worker threads.
+    std::future<HttpResponse> send_async(HttpRequest request);
+
+    /// Close all idle pooled connections.
+    void close_idle();
+
+    HttpClientStats stats() const;
+    const HttpClientOptions& options() const { return options_; }
+
+private:
+    struct Connection {
+        Socket socket;
+        std::unique_ptr<TlsStream> tls;  // set for https; destroyed before socket
+        std::string buffer;  // bytes read past the previous response
+        std::chrono::steady_clock::time_point last_used;
+
+        bool send_all(const char* data, size_t size, std::chrono::milliseconds timeout) {
+            return tls ? tls->send_all(data, size, timeout)
+                       : socket.send_all(data, size, timeout);
+        }
+        ptrdiff_t recv_some(char* data, size_t size, std::chrono::milliseconds timeout) {
+            return tls ? tls->recv_some(data, size, timeout)
+                       : socket.recv_some(data, size, timeout);
+        }
+    };
+
+    struct HostPool {
+        std::vector<std::unique_ptr<Connection>> idle;
+        size_t open = 0;
+        std::condition_variable available;
+    };
+
+    std::unique_ptr<Connection> acquire(const Url& url, bool& reused,
+                                        std::chrono::steady_clock::time_point deadline);
+    void release(const Url& url, std::unique_ptr<Connection> conn, bool reusable);
+    std::vector<HttpResponse> exchange(const Url& url,
+                                       const std::vector<const HttpRequest*>& requests);
+    void worker_loop();
+    TlsContext& tls_context();
+
+    HttpClientOptions options_;
+
+    std::mutex tls_mutex_;
+    std::unique_ptr<TlsContext> tls_;  // created on the first https request
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, HostPool> pools_;
+    HttpClientStats stats_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+}  // namespace ram
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/http.h"
+#include "ram/poller.h"
+#include "ram/socket.h"
+
+namespace ram {
+
+/// A fully serialized response (status line, headers and body) that can
+/// be sent many times without copying.
+using PreformattedResponse = std::shared_ptr<const std::string>;
+
+PreformattedResponse preformat(const HttpResponse& response);
+
+/// What a handler sends back: either a shared preformatted message or a
+/// response serialized on the way out. The body of the latter is moved
+/// into the send queue and written alongside its head, not copied.
+struct ServerResponse {
+    PreformattedResponse preformatted;
+    HttpResponse response;
+
+    ServerResponse() = default;
+    ServerResponse(PreformattedResponse message) : preformatted(std::move(message)) {}
+    ServerResponse(HttpResponse r) : response(std::move(r)) {}
+};
+
+struct ServerRequest {
+    HttpRequest http;
+    bool from_loopback = false;
+};
+
+/// Exact-match lookup table for a fixed set of names. A seed is searched
+/// at build time so that every name lands in its own slot; a lookup is one
+/// hash, one slot and one string compare.
+class PerfectHashRouter {
+public:
+    static constexpr int kNotFound = -1;
+
+    PerfectHashRouter() = default;
+    explicit PerfectHashRouter(const std::vector<std::string>& names);
+
+    /// Index of `name` in the constructor's list, or kNotFound.
+    int find(std::string_view name) const;
+
+    size_t table_size() const { return slots_.size(); }
+
+private:
+    static uint64_t hash(std::string_view name, uint64_t seed);
+
+    std::vector<std::string> names_;
+    std::vector<int> slots_;
+    uint64_t seed_ = 0;
+    uint64_t mask_ = 0;
+};
+
+struct HttpServerOptions {
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;  // 0 picks an ephemeral port
+    /// Threads for handlers that call Responder::defer.
+    size_t worker_threads = 4;
+    /// Requests larger than this (headers plus body) close the connection.
+    size_t max_request_bytes = 1 << 20;
+    /// Keep-alive connections idle for longer than this are closed.
+    std::chrono::milliseconds idle_timeout{60000};
+};
+
+struct HttpServerStats {
+    uint64_t connections_accepted = 0;
+    uint64_t connections_closed = 0;
+    uint64_t requests = 0;
+    uint64_t deferred = 0;       // handled on the worker pool
+    uint64_t preformatted = 0;   // responses sent from shared buffers
+    uint64_t parse_errors = 0;
+};
+
+class HttpServer;
+
+/// Completes one request. Handlers either call send() before returning
+/// or defer() the work to the server's worker pool, which must then
+/// call send() exactly once.
+class Responder {
+public:
+    void send(ServerResponse response);
+    void defer(std::function<void(Responder)> work);
+
+private:
+    friend class HttpServer;
+    Responder(HttpServer* server, uint64_t connection) : server_(server), connection_(connection) {}
+
+    HttpServer* server_;
+    uint64_t connection_;
+};
+
+/// Event-driven HTTP/1.1 server: one thread multiplexes every connection
+/// with epoll (poll on other platforms). Connections are kept alive and
+/// pipelined requests are answered in order, one at a time per
+/// connection. Handlers run on the event thread, so anything that blocks
+/// must be deferred to the worker pool.
+class HttpServer {
+public:
+    using Handler = std::function<void(ServerRequest&, Responder)>;
+
+    explicit HttpServer(Handler handler, HttpServerOptions options = {});
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    /// Bind and start the event and worker threads. Throws
+    /// std::runtime_error if the address cannot be bound.
+    void start();
+    void stop();
+
+    uint16_t port() const { return port_; }
+    HttpServerStats stats() const;
+
+private:
+    friend class Responder;
+
+    struct OutChunk {
+        PreformattedResponse shared;
+        std::string owned;
+        size_t offset = 0;
+
+        const std::string& bytes() const { return shared ? *shared : owned; }
+    };
+
+    struct Connection {
+        Socket socket;
+        std::string in;
+        std::deque<OutChunk> out;
+        bool busy = false;        // a request is being handled
+        bool close_after = false; // close once `out` drains
+        bool loopback = false;
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    void event_loop();
+    void accept_ready();
+    void read_ready(uint64_t id, Connection& conn);
+    void write_ready(uint64_t id, Connection& conn);
+    void process(uint64_t id, Connection& conn);
+    void finish(uint64_t id, ServerResponse response);
+    void close_connection(uint64_t id);
+    void drain_completions();
+    void sweep_idle();
+    void worker_loop();
+    void enqueue_work(std::function<void()> work);
+    void wake();
+
+    Handler handler_;
+    HttpServerOptions options_;
+    uint16_t port_ = 0;
+
+    Socket listener_;
+    Socket wake_read_;
+    Socket wake_write_;
+    std::unique_ptr<Poller> poller_;
+    std::atomic<bool> running_{false};
+    std::thread loop_thread_;
+
+    // Owned by the event thread.
+    std::unordered_map<uint64_t, Connection> connections_;
+    uint64_t next_id_ = 1;
+    // Set by the event thread, read by workers in finish().
+    std::atomic<std::thread::id> loop_id_;
+
+    // Completions posted by workers.
+    std::mutex completions_mutex_;
+    std::vector<std::pair<uint64_t, ServerResponse>> completions_;
+    std::atomic<bool> wake_pending_{false};
+
+    std::mutex work_mutex_;
+    std::condition_variable work_cv_;
+    std::deque<std::function<void()>> work_;
+    std::vector<std::thread> workers_;
+    bool workers_stopping_ = false;
+
+    mutable std::mutex stats_mutex_;
+    HttpServerStats stats_;
+};
+
+}  // namespace ram
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace ram {
+
+struct ImageCacheOptions {
+    /// Directory for the on-disk tier; empty keeps images in memory only.
+    std::string directory;
+    /// Bytes of image data kept in memory.
+    size_t memory_bytes = 64 << 20;
+    /// Bytes of image data kept on disk before the oldest entries go.
+    size_t disk_bytes = 512 << 20;
+};
+
+struct ImageCacheStats {
+    uint64_t memory_hits = 0;
+    uint64_t disk_hits = 0;
+    uint64_t fetches = 0;          // downloads started
+    uint64_t joined = 0;           // lookups that waited on another's download
+    uint64_t fetch_failures = 0;
+    uint64_t memory_evictions = 0;
+    uint64_t disk_evictions = 0;   // URLs dropped from the disk index
+    uint64_t memory_bytes = 0;
+    uint64_t disk_bytes = 0;
+    uint64_t disk_entries = 0;     // URLs in the disk index
+
+    /// Share of lookups answered without a download of their own.
+    double hit_ratio() const {
+        uint64_t lookups = memory_hits + disk_hits + fetches + joined;
+        return lookups == 0 ? 0.0
+                            : static_cast<double>(memory_hits + disk_hits + joined) / lookups;
+    }
+};
+
+/// Cache for thumbnail and avatar images (the URLs Batch.GetImage returns).
+///
+/// The memory tier is an LRU bounded by bytes. On disk each image is
+/// stored once as <directory>/<xx>/<sha256 of the bytes>, so different URLs
+/// for the same picture share a file, and an append-only index of URL ->
+/// content records is memory-mapped and read at startup, so an image is
+/// downloaded once across restarts. Concurrent lookups of a URL that is
+/// being downloaded wait for that download instead of starting their own.
+class ImageCache {
+public:
+    /// Download an image; std::nullopt on failure. Failures are not cached.
+    using Fetcher = std::function<std::optional<std::string>(const std::string& url)>;
+    using Image = std::shared_ptr<const std::string>;
+
+    /// Throws std::runtime_error if the directory cannot be created.
+    explicit ImageCache(Fetcher fetcher, ImageCacheOptions options = {});
+    ~ImageCache();
+
+    ImageCache(const ImageCache&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+
+    /// The image at `url`, downloading it if neither tier has it. Blocks
+    /// while downloading. Returns nullptr if the download failed.
+    Image get(const std::string& url);
+
+    /// The image at `url` if either tier has it, without downloading.
+    Image peek(const std::string& url);
+
+    ImageCacheStats stats() const;
+
+private:
+    struct MemoryEntry {
+        Image image;
+        std::list<std::string>::iterator lru;
+    };
+
+    struct DiskEntry {
+        std::string content;  // SHA-256 of the bytes
+        uint64_t size = 0;
+        std::list<std::string>::iterator order;
+    };
+
+    Image read_disk(const std::string& url_key);
+    Image read_blob(const std::string& content, uint64_t size) const;
+    void remember_locked(const std::string& url_key, const Image& image);
+    void store(const std::string& url_key, const Image& image);
+    void add_disk_entry_locked(const std::string& url_key, const std::string& content,
+                               uint64_t size);
+    /// Drop a URL from the disk tier, deleting its blob if no other URL
+    /// refers to it.
+    void remove_disk_entry_locked(const std::string& url_key);
+    void evict_disk_locked();
+    void load_index();
+    bool rewrite_index_locked();
+    std::string blob_path(const std::string& content) const;
+
+    Fetcher fetcher_;
+    ImageCacheOptions options_;
+    std::string index_path_;
+
+    mutable std::mutex mutex_;
+    // Memory tier, by URL hash; front is most recently used.
+    std::unordered_map<std::string, MemoryEntry> memory_;
+    std::list<std::string> memory_lru_;
+    // Disk tier, by URL hash; front is oldest.
+    std::unordered_map<std::string, DiskEntry> disk_;
+    std::list<std::string> disk_order_;
+    std::unordered_map<std::string, size_t> disk_refs_;  // content -> URLs
+    std::ofstream index_out_;
+    uint64_t index_records_ = 0;
+
+    std::unordered_map<std::string, std::shared_future<Image>> in_flight_;
+    ImageCacheStats stats_;
+};
+
+}  // namespace ram
@@ -1,17 +1,26 @@
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <string>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 namespace ram {
 
 /// Represents a property in an INI file.
 struct IniProperty {
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
     std::string name;
     std::string value;
     std::string comment;
+
+    // Line index in the loaded source, or npos if the property is new.
+    size_t line = npos;
+    // True if the value changed since the last load or save.
+    bool dirty = false;
 };
 
 /// Represents a section in an INI file.
@@ -48,9 +57,22 @@ public:
     /// Return number of properties.
     size_t size() const { return properties_.size(); }
 
+    /// True if any property was added, changed or removed since the last
+    /// load or save.
+    bool dirty() const;
+
 private:
+    friend class IniFile;
+
     std::string name_;
     std::string comment_;
+
+    // Source layout, used by IniFile for lossless saves.
+    // [header, next header) line spans, one per header occurrence.
+    std::vector<std::pair<size_t, size_t>> spans_;
+    size_t last_line_ = IniProperty::npos;
+    std::vector<size_t> removed_lines_;
+
     // Use a vector to maintain insertion order plus a map for fast lookup
     std::vector<std::string> order_;
     std::map<std::string, IniProperty> properties_;
@@ -75,6 +97,15 @@ public:
     char comment_char() const { return comment_char_; }
     void set_comment_char(char c) { comment_char_ = c; }
 
+    /// If true, saving rewrites only the lines of changed properties and keeps
+    /// every other line of the loaded source (comments, blank lines, unknown
+    /// entries) byte-for-byte. Default false.
+    bool preserve_formatting() const { return preserve_formatting_; }
+    void set_preserve_formatting(bool v) { preserve_formatting_ = v; }
+
+    /// True if anything changed since the last load or save.
+    bool dirty() const;
+
     /// Get a section by name. Creates it if it doesn't exist.
     IniSection& section(const std::string& name);
 
@@ -87,8 +118,11 @@ public:
     /// Get all sections.
     std::vector<IniSection> sections() const;
 
-    /// Save INI content to a file path.
-    void save(const std::string& path) const;
+    /// Save INI content to a file path. The file is written to a temporary
+    /// file first and then renamed over the target. Returns false if the
+    /// write was skipped because nothing changed since the file at `path` was
+    /// loaded or last saved.
+    bool save(const std::string& path);
 
     /// Write INI content to a stream.
     void save(std::ostream& stream) const;
@@ -98,9 +132,22 @@ public:
 
 private:
     void load(std::istream& stream);
+    void load_lines();
+    std::string format_property(const IniProperty& prop) const;
+    void render_full(std::ostream& stream) const;
+    void render_lossless(std::ostream& stream) const;
+    void adopt_layout(const IniFile& parsed);
 
     bool write_spacing_ = false;
     char comment_char_ = '#';
+    bool preserve_formatting_ = false;
+
+    // Raw source lines (without line terminators) and the file they came
+    // from, kept so unchanged lines can be written back verbatim.
+    std::vector<std::string> lines_;
+    bool trailing_newline_ = true;
+    std::string source_path_;
+    std::vector<std::pair<size_t, size_t>> removed_spans_;
     std::vector<std::string> section_order_;
     std::map<std::string, IniSection> sections_;
 };
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ram/account.h"
+#include "ram/http.h"
+#include "ram/roblox_auth.h"
+
+namespace ram {
+
+/// Where to send the accounts. Per-account SavedPlaceId/SavedJobId fields
+/// override place_id/job_id unless follow_user is set.
+struct LaunchTarget {
+    int64_t place_id = 0;  // user ID when follow_user is set
+    std::string job_id;
+    bool follow_user = false;
+    bool private_server = false;
+    bool is_teleport = false;
+};
+
+/// Everything needed to start one client.
+struct LaunchSpec {
+    size_t index = 0;  // position in the launch batch
+    std::string username;
+    int64_t user_id = 0;
+    std::string browser_tracker_id;
+    int64_t place_id = 0;
+    std::string job_id;
+    bool follow_user = false;
+    bool private_server = false;
+    bool is_teleport = false;
+    std::string ticket;
+
+    /// The roblox-player: protocol URI the launcher is started with.
+    std::string uri(int64_t launch_time_ms) const;
+};
+
+/// Apply the account's SavedPlaceId/SavedJobId overrides to `target`.
+LaunchTarget resolve_launch_target(const Account& account,
+                                   const LaunchTarget& target);
+
+/// Starts a client for `spec` and returns once it has been handed off
+/// (the C# client waited for the launcher process to exit). Returns false
+/// if it could not be started.
+using Launcher = std::function<bool(const LaunchSpec&)>;
+
+/// Launcher that opens the protocol URI with the system handler.
+bool open_with_protocol_handler(const LaunchSpec& spec);
+
+enum class LaunchStage {
+    Prefetching,  // fetching the CSRF token and authentication ticket
+    Ready,        // ticket obtained, waiting for a launch slot
+    Launching,
+    Launched,
+    Failed,
+    Cancelled,
+};
+
+const char* to_string(LaunchStage stage);
+
+struct LaunchEvent {
+    size_t index = 0;
+    std::string username;
+    LaunchStage stage = LaunchStage::Prefetching;
+    std::string message;  // reason for Failed
+};
+
+struct LaunchOrchestratorOptions {
+    /// Launcher invocations running at once.
+    size_t max_concurrent = 1;
+    /// Launcher invocations started per second, and how many may start
+    /// back-to-back. Replaces the fixed AccountJoinDelay sleep.
+    double starts_per_second = 0.5;
+    double start_burst = 1.0;
+    /// Accounts ahead of the launch cursor whose tickets are fetched early.
+    /// Tickets are single-use and short-lived, so this stays small.
+    size_t prefetch_depth = 4;
+};
+
+struct LaunchSummary {
+    size_t launched = 0;
+    size_t failed = 0;
+    size_t cancelled = 0;
+    /// Per-account results in batch order; browser tracker IDs generated
+    /// for accounts that had none are reported here so they can be saved.
+    std::vector<LaunchEvent> results;
+    std::vector<std::string> browser_tracker_ids;
+};
+
+class TokenBucket;
+
+/// Launches a batch of accounts as a pipeline: tickets for upcoming
+/// accounts are fetched while earlier clients are starting, and launches
+/// proceed in batch order on `max_concurrent` workers under a start rate.
+class LaunchOrchestrator {
+public:
+    using Listener = std::function<void(const LaunchEvent&)>;
+
+    LaunchOrchestrator(HttpClient& client, CsrfTokenCache& csrf,
+                       Launcher launcher,
+                       LaunchOrchestratorOptions options = {});
+
+    LaunchOrchestrator(const LaunchOrchestrator&) = delete;
+    LaunchOrchestrator& operator=(const LaunchOrchestrator&) = delete;
+
+    /// Progress callback, invoked from worker threads.
+    void on_progress(Listener listener) { listener_ = std::move(listener); }
+
+    /// Launch `accounts` in order and block until every account has been
+    /// launched, failed or cancelled.
+    LaunchSummary run(const std::vector<Account>& accounts,
+                      const LaunchTarget& target);
+
+    /// Stop a running batch. Accounts not yet handed to the launcher are
+    /// reported as Cancelled; launches already started are not aborted.
+    /// A cancel issued while no batch is running applies to the next run().
+    void cancel();
+    /// Whether the current (or last) batch was cancelled.
+    bool cancelled() const { return cancelled_; }
+
+private:
+    enum class SlotState { Pending, Fetching, Ready, Failed };
+
+    struct Slot {
+        LaunchSpec spec;
+        const Account* account = nullptr;
+        SlotState state = SlotState::Pending;
+        std::string error;
+    };
+
+    void emit(const Slot& slot, LaunchStage stage, const std::string& message = {});
+    void prefetch_loop(std::vector<Slot>& slots);
+    void launch_loop(std::vector<Slot>& slots, TokenBucket& starts,
+                     std::vector<LaunchEvent>& results);
+
+    HttpClient& client_;
+    CsrfTokenCache& csrf_;
+    Launcher launcher_;
+    LaunchOrchestratorOptions options_;
+    Listener listener_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> cancelled_{false};
+    uint64_t cancel_requests_ = 0;
+    uint64_t cancels_handled_ = 0;  // cancel_requests_ when the last run ended
+    size_t next_prefetch_ = 0;
+    size_t launch_cursor_ = 0;  // slots before it were launched or failed
+    size_t next_launch_ = 0;    // next slot a launch worker takes
+};
+
+}  // namespace ram
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/account.h"
+#include "ram/account_store.h"
+#include "ram/http_server.h"
+#include "ram/ini_file.h"
+#include "ram/roblox_auth.h"
+
+namespace ram {
+
+/// The [WebServer] section of RAMSettings.ini.
+struct LocalApiSettings {
+    uint16_t port = 7963;
+    bool allow_external_connections = false;
+    bool allow_get_cookie = false;
+    bool allow_get_accounts = false;
+    bool allow_launch_account = false;
+    bool allow_account_editing = false;
+    bool every_request_requires_password = false;
+    std::string password;
+
+    static LocalApiSettings from_ini(const IniSection& section);
+};
+
+/// Result of an API method. Plain paths answer with `raw` (or `message`)
+/// as text; /v2/ paths answer {"Success": ..., "Message": ...}.
+struct ApiReply {
+    std::string message;
+    bool success = false;
+    int status = -1;  // -1: 200 on success, 400 otherwise
+    std::optional<std::string> raw;
+};
+
+/// Counters for the cached GetAccounts/GetAccountsJson replies.
+struct AccountsCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;        // replies serialized from the store
+    uint64_t not_modified = 0;  // 304s answered from If-None-Match
+};
+
+/// A call to a method that needs the network or the UI.
+struct ApiCall {
+    std::string method;
+    Account account;  // snapshot taken when the request arrived
+    std::string csrf_token;
+    std::map<std::string, std::string> query;
+    std::string body;
+
+    /// Query parameter, or an empty string.
+    const std::string& param(const std::string& name) const;
+};
+
+/// Port of the local web API (WebServer.cs and SendResponse). Methods that
+/// only read or edit the account store run on the event thread and most
+/// error replies are preformatted once; methods that reach Roblox are
+/// registered with on() and run on the worker pool.
+///
+/// GetAccounts and GetAccountsJson replies are serialized once per store
+/// version and reused until the store (or a displayed CSRF token) changes.
+/// They carry an ETag, and a poll with a matching If-None-Match gets a 304
+/// without touching the store.
+///
+/// Batch takes a JSON array of {"Method", "Account", "Params", "Body"}
+/// operations in the request body and runs the account store methods among
+/// them under one store lock, answering with an array of {"Method",
+/// "Success", "Message"} in the same order. Edits in a batch trigger a
+/// single on_modified callback.
+///
+/// GET /metrics answers with the global MetricsRegistry in Prometheus text
+/// format.
+///
+/// Password gating follows the C# server: with EveryRequestRequiresPassword
+/// every request needs Password to match a password of 6+ characters;
+/// otherwise GetCookie, GetAccounts, LaunchAccount and FollowUser are
+/// refused while the password is shorter than 6 characters or when a
+/// Password parameter is given that does not match.
+class LocalApi {
+public:
+    using Action = std::function<ApiReply(const ApiCall&)>;
+    using Importer = std::function<std::optional<Account>(const std::string& cookie)>;
+
+    /// Method names served by the API, in router order.
+    static const std::vector<std::string>& methods();
+
+    /// `csrf` validates accounts before account methods, as the C# server
+    /// did; without it accounts are not validated and GetCSRFToken is
+    /// unavailable.
+    LocalApi(AccountStore& store, LocalApiSettings settings,
+             CsrfTokenCache* csrf = nullptr, size_t worker_threads = 4);
+
+    LocalApi(const LocalApi&) = delete;
+    LocalApi& operator=(const LocalApi&) = delete;
+
+    /// Serve a network-bound method (LaunchAccount, FollowUser, BlockUser,
+    /// UnblockUser, GetBlockedList, UnblockEveryone, SetServer,
+    /// SetRecommendedServer, SetAvatar) on the worker pool. Unregistered
+    /// methods answer 404. Call before start().
+    void on(const std::string& method, Action action);
+
+    /// Validate a cookie for ImportCookie; the account is added to the store
+    /// on success. Call before start().
+    void set_importer(Importer importer);
+
+    /// Called after a method edits an account, e.g. to schedule a save.
+    void set_on_modified(std::function<void()> callback);
+
+    void start();
+    void stop();
+    uint16_t port() const { return server_.port(); }
+    HttpServerStats stats() const { return server_.stats(); }
+    AccountsCacheStats accounts_cache_stats() const;
+
+private:
+    enum Method : int;
+
+    struct Request {
+        int method;
+        std::string name;
+        bool v2 = false;
+        std::map<std::string, std::string> query;
+        std::string body;
+        std::string password;
+        bool password_given = false;
+    };
+
+    /// A reply rendered ahead of time for both path styles.
+    struct Canned {
+        ApiReply reply;
+        std::array<PreformattedResponse, 2> responses;  // [v1, v2]
+
+        const PreformattedResponse& operator[](int v2) const { return responses[v2]; }
+    };
+
+    struct CachedAccounts {
+        std::string etag;
+        PreformattedResponse response;
+    };
+
+    void handle(ServerRequest& request, Responder responder);
+    void handle_account(Request request, Account account, std::string token,
+                        Responder responder, bool on_worker);
+    const Canned* check(const Request& request) const;
+    ApiReply run_local(const Request& request, Account& account, const std::string& token);
+    ApiReply apply(const Request& request, Account& account, const std::string& token,
+                   bool& edited) const;
+    void handle_batch(const Request& request, Responder responder);
+    /// Run `ops` in one store transaction. Returns std::nullopt without
+    /// running anything if an account's CSRF token is neither in `tokens`
+    /// nor cached; the accounts are then copied to `missing`.
+    std::optional<std::string> run_batch(
+        const std::vector<Request>& ops,
+        const std::unordered_map<std::string, std::string>& tokens,
+        std::vector<Account>* missing);
+    ServerResponse accounts_reply(const Request& request, const std::string* if_none_match);
+    ApiReply get_accounts(const Request& request) const;
+    ApiReply get_accounts_json(const Request& request) const;
+    bool shows_cookies(const Request& request) const;
+    std::string current_etag(std::string_view variant) const;
+    void modified();
+
+    static bool is_network(int method);
+    static bool is_edit(int method);
+    static ServerResponse render(const ApiReply& reply, bool v2);
+    Canned canned(const ApiReply& reply) const;
+
+    AccountStore& store_;
+    LocalApiSettings settings_;
+    CsrfTokenCache* csrf_;
+    PerfectHashRouter router_;
+    std::map<int, Action> actions_;
+    Importer importer_;
+    std::function<void()> on_modified_;
+    HttpServer server_;
+
+    Canned favicon_;
+    Canned running_;
+    Canned external_denied_;
+    Canned invalid_password_;
+    Canned empty_account_;
+    Canned invalid_account_;
+    Canned not_found_;
+    Canned invalid_place_id_;
+    Canned invalid_username_;
+    Canned invalid_batch_;
+    std::vector<Canned> not_allowed_;
+
+    std::string etag_prefix_;
+    mutable std::mutex accounts_cache_mutex_;
+    std::unordered_map<std::string, CachedAccounts> accounts_cache_;
+    AccountsCacheStats accounts_cache_stats_;
+};
+
+}  // namespace ram
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ram {
+
+/// Finds every occurrence of a fixed set of substrings in one pass.
+///
+/// Uses the "Teddy" filter from Hyperscan: patterns are spread over eight
+/// buckets, and for each of the first three bytes of a pattern two 16-entry
+/// tables map the byte's low and high nibble to the buckets that allow it.
+/// With SSSE3 (checked at run time) pshufb looks up 16 positions at once,
+/// so one pass costs the same whatever the number of patterns and text
+/// without markers is skipped at a few instructions per 16 bytes. Positions
+/// that survive the filter are checked with memcmp. Without SSSE3 the same
+/// tables are used a byte at a time.
+class MarkerMatcher {
+public:
+    struct Hit {
+        size_t offset;
+        size_t pattern;  // index into the constructor's list
+    };
+
+    /// Empty patterns are ignored.
+    explicit MarkerMatcher(std::vector<std::string> patterns);
+
+    /// Append every occurrence in `text` to `out`, ordered by offset.
+    void scan(std::string_view text, std::vector<Hit>& out) const;
+
+    size_t size() const { return patterns_.size(); }
+
+    static constexpr size_t kPrefix = 3;
+
+private:
+    /// Bucket bits allowed at `at`, looking at no more than `available`
+    /// bytes.
+    uint8_t candidates(const char* at, size_t available) const;
+    void verify(const char* text, size_t n, size_t at, uint8_t buckets,
+                std::vector<Hit>& out) const;
+
+    std::vector<std::string> patterns_;
+    std::vector<size_t> buckets_[8];
+    // Buckets allowed by the low and high nibble of the byte at each
+    // prefix offset. Patterns shorter than the prefix allow anything past
+    // their end.
+    alignas(16) uint8_t low_[kPrefix][16] = {};
+    alignas(16) uint8_t high_[kPrefix][16] = {};
+    bool ssse3_ = false;
+};
+
+/// A substring that marks an interesting log line. The event's value is
+/// the text after the marker up to `until` (or the end of the line).
+struct LogMarker {
+    std::string name;
+    std::string text;
+    char until = '\0';
+};
+
+/// The lines RobloxProcess.ReadLogFile looks for: joins (job and place
+/// id), disconnect reasons, DataModel start/stop and returns to the app.
+std::vector<LogMarker> roblox_log_markers();
+
+struct LogEvent {
+    std::string file;
+    std::string marker;  // LogMarker::name
+    std::string value;
+    std::string line;    // without the newline
+    uint64_t offset = 0;  // of the line in the file
+    std::chrono::steady_clock::time_point read_at;
+};
+
+struct LogTailerOptions {
+    /// Bytes read per call while catching up.
+    size_t read_chunk = 64 << 10;
+    /// A line longer than this is dropped rather than buffered further.
+    size_t max_line = 64 << 10;
+    /// How often files are checked where inotify is not available.
+    std::chrono::milliseconds poll_interval{250};
+};
+
+struct LogTailerStats {
+    uint64_t wakeups = 0;
+    uint64_t reads = 0;
+    uint64_t bytes = 0;
+    uint64_t events = 0;
+    uint64_t rotations = 0;    // file replaced under the same name
+    uint64_t truncations = 0;  // file shrank below the read offset
+    uint64_t overflows = 0;    // inotify queue overflows, recovered by a rescan
+};
+
+/// Follows Roblox log files and publishes marker lines as they are
+/// written, replacing RobloxWatcher's 250ms re-read timer.
+///
+/// On Linux one inotify watch per directory wakes the tailer when a
+/// watched file is appended to, created or renamed; elsewhere files are
+/// checked every poll_interval. Each file is read from its last offset, so
+/// only new bytes are read, and only lines containing a marker are split
+/// out. A file that shrinks is read again from the start, and one that is
+/// replaced under the same name is finished and then reopened.
+class LogTailer {
+public:
+    using Listener = std::function<void(const LogEvent&)>;
+
+    explicit LogTailer(std::vector<LogMarker> markers = roblox_log_markers(),
+                       LogTailerOptions options = {});
+    ~LogTailer();
+
+    LogTailer(const LogTailer&) = delete;
+    LogTailer& operator=(const LogTailer&) = delete;
+
+    /// Follow `path`. With `from_start` false, content already in the file
+    /// when watch() is called is skipped. The file does not have to exist
+    /// yet; if it does not, it is read from its start once created.
+    void watch(const std::string& path, bool from_start = false);
+    void unwatch(const std::string& path);
+
+    /// Follow every file ending in `suffix` that appears in `directory`
+    /// from now on, from its start.
+    void watch_directory(const std::string& directory, const std::string& suffix = ".log");
+
+    /// Register a listener. Returns an id for unsubscribe. Listeners are
+    /// called on the thread that runs poll() and may subscribe or
+    /// unsubscribe; changes take effect from the next poll.
+    size_t subscribe(Listener listener);
+    void unsubscribe(size_t id);
+
+    /// Wait up to `timeout` for changes and publish what they contain.
+    /// Returns the number of events published.
+    size_t poll(std::chrono::milliseconds timeout);
+
+    /// Read every watched file now, without waiting.
+    size_t poll_now();
+
+    /// Run poll() on a background thread.
+    void start();
+    void stop();
+
+    LogTailerStats stats() const;
+
+private:
+    struct File {
+        std::string path;
+        std::ifstream stream;
+        uint64_t offset = 0;
+        uint64_t identity = 0;  // inode where available
+        bool dirty = true;        // may have unread bytes
+        bool discarding = false;  // inside an over-long line
+        std::string partial;      // bytes after the last newline
+    };
+
+    struct Directory {
+        bool follow_new = false;  // set by watch_directory
+        std::string suffix;
+        int watch = -1;           // inotify watch descriptor
+    };
+
+    Directory& add_directory_locked(const std::string& directory);
+    void add_file_locked(const std::string& path, bool from_start);
+    /// Wait for change notifications and mark the files they name dirty.
+    void wait_for_changes(std::chrono::milliseconds timeout);
+    /// Mark every file dirty and pick up new files in followed directories,
+    /// for when change notifications are unavailable or were lost.
+    void rescan_locked();
+    void drain_locked(File& file, std::vector<LogEvent>& events);
+    void read_locked(File& file, std::vector<LogEvent>& events);
+    void scan_locked(const File& file, std::string_view text, uint64_t base,
+                     std::vector<LogEvent>& events);
+    size_t publish(std::vector<LogEvent>& events);
+    void run();
+
+    std::vector<LogMarker> markers_;
+    MarkerMatcher matcher_;
+    LogTailerOptions options_;
+
+    std::mutex poll_mutex_;  // serializes poll rounds
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<File>> files_;
+    std::map<std::string, Directory> directories_;
+    LogTailerStats stats_;
+    int inotify_ = -1;
+    std::unordered_map<int, std::string> watch_directories_;  // by watch descriptor
+    std::vector<MarkerMatcher::Hit> hits_;
+    std::string chunk_;
+
+    std::mutex listeners_mutex_;
+    std::map<size_t, Listener> listeners_;
+    size_t next_listener_id_ = 1;
+
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
+
+}  // namespace ram
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ram {
+
+/// Subsystems live heap bytes are attributed to.
+enum class MemoryTag : uint8_t {
+    Untagged,
+    Accounts,  // account records and their strings
+    Fields,    // per-account custom fields
+    Ini,       // parsed INI files
+    Crypto,    // encryption and decryption buffers
+    Caches,    // TtlCache entries and cached images
+    Count,
+};
+
+const char* to_string(MemoryTag tag);
+
+/// Allocations made by this thread while a scope is alive are charged to
+/// its tag; scopes nest. A block stays charged to the tag it was allocated
+/// under until it is freed, whichever thread or scope frees it.
+///
+/// Tagging is always on and costs two thread-local writes per scope, but
+/// bytes are only counted in programs that link the ram_memory_hook
+/// library, which replaces the global operator new and delete.
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous_;
+};
+
+/// The tag allocations of this thread are charged to right now.
+MemoryTag current_memory_tag();
+
+struct MemoryTagUsage {
+    MemoryTag tag = MemoryTag::Untagged;
+    int64_t live_bytes = 0;
+    int64_t live_blocks = 0;
+    int64_t peak_bytes = 0;
+    uint64_t allocations = 0;  // since start
+};
+
+struct MemoryReport {
+    bool hooked = false;  // false: ram_memory_hook is not linked, all zeros
+    std::vector<MemoryTagUsage> tags;  // indexed by MemoryTag
+
+    const MemoryTagUsage& operator[](MemoryTag tag) const {
+        return tags[static_cast<size_t>(tag)];
+    }
+    int64_t live_bytes() const;
+
+    /// One line per tag, for logs and the memory bench.
+    std::string to_string() const;
+};
+
+MemoryReport memory_report();
+
+/// Called by ram_memory_hook; not for general use.
+void memory_hook_installed();
+void record_allocation(MemoryTag tag, size_t bytes);
+void record_deallocation(MemoryTag tag, size_t bytes);
+
+}  // namespace ram
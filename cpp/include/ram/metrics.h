@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ram/histogram.h"
+
+namespace ram {
+
+/// Next round-robin shard index; see metrics_shard().
+size_t next_metrics_shard();
+
+/// Shard of the calling thread, assigned on first use.
+inline size_t metrics_shard() {
+    thread_local const size_t shard = next_metrics_shard();
+    return shard;
+}
+
+/// Monotonic counter. Each thread adds to its own cache line, so
+/// concurrent writers do not contend; value() sums the shards.
+class Counter {
+public:
+    static constexpr size_t kShards = 16;
+
+    void add(uint64_t n = 1) {
+        cells_[metrics_shard() % kShards].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t value() const;
+    void reset();
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Cell, kShards> cells_{};
+};
+
+/// A value that goes up and down. set() has to be exact, so a gauge is a
+/// single atomic rather than sharded.
+class Gauge {
+public:
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<int64_t> value_{0};
+};
+
+/// Latency histogram in nanoseconds over per-thread Histogram shards.
+class LatencyHistogram {
+public:
+    static constexpr size_t kShards = 4;
+
+    void record(std::chrono::nanoseconds duration) {
+        shards_[metrics_shard() % kShards].record(duration);
+    }
+    /// All shards merged.
+    Histogram snapshot() const;
+    void reset();
+
+private:
+    std::array<Histogram, kShards> shards_;
+};
+
+/// Records the lifetime of the scope into a LatencyHistogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : histogram_(histogram), started_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { histogram_.record(std::chrono::steady_clock::now() - started_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+/// Named metrics, rendered in the Prometheus text exposition format.
+/// Registration takes a lock and returns a reference that stays valid for
+/// the registry's lifetime; recording through it is lock-free. Asking for
+/// an existing name and label set returns the same metric.
+///
+/// `labels` is the inside of a Prometheus label set, e.g. `algorithm="md5"`.
+/// Metrics sharing a name form one family with one HELP/TYPE header.
+/// Histograms are exported in seconds with power-of-two buckets from ~1us
+/// to ~17s.
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /// The registry ram_core records into.
+    static MetricsRegistry& global();
+
+    /// Throws std::invalid_argument for a malformed name or a name already
+    /// registered as another kind.
+    Counter& counter(const std::string& name, const std::string& help,
+                     const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help,
+                 const std::string& labels = "");
+    LatencyHistogram& histogram(const std::string& name, const std::string& help,
+                                const std::string& labels = "");
+
+    std::string render_prometheus() const;
+
+private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Series {
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<LatencyHistogram> histogram;
+    };
+
+    struct Family {
+        Kind kind;
+        std::string help;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    Series& series(const std::string& name, const std::string& help, const std::string& labels,
+                   Kind kind);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+/// The metrics ram_core records into the global registry.
+struct CoreMetrics {
+    LatencyHistogram& account_load;  // AccountStore::load, decryption included
+    Counter& account_load_failures;
+    LatencyHistogram& account_save;  // AccountStore::save, encryption included
+    Counter& account_save_failures;
+    LatencyHistogram& encrypt;
+    LatencyHistogram& decrypt;
+    LatencyHistogram& kdf;  // Argon2 key derivation inside encrypt/decrypt
+    Counter& crypto_failures;
+    LatencyHistogram& ini_load;
+    Counter& ini_load_bytes;
+    LatencyHistogram& md5;
+    LatencyHistogram& sha256;
+    Counter& hashed_bytes;
+};
+
+const CoreMetrics& core_metrics();
+
+}  // namespace ram
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ram {
+
+/// Wire format a Nexus client negotiated at connect.
+enum class NexusProtocol { Json, Binary };
+
+/// Offered by binary-capable clients in Sec-WebSocket-Protocol (or as
+/// ?protocol=binary for websocket libraries that cannot set headers).
+inline constexpr std::string_view kNexusBinarySubprotocol = "ram-nexus-binary.v1";
+
+/// Nexus.Command: a name and string payload, as sent by Nexus.lua in JSON.
+struct NexusCommand {
+    std::string name;
+    std::map<std::string, std::string> payload;
+};
+
+/// Parse {"Name": ..., "Payload": {...}}. Non-string payload values are
+/// skipped. Returns std::nullopt if the text is not such an object.
+std::optional<NexusCommand> parse_json_command(std::string_view text);
+
+std::string serialize_json_command(const NexusCommand& command);
+
+/// Bump allocator for decoded commands. reset() keeps the largest block,
+/// so decoding frames of a steady size stops allocating after the first.
+class NexusArena {
+public:
+    explicit NexusArena(size_t block_size = 4096) : block_size_(block_size) {}
+
+    NexusArena(const NexusArena&) = delete;
+    NexusArena& operator=(const NexusArena&) = delete;
+
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocate_bytes(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset();
+
+    /// Bytes reserved across all blocks.
+    size_t capacity() const;
+
+private:
+    void* allocate_bytes(size_t size, size_t align);
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    size_t used_ = 0;  // in blocks_.back()
+};
+
+struct NexusField {
+    std::string_view key;
+    std::string_view value;
+};
+
+/// A decoded command. Views point into the frame and the arena.
+struct NexusCommandView {
+    std::string_view name;
+    const NexusField* fields = nullptr;
+    size_t field_count = 0;
+
+    /// Value of `key`, or std::nullopt.
+    std::optional<std::string_view> get(std::string_view key) const;
+};
+
+/// Binary frame layout: a version byte, then commands back to back until
+/// the end of the frame. Integers are LEB128 varints and strings are a
+/// varint length followed by the bytes.
+///
+///   command := name-ref field-count (key-ref string)*
+///   name-ref := id > 0 for a known command, or 0 followed by the name
+///   key-ref  := 1..K for a known key, K+1.. for a key spelled earlier in
+///               the same frame, or 0 followed by the key (which is then
+///               interned for the rest of the frame)
+///
+/// Known commands and keys are the ones Nexus.lua and ControlledAccount.cs
+/// use; anything else is spelled out.
+class NexusBinaryEncoder {
+public:
+    static constexpr uint8_t kVersion = 1;
+
+    /// Start a new frame, reusing the buffer.
+    void begin();
+
+    void add(std::string_view name, const NexusField* fields, size_t count);
+    void add(std::string_view name, std::initializer_list<NexusField> fields = {}) {
+        add(name, fields.begin(), fields.size());
+    }
+    void add(const NexusCommand& command);
+
+    /// The encoded frame; valid until the next begin().
+    std::string_view frame() const { return buffer_; }
+    size_t commands() const { return commands_; }
+
+private:
+    void put_varint(uint64_t value);
+    void put_string(std::string_view text);
+    void put_key(std::string_view key);
+
+    std::string buffer_;
+    size_t commands_ = 0;
+    // Literal keys interned in this frame, as offsets into buffer_.
+    std::pair<size_t, size_t> local_keys_[32];
+    size_t local_key_count_ = 0;
+};
+
+/// Reads the commands of a binary frame one at a time. Field arrays are
+/// allocated from the arena; nothing else is allocated.
+class NexusFrameReader {
+public:
+    explicit NexusFrameReader(std::string_view frame);
+
+    /// Decode the next command. Returns false at the end of the frame or on
+    /// malformed input; error() tells the two apart.
+    bool next(NexusArena& arena, NexusCommandView& out);
+    bool error() const { return error_; }
+
+private:
+    bool get_varint(uint64_t& value);
+    bool get_string(std::string_view& out);
+    bool get_key(std::string_view& out);
+
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool error_ = false;
+    std::string_view local_keys_[32];
+    size_t local_key_count_ = 0;
+};
+
+}  // namespace ram
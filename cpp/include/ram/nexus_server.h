@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/nexus_protocol.h"
+#include "ram/poller.h"
+#include "ram/socket.h"
+#include "ram/websocket.h"
+
+namespace ram {
+
+/// An in-game Nexus client, identified by the query string it connected
+/// with (ws://host/Nexus?name=...&id=...&jobId=...).
+struct NexusClient {
+    uint64_t id = 0;
+    std::string name;
+    int64_t user_id = 0;
+    std::string job_id = "UNKNOWN";
+    bool from_loopback = false;
+    NexusProtocol protocol = NexusProtocol::Json;
+};
+
+struct NexusServerOptions {
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;  // 0 picks an ephemeral port
+    std::string path = "/Nexus";
+    /// Bytes waiting to be written to one client before it is evicted as a
+    /// slow consumer.
+    size_t max_queued_bytes = 4 << 20;
+    /// Largest message accepted from a client, after reassembly.
+    size_t max_message_bytes = 1 << 20;
+    /// A client quiet for this long is sent a ping.
+    std::chrono::milliseconds ping_interval{10000};
+    /// A client quiet for this long (including unanswered pings) is closed.
+    std::chrono::milliseconds timeout{30000};
+};
+
+struct NexusServerStats {
+    uint64_t connections_accepted = 0;
+    uint64_t handshakes_rejected = 0;
+    uint64_t clients = 0;  // currently connected
+    uint64_t messages_received = 0;
+    uint64_t commands_received = 0;
+    uint64_t broadcasts = 0;       // messages framed once for many clients
+    uint64_t frames_queued = 0;    // per-client deliveries
+    uint64_t bytes_sent = 0;
+    uint64_t writes = 0;           // gathered send calls
+    uint64_t slow_consumers_evicted = 0;
+    uint64_t timed_out = 0;
+    uint64_t pings_sent = 0;
+};
+
+/// WebSocket server for Nexus (WebsocketServer.cs and ControlledAccount.cs)
+/// on the same single-threaded event loop design as HttpServer. A message
+/// sent to many clients is framed once and the shared frame is queued for
+/// each of them; each client's queue is flushed with gathered writes, so
+/// back-to-back broadcasts reach a socket in one call. A client whose queue
+/// exceeds max_queued_bytes is disconnected rather than allowed to hold the
+/// others back.
+///
+/// Handlers run on the event thread; the send calls may be used from any
+/// thread.
+class NexusServer {
+public:
+    /// Return false to refuse the client (the C# server closed sockets for
+    /// names that were not in the account list).
+    using ConnectHandler = std::function<bool(const NexusClient&)>;
+    using MessageHandler = std::function<void(const NexusClient&, std::string_view)>;
+    using DisconnectHandler = std::function<void(const NexusClient&)>;
+    /// Called once per command, whichever protocol the client speaks. The
+    /// view is only valid during the call.
+    using CommandHandler = std::function<void(const NexusClient&, const NexusCommandView&)>;
+
+    explicit NexusServer(NexusServerOptions options = {});
+    ~NexusServer();
+
+    NexusServer(const NexusServer&) = delete;
+    NexusServer& operator=(const NexusServer&) = delete;
+
+    /// Set handlers before start().
+    void on_connect(ConnectHandler handler) { on_connect_ = std::move(handler); }
+    void on_message(MessageHandler handler) { on_message_ = std::move(handler); }
+    void on_disconnect(DisconnectHandler handler) { on_disconnect_ = std::move(handler); }
+    void on_command(CommandHandler handler) { on_command_ = std::move(handler); }
+
+    /// Bind and start the event thread. Throws std::runtime_error if the
+    /// address cannot be bound.
+    void start();
+    /// Close every connection without calling the disconnect handler.
+    void stop();
+
+    uint16_t port() const { return port_; }
+    NexusServerStats stats() const;
+
+    /// Queue a text message for one client.
+    void send(uint64_t client, std::string_view message);
+    /// Queue a text message for several clients, framed once.
+    void send(std::vector<uint64_t> clients, std::string_view message);
+    /// Queue a text message for every connected client, framed once.
+    void broadcast(std::string_view message);
+    /// Queue an already encoded frame for `clients` (every client if empty).
+    /// Binary clients take batches as encode_websocket_frame(WsOpcode::Binary,
+    /// NexusBinaryEncoder::frame()).
+    void send_frame(std::vector<uint64_t> clients, WebSocketFrame frame);
+
+    /// Close a client's connection after its queued messages are written.
+    void disconnect(uint64_t client);
+
+private:
+    struct Client {
+        Socket socket;
+        std::string in;
+        std::deque<WebSocketFrame> out;
+        size_t out_offset = 0;   // bytes of out.front() already written
+        size_t queued_bytes = 0;
+        bool upgraded = false;
+        bool closing = false;    // close once `out` drains
+        bool dirty = false;      // in flush_list_
+        bool want_write = false; // registered for writability
+        NexusClient info;
+        std::string message;     // fragments being reassembled
+        WsOpcode message_opcode = WsOpcode::Continuation;  // none in progress
+        std::chrono::steady_clock::time_point last_received;
+        std::chrono::steady_clock::time_point last_ping;
+    };
+
+    struct Outgoing {
+        std::vector<uint64_t> targets;  // empty: every client
+        WebSocketFrame frame;
+        bool disconnect = false;
+    };
+
+    void event_loop();
+    void accept_ready();
+    void read_ready(uint64_t id, Client& client);
+    bool handshake(uint64_t id, Client& client);
+    bool process_frames(uint64_t id, Client& client);
+    bool dispatch_commands(const Client& client, std::string_view message);
+    void dispatch(Outgoing outgoing);
+    bool enqueue(uint64_t id, Client& client, const WebSocketFrame& frame);
+    void queue_raw(uint64_t id, Client& client, WebSocketFrame frame);
+    void flush();
+    void write_ready(uint64_t id, Client& client);
+    void close_client(uint64_t id);
+    void drain_outgoing();
+    void sweep();
+    void publish_stats();
+    void post(Outgoing outgoing);
+    void wake();
+
+    NexusServerOptions options_;
+    uint16_t port_ = 0;
+
+    ConnectHandler on_connect_;
+    MessageHandler on_message_;
+    DisconnectHandler on_disconnect_;
+    CommandHandler on_command_;
+
+    Socket listener_;
+    Socket wake_read_;
+    Socket wake_write_;
+    std::unique_ptr<Poller> poller_;
+    std::atomic<bool> running_{false};
+    std::thread loop_thread_;
+    // Set by the event thread, read by any thread in post().
+    std::atomic<std::thread::id> loop_id_;
+
+    // Owned by the event thread.
+    std::unordered_map<uint64_t, Client> clients_;
+    std::vector<uint64_t> flush_list_;
+    uint64_t next_id_ = 1;
+    NexusArena command_arena_;
+
+    std::mutex outgoing_mutex_;
+    std::vector<Outgoing> outgoing_;
+    std::atomic<bool> wake_pending_{false};
+
+    NexusServerStats loop_stats_;  // owned by the event thread
+    mutable std::mutex stats_mutex_;
+    NexusServerStats stats_;       // published copy
+};
+
+}  // namespace ram
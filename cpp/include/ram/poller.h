@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/socket.h"
+
+namespace ram {
+
+/// Readiness notification for many sockets: epoll on Linux, poll (WSAPoll
+/// on Windows) elsewhere. Sockets are registered with a caller-chosen id
+/// that comes back in the events. Not thread-safe; owned by one event loop.
+class Poller {
+public:
+    struct Event {
+        uint64_t id;
+        bool readable;
+        bool writable;
+        bool error;
+    };
+
+    /// Throws std::runtime_error if the kernel object cannot be created.
+    Poller();
+    ~Poller();
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    /// Watch `fd` for readability.
+    void add(native_socket_t fd, uint64_t id);
+    /// Also watch for writability while `want` is set.
+    void set_writable(native_socket_t fd, uint64_t id, bool want);
+    void remove(native_socket_t fd);
+
+    /// Wait up to `timeout` and replace `out` with the ready sockets.
+    void wait(std::chrono::milliseconds timeout, std::vector<Event>& out);
+
+private:
+#ifdef __linux__
+    int epoll_;
+#else
+    struct Entry {
+        uint64_t id;
+        bool writable;
+    };
+    std::unordered_map<native_socket_t, Entry> fds_;
+#endif
+};
+
+}  // namespace ram
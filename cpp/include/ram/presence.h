@@ -0,0 +1,148 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/http.h"
+#include "ram/rate_limiter.h"
+
+namespace ram {
+
+enum class PresenceType { Offline = 0, Online = 1, InGame = 2, InStudio = 3 };
+
+/// A user's presence as reported by presence.roblox.com.
+struct UserPresence {
+    int64_t user_id = 0;
+    PresenceType type = PresenceType::Offline;
+    std::string last_location;
+    int64_t place_id = 0;
+    int64_t root_place_id = 0;
+    int64_t universe_id = 0;
+    std::string game_id;
+
+    /// Parse one entry of the "userPresences" array.
+    static UserPresence from_json(const nlohmann::json& j);
+
+    /// True if both describe the same observable state (type, place, server).
+    bool same_state(const UserPresence& other) const;
+};
+
+/// A state transition. `previous` is empty the first time a user is seen.
+struct PresenceChange {
+    std::optional<UserPresence> previous;
+    UserPresence current;
+};
+
+struct PresenceEngineOptions {
+    std::string endpoint = "https://presence.roblox.com/v1/presence/users";
+    /// User IDs per request (the API rejects larger batches).
+    size_t batch_size = 100;
+    /// Requests allowed in flight at once, sent on the HttpClient's
+    /// send_async workers.
+    size_t max_in_flight = 4;
+    /// Request budget shared by all batches.
+    double requests_per_second = 2.0;
+    double burst = 4.0;
+    /// Per-user poll interval bounds. Users whose state changes are polled
+    /// more often; idle users back off towards max_interval.
+    std::chrono::milliseconds initial_interval{15000};
+    std::chrono::milliseconds min_interval{5000};
+    std::chrono::milliseconds max_interval{120000};
+    /// When a round's last batch has room, users due within this window
+    /// are polled early to fill it, so per-user intervals do not drift
+    /// the schedule into many tiny requests.
+    std::chrono::milliseconds batch_slack{5000};
+};
+
+struct PresenceStats {
+    uint64_t polls = 0;
+    uint64_t requests = 0;
+    uint64_t failed_requests = 0;
+    uint64_t users_polled = 0;
+    uint64_t changes = 0;
+};
+
+/// Polls presence for a large pool of user IDs. IDs are sharded into
+/// API-sized batches that are sent concurrently under a shared rate budget,
+/// and subscribers only hear about users whose state changed.
+class PresenceEngine {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Listener = std::function<void(const std::vector<PresenceChange>&)>;
+
+    explicit PresenceEngine(HttpClient& client,
+                            PresenceEngineOptions options = {});
+    ~PresenceEngine();
+
+    PresenceEngine(const PresenceEngine&) = delete;
+    PresenceEngine& operator=(const PresenceEngine&) = delete;
+
+    /// Start polling a user; the first poll is due immediately.
+    void track(int64_t user_id);
+    void untrack(int64_t user_id);
+    size_t tracked() const;
+
+    /// Register a listener for state changes. Returns an id for unsubscribe.
+    size_t subscribe(Listener listener);
+    void unsubscribe(size_t id);
+
+    /// Poll every user whose interval has elapsed, topping up the last
+    /// batch with users due within batch_slack. Returns the number of
+    /// changes published.
+    size_t poll_due();
+
+    /// Poll every tracked user regardless of schedule.
+    size_t poll_all();
+
+    /// Run poll_due on a background thread, sleeping until the next user
+    /// is due.
+    void start();
+    void stop();
+
+    /// Last known presence of a user.
+    std::optional<UserPresence> presence(int64_t user_id) const;
+
+    /// Current poll interval of a user (zero if not tracked).
+    std::chrono::milliseconds interval(int64_t user_id) const;
+
+    PresenceStats stats() const;
+
+private:
+    struct Tracked {
+        std::optional<UserPresence> last;
+        std::chrono::milliseconds interval{0};
+        Clock::time_point next_due{};
+    };
+
+    size_t poll(std::vector<int64_t> user_ids);
+    HttpRequest batch_request(const std::vector<int64_t>& user_ids) const;
+    void run();
+
+    HttpClient& client_;
+    PresenceEngineOptions options_;
+    TokenBucket budget_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<int64_t, Tracked> users_;
+    std::map<size_t, Listener> listeners_;
+    size_t next_listener_id_ = 1;
+    PresenceStats stats_;
+
+    std::mutex poll_mutex_;  // serializes whole poll rounds
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::thread worker_;
+};
+
+}  // namespace ram
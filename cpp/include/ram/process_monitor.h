@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/account_store.h"
+
+namespace ram {
+
+/// What the manager cares about in a client's command line.
+struct ClientArgs {
+    bool has_ticket = false;       // -t, or gameinfo: in a roblox-player: URI
+    bool has_join_script = false;  // -j, or placelauncherurl: in a URI
+    std::string browser_tracker_id;
+
+    /// True for clients the manager launched (CheckProcesses' -t / -j test).
+    bool launched() const { return has_ticket || has_join_script; }
+};
+
+/// Parse a client command line without regexes. Accepts /proc cmdline
+/// form (arguments separated by NULs) and Windows form (one string,
+/// whitespace separated, double quotes grouping), with either -t/-j/-b
+/// flags or a roblox-player: URI.
+ClientArgs parse_client_args(std::string_view command_line);
+
+/// Kill rules from the [Watcher] settings, checked once a client is older
+/// than `grace`. A zero/empty limit disables that rule.
+struct KillPolicy {
+    std::chrono::seconds grace{30};
+    uint64_t min_rss_bytes = 0;         // CloseIfMemoryLow / MemoryLowValue
+    std::chrono::seconds max_age{0};
+    std::string expected_title;         // CloseIfWindowTitle / ExpectedWindowTitle
+};
+
+struct ProcessMonitorOptions {
+    std::string proc_root = "/proc";
+    /// Matched against the first 15 characters of /proc/<pid>/comm, which
+    /// is all the kernel keeps.
+    std::string process_name = "RobloxPlayerBeta";
+    KillPolicy policy;
+    /// Processes younger than this are re-checked every scan even if they
+    /// did not match, since a launcher may still exec into the client.
+    std::chrono::seconds recheck_young{10};
+    /// Window title of a pid, if the platform can tell. Without it the
+    /// title rule is not applied.
+    std::function<std::optional<std::string>(int pid)> title;
+    /// Called for each kill decision; returns whether the kill worked.
+    /// Without it decisions are only reported.
+    std::function<bool(int pid)> kill;
+};
+
+struct ClientProcess {
+    int pid = 0;
+    ClientArgs args;
+    std::string username;  // empty if no account has the tracker id
+    std::chrono::seconds age{0};
+    uint64_t rss_bytes = 0;
+};
+
+struct KillDecision {
+    int pid = 0;
+    std::string username;
+    std::string reason;
+    bool killed = false;
+};
+
+/// Cost of one scan.
+struct ScanCost {
+    std::chrono::microseconds elapsed{0};
+    size_t pids = 0;        // entries listed under proc_root
+    size_t new_pids = 0;    // pids seen for the first time
+    size_t file_reads = 0;  // stat/cmdline/uptime files read
+};
+
+struct ProcessScan {
+    std::vector<ClientProcess> clients;
+    std::vector<KillDecision> decisions;
+    ScanCost cost;
+};
+
+struct ProcessMonitorStats {
+    uint64_t scans = 0;
+    uint64_t file_reads = 0;
+    uint64_t kills = 0;
+    std::chrono::microseconds elapsed{0};  // summed over scans
+};
+
+/// Finds running clients by scanning /proc, replacing CheckProcesses'
+/// per-tick GetProcessesByName + WMI command line query + regex + linear
+/// account search.
+///
+/// Each pid's start time and parsed command line are cached, so a scan
+/// reads one small stat file per known client (for its RSS) and only
+/// stat()s the /proc entry of other known processes to notice pid reuse;
+/// cmdline is only read for new pids whose name matches. Tracker ids
+/// resolve to accounts through a hash index that is rebuilt only when the
+/// account store's version changes. Kill rules are evaluated in the same
+/// pass. Not thread-safe.
+class ProcessMonitor {
+public:
+    explicit ProcessMonitor(ProcessMonitorOptions options = {});
+
+    /// Re-index accounts by browser tracker id if `store` changed.
+    void sync_accounts(const AccountStore& store);
+
+    ProcessScan scan();
+
+    ProcessMonitorStats stats() const { return stats_; }
+    const ProcessMonitorOptions& options() const { return options_; }
+
+private:
+    struct Known {
+        uint64_t start_ticks = 0;
+        uint64_t identity = 0;  // of the /proc/<pid> entry; changes if the pid is reused
+        uint64_t seen = 0;  // last scan that listed the pid
+        bool client = false;
+        ClientArgs args;
+    };
+
+    struct Stat {
+        std::string comm;
+        uint64_t start_ticks = 0;
+        uint64_t rss_pages = 0;
+    };
+
+    std::optional<Stat> read_stat(int pid, ScanCost& cost) const;
+    std::optional<std::string> read_file(const std::string& path, ScanCost& cost) const;
+    bool name_matches(std::string_view comm) const;
+    void evaluate(const ClientProcess& client, ProcessScan& scan);
+
+    ProcessMonitorOptions options_;
+    long ticks_per_second_ = 100;
+    long page_size_ = 4096;
+    std::unordered_map<int, Known> known_;
+    uint64_t scan_id_ = 0;
+    std::unordered_map<std::string, std::string> tracker_index_;  // tracker id -> username
+    std::optional<uint64_t> indexed_version_;
+    ProcessMonitorStats stats_;
+};
+
+}  // namespace ram
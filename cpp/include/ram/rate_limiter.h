@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+namespace ram {
+
+/// Thread-safe token bucket: refills at `rate` tokens per second up to
+/// `burst` tokens.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(double rate, double burst);
+
+    /// Take `tokens` if available. Never blocks.
+    bool try_acquire(double tokens = 1.0);
+
+    /// Block until `tokens` are available, then take them.
+    void acquire(double tokens = 1.0);
+
+    /// Time until `tokens` would be available (zero if available now).
+    Clock::duration time_until(double tokens = 1.0);
+
+    double rate() const { return rate_; }
+    double burst() const { return burst_; }
+
+private:
+    void refill(Clock::time_point now);
+
+    const double rate_;
+    const double burst_;
+    double tokens_;
+    Clock::time_point last_;
+    std::mutex mutex_;
+};
+
+}  // namespace ram
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/histogram.h"
+#include "ram/http.h"
+#include "ram/rate_limiter.h"
+
+namespace ram {
+
+struct RateLimit {
+    double rate = 1.0;   // tokens per second
+    double burst = 1.0;  // bucket capacity
+};
+
+struct RequestSchedulerOptions {
+    /// Budget for every account.
+    RateLimit per_account{2.0, 4.0};
+    /// Budgets for named endpoints; unknown endpoints use default_endpoint.
+    std::map<std::string, RateLimit> per_endpoint;
+    RateLimit default_endpoint{10.0, 10.0};
+    /// Requests executing at once across all accounts.
+    size_t max_in_flight = 8;
+    /// Retries of a 429/503 response before it is handed back to the caller.
+    int max_retries = 3;
+    /// Backoff when the server gives no usable Retry-After; doubled per
+    /// retry, capped at max_backoff, with jitter in [50%, 100%].
+    std::chrono::milliseconds base_backoff{1000};
+    std::chrono::milliseconds max_backoff{60000};
+};
+
+struct RequestSchedulerStats {
+    uint64_t submitted = 0;
+    uint64_t dispatched = 0;
+    uint64_t completed = 0;
+    uint64_t throttled = 0;  // 429/503 responses received
+    uint64_t retries = 0;
+    uint64_t failed = 0;     // transport errors
+};
+
+/// Shared request budget across accounts. Every request is charged against
+/// its account's bucket and its endpoint's bucket; accounts with queued
+/// work are served round-robin so one busy account cannot starve others.
+/// A 429/503 pauses the endpoint for Retry-After (or a jittered backoff)
+/// and the request is retried automatically.
+class RequestScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RequestScheduler(HttpClient& client,
+                              RequestSchedulerOptions options = {});
+    ~RequestScheduler();
+
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    /// Queue a request for `account` against the named endpoint budget
+    /// (e.g. "auth", "presence"). An empty endpoint uses the URL's host.
+    std::future<HttpResponse> submit(const std::string& account,
+                                     const std::string& endpoint,
+                                     HttpRequest request);
+
+    /// Requests waiting to be dispatched, in total and for one account.
+    size_t queue_depth() const;
+    size_t queue_depth(const std::string& account) const;
+
+    /// Time from submit to dispatch, in nanoseconds.
+    Histogram wait_times() const;
+    /// Queue depth observed at each submit.
+    Histogram queue_depths() const;
+
+    RequestSchedulerStats stats() const;
+
+private:
+    struct Job {
+        std::string account;
+        std::string endpoint;
+        HttpRequest request;
+        std::promise<HttpResponse> promise;
+        Clock::time_point enqueued;
+        int attempt = 0;
+    };
+
+    struct AccountState {
+        std::deque<std::unique_ptr<Job>> queue;
+        std::unique_ptr<TokenBucket> bucket;
+        bool in_ring = false;
+    };
+
+    struct EndpointState {
+        std::unique_ptr<TokenBucket> bucket;
+        Clock::time_point blocked_until{};
+        int consecutive_throttles = 0;
+    };
+
+    EndpointState& endpoint_state(const std::string& endpoint);
+    void enqueue(std::unique_ptr<Job> job, bool front);
+    void dispatch_loop();
+    void worker_loop();
+    void complete(std::unique_ptr<Job> job, HttpResponse response);
+    Clock::duration backoff_for(const HttpResponse& response, int attempt);
+
+    HttpClient& client_;
+    RequestSchedulerOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable dispatch_cv_;
+    std::condition_variable worker_cv_;
+    std::unordered_map<std::string, AccountState> accounts_;
+    std::unordered_map<std::string, EndpointState> endpoints_;
+    std::deque<std::string> ring_;  // accounts with queued work
+    std::deque<std::unique_ptr<Job>> ready_;
+    size_t queued_ = 0;
+    size_t in_flight_ = 0;
+    bool stopping_ = false;
+    RequestSchedulerStats stats_;
+    Histogram wait_times_;
+    Histogram queue_depths_;
+    std::mt19937 rng_{std::random_device{}()};
+
+    std::thread dispatcher_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace ram
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "ram/account.h"
+#include "ram/http.h"
+
+namespace ram {
+
+struct CsrfCacheOptions {
+    /// Base URL of the authentication API.
+    std::string auth_base_url = "https://auth.roblox.com";
+    /// How long a token is reused before it is fetched again.
+    std::chrono::milliseconds ttl{std::chrono::minutes(10)};
+};
+
+struct CsrfCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;     // lookups that started a fetch
+    uint64_t coalesced = 0;  // lookups that joined an in-flight fetch
+    uint64_t fetch_failures = 0;
+    uint64_t invalidations = 0;
+};
+
+/// Per-account X-CSRF-TOKEN cache. A token is reused until its TTL expires
+/// or the server rejects it with a 403; concurrent lookups for the same
+/// account share a single fetch.
+class CsrfTokenCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit CsrfTokenCache(HttpClient& client, CsrfCacheOptions options = {});
+
+    /// Return the account's token, fetching it if missing or expired.
+    /// Returns std::nullopt if the server did not issue one (e.g. the
+    /// cookie is invalid) or the request failed.
+    std::optional<std::string> get(const Account& account);
+
+    /// The cached token if it is still fresh; never fetches.
+    std::optional<std::string> peek(const Account& account) const;
+
+    /// Drop the cached token so the next get() fetches a fresh one.
+    void invalidate(const Account& account);
+
+    /// Inspect a response to a request made with the cached token. A 403
+    /// carrying a new x-csrf-token replaces the cached one; returns true in
+    /// that case so the caller can retry.
+    bool observe(const Account& account, const HttpResponse& response);
+
+    CsrfCacheStats stats() const;
+
+    /// Incremented whenever a cached token is replaced or dropped, so views
+    /// that display tokens know when to rebuild.
+    uint64_t generation() const { return generation_.load(); }
+
+    /// Cache key: the user ID when known, otherwise a token fingerprint.
+    static std::string key_for(const Account& account);
+
+    const CsrfCacheOptions& options() const { return options_; }
+
+private:
+    struct Entry {
+        std::string token;
+        Clock::time_point fetched_at{};
+        std::shared_future<std::optional<std::string>> in_flight;
+    };
+
+    std::optional<std::string> fetch(const Account& account);
+
+    HttpClient& client_;
+    CsrfCacheOptions options_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    CsrfCacheStats stats_;
+    std::atomic<uint64_t> generation_{0};
+};
+
+/// Request a one-time authentication ticket for launching the client,
+/// using (and refreshing) the account's cached CSRF token.
+std::optional<std::string> get_auth_ticket(HttpClient& client,
+                                           CsrfTokenCache& csrf,
+                                           const Account& account);
+
+/// Sign out of every other session (the cookie refresh the C# client
+/// runs for stale accounts) and return the replacement .ROBLOSECURITY
+/// cookie. Returns std::nullopt if the request failed or no new cookie
+/// was issued.
+std::optional<std::string> sign_out_other_sessions(
+    HttpClient& client, CsrfTokenCache& csrf, const Account& account,
+    const std::string& web_base_url = "https://www.roblox.com");
+
+}  // namespace ram
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/http.h"
+
+namespace ram {
+
+/// One entry of games.roblox.com's servers/public "data" array.
+struct GameServer {
+    std::string id;
+    int max_players = 0;
+    int playing = 0;
+    double fps = 0;
+    int ping = 0;
+
+    int free_slots() const { return max_players > playing ? max_players - playing : 0; }
+
+    /// Parse one entry. Missing or mistyped fields are left at zero.
+    static GameServer from_json(const nlohmann::json& j);
+};
+
+/// What makes one server better than another.
+enum class ServerOrder { MostFreeSlots, LowestPing, MostPlayers, FewestPlayers };
+
+/// The best `capacity` servers seen so far, best first. Offering a server
+/// that is already ranked replaces the old entry, since the same server can
+/// show up on two pages while the list shifts underneath the cursor.
+/// Thread-safe.
+class ServerRanking {
+public:
+    explicit ServerRanking(ServerOrder order, size_t capacity);
+
+    /// Returns true if the server is now ranked.
+    bool offer(const GameServer& server);
+
+    std::optional<GameServer> best() const;
+    std::vector<GameServer> top() const;
+    size_t size() const;
+
+    /// True if `a` ranks ahead of `b`.
+    bool better(const GameServer& a, const GameServer& b) const;
+
+private:
+    ServerOrder order_;
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<GameServer> servers_;  // sorted, best first
+};
+
+struct ServerCrawlOptions {
+    std::string base_url = "https://games.roblox.com";
+    /// Servers per page (the API allows 10, 25, 50 or 100).
+    int page_size = 100;
+    /// Pages fetched at most; 0 walks the whole list.
+    size_t max_pages = 0;
+    ServerOrder order = ServerOrder::MostFreeSlots;
+    /// Servers kept in the ranking.
+    size_t top_k = 10;
+
+    /// Servers outside these bounds are not ranked. The defaults match
+    /// GetRandomJobId: not full, not empty, more than one slot.
+    int min_free_slots = 1;
+    int min_players = 1;
+    /// 0 accepts any ping.
+    int max_ping = 0;
+
+    /// Stop once this many servers have passed the filters; 0 walks every
+    /// page.
+    size_t enough = 0;
+    /// Attempts per page before the crawl gives up.
+    int attempts = 3;
+    std::chrono::milliseconds retry_delay{500};
+};
+
+struct ServerCrawlStats {
+    uint64_t pages = 0;
+    uint64_t servers_seen = 0;
+    uint64_t servers_matched = 0;  // passed the filters
+    uint64_t failed_requests = 0;
+    bool stopped_early = false;    // `enough` was reached before the last page
+    bool failed = false;           // a page ran out of attempts
+};
+
+/// Walks a place's public server list page by page, feeding each page into
+/// a ServerRanking as it arrives, so best() has an answer after the first
+/// round trip instead of after the last. The next page is requested as
+/// soon as the cursor is parsed, while the current page is being ranked.
+class ServerCrawler {
+public:
+    ServerCrawler(HttpClient& client, int64_t place_id, ServerCrawlOptions options = {});
+    ~ServerCrawler();
+
+    ServerCrawler(const ServerCrawler&) = delete;
+    ServerCrawler& operator=(const ServerCrawler&) = delete;
+
+    /// Crawl on the calling thread until done, cancelled or `enough`.
+    void run();
+
+    /// Crawl on a background thread.
+    void start();
+    /// Stop after the page in flight and join the background thread.
+    void cancel();
+
+    /// Wait until the crawl finishes. Returns false on timeout.
+    bool wait(std::chrono::milliseconds timeout);
+    /// Wait until at least one server is ranked or the crawl finishes, and
+    /// return the best one.
+    std::optional<GameServer> wait_best(std::chrono::milliseconds timeout);
+
+    std::optional<GameServer> best() const { return ranking_.best(); }
+    std::vector<GameServer> top() const { return ranking_.top(); }
+    bool done() const;
+    ServerCrawlStats stats() const;
+
+private:
+    HttpRequest page_request(const std::string& cursor) const;
+    bool accepts(const GameServer& server) const;
+    bool stop_requested() const;
+    void finish();
+
+    HttpClient& client_;
+    int64_t place_id_;
+    ServerCrawlOptions options_;
+    ServerRanking ranking_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    ServerCrawlStats stats_;
+    bool cancelled_ = false;
+    bool done_ = false;
+    std::thread worker_;
+};
+
+}  // namespace ram
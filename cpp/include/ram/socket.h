@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace ram {
+
+#ifdef _WIN32
+using native_socket_t = uintptr_t;
+#else
+using native_socket_t = int;
+#endif
+
+/// A read-only span handed to vectored sends.
+struct ConstBuffer {
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+/// Thin RAII wrapper over a TCP socket (BSD sockets or Winsock).
+/// Connection setup failures throw std::runtime_error; I/O calls report
+/// errors through their return values.
+class Socket {
+public:
+    static const native_socket_t kInvalid;
+
+    Socket() = default;
+    explicit Socket(native_socket_t handle) : handle_(handle) {}
+    ~Socket();
+
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    /// Connect to host:port, waiting at most `timeout` for the handshake.
+    static Socket connect(const std::string& host, uint16_t port,
+                          std::chrono::milliseconds timeout);
+
+    /// Bind and listen on host:port. Port 0 picks an ephemeral port.
+    static Socket listen(const std::string& host, uint16_t port,
+                         int backlog = 128);
+
+    /// Two connected loopback sockets, used to wake threads blocked in
+    /// poll/epoll from another thread.
+    static std::pair<Socket, Socket> pair();
+
+    /// Accept a pending connection. Returns an invalid socket on error.
+    Socket accept() const;
+
+    /// Whether the connected peer is a loopback address.
+    bool peer_is_loopback() const;
+
+    /// Send the whole buffer. Returns false on error or timeout.
+    bool send_all(const char* data, size_t size,
+                  std::chrono::milliseconds timeout) const;
+
+    /// Receive up to `size` bytes. Returns the byte count, 0 when the peer
+    /// closed the connection, or -1 on error or timeout.
+    ptrdiff_t recv_some(char* data, size_t size,
+                        std::chrono::milliseconds timeout) const;
+
+    /// Returned by the *_nowait calls when the operation would block.
+    static constexpr ptrdiff_t kWouldBlock = -2;
+
+    /// Non-blocking receive: byte count, 0 on close, -1 on error or
+    /// kWouldBlock.
+    ptrdiff_t recv_nowait(char* data, size_t size) const;
+
+    /// Non-blocking gather send of up to `count` buffers. Returns the bytes
+    /// written, -1 on error or kWouldBlock.
+    ptrdiff_t send_nowait(const ConstBuffer* buffers, size_t count) const;
+
+    /// Wait until the socket is readable. Returns false on timeout.
+    bool wait_readable(std::chrono::milliseconds timeout) const;
+
+    /// Wait until the socket is writable. Returns false on timeout.
+    bool wait_writable(std::chrono::milliseconds timeout) const;
+
+    void set_nonblocking(bool enabled) const;
+    void set_nodelay(bool enabled) const;
+
+    /// The locally bound port (useful after listen on port 0).
+    uint16_t local_port() const;
+
+    bool valid() const { return handle_ != kInvalid; }
+    native_socket_t handle() const { return handle_; }
+
+    /// Shut down both directions without releasing the handle.
+    void shutdown() const;
+    void close();
+
+private:
+    native_socket_t handle_ = kInvalid;
+};
+
+}  // namespace ram
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "ram/socket.h"
+
+namespace ram {
+
+struct TlsOptions {
+    /// Verify the server certificate chain and host name.
+    bool verify_peer = true;
+    /// PEM bundle of trusted CAs; empty uses the system store.
+    std::string ca_file;
+};
+
+/// Client TLS configuration shared by every connection of an HttpClient,
+/// including a cache of the last session per host so new connections
+/// resume instead of doing a full handshake. Backed by OpenSSL when it was
+/// found at build time (RAM_HAS_OPENSSL). Thread-safe.
+class TlsContext {
+public:
+    /// Throws std::runtime_error if TLS is unavailable or the CA file
+    /// cannot be loaded.
+    explicit TlsContext(TlsOptions options = {});
+    ~TlsContext();
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    /// Whether this build has TLS support.
+    static bool available();
+
+    struct Impl;
+
+private:
+    friend class TlsStream;
+    std::unique_ptr<Impl> impl_;
+};
+
+/// A client TLS session over a connected socket, with the same I/O
+/// contract as Socket. The socket is switched to non-blocking mode and
+/// must outlive the stream.
+class TlsStream {
+public:
+    /// Handshake as a client of `host`, resuming the session cached under
+    /// `session_key` when there is one. Throws std::runtime_error on
+    /// failure, including certificate verification errors.
+    static std::unique_ptr<TlsStream> connect(TlsContext& context, const Socket& socket,
+                                              const std::string& host,
+                                              const std::string& session_key,
+                                              std::chrono::milliseconds timeout);
+    ~TlsStream();
+
+    TlsStream(const TlsStream&) = delete;
+    TlsStream& operator=(const TlsStream&) = delete;
+
+    /// Send the whole buffer. Returns false on error or timeout.
+    bool send_all(const char* data, size_t size, std::chrono::milliseconds timeout);
+
+    /// Receive up to `size` bytes: the byte count, 0 when the peer closed
+    /// the session, or -1 on error or timeout.
+    ptrdiff_t recv_some(char* data, size_t size, std::chrono::milliseconds timeout);
+
+    /// Whether an idle connection can carry another request. Consumes
+    /// post-handshake messages such as TLS 1.3 session tickets, which
+    /// leave an idle socket readable without meaning it was closed.
+    bool reusable();
+
+    /// Whether the handshake resumed a cached session.
+    bool resumed() const;
+
+private:
+    struct State;
+    explicit TlsStream(std::unique_ptr<State> state);
+    std::unique_ptr<State> state_;
+};
+
+}  // namespace ram
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ram/ini_file.h"
+
+namespace ram {
+
+/// One completed span.
+struct TraceEvent {
+    const char* name = nullptr;      // string literal
+    const char* category = nullptr;  // string literal
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds duration{0};
+};
+
+/// Process-wide span recorder for one-off investigations. Each thread
+/// writes into its own ring buffer, keeping the newest events when it
+/// fills; dumps are Chrome trace-event JSON, which Perfetto and
+/// chrome://tracing open directly.
+///
+/// Disabled by default. While disabled a span costs one relaxed atomic
+/// load. Buffers of threads that have exited are kept until clear().
+class Tracer {
+public:
+    static constexpr size_t kDefaultEventsPerThread = 1 << 16;
+
+    static Tracer& global();
+
+    /// Start recording, with room for `events_per_thread` events per
+    /// thread. Changing the size clears what was recorded.
+    void enable(size_t events_per_thread = kDefaultEventsPerThread);
+    void disable();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Apply the EnableTracing and TraceBufferEvents keys of the
+    /// [Developer] section.
+    void configure(const IniSection& developer);
+
+    void record(const TraceEvent& event);
+
+    /// Recorded events, oldest first within each thread.
+    std::vector<TraceEvent> events() const;
+    void clear();
+
+    std::string to_chrome_json() const;
+    /// Returns false if the file could not be written.
+    bool write_chrome_json(const std::string& path) const;
+
+private:
+    struct ThreadBuffer {
+        uint32_t tid = 0;
+        size_t capacity = 0;
+        mutable std::mutex mutex;  // uncontended except while dumping
+        std::vector<TraceEvent> ring;
+        uint64_t written = 0;
+    };
+
+    Tracer() = default;
+    ThreadBuffer& thread_buffer();
+
+    inline static std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    size_t capacity_ = kDefaultEventsPerThread;
+    std::atomic<uint64_t> generation_{1};  // bumped by clear() and resizing
+    uint32_t next_tid_ = 1;
+};
+
+/// Records its lifetime as a span when tracing is enabled at construction.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "ram") {
+        if (Tracer::enabled()) {
+            event_.name = name;
+            event_.category = category;
+            event_.start = std::chrono::steady_clock::now();
+        }
+    }
+    ~TraceSpan() {
+        if (event_.name != nullptr) {
+            event_.duration = std::chrono::steady_clock::now() - event_.start;
+            Tracer::global().record(event_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceEvent event_;
+};
+
+}  // namespace ram
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+#include "ram/memory_accounting.h"
+
+namespace ram {
+
+/// Monotonic clock read for every cache lookup. On Linux it is
+/// CLOCK_MONOTONIC_COARSE (a few ms of resolution, several times cheaper
+/// to read than steady_clock), which is plenty for TTLs in seconds.
+struct CoarseSteadyClock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<CoarseSteadyClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+#ifdef __linux__
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return time_point(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+#else
+        return time_point(std::chrono::duration_cast<duration>(
+            std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+    }
+};
+
+struct TtlCacheOptions {
+    /// Entries held across all shards.
+    size_t capacity = 4096;
+    /// Rounded up to a power of two.
+    size_t shards = 16;
+    /// Lifetime of a cached value.
+    std::chrono::milliseconds ttl{std::chrono::minutes(5)};
+    /// Lifetime of a cached "does not exist" answer.
+    std::chrono::milliseconds negative_ttl{std::chrono::seconds(30)};
+};
+
+struct TtlCacheStats {
+    uint64_t hits = 0;
+    uint64_t negative_hits = 0;  // lookups answered by a negative entry
+    uint64_t misses = 0;         // absent or expired
+    uint64_t expired = 0;        // misses on an entry past its TTL
+    uint64_t inserts = 0;
+    uint64_t evictions = 0;      // live entries displaced to make room
+    uint64_t size = 0;
+
+    double hit_ratio() const {
+        uint64_t lookups = hits + negative_hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits + negative_hits) / lookups;
+    }
+};
+
+/// Concurrent cache with per-entry expiry, for lookups like Batch.cs's
+/// PlaceDetails and PlaceUniversePair tables.
+///
+/// Keys are spread over independently locked shards, so threads only
+/// contend when they touch the same shard. Each shard has a plain mutex
+/// rather than a shared_mutex: the critical sections are a hash lookup and
+/// a copy, and taking a reader lock writes the same cache line.
+///
+/// Each shard holds capacity / shards entries and evicts with the CLOCK
+/// algorithm: a lookup sets the entry's reference bit and the hand
+/// skips (and clears) referenced entries, so recently read entries survive
+/// without readers having to reorder a list. Expired entries are taken
+/// first.
+///
+/// A key can also be cached as known to be absent (put_negative), with its
+/// own shorter TTL, so repeated lookups for invalid IDs stay off the
+/// network.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Clock = CoarseSteadyClock>
+class TtlCache {
+public:
+    /// Outcome of lookup().
+    enum class Found { Missing, Hit, Negative };
+
+    explicit TtlCache(TtlCacheOptions options = {}) : options_(options) {
+        size_t count = 1;
+        while (count < std::max<size_t>(options_.shards, 1)) count <<= 1;
+        mask_ = count - 1;
+        per_shard_ = std::max<size_t>(1, (options_.capacity + count - 1) / count);
+        shards_ = std::make_unique<Shard[]>(count);
+    }
+
+    TtlCache(const TtlCache&) = delete;
+    TtlCache& operator=(const TtlCache&) = delete;
+
+    /// Look up `key`, copying the value into `out` on a positive hit.
+    Found lookup(const Key& key, Value& out) const {
+        Shard& shard = shard_for(key);
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            ++shard.stats.misses;
+            return Found::Missing;
+        }
+        Entry& entry = it->second;
+        if (entry.expires <= now) {
+            ++shard.stats.misses;
+            ++shard.stats.expired;
+            return Found::Missing;
+        }
+        entry.referenced = true;
+        if (!entry.value) {
+            ++shard.stats.negative_hits;
+            return Found::Negative;
+        }
+        ++shard.stats.hits;
+        out = *entry.value;
+        return Found::Hit;
+    }
+
+    /// The cached value, or std::nullopt if absent, expired or negative.
+    std::optional<Value> get(const Key& key) const {
+        Value value{};
+        if (lookup(key, value) != Found::Hit) return std::nullopt;
+        return value;
+    }
+
+    void put(const Key& key, Value value) { put(key, std::move(value), options_.ttl); }
+
+    void put(const Key& key, Value value, std::chrono::milliseconds ttl) {
+        insert(key, std::optional<Value>(std::move(value)), ttl);
+    }
+
+    /// Remember that `key` does not exist for negative_ttl.
+    void put_negative(const Key& key) { insert(key, std::nullopt, options_.negative_ttl); }
+
+    /// Cached value for `key`, or the result of `load` which is then cached
+    /// (std::nullopt as a negative entry). Concurrent misses may each call
+    /// `load`; put a Coalescer behind it to merge them.
+    std::optional<Value> get_or_load(const Key& key,
+                                     const std::function<std::optional<Value>(const Key&)>& load) {
+        Value value{};
+        switch (lookup(key, value)) {
+            case Found::Hit:
+                return value;
+            case Found::Negative:
+                return std::nullopt;
+            case Found::Missing:
+                break;
+        }
+        std::optional<Value> loaded = load(key);
+        if (loaded) {
+            put(key, *loaded);
+        } else {
+            put_negative(key);
+        }
+        return loaded;
+    }
+
+    bool erase(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) return false;
+        // Fill the hole in the ring with its last node.
+        size_t hole = it->second.ring_index;
+        shard.ring[hole] = shard.ring.back();
+        shard.ring[hole]->second.ring_index = hole;
+        shard.ring.pop_back();
+        if (shard.hand >= shard.ring.size()) shard.hand = 0;
+        shard.entries.erase(it);
+        return true;
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            shards_[i].entries.clear();
+            shards_[i].ring.clear();
+            shards_[i].hand = 0;
+        }
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i <= mask_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            total += shards_[i].entries.size();
+        }
+        return total;
+    }
+
+    TtlCacheStats stats() const {
+        TtlCacheStats out;
+        for (size_t i = 0; i <= mask_; ++i) {
+            const Shard& shard = shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            out.hits += shard.stats.hits;
+            out.negative_hits += shard.stats.negative_hits;
+            out.misses += shard.stats.misses;
+            out.expired += shard.stats.expired;
+            out.inserts += shard.stats.inserts;
+            out.evictions += shard.stats.evictions;
+            out.size += shard.entries.size();
+        }
+        return out;
+    }
+
+    const TtlCacheOptions& options() const { return options_; }
+
+private:
+    struct Entry {
+        std::optional<Value> value;  // empty: negative entry
+        typename Clock::time_point expires{};
+        bool referenced = false;     // CLOCK reference bit
+        size_t ring_index = 0;
+    };
+    using Node = std::pair<const Key, Entry>;
+
+    // Aligned so neighbouring shards' locks and counters do not share a
+    // cache line.
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Entry, Hash> entries;
+        // The CLOCK ring. Map nodes keep their address across rehashing,
+        // so the ring can point straight at them.
+        std::vector<Node*> ring;
+        size_t hand = 0;
+        TtlCacheStats stats;  // size unused
+    };
+
+    Shard& shard_for(const Key& key) const {
+        // Mix the hash so keys that differ only in high bits still spread.
+        uint64_t h = static_cast<uint64_t>(Hash{}(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return shards_[h & mask_];
+    }
+
+    void insert(const Key& key, std::optional<Value> value, std::chrono::milliseconds ttl) {
+        MemoryScope memory(MemoryTag::Caches);
+        Shard& shard = shard_for(key);
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        ++shard.stats.inserts;
+
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            // Pick the ring position first: evicting may erase a node.
+            size_t position = shard.ring.size() < per_shard_ ? shard.ring.size()
+                                                             : evict(shard, now);
+            it = shard.entries.try_emplace(key).first;
+            if (position == shard.ring.size()) {
+                shard.ring.push_back(&*it);
+            } else {
+                shard.ring[position] = &*it;
+            }
+            it->second.ring_index = position;
+        }
+        Entry& entry = it->second;
+        entry.value = std::move(value);
+        entry.expires = now + ttl;
+        entry.referenced = false;
+    }
+
+    // Advance the hand past referenced entries, erase the first expired or
+    // unreferenced one and return its ring position.
+    size_t evict(Shard& shard, typename Clock::time_point now) {
+        for (;;) {
+            size_t position = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.ring.size();
+            Entry& entry = shard.ring[position]->second;
+            bool expired = entry.expires <= now;
+            if (!expired && entry.referenced) {
+                entry.referenced = false;
+                continue;
+            }
+            if (!expired) ++shard.stats.evictions;
+            shard.entries.erase(shard.ring[position]->first);
+            return position;
+        }
+    }
+
+    TtlCacheOptions options_;
+    size_t mask_ = 0;
+    size_t per_shard_ = 1;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace ram
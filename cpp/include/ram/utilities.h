@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -17,6 +18,19 @@ std::string md5(const std::string& input);
 /// Returns the hash of empty input if the file doesn't exist.
 std::string file_sha256(const std::string& filename);
 
+/// Compute the SHA-256 hash of a string and return the raw 32-byte digest.
+std::string sha256_digest(const std::string& input);
+
+/// Compute the SHA-1 hash of a string and return the raw 20-byte digest.
+std::string sha1_digest(const std::string& input);
+
+/// Fast non-cryptographic 64-bit hash for deduplication keys such as
+/// cookie fingerprints. Stable across runs on the same machine.
+uint64_t fingerprint64(std::string_view bytes, uint64_t seed = 0);
+
+/// Standard (RFC 4648) base64 with padding.
+std::string base64_encode(const std::string& input);
+
 /// Clamp a value between min and max.
 template <typename T>
 T clamp(const T& val, const T& min_val, const T& max_val) {
@@ -40,4 +54,41 @@ double to_roblox_tick(
 /// Recursively delete a directory and all its contents.
 bool recursive_delete(const std::string& path);
 
+/// Write content to a temporary file next to `path`, flush it to disk and
+/// rename it over `path`, so readers never observe a partially written
+/// file, even after a crash. Returns false if the file could not be
+/// written or renamed.
+bool write_file_atomic(const std::string& path, const std::string& content);
+
+/// Incremental form of write_file_atomic for output produced in pieces.
+/// Data goes to a uniquely named temporary file next to `path`; commit()
+/// flushes it to disk and renames it into place. Destroying the writer
+/// without a successful commit() removes the temporary file.
+class AtomicFileWriter {
+public:
+    explicit AtomicFileWriter(std::string path);
+    ~AtomicFileWriter();
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    /// False if the temporary file could not be created.
+    bool is_open() const { return fd_ >= 0; }
+
+    /// Append data. Returns false once any write has failed.
+    bool write(std::string_view data);
+
+    /// Flush, sync and rename over the target. Returns false on failure.
+    bool commit();
+
+private:
+    void flush_buffer();
+
+    std::string path_;
+    std::string tmp_path_;
+    std::string buffer_;
+    int fd_ = -1;
+    bool failed_ = false;
+};
+
 }  // namespace ram
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ram/http.h"
+
+namespace ram {
+
+enum class WsOpcode : uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA,
+};
+
+/// An encoded frame ready to be written to any number of sockets.
+using WebSocketFrame = std::shared_ptr<const std::string>;
+
+/// Encode an unmasked (server-to-client) frame with FIN set.
+WebSocketFrame encode_websocket_frame(WsOpcode opcode, std::string_view payload);
+
+/// Encode a masked (client-to-server) frame with FIN set.
+std::string encode_masked_websocket_frame(WsOpcode opcode, std::string_view payload,
+                                          uint32_t mask);
+
+struct WsFrame {
+    bool fin = true;
+    WsOpcode opcode = WsOpcode::Text;
+    bool masked = false;
+    std::string payload;  // unmasked
+};
+
+/// Parse one frame from the front of `data`. Frames whose payload exceeds
+/// `max_payload`, or that use reserved bits or opcodes, are an Error.
+ParseStatus parse_websocket_frame(std::string_view data, WsFrame& out, size_t& consumed,
+                                  size_t max_payload);
+
+/// Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key (RFC 6455).
+std::string websocket_accept_key(const std::string& client_key);
+
+}  // namespace ram
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "ram/memory_accounting.h"
+
 namespace ram {
 
 Account::Account(const std::string& security_token)
@@ -64,6 +66,7 @@ Account Account::from_json(const nlohmann::json& j) {
     acc.set_password(j.value("Password", std::string{}));
 
     if (j.contains("Fields")) {
+        MemoryScope memory(MemoryTag::Fields);
         try {
             acc.fields =
                 j["Fields"].get<std::map<std::string, std::string>>();
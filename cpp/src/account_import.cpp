@@ -0,0 +1,254 @@
+#include "ram/account_import.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unordered_set>
+
+#include "ram/memory_accounting.h"
+#include "ram/tracing.h"
+#include "ram/utilities.h"
+
+namespace ram {
+
+namespace {
+
+constexpr std::string_view kCookieMarker = "_|WARNING:";
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// Where a cookie embedded in other text (a header, a quoted string) ends.
+bool ends_token(char c) {
+    return c == ' ' || c == '\t' || c == ';' || c == '"' || c == '\'' || c == ',';
+}
+
+// A table rather than range checks: cookie tails are ~800 characters and
+// this loop is most of the parse time.
+constexpr auto kAlnum = [] {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) table[c] = true;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+    return table;
+}();
+
+bool is_alnum(char c) { return kAlnum[static_cast<unsigned char>(c)]; }
+
+// Roblox usernames: 3-20 letters, digits and underscores.
+bool valid_username(std::string_view name) {
+    if (name.size() < 3 || name.size() > 20) return false;
+    return std::all_of(name.begin(), name.end(), [](char c) { return is_alnum(c) || c == '_'; });
+}
+
+bool parse_user_pass(std::string_view text, Account& account, std::string& error) {
+    size_t colon = text.find(':');
+    if (colon == std::string_view::npos) {
+        error = "expected a cookie or username:password";
+        return false;
+    }
+    std::string_view username = trim(text.substr(0, colon));
+    std::string_view password = text.substr(colon + 1);
+    if (!valid_username(username)) {
+        error = "invalid username";
+        return false;
+    }
+    if (password.empty()) {
+        error = "empty password";
+        return false;
+    }
+    if (!account.set_password(std::string(password))) {
+        error = "password too long";
+        return false;
+    }
+    account.username = std::string(username);
+    return true;
+}
+
+// Seeded per kind, so a username that reads like a user ID does not
+// collide with it.
+constexpr uint64_t kTokenSeed = 0xcbf29ce484222325ull;
+constexpr uint64_t kNameSeed = 0x84222325cbf29ce4ull;
+constexpr uint64_t kIdSeed = 0x9e3779b97f4a7c15ull;
+
+struct Keys {
+    uint64_t token = 0;
+    uint64_t name = 0;
+    uint64_t id = 0;
+};
+
+Keys keys_of(const Account& account) {
+    Keys keys;
+    if (!account.security_token.empty()) {
+        keys.token = fingerprint64(account.security_token, kTokenSeed);
+    }
+    if (!account.username.empty()) {
+        std::string name = account.username;
+        for (char& c : name) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        }
+        keys.name = fingerprint64(name, kNameSeed);
+    }
+    if (account.user_id != 0) keys.id = fingerprint64(std::to_string(account.user_id), kIdSeed);
+    return keys;
+}
+
+struct Parsed {
+    Account account;
+    Keys keys;
+};
+
+struct Chunk {
+    std::string_view text;
+    size_t lines = 0;
+    std::vector<Parsed> accounts;
+    std::vector<ImportError> errors;  // line within the chunk
+};
+
+std::vector<Chunk> split(std::string_view text, size_t chunk_bytes) {
+    std::vector<Chunk> chunks;
+    chunk_bytes = std::max<size_t>(chunk_bytes, 1);
+    while (!text.empty()) {
+        size_t end = text.size();
+        if (end > chunk_bytes) {
+            size_t newline = text.find('\n', chunk_bytes - 1);
+            if (newline != std::string_view::npos) end = newline + 1;
+        }
+        Chunk chunk;
+        chunk.text = text.substr(0, end);
+        chunks.push_back(std::move(chunk));
+        text.remove_prefix(end);
+    }
+    return chunks;
+}
+
+void parse_chunk(Chunk& chunk, const ImportOptions& options) {
+    std::string_view rest = chunk.text;
+    std::string error;
+    while (!rest.empty()) {
+        size_t newline = rest.find('\n');
+        std::string_view line = trim(rest.substr(0, newline));
+        rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+        size_t number = chunk.lines++;
+        if (line.empty() || line.front() == '#') continue;
+
+        Account account;
+        if (!parse_import_line(line, account, error)) {
+            chunk.errors.push_back({number, error});
+            continue;
+        }
+        account.group = options.group;
+        if (options.validate && !options.validate(account)) {
+            chunk.errors.push_back({number, "rejected by validation"});
+            continue;
+        }
+        Keys keys = keys_of(account);
+        chunk.accounts.push_back({std::move(account), keys});
+    }
+}
+
+}  // namespace
+
+bool parse_import_line(std::string_view line, Account& account, std::string& error) {
+    line = trim(line);
+    size_t marker = line.find(kCookieMarker);
+    if (marker == std::string_view::npos) return parse_user_pass(line, account, error);
+
+    // The token runs from the marker through the alphanumeric tail after
+    // "|_", and must end the line or be followed by a separator.
+    size_t split = line.find("|_", marker + kCookieMarker.size());
+    size_t end = split == std::string_view::npos ? split : split + 2;
+    if (end != std::string_view::npos) {
+        while (end < line.size() && is_alnum(line[end])) ++end;
+    }
+    if (end == std::string_view::npos || end == split + 2 ||
+        (end < line.size() && !ends_token(line[end])) ||
+        std::any_of(line.begin() + marker, line.begin() + split, ends_token)) {
+        error = "malformed cookie";
+        return false;
+    }
+    account.security_token = std::string(line.substr(marker, end - marker));
+
+    // "username:password:<cookie>" dumps carry the login as well.
+    std::string_view prefix = trim(line.substr(0, marker));
+    if (!prefix.empty() && prefix.back() == ':') {
+        prefix.remove_suffix(1);
+        if (!parse_user_pass(prefix, account, error)) return false;
+    }
+    return true;
+}
+
+ImportResult import_accounts(AccountStore& store, std::string_view text,
+                             const ImportOptions& options) {
+    TraceSpan span("account.import", "accounts");
+    ImportResult result;
+    std::vector<Chunk> chunks = split(text, options.chunk_bytes);
+
+    std::atomic<size_t> cursor{0};
+    auto worker = [&] {
+        MemoryScope memory(MemoryTag::Accounts);
+        for (size_t i = cursor++; i < chunks.size(); i = cursor++) parse_chunk(chunks[i], options);
+    };
+    size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    size_t workers = std::min(std::max<size_t>(threads, 1), chunks.size());
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < workers; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    size_t candidates = 0;
+    size_t first_line = 1;
+    for (auto& chunk : chunks) {
+        for (auto& error : chunk.errors) {
+            error.line += first_line;
+            result.errors.push_back(std::move(error));
+        }
+        candidates += chunk.accounts.size();
+        first_line += chunk.lines;
+    }
+    if (candidates == 0) return result;
+
+    store.update_all([&](std::vector<Account>& accounts) {
+        MemoryScope memory(MemoryTag::Accounts);
+        std::unordered_set<uint64_t> seen;
+        seen.reserve(3 * (accounts.size() + candidates));
+        auto remember = [&](const Keys& keys) {
+            if (keys.token != 0) seen.insert(keys.token);
+            if (keys.name != 0) seen.insert(keys.name);
+            if (keys.id != 0) seen.insert(keys.id);
+        };
+        auto known = [&](const Keys& keys) {
+            return (keys.token != 0 && seen.count(keys.token) != 0) ||
+                   (keys.name != 0 && seen.count(keys.name) != 0) ||
+                   (keys.id != 0 && seen.count(keys.id) != 0);
+        };
+        for (const auto& account : accounts) remember(keys_of(account));
+
+        accounts.reserve(accounts.size() + candidates);
+        for (auto& chunk : chunks) {
+            for (auto& parsed : chunk.accounts) {
+                if (known(parsed.keys)) {
+                    ++result.duplicates;
+                    continue;
+                }
+                remember(parsed.keys);
+                accounts.push_back(std::move(parsed.account));
+                ++result.added;
+            }
+        }
+    });
+
+    if (result.added > 0 && !options.save_path.empty()) {
+        result.saved = store.save(options.save_path);
+    }
+    return result;
+}
+
+}  // namespace ram
@@ -0,0 +1,132 @@
+#include "ram/account_merge.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/cryptography.h"
+#include "ram/memory_accounting.h"
+#include "ram/tracing.h"
+#include "ram/utilities.h"
+
+namespace ram {
+
+namespace {
+
+constexpr uint64_t kTokenSeed = 0x746f6b656e;
+
+uint64_t token_key(const Account& account) {
+    return fingerprint64(account.security_token, kTokenSeed);
+}
+
+}  // namespace
+
+void AccountMerger::add_file(const std::string& path, const std::vector<uint8_t>& key) {
+    TraceSpan span("account.merge_file", "accounts");
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data;
+    if (file.is_open()) {
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    if (has_ram_header(data)) {
+        data = decrypt(data, key);
+        if (data.empty()) throw std::runtime_error("Cannot decrypt " + path);
+    }
+    add_json(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+}
+
+void AccountMerger::add_json(std::string_view json) {
+    MemoryScope memory(MemoryTag::Accounts);
+    ++stats_.inputs;
+    if (json.empty()) return;
+
+    // Convert each array element as soon as it is parsed and drop it from
+    // the document, so the DOM never holds more than one account. The
+    // accounts are staged and only merged once the whole text parsed, so
+    // a truncated file adds nothing.
+    std::vector<Account> staged;
+    using Event = nlohmann::json::parse_event_t;
+    auto element = [&staged](int depth, Event event, nlohmann::json& parsed) {
+        if (depth != 1 || (event != Event::object_end && event != Event::value)) return true;
+        try {
+            staged.push_back(Account::from_json(parsed));
+        } catch (const nlohmann::json::exception& e) {
+            throw std::runtime_error(std::string("Invalid account entry: ") + e.what());
+        }
+        return false;
+    };
+    auto parsed = nlohmann::json::parse(json.begin(), json.end(), element, false);
+    if (parsed.is_discarded() || !parsed.is_array()) {
+        throw std::runtime_error("Account data is not a JSON array");
+    }
+    for (auto& account : staged) add(std::move(account));
+}
+
+void AccountMerger::add(Account account) {
+    ++stats_.read;
+    size_t i = find(account);
+    if (i == accounts_.size()) {
+        accounts_.push_back(std::move(account));
+        index(i);
+        return;
+    }
+
+    ++stats_.merged;
+    Account& kept = accounts_[i];
+    if (account.last_use > kept.last_use) {
+        std::swap(kept, account);
+        ++stats_.replaced;
+    }
+    kept.fields.merge(account.fields);  // keeps the winner's value on clashes
+    if (kept.user_id == 0) kept.user_id = account.user_id;
+    index(i);
+}
+
+size_t AccountMerger::find(const Account& account) const {
+    if (account.user_id != 0) {
+        if (auto it = by_id_.find(account.user_id); it != by_id_.end()) return it->second;
+    }
+    if (!account.security_token.empty()) {
+        if (auto it = by_token_.find(token_key(account)); it != by_token_.end()) return it->second;
+    }
+    return accounts_.size();
+}
+
+// Keys are only ever added: a record whose cookie was replaced by a newer
+// one still matches the old cookie.
+void AccountMerger::index(size_t i) {
+    const Account& account = accounts_[i];
+    if (account.user_id != 0) by_id_.try_emplace(account.user_id, i);
+    if (!account.security_token.empty()) by_token_.try_emplace(token_key(account), i);
+}
+
+std::vector<Account> AccountMerger::take() {
+    by_id_.clear();
+    by_token_.clear();
+    return std::move(accounts_);
+}
+
+bool AccountMerger::save(const std::string& path, const std::vector<uint8_t>& key) const {
+    TraceSpan span("account.merge_save", "accounts");
+    if (!key.empty()) {
+        // The file format encrypts the document as one message.
+        nlohmann::json out = nlohmann::json::array();
+        for (const auto& account : accounts_) out.push_back(account.to_json());
+        std::vector<uint8_t> encrypted = encrypt(out.dump(), key);
+        return !encrypted.empty() &&
+               write_file_atomic(path, std::string(encrypted.begin(), encrypted.end()));
+    }
+
+    // Written one account at a time instead of from a single string.
+    AtomicFileWriter file(path);
+    bool ok = file.write("[");
+    for (size_t i = 0; ok && i < accounts_.size(); ++i) {
+        if (i) file.write(",");
+        ok = file.write(accounts_[i].to_json().dump());
+    }
+    return ok && file.write("]") && file.commit();
+}
+
+}  // namespace ram
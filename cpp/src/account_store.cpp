@@ -0,0 +1,206 @@
+#include "ram/account_store.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+
+#include "ram/cryptography.h"
+#include "ram/memory_accounting.h"
+#include "ram/metrics.h"
+#include "ram/tracing.h"
+#include "ram/utilities.h"
+
+namespace ram {
+
+void AccountStore::load(const std::string& path, const std::vector<uint8_t>& key) {
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.account_load);
+    TraceSpan span("account.load", "accounts");
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data;
+    if (file.is_open()) {
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    try {
+        if (has_ram_header(data)) {
+            std::vector<uint8_t> plain = decrypt(data, key);
+            if (plain.empty()) throw std::runtime_error("Cannot decrypt " + path);
+            load_json(std::string(plain.begin(), plain.end()));
+            set_encryption_key(key);
+            return;
+        }
+        load_json(std::string(data.begin(), data.end()));
+    } catch (...) {
+        metrics.account_load_failures.add();
+        throw;
+    }
+}
+
+void AccountStore::load_json(const std::string& json) {
+    TraceSpan span("account.parse", "accounts");
+    MemoryScope memory(MemoryTag::Accounts);
+    std::vector<Account> accounts;
+    if (!json.empty()) {
+        auto parsed = nlohmann::json::parse(json, nullptr, false);
+        if (parsed.is_discarded() || !parsed.is_array()) {
+            throw std::runtime_error("Account data is not a JSON array");
+        }
+        accounts.reserve(parsed.size());
+        try {
+            for (const auto& entry : parsed) accounts.push_back(Account::from_json(entry));
+        } catch (const nlohmann::json::exception& e) {
+            throw std::runtime_error(std::string("Invalid account entry: ") + e.what());
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    accounts_ = std::move(accounts);
+    reindex_locked();
+    ++version_;
+}
+
+std::string AccountStore::to_json() const {
+    nlohmann::json out = nlohmann::json::array();
+    std::shared_lock lock(mutex_);
+    for (const auto& account : accounts_) out.push_back(account.to_json());
+    return out.dump();
+}
+
+bool AccountStore::save(const std::string& path) const {
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.account_save);
+    TraceSpan span("account.save", "accounts");
+    std::string json = to_json();
+    std::vector<uint8_t> key;
+    {
+        std::shared_lock lock(mutex_);
+        key = key_;
+    }
+    bool saved = false;
+    if (key.empty()) {
+        saved = write_file_atomic(path, json);
+    } else {
+        std::vector<uint8_t> encrypted = encrypt(json, key);
+        saved = !encrypted.empty() &&
+                write_file_atomic(path, std::string(encrypted.begin(), encrypted.end()));
+    }
+    if (!saved) metrics.account_save_failures.add();
+    return saved;
+}
+
+void AccountStore::set_encryption_key(std::vector<uint8_t> key) {
+    std::unique_lock lock(mutex_);
+    key_ = std::move(key);
+}
+
+bool AccountStore::add(Account account) {
+    MemoryScope memory(MemoryTag::Accounts);
+    std::unique_lock lock(mutex_);
+    if (account.user_id != 0) {
+        if (by_id_.count(std::to_string(account.user_id)) != 0) return false;
+    } else {
+        for (const auto& existing : accounts_) {
+            if (existing.security_token == account.security_token) return false;
+        }
+    }
+    size_t index = accounts_.size();
+    if (!account.username.empty()) by_name_.try_emplace(account.username, index);
+    if (account.user_id != 0) by_id_.try_emplace(std::to_string(account.user_id), index);
+    accounts_.push_back(std::move(account));
+    ++version_;
+    return true;
+}
+
+bool AccountStore::remove(const std::string& name_or_id) {
+    std::unique_lock lock(mutex_);
+    const Account* account = find_locked(name_or_id);
+    if (account == nullptr) return false;
+    accounts_.erase(accounts_.begin() + (account - accounts_.data()));
+    reindex_locked();
+    ++version_;
+    return true;
+}
+
+bool AccountStore::read(const std::string& name_or_id,
+                        const std::function<void(const Account&)>& fn) const {
+    std::shared_lock lock(mutex_);
+    const Account* account = find_locked(name_or_id);
+    if (account == nullptr) return false;
+    fn(*account);
+    return true;
+}
+
+bool AccountStore::update(const std::string& name_or_id,
+                          const std::function<void(Account&)>& fn) {
+    std::unique_lock lock(mutex_);
+    auto* account = const_cast<Account*>(find_locked(name_or_id));
+    if (account == nullptr) return false;
+
+    std::string username = account->username;
+    int64_t user_id = account->user_id;
+    fn(*account);
+    if (account->username != username || account->user_id != user_id) reindex_locked();
+    ++version_;
+    return true;
+}
+
+Account* AccountStore::Transaction::find(const std::string& name_or_id) {
+    return const_cast<Account*>(store_.find_locked(name_or_id));
+}
+
+bool AccountStore::transact(const std::function<void(Transaction&)>& fn) {
+    std::unique_lock lock(mutex_);
+    Transaction transaction(*this);
+    fn(transaction);
+    if (!transaction.modified_) return false;
+    reindex_locked();
+    ++version_;
+    return true;
+}
+
+void AccountStore::for_each(const std::function<void(const Account&)>& fn) const {
+    std::shared_lock lock(mutex_);
+    for (const auto& account : accounts_) fn(account);
+}
+
+void AccountStore::update_all(const std::function<void(std::vector<Account>&)>& fn) {
+    std::unique_lock lock(mutex_);
+    fn(accounts_);
+    reindex_locked();
+    ++version_;
+}
+
+std::vector<Account> AccountStore::snapshot() const {
+    std::shared_lock lock(mutex_);
+    return accounts_;
+}
+
+size_t AccountStore::size() const {
+    std::shared_lock lock(mutex_);
+    return accounts_.size();
+}
+
+uint64_t AccountStore::version() const { return version_.load(); }
+
+const Account* AccountStore::find_locked(const std::string& name_or_id) const {
+    // Like the C# lookup, the first account in list order matching either
+    // the username or the user ID wins.
+    size_t best = accounts_.size();
+    if (auto it = by_name_.find(name_or_id); it != by_name_.end()) best = it->second;
+    if (auto it = by_id_.find(name_or_id); it != by_id_.end()) best = std::min(best, it->second);
+    return best < accounts_.size() ? &accounts_[best] : nullptr;
+}
+
+void AccountStore::reindex_locked() {
+    by_name_.clear();
+    by_id_.clear();
+    for (size_t i = 0; i < accounts_.size(); ++i) {
+        if (!accounts_[i].username.empty()) by_name_.try_emplace(accounts_[i].username, i);
+        if (accounts_[i].user_id != 0) by_id_.try_emplace(std::to_string(accounts_[i].user_id), i);
+    }
+}
+
+}  // namespace ram
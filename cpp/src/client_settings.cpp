@@ -0,0 +1,209 @@
+#include "ram/client_settings.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/utilities.h"
+
+namespace fs = std::filesystem;
+
+namespace ram {
+
+namespace {
+
+std::optional<std::string> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (file.bad()) return std::nullopt;
+    return content;
+}
+
+std::string sha256_hex(const std::string& content) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string digest = sha256_digest(content);
+    std::string out;
+    out.reserve(digest.size() * 2);
+    for (unsigned char c : digest) {
+        out += hex[c >> 4];
+        out += hex[c & 15];
+    }
+    return out;
+}
+
+}  // namespace
+
+ClientSettingsConfig ClientSettingsConfig::from_ini(const IniSection& general) {
+    ClientSettingsConfig config;
+    config.custom_file = general.get("CustomClientSettings");
+    config.unlock_fps = general.get_as<bool>("UnlockFPS");
+    if (general.exists("MaxFPSValue")) config.max_fps = general.get_as<int>("MaxFPSValue");
+    return config;
+}
+
+ClientSettingsPatcher::ClientSettingsPatcher(ClientSettingsConfig config)
+    : config_(std::move(config)) {}
+
+void ClientSettingsPatcher::configure(ClientSettingsConfig config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = std::move(config);
+    ++generation_;
+    desired_.reset();
+}
+
+uint64_t ClientSettingsPatcher::generation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+std::string ClientSettingsPatcher::settings_path(const std::string& version_dir) {
+    return (fs::path(version_dir) / "ClientSettings" / "ClientAppSettings.json").string();
+}
+
+std::shared_ptr<const ClientSettingsPatcher::Desired> ClientSettingsPatcher::desired() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (desired_) return desired_;
+
+    auto out = std::make_shared<Desired>();
+    out->generation = generation_;
+    std::optional<std::string> custom;
+    if (!config_.custom_file.empty()) custom = read_file(config_.custom_file);
+    if (custom) {
+        out->mode = Desired::Mode::Replace;
+        out->content = std::move(*custom);
+    } else if (config_.unlock_fps) {
+        out->mode = Desired::Mode::Merge;
+        out->fps = config_.max_fps;
+        out->content = nlohmann::json{{kFpsKey, out->fps}}.dump();
+    }
+    if (out->mode != Desired::Mode::None) out->content_hash = sha256_hex(out->content);
+    ++stats_.generations;
+    desired_ = out;
+    return desired_;
+}
+
+void ClientSettingsPatcher::remember(const std::string& target, uint64_t generation,
+                                     std::string hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Verified& v = verified_[target];
+    v.generation = generation;
+    v.hash = std::move(hash);
+}
+
+PatchResult ClientSettingsPatcher::apply(const Desired& desired, const std::string& target) {
+    std::error_code ec;
+    bool exists = fs::exists(target, ec);
+    std::string current_hash = exists ? file_sha256(target) : std::string();
+
+    if (exists) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = verified_.find(target);
+        if (it != verified_.end() && it->second.generation == desired.generation &&
+            it->second.hash == current_hash) {
+            return PatchResult::Unchanged;
+        }
+    }
+
+    std::string content;
+    if (desired.mode == Desired::Mode::Replace) {
+        if (exists && current_hash == desired.content_hash) {
+            remember(target, desired.generation, current_hash);
+            return PatchResult::Unchanged;
+        }
+        content = desired.content;
+    } else {
+        // Keep whatever else the file sets; rewrite it only if the FPS
+        // value differs or the file is not a JSON object.
+        std::optional<std::string> existing = exists ? read_file(target) : std::nullopt;
+        nlohmann::json settings;
+        if (existing) settings = nlohmann::json::parse(*existing, nullptr, false);
+        if (settings.is_object()) {
+            auto fps = settings.find(kFpsKey);
+            if (fps != settings.end() && fps->is_number_integer() &&
+                fps->get<int64_t>() == desired.fps) {
+                remember(target, desired.generation, current_hash);
+                return PatchResult::Unchanged;
+            }
+            settings[kFpsKey] = desired.fps;
+            content = settings.dump();
+        } else {
+            content = desired.content;
+        }
+    }
+
+    fs::create_directories(fs::path(target).parent_path(), ec);
+    if (!write_file_atomic(target, content)) return PatchResult::Failed;
+    remember(target, desired.generation, sha256_hex(content));
+    return PatchResult::Written;
+}
+
+PatchResult ClientSettingsPatcher::patch(const std::string& version_dir) {
+    std::shared_ptr<const Desired> want = desired();
+    PatchResult result = want->mode == Desired::Mode::None
+                             ? PatchResult::Skipped
+                             : apply(*want, settings_path(version_dir));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.patches;
+    switch (result) {
+        case PatchResult::Unchanged:
+            ++stats_.unchanged;
+            break;
+        case PatchResult::Written:
+            ++stats_.writes;
+            break;
+        case PatchResult::Failed:
+            ++stats_.failures;
+            break;
+        case PatchResult::Skipped:
+            break;
+    }
+    return result;
+}
+
+std::vector<PatchResult> ClientSettingsPatcher::patch_all(
+    const std::vector<std::string>& version_dirs, size_t threads) {
+    std::vector<PatchResult> results(version_dirs.size(), PatchResult::Skipped);
+    std::atomic<size_t> cursor{0};
+    auto worker = [&] {
+        for (size_t i = cursor++; i < version_dirs.size(); i = cursor++) {
+            results[i] = patch(version_dirs[i]);
+        }
+    };
+    size_t workers = std::min(std::max<size_t>(threads, 1), version_dirs.size());
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < workers; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    return results;
+}
+
+std::vector<std::string> ClientSettingsPatcher::find_version_dirs(const std::string& root) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(root, ec)) {
+        if (!entry.is_directory(ec)) continue;
+        std::string name = entry.path().filename().string();
+        if (name.rfind("version-", 0) != 0) continue;
+        if (fs::exists(entry.path() / "RobloxPlayerBeta.exe", ec) ||
+            fs::exists(entry.path() / "RobloxPlayerLauncher.exe", ec)) {
+            out.push_back(entry.path().string());
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+ClientSettingsStats ClientSettingsPatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace ram
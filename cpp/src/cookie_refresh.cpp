@@ -0,0 +1,273 @@
+#include "ram/cookie_refresh.h"
+
+#include <algorithm>
+
+namespace ram {
+
+CookieRefreshScheduler::CookieRefreshScheduler(Refresher refresher,
+                                               CookieRefreshOptions options)
+    : refresher_(std::move(refresher)),
+      options_(options),
+      budget_(options_.refreshes_per_second, std::max(1.0, options_.burst)) {
+    if (options_.max_in_flight == 0) options_.max_in_flight = 1;
+}
+
+CookieRefreshScheduler::~CookieRefreshScheduler() { stop(); }
+
+std::optional<CookieRefreshScheduler::Clock::time_point>
+CookieRefreshScheduler::eligible_at(const Account& account) const {
+    auto opt_out = account.fields.find("NoCookieRefresh");
+    if (opt_out != account.fields.end() && opt_out->second == "true") {
+        return std::nullopt;
+    }
+    Entry entry;
+    entry.last_use = account.last_use;
+    entry.last_attempted = account.last_attempted_refresh;
+    return due_for(entry);
+}
+
+CookieRefreshScheduler::Clock::time_point CookieRefreshScheduler::due_for(
+    const Entry& entry) const {
+    return std::max(entry.last_use + options_.stale_after,
+                    entry.last_attempted + options_.retry_after);
+}
+
+void CookieRefreshScheduler::update(const std::string& key, const Account& account) {
+    auto due = eligible_at(account);
+    if (!due) {
+        remove(key);
+        return;
+    }
+
+    bool earliest_changed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = entries_.try_emplace(key);
+        Entry& entry = it->second;
+        entry.removed = false;
+        entry.last_use = account.last_use;
+        // Never move the attempt time backwards past one made by a worker
+        // that the caller has not saved yet.
+        entry.last_attempted = std::max(entry.last_attempted, account.last_attempted_refresh);
+        if (entry.in_flight) return;  // rescheduled when the refresh finishes
+
+        entry.due = due_for(entry);
+        if (entry.heap_index == kNotQueued) {
+            heap_push(*it);
+        } else {
+            heap_fix(entry.heap_index);
+        }
+        earliest_changed = heap_.front() == &*it;
+    }
+    if (earliest_changed) dispatch_cv_.notify_one();
+}
+
+void CookieRefreshScheduler::remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+    if (it->second.in_flight) {
+        it->second.removed = true;
+        return;
+    }
+    if (it->second.heap_index != kNotQueued) heap_erase(it->second.heap_index);
+    entries_.erase(it);
+}
+
+std::optional<CookieRefreshScheduler::Clock::time_point>
+CookieRefreshScheduler::due_at(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.heap_index == kNotQueued) {
+        return std::nullopt;
+    }
+    return it->second.due;
+}
+
+std::optional<CookieRefreshScheduler::Clock::time_point>
+CookieRefreshScheduler::next_due() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (heap_.empty()) return std::nullopt;
+    return heap_.front()->second.due;
+}
+
+size_t CookieRefreshScheduler::scheduled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return heap_.size();
+}
+
+CookieRefreshStats CookieRefreshScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void CookieRefreshScheduler::heap_push(Node& node) {
+    node.second.heap_index = heap_.size();
+    heap_.push_back(&node);
+    sift_up(heap_.size() - 1);
+}
+
+void CookieRefreshScheduler::heap_erase(size_t index) {
+    size_t last = heap_.size() - 1;
+    heap_[index]->second.heap_index = kNotQueued;
+    if (index != last) {
+        heap_[index] = heap_[last];
+        heap_[index]->second.heap_index = index;
+    }
+    heap_.pop_back();
+    if (index < heap_.size()) heap_fix(index);
+}
+
+void CookieRefreshScheduler::heap_fix(size_t index) {
+    sift_up(index);
+    sift_down(index);
+}
+
+void CookieRefreshScheduler::heap_swap(size_t a, size_t b) {
+    std::swap(heap_[a], heap_[b]);
+    heap_[a]->second.heap_index = a;
+    heap_[b]->second.heap_index = b;
+}
+
+void CookieRefreshScheduler::sift_up(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap_[parent]->second.due <= heap_[index]->second.due) break;
+        heap_swap(parent, index);
+        index = parent;
+    }
+}
+
+void CookieRefreshScheduler::sift_down(size_t index) {
+    for (;;) {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        if (left < heap_.size() && heap_[left]->second.due < heap_[smallest]->second.due) {
+            smallest = left;
+        }
+        if (right < heap_.size() && heap_[right]->second.due < heap_[smallest]->second.due) {
+            smallest = right;
+        }
+        if (smallest == index) return;
+        heap_swap(index, smallest);
+        index = smallest;
+    }
+}
+
+void CookieRefreshScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    dispatcher_ = std::thread([this] { dispatch_loop(); });
+    for (size_t i = 0; i < options_.max_in_flight; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+void CookieRefreshScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    dispatch_cv_.notify_all();
+    worker_cv_.notify_all();
+    if (dispatcher_.joinable()) dispatcher_.join();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+
+    // Put back accounts that were dispatched but never picked up.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& key : ready_) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) continue;
+        it->second.in_flight = false;
+        if (it->second.removed) {
+            entries_.erase(it);
+        } else {
+            heap_push(*it);
+        }
+    }
+    ready_.clear();
+}
+
+void CookieRefreshScheduler::dispatch_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        ++stats_.wakeups;
+        if (heap_.empty()) {
+            dispatch_cv_.wait(lock);
+            continue;
+        }
+
+        auto due = heap_.front()->second.due;
+        if (due > Clock::now()) {
+            dispatch_cv_.wait_until(lock, due);
+            continue;
+        }
+        if (in_flight_ + ready_.size() >= options_.max_in_flight) {
+            dispatch_cv_.wait(lock);
+            continue;
+        }
+        if (!budget_.try_acquire()) {
+            dispatch_cv_.wait_for(lock, budget_.time_until());
+            continue;
+        }
+
+        Node* node = heap_.front();
+        heap_erase(0);
+        node->second.in_flight = true;
+        ready_.push_back(node->first);
+        worker_cv_.notify_one();
+    }
+}
+
+void CookieRefreshScheduler::worker_loop() {
+    for (;;) {
+        std::string key;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            worker_cv_.wait(lock, [&] { return !running_ || !ready_.empty(); });
+            if (!running_) return;
+            key = std::move(ready_.front());
+            ready_.pop_front();
+            ++in_flight_;
+            ++stats_.attempted;
+        }
+
+        auto attempted_at = Clock::now();
+        bool ok = false;
+        try {
+            ok = refresher_(key, attempted_at);
+        } catch (...) {
+            ok = false;
+        }
+        finish(key, attempted_at, ok);
+    }
+}
+
+void CookieRefreshScheduler::finish(const std::string& key,
+                                    Clock::time_point attempted_at, bool ok) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --in_flight_;
+        ++(ok ? stats_.succeeded : stats_.failed);
+
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            Entry& entry = it->second;
+            entry.in_flight = false;
+            if (entry.removed) {
+                entries_.erase(it);
+            } else {
+                entry.last_attempted = std::max(entry.last_attempted, attempted_at);
+                entry.due = due_for(entry);
+                heap_push(*it);
+            }
+        }
+    }
+    dispatch_cv_.notify_one();
+}
+
+}  // namespace ram
@@ -3,6 +3,10 @@
 #include <algorithm>
 #include <cstring>
 
+#include "ram/memory_accounting.h"
+#include "ram/metrics.h"
+#include "ram/tracing.h"
+
 #if RAM_HAS_LIBSODIUM
 #include <sodium.h>
 #endif
@@ -17,6 +21,22 @@ const std::vector<uint8_t> kRAMHeader = {
     108, 102, 50,  50,  32,  64,  32,  103, 105, 116, 104, 117, 98,
     46,  99,  111, 109, 32,  46,  46,  46,  46,  46,  46,  46};
 
+#if RAM_HAS_LIBSODIUM
+namespace {
+
+// Argon2 key derivation, timed separately since it dominates both directions.
+bool derive_key(uint8_t (&key)[crypto_secretbox_KEYBYTES], const std::vector<uint8_t>& password,
+                const uint8_t* salt) {
+    ScopedTimer timer(core_metrics().kdf);
+    TraceSpan span("kdf", "crypto");
+    return crypto_pwhash(key, sizeof(key), reinterpret_cast<const char*>(password.data()),
+                         password.size(), salt, crypto_pwhash_OPSLIMIT_MODERATE,
+                         crypto_pwhash_MEMLIMIT_MODERATE, crypto_pwhash_ALG_DEFAULT) == 0;
+}
+
+}  // namespace
+#endif
+
 bool has_ram_header(const std::vector<uint8_t>& data) {
     if (data.size() < kRAMHeader.size()) return false;
     return std::equal(kRAMHeader.begin(), kRAMHeader.end(), data.begin());
@@ -27,7 +47,14 @@ std::vector<uint8_t> encrypt(const std::string& content,
 #if RAM_HAS_LIBSODIUM
     if (content.empty()) return {};
 
-    if (sodium_init() < 0) return {};
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.encrypt);
+    TraceSpan span("encrypt", "crypto");
+    MemoryScope memory(MemoryTag::Crypto);
+    if (sodium_init() < 0) {
+        metrics.crypto_failures.add();
+        return {};
+    }
 
     // Generate salt for Argon2
     uint8_t salt[crypto_pwhash_SALTBYTES];
@@ -35,10 +62,8 @@ std::vector<uint8_t> encrypt(const std::string& content,
 
     // Derive key using Argon2
     uint8_t key[crypto_secretbox_KEYBYTES];
-    if (crypto_pwhash(key, sizeof(key), reinterpret_cast<const char*>(password.data()),
-                      password.size(), salt, crypto_pwhash_OPSLIMIT_MODERATE,
-                      crypto_pwhash_MEMLIMIT_MODERATE,
-                      crypto_pwhash_ALG_DEFAULT) != 0) {
+    if (!derive_key(key, password, salt)) {
+        metrics.crypto_failures.add();
         return {};
     }
 
@@ -78,13 +103,18 @@ std::vector<uint8_t> decrypt(const std::vector<uint8_t>& encrypted,
 #if RAM_HAS_LIBSODIUM
     if (!has_ram_header(encrypted)) return {};
 
-    if (sodium_init() < 0) return {};
-
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.decrypt);
+    TraceSpan span("decrypt", "crypto");
+    MemoryScope memory(MemoryTag::Crypto);
     size_t offset = kRAMHeader.size();
     size_t min_size =
         offset + crypto_pwhash_SALTBYTES + crypto_secretbox_NONCEBYTES +
         crypto_secretbox_MACBYTES;
-    if (encrypted.size() < min_size) return {};
+    if (sodium_init() < 0 || encrypted.size() < min_size) {
+        metrics.crypto_failures.add();
+        return {};
+    }
 
     // Extract salt
     const uint8_t* salt = encrypted.data() + offset;
@@ -100,10 +130,8 @@ std::vector<uint8_t> decrypt(const std::vector<uint8_t>& encrypted,
 
     // Derive key
     uint8_t key[crypto_secretbox_KEYBYTES];
-    if (crypto_pwhash(key, sizeof(key), reinterpret_cast<const char*>(password.data()),
-                      password.size(), salt, crypto_pwhash_OPSLIMIT_MODERATE,
-                      crypto_pwhash_MEMLIMIT_MODERATE,
-                      crypto_pwhash_ALG_DEFAULT) != 0) {
+    if (!derive_key(key, password, salt)) {
+        metrics.crypto_failures.add();
         return {};
     }
 
@@ -113,6 +141,7 @@ std::vector<uint8_t> decrypt(const std::vector<uint8_t>& encrypted,
     if (crypto_secretbox_open_easy(plaintext.data(), ciphertext, ciphertext_len,
                                    nonce, key) != 0) {
         sodium_memzero(key, sizeof(key));
+        metrics.crypto_failures.add();
         return {};
     }
 
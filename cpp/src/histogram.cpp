@@ -0,0 +1,94 @@
+#include "ram/histogram.h"
+
+#include <bit>
+
+namespace ram {
+
+namespace {
+
+void update_max(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t prev = target.load(std::memory_order_relaxed);
+    while (value > prev &&
+           !target.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace
+
+Histogram::Histogram(const Histogram& other) { merge(other); }
+
+Histogram& Histogram::operator=(const Histogram& other) {
+    if (this != &other) {
+        reset();
+        merge(other);
+    }
+    return *this;
+}
+
+size_t Histogram::bucket_index(uint64_t value) {
+    if (value < kSubBuckets) return static_cast<size_t>(value);
+    int msb = static_cast<int>(std::bit_width(value)) - 1;
+    uint64_t sub = (value >> (msb - kSubBits)) & (kSubBuckets - 1);
+    return static_cast<size_t>((msb - kSubBits + 1) * kSubBuckets + sub);
+}
+
+uint64_t Histogram::bucket_lower_bound(size_t index) {
+    if (index < kSubBuckets) return index;
+    int msb = static_cast<int>(index / kSubBuckets) + kSubBits - 1;
+    uint64_t sub = index % kSubBuckets;
+    return (kSubBuckets + sub) << (msb - kSubBits);
+}
+
+uint64_t Histogram::bucket_upper_bound(size_t index) {
+    if (index + 1 >= kBuckets) return UINT64_MAX;
+    return bucket_lower_bound(index + 1) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    update_max(max_, value);
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (size_t i = 0; i < kBuckets; ++i) {
+        uint64_t n = other.bucket_count(i);
+        if (n) buckets_[i].fetch_add(n, std::memory_order_relaxed);
+    }
+    count_.fetch_add(other.count(), std::memory_order_relaxed);
+    sum_.fetch_add(other.sum(), std::memory_order_relaxed);
+    update_max(max_, other.max());
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+double Histogram::mean() const {
+    uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(sum()) / static_cast<double>(n);
+}
+
+uint64_t Histogram::percentile(double p) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    if (p >= 100) return max();
+
+    auto rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += bucket_count(i);
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper_bound(i);
+            return upper < max() ? upper : max();
+        }
+    }
+    return max();
+}
+
+}  // namespace ram
@@ -0,0 +1,758 @@
+#include "ram/http.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+#include "ram/socket.h"
+
+namespace ram {
+
+namespace {
+
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string_view::npos) return {};
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+}
+
+// Split the header block into the start line and headers. Returns the offset
+// of the body, 0 if the header block is incomplete, or npos on error.
+size_t parse_head(std::string_view data, std::string_view& start_line,
+                  HttpHeaders& headers) {
+    size_t head_end = data.find("\r\n\r\n");
+    if (head_end == std::string_view::npos) {
+        return data.size() > kMaxHeaderBytes ? std::string_view::npos : 0;
+    }
+
+    std::string_view head = data.substr(0, head_end);
+    size_t line_end = head.find("\r\n");
+    start_line = head.substr(0, line_end);
+
+    headers.clear();
+    while (line_end != std::string_view::npos) {
+        size_t next = line_end + 2;
+        line_end = head.find("\r\n", next);
+        std::string_view line = head.substr(
+            next, line_end == std::string_view::npos ? std::string_view::npos
+                                                     : line_end - next);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) return std::string_view::npos;
+        headers.emplace_back(std::string(trim(line.substr(0, colon))),
+                             std::string(trim(line.substr(colon + 1))));
+    }
+    return head_end + 4;
+}
+
+// Decode a chunked body starting at `pos`. Returns the end offset of the
+// message, 0 if incomplete, or npos on error, including a body that would
+// exceed `max_body`. Sizes are compared against what is left of `data`
+// rather than added to offsets, so huge chunk sizes cannot wrap.
+size_t parse_chunked(std::string_view data, size_t pos, size_t max_body,
+                     std::string& body) {
+    body.clear();
+    for (;;) {
+        size_t line_end = data.find("\r\n", pos);
+        if (line_end == std::string_view::npos) return 0;
+        std::string_view size_str = data.substr(pos, line_end - pos);
+        size_str = size_str.substr(0, size_str.find(';'));
+        size_t chunk = 0;
+        auto [ptr, ec] = std::from_chars(
+            size_str.data(), size_str.data() + size_str.size(), chunk, 16);
+        if (ec != std::errc() || size_str.empty()) return std::string_view::npos;
+        if (chunk > max_body - body.size()) return std::string_view::npos;
+        pos = line_end + 2;
+
+        if (chunk == 0) {
+            // Skip optional trailers up to the terminating blank line.
+            if (data.substr(pos, 2) == "\r\n") return pos + 2;
+            size_t end = data.find("\r\n\r\n", pos);
+            return end == std::string_view::npos ? 0 : end + 4;
+        }
+
+        size_t left = data.size() - pos;
+        if (left < 2 || chunk > left - 2) return 0;
+        if (data.substr(pos + chunk, 2) != "\r\n") return std::string_view::npos;
+        body.append(data.substr(pos, chunk));
+        pos += chunk + 2;
+    }
+}
+
+bool is_chunked(const HttpHeaders& headers) {
+    const std::string* te = find_header(headers, "Transfer-Encoding");
+    if (te == nullptr) return false;
+    std::string lower = *te;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return lower.find("chunked") != std::string::npos;
+}
+
+// Returns false if a Content-Length header is present but malformed.
+bool content_length(const HttpHeaders& headers, std::optional<size_t>& out) {
+    const std::string* cl = find_header(headers, "Content-Length");
+    if (cl == nullptr) return true;
+    size_t value = 0;
+    auto [ptr, ec] = std::from_chars(cl->data(), cl->data() + cl->size(), value);
+    if (ec != std::errc() || ptr != cl->data() + cl->size()) return false;
+    out = value;
+    return true;
+}
+
+const char* default_reason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Methods RFC 9110 defines as idempotent.
+bool idempotent(std::string_view method) {
+    return method == "GET" || method == "HEAD" || method == "OPTIONS" ||
+           method == "PUT" || method == "DELETE" || method == "TRACE";
+}
+
+std::string serialize_request(const HttpRequest& request, const Url& url) {
+    std::string out;
+    out.reserve(256 + request.body.size());
+    out.append(request.method).append(" ").append(url.target).append(
+        " HTTP/1.1\r\n");
+    if (request.header("Host") == nullptr) {
+        out.append("Host: ").append(url.host);
+        if (url.port != (url.scheme == "https" ? 443 : 80)) {
+            out.append(":").append(std::to_string(url.port));
+        }
+        out.append("\r\n");
+    }
+    const std::string* explicit_cookie = nullptr;
+    for (const auto& [name, value] : request.headers) {
+        if (request.cookies && iequals(name, "Cookie")) {
+            explicit_cookie = &value;
+            continue;
+        }
+        out.append(name).append(": ").append(value).append("\r\n");
+    }
+    if (request.cookies && (explicit_cookie || !request.cookies->empty())) {
+        out.append("Cookie: ");
+        if (explicit_cookie) {
+            out.append(*explicit_cookie);
+            if (!request.cookies->empty()) out.append("; ");
+        }
+        request.cookies->append_to(out);
+        out.append("\r\n");
+    }
+    if (request.header("Content-Length") == nullptr &&
+        (!request.body.empty() || request.method == "POST" ||
+         request.method == "PUT" || request.method == "PATCH")) {
+        out.append("Content-Length: ")
+            .append(std::to_string(request.body.size()))
+            .append("\r\n");
+    }
+    out.append("\r\n").append(request.body);
+    return out;
+}
+
+}  // namespace
+
+const std::string* find_header(const HttpHeaders& headers,
+                               std::string_view name) {
+    for (const auto& [key, value] : headers) {
+        if (iequals(key, name)) return &value;
+    }
+    return nullptr;
+}
+
+// --- CookieJar ---
+
+std::shared_ptr<CookieJar> CookieJar::for_security_token(std::string token) {
+    auto jar = std::make_shared<CookieJar>();
+    jar->set(".ROBLOSECURITY", std::move(token));
+    return jar;
+}
+
+void CookieJar::set(const std::string& name, std::string value) {
+    set(name, std::make_shared<const std::string>(std::move(value)));
+}
+
+void CookieJar::set(const std::string& name,
+                    std::shared_ptr<const std::string> value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cookies_[name] = std::move(value);
+}
+
+void CookieJar::remove(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cookies_.erase(name);
+}
+
+std::shared_ptr<const std::string> CookieJar::get(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cookies_.find(name);
+    return it == cookies_.end() ? nullptr : it->second;
+}
+
+void CookieJar::append_to(std::string& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool first = true;
+    for (const auto& [name, value] : cookies_) {
+        if (!first) out.append("; ");
+        out.append(name).append("=").append(*value);
+        first = false;
+    }
+}
+
+void CookieJar::update_from(const HttpHeaders& headers) {
+    for (const auto& [name, value] : headers) {
+        if (!iequals(name, "Set-Cookie")) continue;
+        std::string_view pair(value);
+        pair = pair.substr(0, pair.find(';'));
+        size_t eq = pair.find('=');
+        if (eq == std::string_view::npos) continue;
+        std::string cookie_name(trim(pair.substr(0, eq)));
+        std::string cookie_value(trim(pair.substr(eq + 1)));
+        if (cookie_name.empty()) continue;
+        if (cookie_value.empty()) {
+            remove(cookie_name);
+        } else {
+            set(cookie_name, std::move(cookie_value));
+        }
+    }
+}
+
+bool CookieJar::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cookies_.empty();
+}
+
+std::optional<Url> Url::parse(const std::string& url) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos || scheme_end == 0) return std::nullopt;
+
+    Url out;
+    out.scheme = url.substr(0, scheme_end);
+    std::transform(out.scheme.begin(), out.scheme.end(), out.scheme.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    out.port = out.scheme == "https" ? 443 : 80;
+
+    size_t host_start = scheme_end + 3;
+    size_t path_start = url.find_first_of("/?", host_start);
+    std::string authority = url.substr(
+        host_start, path_start == std::string::npos ? std::string::npos
+                                                    : path_start - host_start);
+    if (path_start != std::string::npos) {
+        out.target = url.substr(path_start);
+        if (out.target.front() == '?') out.target.insert(0, "/");
+    }
+
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        std::string_view port_str(authority.data() + colon + 1,
+                                  authority.size() - colon - 1);
+        uint16_t port = 0;
+        auto [ptr, ec] = std::from_chars(
+            port_str.data(), port_str.data() + port_str.size(), port);
+        if (ec != std::errc() || ptr != port_str.data() + port_str.size()) {
+            return std::nullopt;
+        }
+        out.port = port;
+        authority.resize(colon);
+    }
+    if (authority.empty()) return std::nullopt;
+    out.host = authority;
+    return out;
+}
+
+std::string Url::authority() const {
+    return host + ":" + std::to_string(port);
+}
+
+std::string Url::origin() const {
+    return scheme + "://" + authority();
+}
+
+std::string url_decode(std::string_view in) {
+    std::string out;
+    out.reserve(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] == '+') {
+            out += ' ';
+        } else if (in[i] == '%' && i + 2 < in.size() && hex_value(in[i + 1]) >= 0 &&
+                   hex_value(in[i + 2]) >= 0) {
+            out += static_cast<char>(hex_value(in[i + 1]) * 16 + hex_value(in[i + 2]));
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+std::map<std::string, std::string> parse_query(std::string_view query) {
+    std::map<std::string, std::string> out;
+    while (!query.empty()) {
+        size_t amp = query.find('&');
+        std::string_view pair = query.substr(0, amp);
+        query = amp == std::string_view::npos ? std::string_view{} : query.substr(amp + 1);
+        if (pair.empty()) continue;
+        size_t eq = pair.find('=');
+        std::string key = url_decode(pair.substr(0, eq));
+        std::string value =
+            eq == std::string_view::npos ? std::string{} : url_decode(pair.substr(eq + 1));
+        out.try_emplace(std::move(key), std::move(value));
+    }
+    return out;
+}
+
+ParseStatus parse_http_request(std::string_view data, HttpRequest& out,
+                               size_t& consumed, size_t max_body) {
+    std::string_view start_line;
+    size_t body_start = parse_head(data, start_line, out.headers);
+    if (body_start == std::string_view::npos) return ParseStatus::Error;
+    if (body_start == 0) return ParseStatus::Incomplete;
+
+    // METHOD SP target SP HTTP/1.x
+    size_t sp1 = start_line.find(' ');
+    size_t sp2 = start_line.rfind(' ');
+    if (sp1 == std::string_view::npos || sp2 == sp1 ||
+        start_line.substr(sp2 + 1, 5) != "HTTP/") {
+        return ParseStatus::Error;
+    }
+    out.method = std::string(start_line.substr(0, sp1));
+    out.url = std::string(start_line.substr(sp1 + 1, sp2 - sp1 - 1));
+
+    if (is_chunked(out.headers)) {
+        size_t end = parse_chunked(data, body_start, max_body, out.body);
+        if (end == std::string_view::npos) return ParseStatus::Error;
+        if (end == 0) return ParseStatus::Incomplete;
+        consumed = end;
+        return ParseStatus::Complete;
+    }
+
+    std::optional<size_t> length;
+    if (!content_length(out.headers, length)) return ParseStatus::Error;
+    size_t body_len = length.value_or(0);
+    if (body_len > max_body) return ParseStatus::Error;
+    if (data.size() - body_start < body_len) return ParseStatus::Incomplete;
+    out.body = std::string(data.substr(body_start, body_len));
+    consumed = body_start + body_len;
+    return ParseStatus::Complete;
+}
+
+ParseStatus parse_http_response(std::string_view data, bool eof,
+                                HttpResponse& out, size_t& consumed,
+                                size_t max_body, bool body_expected) {
+    std::string_view start_line;
+    size_t body_start = parse_head(data, start_line, out.headers);
+    if (body_start == std::string_view::npos) return ParseStatus::Error;
+    if (body_start == 0) {
+        return eof && !data.empty() ? ParseStatus::Error
+                                    : ParseStatus::Incomplete;
+    }
+
+    // HTTP/1.x SP status SP reason
+    size_t sp1 = start_line.find(' ');
+    if (start_line.substr(0, 5) != "HTTP/" || sp1 == std::string_view::npos) {
+        return ParseStatus::Error;
+    }
+    std::string_view rest = start_line.substr(sp1 + 1);
+    size_t sp2 = rest.find(' ');
+    std::string_view code = rest.substr(0, sp2);
+    auto [ptr, ec] =
+        std::from_chars(code.data(), code.data() + code.size(), out.status);
+    if (ec != std::errc()) return ParseStatus::Error;
+    out.reason = sp2 == std::string_view::npos
+                     ? std::string()
+                     : std::string(rest.substr(sp2 + 1));
+
+    if (out.status >= 100 && out.status < 200 && out.status != 101) {
+        // Interim response (100 Continue, 103 Early Hints): the final one
+        // follows on the same connection.
+        out = HttpResponse{};
+        auto status = parse_http_response(data.substr(body_start), eof, out,
+                                          consumed, max_body, body_expected);
+        if (status == ParseStatus::Complete) consumed += body_start;
+        return status;
+    }
+
+    if (!body_expected || out.status == 101 || out.status == 204 ||
+        out.status == 304) {
+        out.body.clear();
+        consumed = body_start;
+        return ParseStatus::Complete;
+    }
+
+    if (is_chunked(out.headers)) {
+        size_t end = parse_chunked(data, body_start, max_body, out.body);
+        if (end == std::string_view::npos) return ParseStatus::Error;
+        if (end == 0) {
+            return eof ? ParseStatus::Error : ParseStatus::Incomplete;
+        }
+        consumed = end;
+        return ParseStatus::Complete;
+    }
+
+    std::optional<size_t> length;
+    if (!content_length(out.headers, length)) return ParseStatus::Error;
+    if (!length) {
+        // Body is delimited by the connection closing.
+        if (data.size() - body_start > max_body) return ParseStatus::Error;
+        if (!eof) return ParseStatus::Incomplete;
+        out.body = std::string(data.substr(body_start));
+        consumed = data.size();
+        return ParseStatus::Complete;
+    }
+    if (*length > max_body) return ParseStatus::Error;
+    if (data.size() - body_start < *length) {
+        return eof ? ParseStatus::Error : ParseStatus::Incomplete;
+    }
+    out.body = std::string(data.substr(body_start, *length));
+    consumed = body_start + *length;
+    return ParseStatus::Complete;
+}
+
+std::string serialize_http_response_head(const HttpResponse& response) {
+    std::string out;
+    out.reserve(128);
+    out.append("HTTP/1.1 ").append(std::to_string(response.status)).append(" ");
+    out.append(response.reason.empty() ? default_reason(response.status)
+                                      : response.reason).append("\r\n");
+    for (const auto& [name, value] : response.headers) {
+        if (iequals(name, "Content-Length")) continue;
+        out.append(name).append(": ").append(value).append("\r\n");
+    }
+    out.append("Content-Length: ")
+        .append(std::to_string(response.body.size()))
+        .append("\r\n\r\n");
+    return out;
+}
+
+std::string serialize_http_response(const HttpResponse& response) {
+    std::string out = serialize_http_response_head(response);
+    out.append(response.body);
+    return out;
+}
+
+// --- HttpClient ---
+
+HttpClient::HttpClient(HttpClientOptions options) : options_(options) {
+    if (options_.max_connections_per_host == 0) {
+        options_.max_connections_per_host = 1;
+    }
+}
+
+HttpClient::~HttpClient() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+HttpResponse HttpClient::send(const HttpRequest& request) {
+    auto url = Url::parse(request.url);
+    if (!url) throw HttpError("Invalid URL: " + request.url);
+    if (url->scheme != "http" && url->scheme != "https") {
+        throw HttpError("Unsupported URL scheme: " + url->scheme);
+    }
+    return std::move(exchange(*url, {&request}).front());
+}
+
+std::vector<HttpResponse> HttpClient::send_pipelined(
+    const std::vector<HttpRequest>& requests) {
+    // Group by origin, keeping each group's requests in their original order.
+    std::vector<std::pair<Url, std::vector<size_t>>> groups;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto url = Url::parse(requests[i].url);
+        if (!url) throw HttpError("Invalid URL: " + requests[i].url);
+        if (url->scheme != "http" && url->scheme != "https") {
+            throw HttpError("Unsupported URL scheme: " + url->scheme);
+        }
+        auto it = std::find_if(groups.begin(), groups.end(), [&](const auto& g) {
+            return g.first.origin() == url->origin();
+        });
+        if (it == groups.end()) {
+            groups.emplace_back(*url, std::vector<size_t>{i});
+        } else {
+            it->second.push_back(i);
+        }
+    }
+
+    std::vector<HttpResponse> responses(requests.size());
+    for (const auto& [url, indices] : groups) {
+        std::vector<const HttpRequest*> batch;
+        batch.reserve(indices.size());
+        for (size_t i : indices) batch.push_back(&requests[i]);
+        auto results = exchange(url, batch);
+        for (size_t j = 0; j < indices.size(); ++j) {
+            responses[indices[j]] = std::move(results[j]);
+        }
+    }
+    return responses;
+}
+
+std::future<HttpResponse> HttpClient::send_async(HttpRequest request) {
+    auto task = std::make_shared<std::packaged_task<HttpResponse()>>(
+        [this, request = std::move(request)] { return send(request); });
+    auto future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (workers_.empty()) {
+            size_t count = std::max<size_t>(1, options_.async_threads);
+            for (size_t i = 0; i < count; ++i) {
+                workers_.emplace_back([this] { worker_loop(); });
+            }
+        }
+        queue_.emplace_back([task] { (*task)(); });
+    }
+    queue_cv_.notify_one();
+    return future;
+}
+
+void HttpClient::worker_loop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+    }
+}
+
+void HttpClient::close_idle() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [origin, pool] : pools_) {
+        pool.open -= pool.idle.size();
+        pool.idle.clear();
+        pool.available.notify_all();
+    }
+}
+
+HttpClientStats HttpClient::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::unique_ptr<HttpClient::Connection> HttpClient::acquire(
+    const Url& url, bool& reused,
+    std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    HostPool& pool = pools_[url.origin()];
+
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        while (!pool.idle.empty()) {
+            std::unique_ptr<Connection> conn = std::move(pool.idle.back());
+            pool.idle.pop_back();
+            // A readable idle socket means the server closed it (or sent
+            // something unsolicited); either way it cannot be reused. TLS
+            // sockets also turn readable for session tickets, so ask the
+            // stream instead.
+            bool usable = conn->tls ? conn->tls->reusable()
+                                    : !conn->socket.wait_readable(std::chrono::milliseconds(0));
+            if (now - conn->last_used > options_.idle_timeout ||
+                !conn->buffer.empty() || !usable) {
+                --pool.open;
+                continue;
+            }
+            reused = true;
+            ++stats_.connections_reused;
+            return conn;
+        }
+
+        if (pool.open < options_.max_connections_per_host) {
+            ++pool.open;
+            ++stats_.connections_opened;
+            lock.unlock();
+            auto conn = std::make_unique<Connection>();
+            try {
+                conn->socket =
+                    Socket::connect(url.host, url.port, options_.connect_timeout);
+                if (url.scheme == "https") {
+                    conn->tls = TlsStream::connect(tls_context(), conn->socket, url.host,
+                                                   url.origin(), options_.connect_timeout);
+                }
+            } catch (const std::runtime_error& e) {
+                conn.reset();
+                lock.lock();
+                --pool.open;
+                pool.available.notify_one();
+                throw HttpError(e.what());
+            }
+            if (conn->tls) {
+                lock.lock();
+                ++stats_.tls_handshakes;
+                if (conn->tls->resumed()) ++stats_.tls_resumed;
+            }
+            reused = false;
+            return conn;
+        }
+
+        if (pool.available.wait_until(lock, deadline) == std::cv_status::timeout) {
+            throw HttpError("Timed out waiting for a connection to " +
+                            url.authority());
+        }
+    }
+}
+
+TlsContext& HttpClient::tls_context() {
+    std::lock_guard<std::mutex> lock(tls_mutex_);
+    if (!tls_) tls_ = std::make_unique<TlsContext>(options_.tls);
+    return *tls_;
+}
+
+void HttpClient::release(const Url& url, std::unique_ptr<Connection> conn,
+                         bool reusable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HostPool& pool = pools_[url.origin()];
+    if (reusable) {
+        conn->last_used = std::chrono::steady_clock::now();
+        pool.idle.push_back(std::move(conn));
+    } else {
+        --pool.open;
+    }
+    pool.available.notify_one();
+}
+
+std::vector<HttpResponse> HttpClient::exchange(
+    const Url& url, const std::vector<const HttpRequest*>& requests) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + options_.request_timeout;
+    auto remaining = [&] {
+        return std::max(std::chrono::milliseconds(0),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            deadline - std::chrono::steady_clock::now()));
+    };
+
+    std::string raw;
+    for (const HttpRequest* request : requests) {
+        auto request_url = Url::parse(request->url);
+        raw.append(serialize_request(*request, request_url ? *request_url : url));
+    }
+
+    // A pooled connection may have been closed by the server while idle;
+    // if it yields nothing at all, retry once on a fresh connection. The
+    // server may still have acted on what it read, so only requests that
+    // are safe to repeat are retried: a POST could launch twice.
+    bool repeatable = std::all_of(requests.begin(), requests.end(),
+                                  [](const HttpRequest* r) { return idempotent(r->method); });
+    for (int attempt = 0;; ++attempt) {
+        bool reused = false;
+        std::unique_ptr<Connection> conn = acquire(url, reused, deadline);
+        bool may_retry = reused && attempt == 0 && repeatable;
+
+        if (!conn->send_all(raw.data(), raw.size(), remaining())) {
+            release(url, std::move(conn), false);
+            if (may_retry) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.stale_retries;
+                continue;
+            }
+            throw HttpError("Failed to send request to " + url.authority());
+        }
+
+        std::vector<HttpResponse> responses;
+        responses.reserve(requests.size());
+        bool eof = false;
+        bool received_any = false;
+        bool keep_alive = true;
+        char chunk[16 * 1024];
+        std::string error;
+
+        while (responses.size() < requests.size()) {
+            HttpResponse response;
+            size_t consumed = 0;
+            const HttpRequest* request = requests[responses.size()];
+            auto status = parse_http_response(conn->buffer, eof, response, consumed,
+                                              options_.max_response_bytes,
+                                              request->method != "HEAD");
+            if (status == ParseStatus::Complete) {
+                conn->buffer.erase(0, consumed);
+                const std::string* connection = response.header("Connection");
+                if (eof || (connection && iequals(*connection, "close"))) {
+                    keep_alive = false;
+                }
+                if (request->cookies) request->cookies->update_from(response.headers);
+                responses.push_back(std::move(response));
+                if (!keep_alive && responses.size() < requests.size()) {
+                    error = "Connection closed by " + url.authority();
+                    break;
+                }
+                continue;
+            }
+            if (status == ParseStatus::Error) {
+                error = "Malformed or oversized response from " + url.authority();
+                break;
+            }
+            if (eof) {
+                error = "Connection closed by " + url.authority();
+                break;
+            }
+
+            ptrdiff_t got =
+                conn->recv_some(chunk, sizeof(chunk), remaining());
+            if (got < 0) {
+                error = "Timed out waiting for " + url.authority();
+                break;
+            }
+            if (got == 0) {
+                eof = true;
+            } else {
+                received_any = true;
+                conn->buffer.append(chunk, static_cast<size_t>(got));
+            }
+        }
+
+        if (error.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.requests += requests.size();
+            }
+            release(url, std::move(conn), keep_alive);
+            return responses;
+        }
+
+        release(url, std::move(conn), false);
+        if (may_retry && !received_any && responses.empty()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.stale_retries;
+            continue;
+        }
+        throw HttpError(error);
+    }
+}
+
+}  // namespace ram
@@ -0,0 +1,411 @@
+#include "ram/http_server.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace ram {
+
+namespace {
+
+constexpr uint64_t kListenerId = UINT64_MAX;
+constexpr uint64_t kWakeId = UINT64_MAX - 1;
+
+ServerResponse bad_request() {
+    static const PreformattedResponse kBadRequest = [] {
+        HttpResponse response;
+        response.status = 400;
+        response.headers.emplace_back("Connection", "close");
+        return preformat(response);
+    }();
+    return kBadRequest;
+}
+
+bool wants_close(const HttpRequest& request) {
+    const std::string* conn = request.header("Connection");
+    if (conn == nullptr) return false;
+    std::string value = *conn;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value == "close";
+}
+
+}  // namespace
+
+PreformattedResponse preformat(const HttpResponse& response) {
+    return std::make_shared<const std::string>(serialize_http_response(response));
+}
+
+// --- PerfectHashRouter ---
+
+uint64_t PerfectHashRouter::hash(std::string_view name, uint64_t seed) {
+    // FNV-1a with the seed folded into the offset basis.
+    uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+    for (unsigned char c : name) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h ^ (h >> 29);
+}
+
+PerfectHashRouter::PerfectHashRouter(const std::vector<std::string>& names)
+    : names_(names) {
+    size_t size = 1;
+    while (size < names.size() * 2) size <<= 1;
+
+    // Grow the table if no collision-free seed turns up quickly.
+    for (;; size <<= 1) {
+        mask_ = size - 1;
+        for (uint64_t seed = 0; seed < 1024; ++seed) {
+            std::vector<int> slots(size, kNotFound);
+            bool ok = true;
+            for (size_t i = 0; i < names.size() && ok; ++i) {
+                int& slot = slots[hash(names[i], seed) & mask_];
+                if (slot != kNotFound) {
+                    ok = names[static_cast<size_t>(slot)] == names[i];
+                    continue;
+                }
+                slot = static_cast<int>(i);
+            }
+            if (ok) {
+                seed_ = seed;
+                slots_ = std::move(slots);
+                return;
+            }
+        }
+    }
+}
+
+int PerfectHashRouter::find(std::string_view name) const {
+    if (slots_.empty()) return kNotFound;
+    int slot = slots_[hash(name, seed_) & mask_];
+    if (slot == kNotFound || names_[static_cast<size_t>(slot)] != name) return kNotFound;
+    return slot;
+}
+
+// --- Responder ---
+
+void Responder::send(ServerResponse response) {
+    server_->finish(connection_, std::move(response));
+}
+
+void Responder::defer(std::function<void(Responder)> work) {
+    {
+        std::lock_guard<std::mutex> lock(server_->stats_mutex_);
+        ++server_->stats_.deferred;
+    }
+    server_->enqueue_work([server = server_, id = connection_, work = std::move(work)] {
+        work(Responder(server, id));
+    });
+}
+
+// --- HttpServer ---
+
+HttpServer::HttpServer(Handler handler, HttpServerOptions options)
+    : handler_(std::move(handler)), options_(std::move(options)) {
+    if (options_.worker_threads == 0) options_.worker_threads = 1;
+}
+
+HttpServer::~HttpServer() { stop(); }
+
+void HttpServer::start() {
+    if (running_) return;
+    listener_ = Socket::listen(options_.host, options_.port);
+    listener_.set_nonblocking(true);
+    port_ = listener_.local_port();
+
+    auto [wake_write, wake_read] = Socket::pair();
+    wake_write_ = std::move(wake_write);
+    wake_read_ = std::move(wake_read);
+    wake_read_.set_nonblocking(true);
+
+    poller_ = std::make_unique<Poller>();
+    poller_->add(listener_.handle(), kListenerId);
+    poller_->add(wake_read_.handle(), kWakeId);
+
+    workers_stopping_ = false;
+    for (size_t i = 0; i < options_.worker_threads; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+    running_ = true;
+    loop_thread_ = std::thread([this] { event_loop(); });
+}
+
+void HttpServer::stop() {
+    if (!running_.exchange(false)) return;
+    wake();
+    if (loop_thread_.joinable()) loop_thread_.join();
+
+    {
+        std::lock_guard<std::mutex> lock(work_mutex_);
+        workers_stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+    work_.clear();
+
+    connections_.clear();
+    completions_.clear();
+    poller_.reset();
+    listener_.close();
+    wake_read_.close();
+    wake_write_.close();
+}
+
+HttpServerStats HttpServer::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void HttpServer::wake() {
+    if (wake_pending_.exchange(true)) return;
+    char byte = 1;
+    ConstBuffer buf{&byte, 1};
+    wake_write_.send_nowait(&buf, 1);
+}
+
+void HttpServer::event_loop() {
+    loop_id_.store(std::this_thread::get_id());
+    std::vector<Poller::Event> events;
+    auto next_sweep = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    while (running_) {
+        poller_->wait(std::chrono::milliseconds(500), events);
+        for (const auto& ev : events) {
+            if (ev.id == kListenerId) {
+                accept_ready();
+                continue;
+            }
+            if (ev.id == kWakeId) {
+                char sink[64];
+                while (wake_read_.recv_nowait(sink, sizeof(sink)) > 0) {
+                }
+                wake_pending_ = false;
+                drain_completions();
+                continue;
+            }
+
+            auto it = connections_.find(ev.id);
+            if (it == connections_.end()) continue;
+            if (ev.writable) write_ready(ev.id, it->second);
+            it = connections_.find(ev.id);
+            if (it == connections_.end()) continue;
+            if (ev.readable || ev.error) read_ready(ev.id, it->second);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_sweep) {
+            sweep_idle();
+            next_sweep = now + std::chrono::seconds(1);
+        }
+    }
+}
+
+void HttpServer::accept_ready() {
+    for (;;) {
+        Socket client = listener_.accept();
+        if (!client.valid()) return;
+        client.set_nonblocking(true);
+        client.set_nodelay(true);
+
+        uint64_t id = next_id_++;
+        poller_->add(client.handle(), id);
+        Connection& conn = connections_[id];
+        conn.loopback = client.peer_is_loopback();
+        conn.socket = std::move(client);
+        conn.last_active = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.connections_accepted;
+    }
+}
+
+void HttpServer::read_ready(uint64_t id, Connection& conn) {
+    char chunk[16384];
+    for (;;) {
+        ptrdiff_t got = conn.socket.recv_nowait(chunk, sizeof(chunk));
+        if (got == Socket::kWouldBlock) break;
+        if (got <= 0) {
+            close_connection(id);
+            return;
+        }
+        conn.in.append(chunk, static_cast<size_t>(got));
+        if (conn.in.size() > options_.max_request_bytes) {
+            close_connection(id);
+            return;
+        }
+        if (static_cast<size_t>(got) < sizeof(chunk)) break;
+    }
+    conn.last_active = std::chrono::steady_clock::now();
+    process(id, conn);
+}
+
+void HttpServer::process(uint64_t id, Connection& conn) {
+    while (!conn.busy && !conn.close_after && !conn.in.empty()) {
+        ServerRequest request;
+        size_t consumed = 0;
+        ParseStatus status = parse_http_request(conn.in, request.http, consumed,
+                                                options_.max_request_bytes);
+        if (status == ParseStatus::Incomplete) break;
+
+        if (status == ParseStatus::Error) {
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                ++stats_.parse_errors;
+            }
+            conn.in.clear();
+            conn.busy = true;
+            conn.close_after = true;
+            finish(id, bad_request());
+            break;
+        }
+
+        conn.in.erase(0, consumed);
+        conn.busy = true;
+        if (wants_close(request.http)) conn.close_after = true;
+        request.from_loopback = conn.loopback;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.requests;
+        }
+
+        try {
+            handler_(request, Responder(this, id));
+        } catch (...) {
+            if (conn.busy) {
+                HttpResponse error;
+                error.status = 500;
+                finish(id, std::move(error));
+            }
+        }
+    }
+
+    auto it = connections_.find(id);
+    if (it != connections_.end()) write_ready(id, it->second);
+}
+
+void HttpServer::finish(uint64_t id, ServerResponse response) {
+    if (std::this_thread::get_id() != loop_id_.load()) {
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex_);
+            completions_.emplace_back(id, std::move(response));
+        }
+        wake();
+        return;
+    }
+
+    auto it = connections_.find(id);
+    if (it == connections_.end()) return;  // closed while the handler ran
+    Connection& conn = it->second;
+
+    OutChunk head;
+    if (response.preformatted) {
+        head.shared = std::move(response.preformatted);
+        conn.out.push_back(std::move(head));
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.preformatted;
+    } else {
+        head.owned = serialize_http_response_head(response.response);
+        conn.out.push_back(std::move(head));
+        if (!response.response.body.empty()) {
+            OutChunk body;
+            body.owned = std::move(response.response.body);
+            conn.out.push_back(std::move(body));
+        }
+    }
+    conn.busy = false;
+}
+
+void HttpServer::drain_completions() {
+    std::vector<std::pair<uint64_t, ServerResponse>> done;
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        done.swap(completions_);
+    }
+    for (auto& [id, response] : done) {
+        finish(id, std::move(response));
+        auto it = connections_.find(id);
+        if (it != connections_.end()) process(id, it->second);
+    }
+}
+
+void HttpServer::write_ready(uint64_t id, Connection& conn) {
+    while (!conn.out.empty()) {
+        ConstBuffer buffers[16];
+        size_t count = 0;
+        for (auto it = conn.out.begin(); it != conn.out.end() && count < 16; ++it) {
+            const std::string& bytes = it->bytes();
+            buffers[count++] = {bytes.data() + it->offset, bytes.size() - it->offset};
+        }
+
+        ptrdiff_t sent = conn.socket.send_nowait(buffers, count);
+        if (sent == Socket::kWouldBlock) {
+            poller_->set_writable(conn.socket.handle(), id, true);
+            return;
+        }
+        if (sent < 0) {
+            close_connection(id);
+            return;
+        }
+
+        auto remaining = static_cast<size_t>(sent);
+        while (remaining > 0 && !conn.out.empty()) {
+            OutChunk& front = conn.out.front();
+            size_t left = front.bytes().size() - front.offset;
+            if (remaining < left) {
+                front.offset += remaining;
+                remaining = 0;
+            } else {
+                remaining -= left;
+                conn.out.pop_front();
+            }
+        }
+    }
+
+    poller_->set_writable(conn.socket.handle(), id, false);
+    if (conn.close_after && !conn.busy) close_connection(id);
+}
+
+void HttpServer::close_connection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    poller_->remove(it->second.socket.handle());
+    connections_.erase(it);
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++stats_.connections_closed;
+}
+
+void HttpServer::sweep_idle() {
+    auto cutoff = std::chrono::steady_clock::now() - options_.idle_timeout;
+    std::vector<uint64_t> idle;
+    for (const auto& [id, conn] : connections_) {
+        if (!conn.busy && conn.out.empty() && conn.last_active < cutoff) idle.push_back(id);
+    }
+    for (uint64_t id : idle) close_connection(id);
+}
+
+void HttpServer::enqueue_work(std::function<void()> work) {
+    {
+        std::lock_guard<std::mutex> lock(work_mutex_);
+        work_.push_back(std::move(work));
+    }
+    work_cv_.notify_one();
+}
+
+void HttpServer::worker_loop() {
+    for (;;) {
+        std::function<void()> work;
+        {
+            std::unique_lock<std::mutex> lock(work_mutex_);
+            work_cv_.wait(lock, [this] { return workers_stopping_ || !work_.empty(); });
+            if (workers_stopping_) return;
+            work = std::move(work_.front());
+            work_.pop_front();
+        }
+        work();
+    }
+}
+
+}  // namespace ram
@@ -0,0 +1,365 @@
+#include "ram/image_cache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ram/memory_accounting.h"
+#include "ram/utilities.h"
+
+namespace ram {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::string_view kIndexMagic = "RAMIMG1\n";
+// URL hash, content hash, little-endian size.
+constexpr size_t kRecordSize = 32 + 32 + 8;
+
+// Read-only view of a whole file: memory-mapped where mmap is available,
+// read into memory otherwise.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE,
+                             fd, 0);
+            if (p != MAP_FAILED) {
+                map_ = p;
+                data_ = std::string_view(static_cast<const char*>(p),
+                                         static_cast<size_t>(st.st_size));
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        copy_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = copy_;
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (map_ != nullptr) ::munmap(map_, data_.size());
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view data() const { return data_; }
+
+private:
+    std::string_view data_;
+#ifndef _WIN32
+    void* map_ = nullptr;
+#else
+    std::string copy_;
+#endif
+};
+
+std::string to_hex(const std::string& bytes) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        out += kDigits[c >> 4];
+        out += kDigits[c & 15];
+    }
+    return out;
+}
+
+std::string encode_record(const std::string& url_key, const std::string& content,
+                          uint64_t size) {
+    std::string record = url_key + content;
+    for (int i = 0; i < 8; ++i) record += static_cast<char>((size >> (8 * i)) & 0xFF);
+    return record;
+}
+
+}  // namespace
+
+ImageCache::ImageCache(Fetcher fetcher, ImageCacheOptions options)
+    : fetcher_(std::move(fetcher)), options_(std::move(options)) {
+    if (options_.directory.empty()) return;
+
+    std::error_code ec;
+    fs::create_directories(options_.directory, ec);
+    if (ec) throw std::runtime_error("Cannot create image cache " + options_.directory);
+    index_path_ = (fs::path(options_.directory) / "index").string();
+    load_index();
+}
+
+ImageCache::~ImageCache() = default;
+
+void ImageCache::load_index() {
+    bool rewrite = false;
+    {
+        MappedFile file(index_path_);
+        std::string_view data = file.data();
+        if (data.substr(0, kIndexMagic.size()) != kIndexMagic) {
+            // Missing or unrecognised: start a fresh index.
+            rewrite = true;
+        } else {
+            data.remove_prefix(kIndexMagic.size());
+            // A trailing partial record is a write cut short; drop it.
+            rewrite = data.size() % kRecordSize != 0;
+            for (; data.size() >= kRecordSize; data.remove_prefix(kRecordSize)) {
+                uint64_t size = 0;
+                for (int i = 0; i < 8; ++i) {
+                    size |= static_cast<uint64_t>(static_cast<uint8_t>(data[64 + i])) << (8 * i);
+                }
+                // Later records for a URL replace earlier ones.
+                add_disk_entry_locked(std::string(data.substr(0, 32)),
+                                      std::string(data.substr(32, 32)), size);
+                ++index_records_;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.disk_bytes > options_.disk_bytes) {
+        evict_disk_locked();
+    } else if (rewrite || index_records_ > 2 * disk_.size() + 64) {
+        rewrite_index_locked();
+    } else {
+        index_out_.open(index_path_, std::ios::binary | std::ios::app);
+    }
+}
+
+bool ImageCache::rewrite_index_locked() {
+    index_out_.close();
+    std::string data(kIndexMagic);
+    data.reserve(kIndexMagic.size() + disk_.size() * kRecordSize);
+    for (const auto& url_key : disk_order_) {
+        const DiskEntry& entry = disk_.at(url_key);
+        data += encode_record(url_key, entry.content, entry.size);
+    }
+    bool ok = write_file_atomic(index_path_, data);
+    index_records_ = disk_.size();
+    index_out_.open(index_path_, std::ios::binary | std::ios::app);
+    return ok;
+}
+
+std::string ImageCache::blob_path(const std::string& content) const {
+    std::string hex = to_hex(content);
+    return (fs::path(options_.directory) / hex.substr(0, 2) / hex).string();
+}
+
+void ImageCache::add_disk_entry_locked(const std::string& url_key, const std::string& content,
+                                       uint64_t size) {
+    if (auto it = disk_.find(url_key); it != disk_.end()) {
+        if (it->second.content == content) return;
+        remove_disk_entry_locked(url_key);
+    }
+    disk_order_.push_back(url_key);
+    disk_.emplace(url_key, DiskEntry{content, size, std::prev(disk_order_.end())});
+    if (disk_refs_[content]++ == 0) stats_.disk_bytes += size;
+    stats_.disk_entries = disk_.size();
+}
+
+void ImageCache::remove_disk_entry_locked(const std::string& url_key) {
+    auto it = disk_.find(url_key);
+    if (it == disk_.end()) return;
+    DiskEntry entry = std::move(it->second);
+    disk_order_.erase(entry.order);
+    disk_.erase(it);
+    stats_.disk_entries = disk_.size();
+
+    auto refs = disk_refs_.find(entry.content);
+    if (refs != disk_refs_.end() && --refs->second == 0) {
+        disk_refs_.erase(refs);
+        stats_.disk_bytes -= entry.size;
+        std::error_code ec;
+        fs::remove(blob_path(entry.content), ec);
+    }
+}
+
+void ImageCache::evict_disk_locked() {
+    // Go a little under the budget so each eviction is not followed by
+    // another on the next store.
+    uint64_t target = options_.disk_bytes - options_.disk_bytes / 10;
+    while (stats_.disk_bytes > target && !disk_order_.empty()) {
+        remove_disk_entry_locked(disk_order_.front());
+        ++stats_.disk_evictions;
+    }
+    rewrite_index_locked();
+}
+
+void ImageCache::remember_locked(const std::string& url_key, const Image& image) {
+    MemoryScope memory(MemoryTag::Caches);
+    if (image->size() > options_.memory_bytes) return;
+    if (auto it = memory_.find(url_key); it != memory_.end()) {
+        stats_.memory_bytes -= it->second.image->size();
+        memory_lru_.erase(it->second.lru);
+        memory_.erase(it);
+    }
+    memory_lru_.push_front(url_key);
+    memory_.emplace(url_key, MemoryEntry{image, memory_lru_.begin()});
+    stats_.memory_bytes += image->size();
+
+    while (stats_.memory_bytes > options_.memory_bytes) {
+        auto victim = memory_.find(memory_lru_.back());
+        stats_.memory_bytes -= victim->second.image->size();
+        memory_.erase(victim);
+        memory_lru_.pop_back();
+        ++stats_.memory_evictions;
+    }
+}
+
+ImageCache::Image ImageCache::read_blob(const std::string& content, uint64_t size) const {
+    MemoryScope memory(MemoryTag::Caches);
+    std::ifstream file(blob_path(content), std::ios::binary);
+    if (!file.is_open()) return nullptr;
+    std::string data(std::istreambuf_iterator<char>(file), {});
+    // A size mismatch is a blob cut short or overwritten; treat it as gone.
+    if (data.size() != size) return nullptr;
+    return std::make_shared<const std::string>(std::move(data));
+}
+
+ImageCache::Image ImageCache::read_disk(const std::string& url_key) {
+    std::string content;
+    uint64_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = disk_.find(url_key);
+        if (it == disk_.end()) return nullptr;
+        content = it->second.content;
+        size = it->second.size;
+    }
+
+    Image image = read_blob(content, size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = disk_.find(url_key);
+    if (image == nullptr) {
+        if (it != disk_.end() && it->second.content == content) remove_disk_entry_locked(url_key);
+        return nullptr;
+    }
+    ++stats_.disk_hits;
+    if (it != disk_.end()) disk_order_.splice(disk_order_.end(), disk_order_, it->second.order);
+    remember_locked(url_key, image);
+    return image;
+}
+
+void ImageCache::store(const std::string& url_key, const Image& image) {
+    if (options_.directory.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remember_locked(url_key, image);
+        return;
+    }
+
+    std::string content = sha256_digest(*image);
+    std::string path = blob_path(content);
+    std::error_code ec;
+    bool on_disk = fs::file_size(path, ec) == image->size() && !ec;
+    if (!on_disk) {
+        fs::create_directories(fs::path(path).parent_path(), ec);
+        on_disk = write_file_atomic(path, *image);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    remember_locked(url_key, image);
+    if (!on_disk) return;
+    add_disk_entry_locked(url_key, content, image->size());
+    std::string record = encode_record(url_key, content, image->size());
+    index_out_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    index_out_.flush();
+    ++index_records_;
+    if (stats_.disk_bytes > options_.disk_bytes) evict_disk_locked();
+}
+
+ImageCache::Image ImageCache::peek(const std::string& url) {
+    std::string url_key = sha256_digest(url);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto it = memory_.find(url_key); it != memory_.end()) {
+            ++stats_.memory_hits;
+            memory_lru_.splice(memory_lru_.begin(), memory_lru_, it->second.lru);
+            return it->second.image;
+        }
+    }
+    return read_disk(url_key);
+}
+
+ImageCache::Image ImageCache::get(const std::string& url) {
+    std::string url_key = sha256_digest(url);
+    std::promise<Image> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (auto it = memory_.find(url_key); it != memory_.end()) {
+            ++stats_.memory_hits;
+            memory_lru_.splice(memory_lru_.begin(), memory_lru_, it->second.lru);
+            return it->second.image;
+        }
+        if (auto it = in_flight_.find(url_key); it != in_flight_.end()) {
+            ++stats_.joined;
+            std::shared_future<Image> future = it->second;
+            lock.unlock();
+            return future.get();
+        }
+        // Disk reads go through in_flight_ too, so a burst of lookups for
+        // one image reads the file once.
+        in_flight_.emplace(url_key, promise.get_future().share());
+    }
+
+    // Joined callers wait on the promise, so it is fulfilled and the
+    // in_flight_ entry dropped however the load ends.
+    Image image;
+    try {
+        image = read_disk(url_key);
+        if (image == nullptr) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.fetches;
+            }
+            std::optional<std::string> bytes;
+            try {
+                MemoryScope memory(MemoryTag::Caches);
+                bytes = fetcher_(url);
+            } catch (...) {
+                // Any fetcher exception is a failed download.
+            }
+            if (bytes) {
+                image = std::make_shared<const std::string>(std::move(*bytes));
+                store(url_key, image);
+            } else {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.fetch_failures;
+            }
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_.erase(url_key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_.erase(url_key);
+    }
+    promise.set_value(image);
+    return image;
+}
+
+ImageCacheStats ImageCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace ram
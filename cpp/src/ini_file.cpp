@@ -1,9 +1,16 @@
 #include "ram/ini_file.h"
 
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <stdexcept>
 
+#include "ram/memory_accounting.h"
+#include "ram/metrics.h"
+#include "ram/tracing.h"
+#include "ram/utilities.h"
+
 namespace ram {
 
 // --- IniSection ---
@@ -62,6 +69,7 @@ bool IniSection::exists(const std::string& name) const {
 
 void IniSection::set(const std::string& name, const std::string& value,
                      const std::string& comment) {
+    MemoryScope memory(MemoryTag::Ini);
     if (value.empty()) {
         remove_property(name);
         return;
@@ -72,7 +80,10 @@ void IniSection::set(const std::string& name, const std::string& value,
         order_.push_back(name);
         properties_[name] = {name, value, comment};
     } else {
-        it->second.value = value;
+        if (it->second.value != value) {
+            it->second.value = value;
+            it->second.dirty = true;
+        }
         if (!comment.empty()) {
             it->second.comment = comment;
         }
@@ -82,12 +93,23 @@ void IniSection::set(const std::string& name, const std::string& value,
 void IniSection::remove_property(const std::string& name) {
     auto it = properties_.find(name);
     if (it != properties_.end()) {
+        if (it->second.line != IniProperty::npos) {
+            removed_lines_.push_back(it->second.line);
+        }
         properties_.erase(it);
         order_.erase(
             std::remove(order_.begin(), order_.end(), name), order_.end());
     }
 }
 
+bool IniSection::dirty() const {
+    if (!removed_lines_.empty()) return true;
+    for (const auto& [key, prop] : properties_) {
+        if (prop.dirty || prop.line == IniProperty::npos) return true;
+    }
+    return false;
+}
+
 std::vector<IniProperty> IniSection::properties() const {
     std::vector<IniProperty> result;
     result.reserve(order_.size());
@@ -110,15 +132,42 @@ IniFile::IniFile(const std::string& path) {
         throw std::runtime_error("Cannot open INI file: " + path);
     }
     load(file);
+    source_path_ = path;
 }
 
 IniFile::IniFile(std::istream& stream) { load(stream); }
 
 void IniFile::load(std::istream& stream) {
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.ini_load);
+    TraceSpan span("ini.load", "ini");
+    MemoryScope memory(MemoryTag::Ini);
+    std::string content{std::istreambuf_iterator<char>(stream),
+                        std::istreambuf_iterator<char>()};
+    metrics.ini_load_bytes.add(content.size());
+
+    lines_.clear();
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t nl = content.find('\n', pos);
+        if (nl == std::string::npos) {
+            lines_.push_back(content.substr(pos));
+            break;
+        }
+        lines_.push_back(content.substr(pos, nl - pos));
+        pos = nl + 1;
+    }
+    trailing_newline_ = content.empty() || content.back() == '\n';
+
+    load_lines();
+}
+
+void IniFile::load_lines() {
     IniSection* current_section = nullptr;
-    std::string line;
 
-    while (std::getline(stream, line)) {
+    for (size_t i = 0; i < lines_.size(); ++i) {
+        std::string line = lines_[i];
+
         // Trim whitespace
         size_t start = line.find_first_not_of(" \t\r\n");
         if (start == std::string::npos) continue;
@@ -142,7 +191,14 @@ void IniFile::load(std::istream& stream) {
                 section_order_.push_back(section_name);
                 sections_.emplace(section_name, IniSection(section_name));
             }
+            if (current_section != nullptr) {
+                current_section->spans_.back().second = i;
+            }
             current_section = &sections_.at(section_name);
+            current_section->spans_.emplace_back(i, lines_.size());
+            if (current_section->last_line_ == IniProperty::npos) {
+                current_section->last_line_ = i;
+            }
             continue;
         }
 
@@ -171,6 +227,10 @@ void IniFile::load(std::istream& stream) {
             // This matches the C# parser semantics where lines like "key=" are ignored.
             if (!key.empty() && !value.empty()) {
                 current_section->set(key, value);
+                auto& prop = current_section->properties_.at(key);
+                prop.line = i;
+                prop.dirty = false;
+                current_section->last_line_ = i;
             }
         }
     }
@@ -193,6 +253,8 @@ bool IniFile::has_section(const std::string& name) const {
 void IniFile::remove_section(const std::string& name) {
     auto it = sections_.find(name);
     if (it != sections_.end()) {
+        removed_spans_.insert(removed_spans_.end(), it->second.spans_.begin(),
+                              it->second.spans_.end());
         sections_.erase(it);
         section_order_.erase(
             std::remove(section_order_.begin(), section_order_.end(), name),
@@ -212,15 +274,47 @@ std::vector<IniSection> IniFile::sections() const {
     return result;
 }
 
-void IniFile::save(const std::string& path) const {
-    std::ofstream file(path);
-    if (!file.is_open()) {
+bool IniFile::dirty() const {
+    if (!removed_spans_.empty()) return true;
+    for (const auto& [name, sec] : sections_) {
+        if (sec.dirty()) return true;
+    }
+    return false;
+}
+
+bool IniFile::save(const std::string& path) {
+    TraceSpan span("ini.save", "ini");
+    if (preserve_formatting_ && !dirty() && path == source_path_ &&
+        std::filesystem::exists(path)) {
+        return false;
+    }
+
+    std::string content = to_string();
+    if (!write_file_atomic(path, content)) {
         throw std::runtime_error("Cannot write INI file: " + path);
     }
-    save(file);
+
+    // Re-read the layout of what was written so later saves diff against it.
+    std::istringstream written(content);
+    adopt_layout(IniFile(written));
+    source_path_ = path;
+    return true;
 }
 
 void IniFile::save(std::ostream& stream) const {
+    if (preserve_formatting_) {
+        render_lossless(stream);
+    } else {
+        render_full(stream);
+    }
+}
+
+std::string IniFile::format_property(const IniProperty& prop) const {
+    if (write_spacing_) return prop.name + " = " + prop.value;
+    return prop.name + "=" + prop.value;
+}
+
+void IniFile::render_full(std::ostream& stream) const {
     for (const auto& name : section_order_) {
         auto it = sections_.find(name);
         if (it == sections_.end()) continue;
@@ -239,14 +333,127 @@ void IniFile::save(std::ostream& stream) const {
             if (!prop.comment.empty()) {
                 stream << comment_char_ << " " << prop.comment << "\n";
             }
-            if (write_spacing_) {
-                stream << prop.name << " = " << prop.value << "\n";
+            stream << format_property(prop) << "\n";
+        }
+
+        stream << "\n";
+    }
+}
+
+void IniFile::render_lossless(std::ostream& stream) const {
+    const size_t n = lines_.size();
+    const std::string eol_cr =
+        (!lines_.empty() && !lines_[0].empty() && lines_[0].back() == '\r')
+            ? "\r"
+            : "";
+
+    std::vector<bool> drop(n, false);
+    std::vector<const IniProperty*> replace(n, nullptr);
+    std::map<size_t, std::vector<const IniProperty*>> inserts;
+
+    for (const auto& [first, last] : removed_spans_) {
+        for (size_t i = first; i < last && i < n; ++i) drop[i] = true;
+    }
+
+    for (const auto& [name, sec] : sections_) {
+        for (size_t line : sec.removed_lines_) {
+            if (line < n) drop[line] = true;
+        }
+        if (sec.spans_.empty()) continue;
+        for (const auto& key : sec.order_) {
+            const auto& prop = sec.properties_.at(key);
+            if (prop.line == IniProperty::npos) {
+                inserts[sec.last_line_].push_back(&prop);
+            } else if (prop.dirty && prop.line < n) {
+                replace[prop.line] = &prop;
+            }
+        }
+    }
+
+    std::vector<std::string> out;
+    out.reserve(n);
+    auto emit_new = [&](const IniProperty& prop) {
+        if (!prop.comment.empty()) {
+            out.push_back(comment_char_ + (" " + prop.comment) + eol_cr);
+        }
+        out.push_back(format_property(prop) + eol_cr);
+    };
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!drop[i]) {
+            if (const IniProperty* prop = replace[i]) {
+                // Keep the original key and separator spacing; swap the value.
+                const std::string& orig = lines_[i];
+                bool cr = !orig.empty() && orig.back() == '\r';
+                size_t eq = orig.find('=');
+                size_t value_start = orig.find_first_not_of(" \t", eq + 1);
+                if (value_start == std::string::npos) {
+                    value_start = orig.size() - (cr ? 1 : 0);
+                }
+                out.push_back(orig.substr(0, value_start) + prop->value +
+                              (cr ? "\r" : ""));
             } else {
-                stream << prop.name << "=" << prop.value << "\n";
+                out.push_back(lines_[i]);
             }
         }
+        auto ins = inserts.find(i);
+        if (ins != inserts.end()) {
+            for (const IniProperty* prop : ins->second) emit_new(*prop);
+        }
+    }
 
-        stream << "\n";
+    bool appended = false;
+    for (const auto& name : section_order_) {
+        auto it = sections_.find(name);
+        if (it == sections_.end()) continue;
+        const auto& sec = it->second;
+        if (!sec.spans_.empty() || sec.size() == 0) continue;
+
+        if (!out.empty() && out.back().find_first_not_of(" \t\r") !=
+                                std::string::npos) {
+            out.push_back(eol_cr);
+        }
+        if (!sec.comment().empty()) {
+            out.push_back(comment_char_ + (" " + sec.comment()) + eol_cr);
+        }
+        out.push_back("[" + sec.name() + "]" + eol_cr);
+        for (const auto& prop : sec.properties()) emit_new(prop);
+        appended = true;
+    }
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        stream << out[i];
+        if (i + 1 < out.size() || trailing_newline_ || appended) {
+            stream << "\n";
+        }
+    }
+}
+
+void IniFile::adopt_layout(const IniFile& parsed) {
+    lines_ = parsed.lines_;
+    trailing_newline_ = parsed.trailing_newline_;
+    removed_spans_.clear();
+
+    for (auto& [name, sec] : sections_) {
+        sec.removed_lines_.clear();
+        auto it = parsed.sections_.find(name);
+        if (it == parsed.sections_.end()) {
+            sec.spans_.clear();
+            sec.last_line_ = IniProperty::npos;
+            for (auto& [key, prop] : sec.properties_) {
+                prop.line = IniProperty::npos;
+                prop.dirty = false;
+            }
+            continue;
+        }
+        sec.spans_ = it->second.spans_;
+        sec.last_line_ = it->second.last_line_;
+        for (auto& [key, prop] : sec.properties_) {
+            auto p = it->second.properties_.find(key);
+            prop.line = p != it->second.properties_.end() ? p->second.line
+                                                          : IniProperty::npos;
+            prop.dirty = false;
+        }
     }
 }
 
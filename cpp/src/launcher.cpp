@@ -0,0 +1,341 @@
+#include "ram/launcher.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "ram/rate_limiter.h"
+#include "ram/tracing.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <shellapi.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace ram {
+
+namespace {
+
+// Matches HttpUtility.UrlEncode: space becomes '+', lowercase hex escapes.
+std::string url_encode(const std::string& in) {
+    static const char* kHex = "0123456789abcdef";
+    std::string out;
+    out.reserve(in.size() * 3 / 2);
+    for (unsigned char c : in) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' ||
+            c == '!' || c == '*' || c == '(' || c == ')') {
+            out += static_cast<char>(c);
+        } else if (c == ' ') {
+            out += '+';
+        } else {
+            out += '%';
+            out += kHex[c >> 4];
+            out += kHex[c & 0xF];
+        }
+    }
+    return out;
+}
+
+std::string generate_browser_tracker_id(std::mt19937& rng) {
+    std::uniform_int_distribution<int> first(100000, 174999);
+    std::uniform_int_distribution<int> second(100000, 899999);
+    return std::to_string(first(rng)) + std::to_string(second(rng));
+}
+
+}  // namespace
+
+std::string LaunchSpec::uri(int64_t launch_time_ms) const {
+    std::string place_launcher =
+        "https://assetgame.roblox.com/game/PlaceLauncher.ashx?request=";
+    if (private_server) {
+        place_launcher += "RequestPrivateGame&placeId=" + std::to_string(place_id) +
+                          "&accessCode=" + job_id + "&linkCode=";
+    } else if (follow_user) {
+        place_launcher += "RequestFollowUser&userId=" + std::to_string(place_id);
+    } else {
+        place_launcher += job_id.empty() ? "RequestGame" : "RequestGameJob";
+        place_launcher += "&browserTrackerId=" + browser_tracker_id +
+                          "&placeId=" + std::to_string(place_id);
+        if (!job_id.empty()) place_launcher += "&gameId=" + job_id;
+        place_launcher += "&isPlayTogetherGame=false";
+        if (is_teleport) place_launcher += "&isTeleport=true";
+    }
+
+    return "roblox-player:1+launchmode:play+gameinfo:" + ticket +
+           "+launchtime:" + std::to_string(launch_time_ms) +
+           "+placelauncherurl:" + url_encode(place_launcher) +
+           "+browsertrackerid:" + browser_tracker_id +
+           "+robloxLocale:en_us+gameLocale:en_us+channel:+LaunchExp:InApp";
+}
+
+LaunchTarget resolve_launch_target(const Account& account,
+                                   const LaunchTarget& target) {
+    LaunchTarget resolved = target;
+    if (target.follow_user) return resolved;
+
+    auto place = account.fields.find("SavedPlaceId");
+    if (place != account.fields.end() && !place->second.empty()) {
+        try {
+            size_t used = 0;
+            int64_t id = std::stoll(place->second, &used);
+            if (used == place->second.size()) resolved.place_id = id;
+        } catch (...) {
+        }
+    }
+    auto job = account.fields.find("SavedJobId");
+    if (job != account.fields.end() && !job->second.empty()) {
+        resolved.job_id = job->second;
+    }
+    return resolved;
+}
+
+bool open_with_protocol_handler(const LaunchSpec& spec) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    std::string uri =
+        spec.uri(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+#ifdef _WIN32
+    auto result = reinterpret_cast<intptr_t>(
+        ShellExecuteA(nullptr, "open", uri.c_str(), nullptr, nullptr, SW_SHOWNORMAL));
+    return result > 32;
+#else
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        execlp("xdg-open", "xdg-open", uri.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+}
+
+const char* to_string(LaunchStage stage) {
+    switch (stage) {
+        case LaunchStage::Prefetching: return "Prefetching";
+        case LaunchStage::Ready: return "Ready";
+        case LaunchStage::Launching: return "Launching";
+        case LaunchStage::Launched: return "Launched";
+        case LaunchStage::Failed: return "Failed";
+        case LaunchStage::Cancelled: return "Cancelled";
+    }
+    return "Unknown";
+}
+
+LaunchOrchestrator::LaunchOrchestrator(HttpClient& client, CsrfTokenCache& csrf,
+                                       Launcher launcher,
+                                       LaunchOrchestratorOptions options)
+    : client_(client),
+      csrf_(csrf),
+      launcher_(std::move(launcher)),
+      options_(options) {
+    if (options_.max_concurrent == 0) options_.max_concurrent = 1;
+    if (options_.prefetch_depth == 0) options_.prefetch_depth = 1;
+    if (options_.start_burst < 1.0) options_.start_burst = 1.0;
+}
+
+void LaunchOrchestrator::emit(const Slot& slot, LaunchStage stage,
+                              const std::string& message) {
+    if (!listener_) return;
+    listener_(LaunchEvent{slot.spec.index, slot.spec.username, stage, message});
+}
+
+void LaunchOrchestrator::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++cancel_requests_;
+        cancelled_ = true;
+    }
+    cv_.notify_all();
+}
+
+void LaunchOrchestrator::prefetch_loop(std::vector<Slot>& slots) {
+    for (;;) {
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] {
+                return cancelled_ || next_prefetch_ >= slots.size() ||
+                       next_prefetch_ < launch_cursor_ + options_.prefetch_depth;
+            });
+            if (cancelled_ || next_prefetch_ >= slots.size()) return;
+            slot = &slots[next_prefetch_++];
+            slot->state = SlotState::Fetching;
+        }
+
+        emit(*slot, LaunchStage::Prefetching);
+
+        // Fetch the CSRF token separately so an expired session can be told
+        // apart from a ticket failure; get_auth_ticket then reuses it.
+        std::string error;
+        std::optional<std::string> ticket;
+        bool session = false;
+        {
+            TraceSpan span("launch.csrf", "launch");
+            session = csrf_.get(*slot->account).has_value();
+        }
+        if (!session) {
+            error = "Account session expired (invalid X-CSRF-Token)";
+        } else {
+            TraceSpan span("launch.ticket", "launch");
+            ticket = get_auth_ticket(client_, csrf_, *slot->account);
+            if (!ticket) error = "Failed to get authentication ticket";
+        }
+
+        if (ticket) emit(*slot, LaunchStage::Ready);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ticket) {
+                slot->spec.ticket = std::move(*ticket);
+                slot->state = SlotState::Ready;
+            } else {
+                slot->error = error;
+                slot->state = SlotState::Failed;
+            }
+        }
+        cv_.notify_all();
+    }
+}
+
+void LaunchOrchestrator::launch_loop(std::vector<Slot>& slots, TokenBucket& starts,
+                                     std::vector<LaunchEvent>& results) {
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cancelled_ || next_launch_ >= slots.size()) return;
+        size_t index = next_launch_++;
+        Slot& slot = slots[index];
+        {
+            // Slots are handed to the launcher in batch order, so wait for
+            // the previous one as well as for this slot's ticket.
+            TraceSpan span("launch.wait_ticket", "launch");
+            cv_.wait(lock, [&] {
+                return cancelled_ ||
+                       (launch_cursor_ == index && (slot.state == SlotState::Ready ||
+                                                    slot.state == SlotState::Failed));
+            });
+        }
+        if (cancelled_) return;
+
+        if (slot.state == SlotState::Failed) {
+            results[index].stage = LaunchStage::Failed;
+            results[index].message = slot.error;
+            launch_cursor_ = index + 1;
+            lock.unlock();
+            cv_.notify_all();
+            emit(slot, LaunchStage::Failed, slot.error);
+            continue;
+        }
+
+        {
+            TraceSpan span("launch.wait_slot", "launch");
+            while (!cancelled_ && !starts.try_acquire()) {
+                cv_.wait_for(lock, starts.time_until());
+            }
+        }
+        if (cancelled_) return;
+
+        launch_cursor_ = index + 1;
+        lock.unlock();
+        cv_.notify_all();
+
+        emit(slot, LaunchStage::Launching);
+        bool ok = false;
+        std::string error;
+        try {
+            TraceSpan span("launch.start", "launch");
+            ok = launcher_(slot.spec);
+            if (!ok) error = "Failed to launch Roblox";
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        // Report before taking another slot so events stay in launch order.
+        emit(slot, ok ? LaunchStage::Launched : LaunchStage::Failed, error);
+        std::lock_guard<std::mutex> guard(mutex_);
+        results[index].stage = ok ? LaunchStage::Launched : LaunchStage::Failed;
+        results[index].message = std::move(error);
+    }
+}
+
+LaunchSummary LaunchOrchestrator::run(const std::vector<Account>& accounts,
+                                      const LaunchTarget& target) {
+    TraceSpan batch_span("launch.batch", "launch");
+    std::mt19937 rng{std::random_device{}()};
+    std::vector<Slot> slots(accounts.size());
+    LaunchSummary summary;
+    summary.results.resize(accounts.size());
+    summary.browser_tracker_ids.resize(accounts.size());
+
+    for (size_t i = 0; i < accounts.size(); ++i) {
+        const Account& account = accounts[i];
+        LaunchTarget resolved = resolve_launch_target(account, target);
+        LaunchSpec& spec = slots[i].spec;
+        spec.index = i;
+        spec.username = account.username;
+        spec.user_id = account.user_id;
+        spec.browser_tracker_id = account.browser_tracker_id.empty()
+                                      ? generate_browser_tracker_id(rng)
+                                      : account.browser_tracker_id;
+        spec.place_id = resolved.place_id;
+        spec.job_id = resolved.job_id;
+        spec.follow_user = resolved.follow_user;
+        spec.private_server = resolved.private_server;
+        spec.is_teleport = resolved.is_teleport;
+        slots[i].account = &account;
+        summary.results[i] = LaunchEvent{i, account.username, LaunchStage::Cancelled, {}};
+        summary.browser_tracker_ids[i] = spec.browser_tracker_id;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Only cancels that belonged to the previous run are forgotten; one
+        // issued since then, even while this run was being set up, stands.
+        cancelled_ = cancel_requests_ != cancels_handled_;
+        next_prefetch_ = 0;
+        launch_cursor_ = 0;
+        next_launch_ = 0;
+    }
+
+    std::vector<std::thread> prefetchers;
+    size_t fetchers = std::min(options_.prefetch_depth, slots.size());
+    for (size_t i = 0; i < fetchers; ++i) {
+        prefetchers.emplace_back([this, &slots] { prefetch_loop(slots); });
+    }
+
+    // Each worker launches one client at a time, which bounds concurrency
+    // without a thread per account.
+    TokenBucket starts(options_.starts_per_second, options_.start_burst);
+    std::vector<std::thread> launchers;
+    size_t workers = std::min(options_.max_concurrent, slots.size());
+    for (size_t i = 0; i < workers; ++i) {
+        launchers.emplace_back(
+            [this, &slots, &starts, &summary] { launch_loop(slots, starts, summary.results); });
+    }
+
+    for (auto& t : launchers) t.join();
+    // Launch workers only stop early on cancel, which also stops the
+    // prefetchers.
+    cv_.notify_all();
+    for (auto& t : prefetchers) t.join();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancels_handled_ = cancel_requests_;
+    }
+
+    for (size_t i = launch_cursor_; i < slots.size(); ++i) {
+        emit(slots[i], LaunchStage::Cancelled);
+    }
+    for (const auto& result : summary.results) {
+        switch (result.stage) {
+            case LaunchStage::Launched: ++summary.launched; break;
+            case LaunchStage::Failed: ++summary.failed; break;
+            default: ++summary.cancelled; break;
+        }
+    }
+    return summary;
+}
+
+}  // namespace ram
@@ -0,0 +1,676 @@
+#include "ram/local_api.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+
+#include "ram/metrics.h"
+#include "ram/utilities.h"
+
+namespace ram {
+
+enum LocalApi::Method : int {
+    kGetAccounts,
+    kGetAccountsJson,
+    kImportCookie,
+    kGetCookie,
+    kLaunchAccount,
+    kFollowUser,
+    kGetCSRFToken,
+    kGetAlias,
+    kGetDescription,
+    kBlockUser,
+    kUnblockUser,
+    kGetBlockedList,
+    kUnblockEveryone,
+    kSetServer,
+    kSetRecommendedServer,
+    kGetField,
+    kSetField,
+    kRemoveField,
+    kSetAvatar,
+    kSetAlias,
+    kSetDescription,
+    kAppendDescription,
+    kBatch,
+    kMethodCount,
+};
+
+namespace {
+
+const std::string kEmpty;
+// Upper bound on operations in one Batch request.
+constexpr size_t kMaxBatchOperations = 1000;
+
+const std::string& lookup(const std::map<std::string, std::string>& query,
+                          const std::string& name) {
+    auto it = query.find(name);
+    return it == query.end() ? kEmpty : it->second;
+}
+
+// Whether an If-None-Match header value lists `etag` (weak comparison).
+bool etag_matches(std::string_view header, std::string_view etag) {
+    while (!header.empty()) {
+        size_t comma = header.find(',');
+        std::string_view candidate = header.substr(0, comma);
+        header = comma == std::string_view::npos ? std::string_view{} : header.substr(comma + 1);
+        while (!candidate.empty() && candidate.front() == ' ') candidate.remove_prefix(1);
+        while (!candidate.empty() && candidate.back() == ' ') candidate.remove_suffix(1);
+        if (candidate.rfind("W/", 0) == 0) candidate.remove_prefix(2);
+        if (candidate == "*" || candidate == etag) return true;
+    }
+    return false;
+}
+
+bool is_json(const std::string& text) {
+    return !nlohmann::json::parse(text, nullptr, false).is_discarded();
+}
+
+ApiReply reply(std::string message, bool success, int status = -1,
+               std::optional<std::string> raw = std::nullopt) {
+    return ApiReply{std::move(message), success, status, std::move(raw)};
+}
+
+}  // namespace
+
+const std::string& ApiCall::param(const std::string& name) const {
+    return lookup(query, name);
+}
+
+LocalApiSettings LocalApiSettings::from_ini(const IniSection& section) {
+    LocalApiSettings settings;
+    if (section.exists("WebServerPort")) {
+        int port = section.get_as<int>("WebServerPort");
+        if (port > 0 && port < 65536) settings.port = static_cast<uint16_t>(port);
+    }
+    settings.allow_external_connections = section.get_as<bool>("AllowExternalConnections");
+    settings.allow_get_cookie = section.get_as<bool>("AllowGetCookie");
+    settings.allow_get_accounts = section.get_as<bool>("AllowGetAccounts");
+    settings.allow_launch_account = section.get_as<bool>("AllowLaunchAccount");
+    settings.allow_account_editing = section.get_as<bool>("AllowAccountEditing");
+    settings.every_request_requires_password =
+        section.get_as<bool>("EveryRequestRequiresPassword");
+    settings.password = section.get("Password");
+    return settings;
+}
+
+const std::vector<std::string>& LocalApi::methods() {
+    static const std::vector<std::string> kMethods = {
+        "GetAccounts",     "GetAccountsJson", "ImportCookie",   "GetCookie",
+        "LaunchAccount",   "FollowUser",      "GetCSRFToken",   "GetAlias",
+        "GetDescription",  "BlockUser",       "UnblockUser",    "GetBlockedList",
+        "UnblockEveryone", "SetServer",       "SetRecommendedServer",
+        "GetField",        "SetField",        "RemoveField",    "SetAvatar",
+        "SetAlias",        "SetDescription",  "AppendDescription", "Batch",
+    };
+    return kMethods;
+}
+
+LocalApi::LocalApi(AccountStore& store, LocalApiSettings settings,
+                   CsrfTokenCache* csrf, size_t worker_threads)
+    : store_(store),
+      settings_(std::move(settings)),
+      csrf_(csrf),
+      router_(methods()),
+      server_([this](ServerRequest& request, Responder responder) {
+                  handle(request, responder);
+              },
+              HttpServerOptions{settings_.allow_external_connections ? "0.0.0.0" : "127.0.0.1",
+                                settings_.port, worker_threads}) {
+    favicon_ = canned(reply("", true, 200, std::string{}));
+    running_ = canned(reply("Roblox Account Manager is running", true, -1, "true"));
+    external_denied_ =
+        canned(reply("External connections are not allowed", false, 401, std::string{}));
+    invalid_password_ = canned(reply(
+        "Invalid Password, make sure your password contains 6 or more characters", false,
+        401, "Invalid Password"));
+    empty_account_ = canned(reply("Empty Account", false));
+    invalid_account_ = canned(reply(
+        "Invalid Account, the account's cookie may have expired and resulted in the "
+        "account being logged out",
+        false, -1, "Invalid Account"));
+    not_found_ = canned(reply("404 not found", false, 404));
+    invalid_place_id_ = canned(reply("Invalid PlaceId provided", false, -1, "Invalid PlaceId"));
+    invalid_username_ = canned(reply("Invalid Username Parameter", false));
+    invalid_batch_ = canned(reply("Invalid batch, expected a JSON array of operations", false));
+
+    // Versions restart with the process; the prefix keeps ETags from an
+    // earlier run from matching.
+    char prefix[17];
+    std::snprintf(prefix, sizeof(prefix), "%016llx",
+                  static_cast<unsigned long long>(
+                      std::chrono::system_clock::now().time_since_epoch().count()));
+    etag_prefix_ = prefix;
+
+    // Editing methods answered 400 rather than 401 when disabled.
+    not_allowed_.resize(kMethodCount);
+    for (int m = 0; m < kMethodCount; ++m) {
+        bool editing = m == kSetAlias || m == kSetDescription || m == kAppendDescription;
+        not_allowed_[m] = canned(reply("Method `" + methods()[m] + "` not allowed", false,
+                                       editing ? -1 : 401, "Method not allowed"));
+    }
+}
+
+void LocalApi::on(const std::string& method, Action action) {
+    int m = router_.find(method);
+    if (m != PerfectHashRouter::kNotFound) actions_[m] = std::move(action);
+}
+
+void LocalApi::set_importer(Importer importer) { importer_ = std::move(importer); }
+
+void LocalApi::set_on_modified(std::function<void()> callback) {
+    on_modified_ = std::move(callback);
+}
+
+void LocalApi::start() { server_.start(); }
+void LocalApi::stop() { server_.stop(); }
+
+void LocalApi::modified() {
+    if (on_modified_) on_modified_();
+}
+
+bool LocalApi::is_network(int method) {
+    switch (method) {
+        case kLaunchAccount:
+        case kFollowUser:
+        case kBlockUser:
+        case kUnblockUser:
+        case kGetBlockedList:
+        case kUnblockEveryone:
+        case kSetServer:
+        case kSetRecommendedServer:
+        case kSetAvatar:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool LocalApi::is_edit(int method) {
+    return method == kSetField || method == kRemoveField || method == kSetAlias ||
+           method == kSetDescription || method == kAppendDescription;
+}
+
+ServerResponse LocalApi::render(const ApiReply& reply, bool v2) {
+    HttpResponse response;
+    response.status = reply.status > 0 ? reply.status : (reply.success ? 200 : 400);
+    response.body = v2 ? nlohmann::json{{"Success", reply.success}, {"Message", reply.message}}.dump()
+                       : reply.raw.value_or(reply.message);
+    response.headers.emplace_back("Content-Type", "text/plain; charset=utf-8");
+    if (response.status > 299) {
+        std::string error = response.body;
+        for (char& c : error) {
+            if (c == '\r' || c == '\n') c = ' ';
+        }
+        response.headers.emplace_back("ws-error", std::move(error));
+    }
+    return response;
+}
+
+LocalApi::Canned LocalApi::canned(const ApiReply& reply) const {
+    return {reply,
+            {preformat(render(reply, false).response), preformat(render(reply, true).response)}};
+}
+
+void LocalApi::handle(ServerRequest& server_request, Responder responder) {
+    const std::string& target = server_request.http.url;
+    size_t qmark = target.find('?');
+    std::string_view path = std::string_view(target).substr(0, qmark);
+
+    Request request;
+    request.v2 = path.rfind("/v2/", 0) == 0;
+    if (request.v2) path.remove_prefix(3);
+    int v = request.v2 ? 1 : 0;
+
+    if (!server_request.from_loopback && !settings_.allow_external_connections) {
+        return responder.send(external_denied_[v]);
+    }
+    if (path == "/favicon.ico") return responder.send(favicon_[v]);
+    if (path == "/Running") return responder.send(running_[v]);
+
+    request.name = std::string(path.substr(path.empty() ? 0 : 1));
+    request.method = router_.find(request.name);
+    if (qmark != std::string::npos) {
+        request.query = parse_query(std::string_view(target).substr(qmark + 1));
+    }
+    request.body = std::move(server_request.http.body);
+    if (auto it = request.query.find("Password"); it != request.query.end()) {
+        request.password = it->second;
+        request.password_given = true;
+    }
+
+    const std::string& password = settings_.password;
+    if (settings_.every_request_requires_password &&
+        (password.size() < 6 || request.password != password)) {
+        return responder.send(invalid_password_[v]);
+    }
+    if (path == "/metrics") {
+        HttpResponse response;
+        response.status = 200;
+        response.body = MetricsRegistry::global().render_prometheus();
+        response.headers.emplace_back("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+        return responder.send(std::move(response));
+    }
+    bool protected_method = request.method == kGetCookie || request.method == kGetAccounts ||
+                            request.method == kLaunchAccount || request.method == kFollowUser;
+    if (protected_method &&
+        (password.size() < 6 || (request.password_given && request.password != password))) {
+        return responder.send(invalid_password_[v]);
+    }
+
+    if (request.method == kBatch) return handle_batch(request, responder);
+
+    if (request.method == kGetAccounts || request.method == kGetAccountsJson) {
+        if (!settings_.allow_get_accounts) return responder.send(not_allowed_[request.method][v]);
+        return responder.send(
+            accounts_reply(request, server_request.http.header("If-None-Match")));
+    }
+
+    if (request.method == kImportCookie) {
+        if (!importer_) return responder.send(not_found_[v]);
+        return responder.defer([this, request = std::move(request)](Responder r) {
+            std::optional<Account> account = importer_(lookup(request.query, "Cookie"));
+            bool ok = account.has_value() && store_.add(std::move(*account));
+            if (ok) modified();
+            r.send(render(ok ? reply("Cookie successfully imported", true, -1, "true")
+                             : reply("[ImportCookie] An error was encountered importing the cookie",
+                                     false, -1, "false"),
+                          request.v2));
+        });
+    }
+
+    const std::string& name = lookup(request.query, "Account");
+    if (name.empty()) return responder.send(empty_account_[v]);
+
+    std::optional<Account> account;
+    store_.read(name, [&](const Account& found) { account = found; });
+    if (!account) return responder.send(invalid_account_[v]);
+
+    if (csrf_ == nullptr) {
+        return handle_account(std::move(request), std::move(*account), {}, responder, false);
+    }
+    if (auto token = csrf_->peek(*account)) {
+        return handle_account(std::move(request), std::move(*account), std::move(*token),
+                              responder, false);
+    }
+    // The token has to be fetched, which blocks; finish on a worker.
+    responder.defer([this, request = std::move(request),
+                     account = std::move(*account)](Responder r) mutable {
+        auto token = csrf_->get(account);
+        if (!token) return r.send(invalid_account_[request.v2 ? 1 : 0]);
+        handle_account(std::move(request), std::move(account), std::move(*token), r, true);
+    });
+}
+
+const LocalApi::Canned* LocalApi::check(const Request& request) const {
+    const auto& q = request.query;
+    switch (request.method) {
+        case kGetCookie:
+            if (!settings_.allow_get_cookie) return &not_allowed_[kGetCookie];
+            break;
+        case kLaunchAccount: {
+            if (!settings_.allow_launch_account) return &not_allowed_[kLaunchAccount];
+            const std::string& place = lookup(q, "PlaceId");
+            try {
+                size_t used = 0;
+                std::stoll(place, &used);
+                if (used != place.size()) throw std::invalid_argument(place);
+            } catch (...) {
+                return &invalid_place_id_;
+            }
+            break;
+        }
+        case kFollowUser:
+            if (!settings_.allow_launch_account) return &not_allowed_[kFollowUser];
+            if (lookup(q, "Username").empty()) return &invalid_username_;
+            break;
+        case kBlockUser:
+        case kUnblockUser:
+            if (lookup(q, "UserId").empty()) return &not_found_;
+            break;
+        case kSetServer:
+            if (lookup(q, "PlaceId").empty() || lookup(q, "JobId").empty()) return &not_found_;
+            break;
+        case kSetAvatar:
+            if (!is_json(request.body)) return &not_found_;
+            break;
+        case kSetField:
+            if (lookup(q, "Field").empty() || lookup(q, "Value").empty()) return &not_found_;
+            [[fallthrough]];
+        case kRemoveField:
+            if (lookup(q, "Field").empty()) return &not_found_;
+            if (!settings_.allow_account_editing) return &not_allowed_[request.method];
+            break;
+        case kSetAlias:
+        case kSetDescription:
+        case kAppendDescription:
+            if (request.body.empty()) return &not_found_;
+            if (!settings_.allow_account_editing) return &not_allowed_[request.method];
+            break;
+        case kGetField:
+            if (lookup(q, "Field").empty()) return &not_found_;
+            break;
+        case kGetCSRFToken:
+            if (csrf_ == nullptr) return &not_found_;
+            break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+void LocalApi::handle_account(Request request, Account account, std::string token,
+                              Responder responder, bool on_worker) {
+    int v = request.v2 ? 1 : 0;
+    if (const Canned* rejected = check(request)) return responder.send((*rejected)[v]);
+
+    Action* action = nullptr;
+    if (request.method != PerfectHashRouter::kNotFound) {
+        auto it = actions_.find(request.method);
+        if (it != actions_.end()) action = &it->second;
+    }
+    if (!is_network(request.method)) {
+        return responder.send(render(run_local(request, account, token), request.v2));
+    }
+    if (action == nullptr) return responder.send(not_found_[v]);
+
+    auto run = [action, request = std::move(request), account = std::move(account),
+                token = std::move(token)](Responder r) mutable {
+        ApiCall call{request.name, std::move(account), std::move(token), std::move(request.query),
+                     std::move(request.body)};
+        ApiReply result;
+        try {
+            result = (*action)(call);
+        } catch (const std::exception& e) {
+            result = reply(e.what(), false, 500);
+        }
+        r.send(render(result, request.v2));
+    };
+    if (on_worker) return run(responder);
+    responder.defer(std::move(run));
+}
+
+ApiReply LocalApi::run_local(const Request& request, Account& account,
+                             const std::string& token) {
+    bool edited = false;
+    if (!is_edit(request.method)) return apply(request, account, token, edited);
+
+    // Edits go to the stored account, not the snapshot.
+    std::string key = account.user_id != 0 ? std::to_string(account.user_id) : account.username;
+    ApiReply result;
+    bool found = store_.update(key, [&](Account& acc) {
+        result = apply(request, acc, token, edited);
+    });
+    if (!found) return reply("Invalid Account", false);
+    if (edited) modified();
+    return result;
+}
+
+ApiReply LocalApi::apply(const Request& request, Account& account, const std::string& token,
+                         bool& edited) const {
+    const auto& q = request.query;
+    const std::string& field = lookup(q, "Field");
+    switch (request.method) {
+        case kGetCookie:
+            return reply(account.security_token, true);
+        case kGetCSRFToken:
+            return reply(token, true);
+        case kGetAlias:
+            return reply(account.alias(), true);
+        case kGetDescription:
+            return reply(account.description(), true);
+        case kGetField: {
+            auto it = account.fields.find(field);
+            return reply(it == account.fields.end() ? std::string{} : it->second, true);
+        }
+        case kSetField: {
+            const std::string& value = lookup(q, "Value");
+            account.fields[field] = value;
+            edited = true;
+            return reply("Set Field " + field + " to " + value + " for " + account.username, true);
+        }
+        case kRemoveField:
+            account.fields.erase(field);
+            edited = true;
+            return reply("Removed Field " + field + " from " + account.username, true);
+        case kSetAlias:
+            account.set_alias(request.body);
+            edited = true;
+            return reply("Set Alias of " + account.username + " to " + request.body, true);
+        case kSetDescription:
+            account.set_description(request.body);
+            edited = true;
+            return reply("Set Description of " + account.username + " to " + request.body, true);
+        case kAppendDescription:
+            account.set_description(account.description() + request.body);
+            edited = true;
+            return reply("Appended Description of " + account.username + " with " + request.body,
+                         true);
+        default:
+            return not_found_.reply;
+    }
+}
+
+void LocalApi::handle_batch(const Request& request, Responder responder) {
+    int v = request.v2 ? 1 : 0;
+    auto parsed = nlohmann::json::parse(request.body, nullptr, false);
+    if (!parsed.is_array() || parsed.size() > kMaxBatchOperations) {
+        return responder.send(invalid_batch_[v]);
+    }
+
+    // Operations inherit the batch's password; anything malformed becomes
+    // an unknown method and fails on its own.
+    std::vector<Request> ops(parsed.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const auto& entry = parsed[i];
+        Request& op = ops[i];
+        op.method = PerfectHashRouter::kNotFound;
+        op.v2 = request.v2;
+        op.password = request.password;
+        op.password_given = request.password_given;
+        if (!entry.is_object()) continue;
+        if (auto it = entry.find("Method"); it != entry.end() && it->is_string()) {
+            op.name = it->get<std::string>();
+            op.method = router_.find(op.name);
+        }
+        if (auto it = entry.find("Params"); it != entry.end() && it->is_object()) {
+            for (const auto& [key, value] : it->items()) {
+                op.query[key] = value.is_string() ? value.get<std::string>() : value.dump();
+            }
+        }
+        if (auto it = entry.find("Account"); it != entry.end() && it->is_string()) {
+            op.query["Account"] = it->get<std::string>();
+        }
+        if (auto it = entry.find("Body"); it != entry.end() && it->is_string()) {
+            op.body = it->get<std::string>();
+        }
+    }
+
+    auto send = [](Responder& r, const std::string& body) {
+        r.send(render(reply(body, true, -1, body), false));
+    };
+    std::vector<Account> missing;
+    if (auto results = run_batch(ops, {}, &missing)) return send(responder, *results);
+
+    // Some accounts have no cached CSRF token; fetch them on a worker.
+    responder.defer([this, ops = std::move(ops), missing = std::move(missing),
+                     send](Responder r) mutable {
+        std::unordered_map<std::string, std::string> tokens;
+        for (const auto& account : missing) {
+            if (tokens.count(account.security_token) != 0) continue;
+            if (auto token = csrf_->get(account)) tokens[account.security_token] = *token;
+        }
+        send(r, *run_batch(ops, tokens, nullptr));
+    });
+}
+
+std::optional<std::string> LocalApi::run_batch(
+    const std::vector<Request>& ops, const std::unordered_map<std::string, std::string>& tokens,
+    std::vector<Account>* missing) {
+    const std::string& password = settings_.password;
+    std::vector<ApiReply> results(ops.size());
+    bool complete = true;
+
+    bool edited = store_.transact([&](AccountStore::Transaction& tx) {
+        // Resolve accounts and tokens first so a batch that has to wait
+        // for a token fetch has not applied anything yet.
+        std::vector<Account*> accounts(ops.size(), nullptr);
+        std::vector<std::string> op_tokens(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i) {
+            const Request& op = ops[i];
+            if (op.method == PerfectHashRouter::kNotFound) {
+                results[i] = not_found_.reply;
+            } else if (op.method == kGetAccounts || op.method == kGetAccountsJson ||
+                       op.method == kImportCookie || op.method == kBatch ||
+                       is_network(op.method)) {
+                results[i] = reply("Method `" + op.name + "` cannot be batched", false);
+            } else if (op.method == kGetCookie &&
+                       (password.size() < 6 || (op.password_given && op.password != password))) {
+                results[i] = invalid_password_.reply;
+            } else if (lookup(op.query, "Account").empty()) {
+                results[i] = empty_account_.reply;
+            } else if ((accounts[i] = tx.find(lookup(op.query, "Account"))) == nullptr) {
+                results[i] = invalid_account_.reply;
+            } else if (csrf_ != nullptr) {
+                const Account& account = *accounts[i];
+                if (auto it = tokens.find(account.security_token); it != tokens.end()) {
+                    op_tokens[i] = it->second;
+                } else if (auto token = csrf_->peek(account)) {
+                    op_tokens[i] = std::move(*token);
+                } else if (missing != nullptr) {
+                    missing->push_back(account);
+                    complete = false;
+                } else {
+                    results[i] = invalid_account_.reply;
+                    accounts[i] = nullptr;
+                }
+            }
+        }
+        if (!complete) return;
+
+        for (size_t i = 0; i < ops.size(); ++i) {
+            if (accounts[i] == nullptr) continue;
+            if (const Canned* rejected = check(ops[i])) {
+                results[i] = rejected->reply;
+                continue;
+            }
+            bool changed = false;
+            results[i] = apply(ops[i], *accounts[i], op_tokens[i], changed);
+            if (changed) tx.touch();
+        }
+    });
+    if (!complete) return std::nullopt;
+    if (edited) modified();
+
+    nlohmann::json out = nlohmann::json::array();
+    for (size_t i = 0; i < ops.size(); ++i) {
+        out.push_back({{"Method", ops[i].name},
+                       {"Success", results[i].success},
+                       {"Message", results[i].message}});
+    }
+    return out.dump();
+}
+
+// `variant` is the accounts cache key, so replies that differ in format,
+// cookie visibility or group never share a tag.
+std::string LocalApi::current_etag(std::string_view variant) const {
+    uint64_t csrf_generation = csrf_ ? csrf_->generation() : 0;
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  static_cast<unsigned long long>(fingerprint64(variant)));
+    return "\"" + etag_prefix_ + "-" + std::to_string(store_.version()) + "-" +
+           std::to_string(csrf_generation) + "-" + hash + "\"";
+}
+
+ServerResponse LocalApi::accounts_reply(const Request& request,
+                                        const std::string* if_none_match) {
+    std::string key = std::to_string(request.method) + (request.v2 ? "2" : "1") +
+                      (shows_cookies(request) ? "c" : "-") + lookup(request.query, "Group");
+    // Read the version before serializing: a concurrent edit then leaves
+    // the entry tagged older than its contents and it is simply rebuilt.
+    std::string etag = current_etag(key);
+
+    if (if_none_match != nullptr && etag_matches(*if_none_match, etag)) {
+        {
+            std::lock_guard<std::mutex> lock(accounts_cache_mutex_);
+            ++accounts_cache_stats_.not_modified;
+        }
+        HttpResponse response;
+        response.status = 304;
+        response.headers.emplace_back("ETag", etag);
+        return response;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(accounts_cache_mutex_);
+        auto it = accounts_cache_.find(key);
+        if (it != accounts_cache_.end() && it->second.etag == etag) {
+            ++accounts_cache_stats_.hits;
+            return it->second.response;
+        }
+    }
+
+    ApiReply result =
+        request.method == kGetAccounts ? get_accounts(request) : get_accounts_json(request);
+    HttpResponse response = render(result, request.v2).response;
+    response.headers.emplace_back("ETag", etag);
+    response.headers.emplace_back("Cache-Control", "no-cache");
+    PreformattedResponse message = preformat(response);
+
+    std::lock_guard<std::mutex> lock(accounts_cache_mutex_);
+    ++accounts_cache_stats_.misses;
+    // Group filters come from the caller; keep the table small.
+    if (accounts_cache_.size() >= 64 && accounts_cache_.count(key) == 0) accounts_cache_.clear();
+    accounts_cache_[key] = CachedAccounts{std::move(etag), message};
+    return message;
+}
+
+AccountsCacheStats LocalApi::accounts_cache_stats() const {
+    std::lock_guard<std::mutex> lock(accounts_cache_mutex_);
+    return accounts_cache_stats_;
+}
+
+bool LocalApi::shows_cookies(const Request& request) const {
+    // The C# server compared with != here, exposing cookies only to callers
+    // with the wrong password; cookies now require the right one.
+    return settings_.password.size() >= 6 && request.password == settings_.password &&
+           lookup(request.query, "IncludeCookies") == "true" && settings_.allow_get_cookie;
+}
+
+ApiReply LocalApi::get_accounts(const Request& request) const {
+    const std::string& group = lookup(request.query, "Group");
+    std::string names;
+    store_.for_each([&](const Account& acc) {
+        if (!group.empty() && acc.group != group) return;
+        if (!names.empty()) names += ',';
+        names += acc.username;
+    });
+    return reply(names, true, -1, names);
+}
+
+ApiReply LocalApi::get_accounts_json(const Request& request) const {
+    const std::string& group = lookup(request.query, "Group");
+    bool show_cookies = shows_cookies(request);
+
+    nlohmann::json out = nlohmann::json::array();
+    store_.for_each([&](const Account& acc) {
+        if (!group.empty() && acc.group != group) return;
+        // A token that merely ages past the cache TTL does not bump the
+        // generation, so a cached reply can show it until the next change.
+        std::optional<std::string> token = csrf_ ? csrf_->peek(acc) : std::nullopt;
+        out.push_back({
+            {"Username", acc.username},
+            {"UserID", acc.user_id},
+            {"Alias", acc.alias()},
+            {"Description", acc.description()},
+            {"Group", acc.group},
+            {"CSRFToken", token ? nlohmann::json(*token) : nlohmann::json(nullptr)},
+            {"LastUsed", to_roblox_tick(acc.last_use)},
+            {"Cookie", show_cookies ? nlohmann::json(acc.security_token) : nlohmann::json(nullptr)},
+            {"Fields", acc.fields},
+        });
+    });
+    return reply(out.dump(), true);
+}
+
+}  // namespace ram
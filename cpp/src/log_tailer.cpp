@@ -0,0 +1,545 @@
+#include "ram/log_tailer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <tuple>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RAM_HAVE_SSSE3 1
+#define RAM_TARGET_SSSE3 __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define RAM_HAVE_SSSE3 1
+#define RAM_TARGET_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace ram {
+
+namespace {
+
+unsigned lowest_bit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+bool have_ssse3() {
+#if defined(RAM_HAVE_SSSE3) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#elif defined(RAM_HAVE_SSSE3)
+    return __builtin_cpu_supports("ssse3");
+#else
+    return false;
+#endif
+}
+
+#ifdef RAM_HAVE_SSSE3
+// Run the filter over 16 positions at a time and call found(offset,
+// buckets) for each that survives. Returns the first position left for the
+// scalar loop: every load has to stay inside the text.
+template <typename Found>
+RAM_TARGET_SSSE3 size_t teddy_ssse3(const uint8_t (&low)[MarkerMatcher::kPrefix][16],
+                                    const uint8_t (&high)[MarkerMatcher::kPrefix][16],
+                                    const char* data, size_t n, Found&& found) {
+    constexpr size_t kPrefix = MarkerMatcher::kPrefix;
+    __m128i low_tables[kPrefix];
+    __m128i high_tables[kPrefix];
+    for (size_t k = 0; k < kPrefix; ++k) {
+        low_tables[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(low[k]));
+        high_tables[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(high[k]));
+    }
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 + kPrefix - 1 <= n; i += 16) {
+        __m128i buckets = _mm_set1_epi8(-1);
+        for (size_t k = 0; k < kPrefix; ++k) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + k));
+            __m128i lo = _mm_shuffle_epi8(low_tables[k], _mm_and_si128(in, nibble));
+            __m128i hi = _mm_shuffle_epi8(high_tables[k],
+                                          _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+            buckets = _mm_and_si128(buckets, _mm_and_si128(lo, hi));
+        }
+        auto mask = static_cast<unsigned>(
+            ~_mm_movemask_epi8(_mm_cmpeq_epi8(buckets, _mm_setzero_si128())) & 0xffff);
+        if (mask == 0) continue;
+        alignas(16) uint8_t lanes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), buckets);
+        while (mask != 0) {
+            unsigned lane = lowest_bit(mask);
+            mask &= mask - 1;
+            found(i + lane, lanes[lane]);
+        }
+    }
+    return i;
+}
+#endif
+
+// Size and identity (inode) of a file; false if it does not exist.
+bool stat_file(const std::string& path, uint64_t& size, uint64_t& identity) {
+#ifndef _WIN32
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) return false;
+    size = static_cast<uint64_t>(st.st_size);
+    identity = static_cast<uint64_t>(st.st_ino);
+    return true;
+#else
+    std::error_code ec;
+    size = fs::file_size(path, ec);
+    identity = 0;
+    return !ec;
+#endif
+}
+
+std::string_view trim_cr(std::string_view text) {
+    if (!text.empty() && text.back() == '\r') text.remove_suffix(1);
+    return text;
+}
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::vector<std::string> marker_texts(const std::vector<LogMarker>& markers) {
+    std::vector<std::string> out;
+    out.reserve(markers.size());
+    for (const auto& marker : markers) out.push_back(marker.text);
+    return out;
+}
+
+}  // namespace
+
+MarkerMatcher::MarkerMatcher(std::vector<std::string> patterns)
+    : patterns_(std::move(patterns)), ssse3_(have_ssse3()) {
+    size_t next = 0;
+    for (size_t i = 0; i < patterns_.size(); ++i) {
+        const std::string& p = patterns_[i];
+        if (p.empty()) continue;
+        size_t bucket = next++ % 8;
+        buckets_[bucket].push_back(i);
+        auto bit = static_cast<uint8_t>(1u << bucket);
+        for (size_t k = 0; k < kPrefix; ++k) {
+            if (k < p.size()) {
+                auto c = static_cast<unsigned char>(p[k]);
+                low_[k][c & 15] |= bit;
+                high_[k][c >> 4] |= bit;
+            } else {
+                for (size_t nibble = 0; nibble < 16; ++nibble) {
+                    low_[k][nibble] |= bit;
+                    high_[k][nibble] |= bit;
+                }
+            }
+        }
+    }
+}
+
+uint8_t MarkerMatcher::candidates(const char* at, size_t available) const {
+    uint8_t bits = 0xff;
+    for (size_t k = 0; k < kPrefix && k < available; ++k) {
+        auto c = static_cast<unsigned char>(at[k]);
+        bits &= low_[k][c & 15] & high_[k][c >> 4];
+    }
+    return bits;
+}
+
+void MarkerMatcher::verify(const char* text, size_t n, size_t at, uint8_t buckets,
+                           std::vector<Hit>& out) const {
+    while (buckets != 0) {
+        unsigned bucket = lowest_bit(buckets);
+        buckets &= static_cast<uint8_t>(buckets - 1);
+        for (size_t index : buckets_[bucket]) {
+            const std::string& p = patterns_[index];
+            if (at + p.size() <= n && std::memcmp(text + at, p.data(), p.size()) == 0) {
+                out.push_back({at, index});
+            }
+        }
+    }
+}
+
+void MarkerMatcher::scan(std::string_view text, std::vector<Hit>& out) const {
+    const size_t begin = out.size();
+    const char* data = text.data();
+    const size_t n = text.size();
+    size_t i = 0;
+
+#ifdef RAM_HAVE_SSSE3
+    if (ssse3_) {
+        i = teddy_ssse3(low_, high_, data, n, [&](size_t at, uint8_t buckets) {
+            verify(data, n, at, buckets, out);
+        });
+    }
+#endif
+    for (; i < n; ++i) {
+        uint8_t buckets = candidates(data + i, n - i);
+        if (buckets != 0) verify(data, n, i, buckets, out);
+    }
+
+    // A position can match patterns from several buckets.
+    std::sort(out.begin() + static_cast<ptrdiff_t>(begin), out.end(),
+              [](const Hit& a, const Hit& b) {
+                  return std::tie(a.offset, a.pattern) < std::tie(b.offset, b.pattern);
+              });
+}
+
+std::vector<LogMarker> roblox_log_markers() {
+    return {
+        {"job_id", "! Joining game '", '\''},
+        {"place_id", "' place ", ' '},
+        {"disconnect", "Sending disconnect with reason: ", '\0'},
+        {"data_model_init", "initialized DataModel(", ')'},
+        {"data_model_start", "::start dataModel(", ')'},
+        {"data_model_stop", "UGCGameController::leave (blocking:", '\0'},
+        {"data_model_pause", "::pause dataModel(", ')'},
+        {"return_to_app", "returnToLuaApp: ", '\0'},
+    };
+}
+
+LogTailer::LogTailer(std::vector<LogMarker> markers, LogTailerOptions options)
+    : markers_(std::move(markers)),
+      matcher_(marker_texts(markers_)),
+      options_(options) {
+    if (options_.read_chunk == 0) options_.read_chunk = 64 << 10;
+#ifdef __linux__
+    inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_ < 0) throw std::runtime_error("Cannot create inotify instance");
+#endif
+}
+
+LogTailer::~LogTailer() {
+    stop();
+#ifdef __linux__
+    ::close(inotify_);
+#endif
+}
+
+LogTailer::Directory& LogTailer::add_directory_locked(const std::string& directory) {
+    Directory& dir = directories_[directory];
+#ifdef __linux__
+    if (dir.watch < 0) {
+        dir.watch = inotify_add_watch(inotify_, directory.c_str(),
+                                      IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO |
+                                          IN_MOVED_FROM | IN_DELETE);
+        if (dir.watch >= 0) watch_directories_[dir.watch] = directory;
+    }
+#endif
+    return dir;
+}
+
+void LogTailer::add_file_locked(const std::string& path, bool from_start) {
+    auto [it, inserted] = files_.try_emplace(path);
+    if (!inserted) return;
+    it->second = std::make_unique<File>();
+    it->second->path = path;
+    // Fix the skip point now rather than at the first poll, so lines
+    // appended in between are not skipped with the history.
+    uint64_t size = 0;
+    uint64_t identity = 0;
+    if (!from_start && stat_file(path, size, identity)) {
+        it->second->offset = size;
+        it->second->identity = identity;
+    }
+}
+
+void LogTailer::watch(const std::string& path, bool from_start) {
+    fs::path p(path);
+    std::string directory = p.has_parent_path() ? p.parent_path().string() : ".";
+    std::lock_guard<std::mutex> lock(mutex_);
+    add_directory_locked(directory);
+    add_file_locked((fs::path(directory) / p.filename()).string(), from_start);
+}
+
+void LogTailer::unwatch(const std::string& path) {
+    fs::path p(path);
+    std::string directory = p.has_parent_path() ? p.parent_path().string() : ".";
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_.erase((fs::path(directory) / p.filename()).string());
+}
+
+void LogTailer::watch_directory(const std::string& directory, const std::string& suffix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Directory& dir = add_directory_locked(directory);
+    dir.follow_new = true;
+    dir.suffix = suffix;
+}
+
+size_t LogTailer::subscribe(Listener listener) {
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    size_t id = next_listener_id_++;
+    listeners_.emplace(id, std::move(listener));
+    return id;
+}
+
+void LogTailer::unsubscribe(size_t id) {
+    std::lock_guard<std::mutex> lock(listeners_mutex_);
+    listeners_.erase(id);
+}
+
+#ifdef __linux__
+
+void LogTailer::wait_for_changes(std::chrono::milliseconds timeout) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool pending = false;
+        for (auto& [path, dir] : directories_) add_directory_locked(path);  // retry failed watches
+        for (const auto& [path, file] : files_) pending = pending || file->dirty;
+        if (pending) timeout = std::chrono::milliseconds(0);
+    }
+
+    pollfd pfd{inotify_, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) return;
+
+    alignas(inotify_event) char buffer[16 << 10];
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.wakeups;
+    for (;;) {
+        ssize_t n = ::read(inotify_, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        for (char* p = buffer; p < buffer + n;) {
+            auto* event = reinterpret_cast<inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were dropped, so any file may have changed.
+                ++stats_.overflows;
+                rescan_locked();
+                continue;
+            }
+            auto dir_it = watch_directories_.find(event->wd);
+            if (dir_it == watch_directories_.end() || event->len == 0) continue;
+
+            std::string name(event->name);
+            std::string path = (fs::path(dir_it->second) / name).string();
+            auto file = files_.find(path);
+            if (file != files_.end()) {
+                file->second->dirty = true;
+                continue;
+            }
+            const Directory& dir = directories_[dir_it->second];
+            if (dir.follow_new && (event->mask & (IN_CREATE | IN_MOVED_TO | IN_MODIFY)) &&
+                ends_with(name, dir.suffix)) {
+                add_file_locked(path, true);
+            }
+        }
+    }
+}
+
+#else
+
+void LogTailer::wait_for_changes(std::chrono::milliseconds timeout) {
+    std::this_thread::sleep_for(std::min(timeout, options_.poll_interval));
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.wakeups;
+    rescan_locked();
+}
+
+#endif
+
+void LogTailer::rescan_locked() {
+    for (auto& [path, file] : files_) file->dirty = true;
+    for (const auto& [directory, dir] : directories_) {
+        if (!dir.follow_new) continue;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            std::string name = entry.path().filename().string();
+            if (entry.is_regular_file(ec) && ends_with(name, dir.suffix)) {
+                add_file_locked((fs::path(directory) / name).string(), true);
+            }
+        }
+    }
+}
+
+void LogTailer::scan_locked(const File& file, std::string_view text, uint64_t base,
+                            std::vector<LogEvent>& events) {
+    hits_.clear();
+    matcher_.scan(text, hits_);
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& hit : hits_) {
+        size_t start = hit.offset == 0 ? std::string_view::npos : text.rfind('\n', hit.offset - 1);
+        start = start == std::string_view::npos ? 0 : start + 1;
+        size_t end = text.find('\n', hit.offset);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view line = trim_cr(text.substr(start, end - start));
+
+        const LogMarker& marker = markers_[hit.pattern];
+        size_t value_start = std::min(end, hit.offset + marker.text.size());
+        size_t value_end = end;
+        if (marker.until != '\0') {
+            value_end = std::min(end, text.find(marker.until, value_start));
+        }
+        LogEvent event;
+        event.file = file.path;
+        event.marker = marker.name;
+        event.value = std::string(trim_cr(text.substr(value_start, value_end - value_start)));
+        event.line = std::string(line);
+        event.offset = base + start;
+        event.read_at = now;
+        events.push_back(std::move(event));
+    }
+}
+
+void LogTailer::read_locked(File& file, std::vector<LogEvent>& events) {
+    chunk_.resize(options_.read_chunk);
+    file.stream.clear();
+    file.stream.seekg(static_cast<std::streamoff>(file.offset));
+    for (;;) {
+        file.stream.read(chunk_.data(), static_cast<std::streamsize>(chunk_.size()));
+        auto n = static_cast<size_t>(file.stream.gcount());
+        if (n == 0) break;
+        ++stats_.reads;
+        stats_.bytes += n;
+        file.offset += n;
+
+        std::string_view data(chunk_.data(), n);
+        if (file.discarding) {
+            size_t newline = data.find('\n');
+            if (newline == std::string_view::npos) continue;
+            data.remove_prefix(newline + 1);
+            file.discarding = false;
+        }
+        file.partial.append(data);
+
+        size_t last = file.partial.rfind('\n');
+        if (last == std::string::npos) {
+            if (file.partial.size() > options_.max_line) {
+                file.partial.clear();
+                file.discarding = true;
+            }
+            continue;
+        }
+        uint64_t base = file.offset - file.partial.size();
+        scan_locked(file, std::string_view(file.partial).substr(0, last + 1), base, events);
+        file.partial.erase(0, last + 1);
+        if (n < chunk_.size()) break;
+    }
+}
+
+void LogTailer::drain_locked(File& file, std::vector<LogEvent>& events) {
+    file.dirty = false;
+    uint64_t size = 0;
+    uint64_t identity = 0;
+    if (!stat_file(file.path, size, identity)) {
+        if (file.stream.is_open()) {
+            // Deleted or moved away: finish what was written to it.
+            read_locked(file, events);
+            file.stream.close();
+            file.offset = 0;
+            file.partial.clear();
+            file.discarding = false;
+            ++stats_.rotations;
+        }
+        return;
+    }
+
+    if (file.stream.is_open() && identity != file.identity) {
+        // Replaced under the same name: finish the old file, then follow
+        // the new one from its start.
+        read_locked(file, events);
+        file.stream.close();
+        file.offset = 0;
+        file.partial.clear();
+        file.discarding = false;
+        ++stats_.rotations;
+    }
+    if (!file.stream.is_open()) {
+        file.stream.open(file.path, std::ios::binary);
+        if (!file.stream.is_open()) return;
+        // A file other than the one watch() measured is read from its start.
+        if (identity != file.identity) file.offset = 0;
+        file.identity = identity;
+    }
+    if (size < file.offset) {
+        file.offset = 0;
+        file.partial.clear();
+        file.discarding = false;
+        ++stats_.truncations;
+    }
+    if (size > file.offset) read_locked(file, events);
+}
+
+size_t LogTailer::publish(std::vector<LogEvent>& events) {
+    if (events.empty()) return 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.events += events.size();
+    }
+    // Call a snapshot without the lock held, so listeners can subscribe or
+    // unsubscribe.
+    std::vector<Listener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        listeners.reserve(listeners_.size());
+        for (const auto& [id, listener] : listeners_) listeners.push_back(listener);
+    }
+    for (const auto& event : events) {
+        for (const auto& listener : listeners) listener(event);
+    }
+    return events.size();
+}
+
+size_t LogTailer::poll(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> round(poll_mutex_);
+    wait_for_changes(timeout);
+    std::vector<LogEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [path, file] : files_) {
+            if (file->dirty) drain_locked(*file, events);
+        }
+    }
+    return publish(events);
+}
+
+size_t LogTailer::poll_now() {
+    std::lock_guard<std::mutex> round(poll_mutex_);
+    std::vector<LogEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [path, file] : files_) drain_locked(*file, events);
+    }
+    return publish(events);
+}
+
+void LogTailer::run() {
+    while (running_) poll(std::chrono::milliseconds(100));
+}
+
+void LogTailer::start() {
+    if (running_.exchange(true)) return;
+    worker_ = std::thread([this] { run(); });
+}
+
+void LogTailer::stop() {
+    running_ = false;
+    if (worker_.joinable()) worker_.join();
+}
+
+LogTailerStats LogTailer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace ram
@@ -1,13 +1,69 @@
+#include <exception>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "ram/account.h"
+#include "ram/account_merge.h"
 #include "ram/ini_file.h"
+#include "ram/tracing.h"
 #include "ram/utilities.h"
 
-int main() {
-    std::cout << "Roblox Account Manager (C++ Edition)" << std::endl;
-    std::cout << "=====================================" << std::endl;
-    std::cout << "Core library loaded successfully." << std::endl;
-    std::cout << "MD5 of 'test': " << ram::md5("test") << std::endl;
+namespace {
+
+int merge_files(const std::string& output, const std::vector<std::string>& inputs) {
+    ram::AccountMerger merger;
+    try {
+        for (const auto& input : inputs) merger.add_file(input);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (!merger.save(output)) {
+        std::cerr << "Cannot write " << output << std::endl;
+        return 1;
+    }
+    ram::MergeStats stats = merger.stats();
+    std::cout << "Merged " << stats.read << " accounts from " << stats.inputs << " files into "
+              << merger.accounts().size() << " (" << stats.replaced
+              << " replaced by newer copies)" << std::endl;
     return 0;
 }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    // --trace=<file>: record spans and write them as Chrome trace JSON on exit.
+    // --merge=<out> <in>...: merge plain AccountData files into <out>.
+    std::string trace_path;
+    std::string merge_path;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.rfind("--trace=", 0) == 0) {
+            trace_path = std::string(arg.substr(8));
+        } else if (arg.rfind("--merge=", 0) == 0) {
+            merge_path = std::string(arg.substr(8));
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+    if (!trace_path.empty()) ram::Tracer::global().enable();
+
+    int status = 0;
+    if (!merge_path.empty()) {
+        status = merge_files(merge_path, inputs);
+    } else {
+        std::cout << "Roblox Account Manager (C++ Edition)" << std::endl;
+        std::cout << "=====================================" << std::endl;
+        std::cout << "Core library loaded successfully." << std::endl;
+        std::cout << "MD5 of 'test': " << ram::md5("test") << std::endl;
+    }
+
+    if (!trace_path.empty() && !ram::Tracer::global().write_chrome_json(trace_path)) {
+        std::cerr << "Cannot write trace to " << trace_path << std::endl;
+        return 1;
+    }
+    return status;
+}
@@ -0,0 +1,103 @@
+#include "ram/memory_accounting.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+
+namespace ram {
+
+namespace {
+
+constexpr size_t kTags = static_cast<size_t>(MemoryTag::Count);
+
+// Constant-initialized, so the hook can record allocations made before
+// dynamic initialization.
+struct alignas(64) TagCounters {
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<int64_t> live_blocks{0};
+    std::atomic<int64_t> peak_bytes{0};
+    std::atomic<uint64_t> allocations{0};
+};
+
+std::array<TagCounters, kTags> counters;
+std::atomic<bool> hooked{false};
+thread_local MemoryTag current_tag = MemoryTag::Untagged;
+
+}  // namespace
+
+const char* to_string(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::Untagged: return "untagged";
+        case MemoryTag::Accounts: return "accounts";
+        case MemoryTag::Fields: return "fields";
+        case MemoryTag::Ini: return "ini";
+        case MemoryTag::Crypto: return "crypto";
+        case MemoryTag::Caches: return "caches";
+        default: return "unknown";
+    }
+}
+
+MemoryScope::MemoryScope(MemoryTag tag) : previous_(current_tag) { current_tag = tag; }
+
+MemoryScope::~MemoryScope() { current_tag = previous_; }
+
+MemoryTag current_memory_tag() { return current_tag; }
+
+void memory_hook_installed() { hooked.store(true, std::memory_order_relaxed); }
+
+void record_allocation(MemoryTag tag, size_t bytes) {
+    TagCounters& c = counters[static_cast<size_t>(tag)];
+    auto size = static_cast<int64_t>(bytes);
+    int64_t live = c.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    c.live_blocks.fetch_add(1, std::memory_order_relaxed);
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !c.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void record_deallocation(MemoryTag tag, size_t bytes) {
+    TagCounters& c = counters[static_cast<size_t>(tag)];
+    c.live_bytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    c.live_blocks.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int64_t MemoryReport::live_bytes() const {
+    int64_t total = 0;
+    for (const auto& usage : tags) total += usage.live_bytes;
+    return total;
+}
+
+std::string MemoryReport::to_string() const {
+    if (!hooked) return "memory accounting unavailable (ram_memory_hook not linked)\n";
+    std::string out;
+    char line[160];
+    for (const auto& usage : tags) {
+        std::snprintf(line, sizeof(line),
+                      "%-9s live=%12lld bytes  blocks=%9lld  peak=%12lld bytes  allocs=%llu\n",
+                      ram::to_string(usage.tag), static_cast<long long>(usage.live_bytes),
+                      static_cast<long long>(usage.live_blocks),
+                      static_cast<long long>(usage.peak_bytes),
+                      static_cast<unsigned long long>(usage.allocations));
+        out += line;
+    }
+    return out;
+}
+
+MemoryReport memory_report() {
+    MemoryReport report;
+    report.hooked = hooked.load(std::memory_order_relaxed);
+    report.tags.resize(kTags);
+    for (size_t i = 0; i < kTags; ++i) {
+        MemoryTagUsage& usage = report.tags[i];
+        usage.tag = static_cast<MemoryTag>(i);
+        usage.live_bytes = counters[i].live_bytes.load(std::memory_order_relaxed);
+        usage.live_blocks = counters[i].live_blocks.load(std::memory_order_relaxed);
+        usage.peak_bytes = counters[i].peak_bytes.load(std::memory_order_relaxed);
+        usage.allocations = counters[i].allocations.load(std::memory_order_relaxed);
+    }
+    return report;
+}
+
+}  // namespace ram
@@ -0,0 +1,93 @@
+// Global operator new/delete replacement behind ram_memory_hook. Each
+// block carries a small header with its size and the MemoryTag it was
+// allocated under, so frees are charged back to the right subsystem.
+// Linked only into programs that ask for memory accounting.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "ram/memory_accounting.h"
+
+namespace {
+
+struct Header {
+    uint64_t size;
+    uint32_t offset;  // from the malloc'd start to the user pointer
+    uint8_t tag;
+};
+
+constexpr size_t kMinAlign = alignof(std::max_align_t);
+
+void* allocate(size_t size, size_t align) {
+    if (align < kMinAlign) align = kMinAlign;
+    size_t room = sizeof(Header) + align - 1;
+    if (size > SIZE_MAX - room) return nullptr;
+    void* raw = std::malloc(size + room);
+    if (raw == nullptr) return nullptr;
+    auto start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t user = (start + sizeof(Header) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    auto* header = reinterpret_cast<Header*>(user - sizeof(Header));
+    header->size = size;
+    header->offset = static_cast<uint32_t>(user - start);
+    ram::MemoryTag tag = ram::current_memory_tag();
+    header->tag = static_cast<uint8_t>(tag);
+    ram::record_allocation(tag, size);
+    return reinterpret_cast<void*>(user);
+}
+
+void* allocate_or_throw(size_t size, size_t align) {
+    for (;;) {
+        if (void* p = allocate(size, align)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void release(void* p) noexcept {
+    if (p == nullptr) return;
+    auto user = reinterpret_cast<uintptr_t>(p);
+    auto* header = reinterpret_cast<Header*>(user - sizeof(Header));
+    ram::record_deallocation(static_cast<ram::MemoryTag>(header->tag), header->size);
+    std::free(reinterpret_cast<void*>(user - header->offset));
+}
+
+[[maybe_unused]] const bool installed = (ram::memory_hook_installed(), true);
+
+}  // namespace
+
+void* operator new(size_t size) { return allocate_or_throw(size, kMinAlign); }
+void* operator new[](size_t size) { return allocate_or_throw(size, kMinAlign); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, kMinAlign);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, kMinAlign);
+}
+void* operator new(size_t size, std::align_val_t align) {
+    return allocate_or_throw(size, static_cast<size_t>(align));
+}
+void* operator new[](size_t size, std::align_val_t align) {
+    return allocate_or_throw(size, static_cast<size_t>(align));
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<size_t>(align));
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
@@ -0,0 +1,201 @@
+#include "ram/metrics.h"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace ram {
+
+namespace {
+
+// Histogram buckets exported as `le` bounds: 2^10ns (~1us) to 2^34ns (~17s).
+constexpr int kFirstBoundBit = 10;
+constexpr int kLastBoundBit = 34;
+
+bool valid_name(const std::string& name) {
+    if (name.empty()) return false;
+    for (size_t i = 0; i < name.size(); ++i) {
+        char c = name[i];
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        if (!alpha && (i == 0 || c < '0' || c > '9')) return false;
+    }
+    return true;
+}
+
+std::string escape_help(const std::string& help) {
+    std::string out;
+    for (char c : help) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string format_double(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.12g", value);
+    return buffer;
+}
+
+// `name{labels}` with `extra` appended to the label set.
+std::string series_name(const std::string& name, const std::string& labels,
+                        const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) return name;
+    std::string out = name + "{" + labels;
+    if (!labels.empty() && !extra.empty()) out += ",";
+    return out + extra + "}";
+}
+
+const char* type_name(int kind) {
+    static const char* const kNames[] = {"counter", "gauge", "histogram"};
+    return kNames[kind];
+}
+
+}  // namespace
+
+size_t next_metrics_shard() {
+    static std::atomic<size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& cell : cells_) total += cell.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Counter::reset() {
+    for (auto& cell : cells_) cell.value.store(0, std::memory_order_relaxed);
+}
+
+Histogram LatencyHistogram::snapshot() const {
+    Histogram out;
+    for (const auto& shard : shards_) out.merge(shard);
+    return out;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& shard : shards_) shard.reset();
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(const std::string& name,
+                                                 const std::string& help,
+                                                 const std::string& labels, Kind kind) {
+    if (!valid_name(name)) throw std::invalid_argument("Invalid metric name: " + name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = families_.try_emplace(name);
+    Family& family = it->second;
+    if (inserted) {
+        family.kind = kind;
+        family.help = help;
+    } else if (family.kind != kind) {
+        throw std::invalid_argument("Metric " + name + " is already registered as a " +
+                                    type_name(static_cast<int>(family.kind)));
+    }
+    for (auto& existing : family.series) {
+        if (existing->labels == labels) return *existing;
+    }
+    auto created = std::make_unique<Series>();
+    created->labels = labels;
+    switch (kind) {
+        case Kind::Counter: created->counter = std::make_unique<Counter>(); break;
+        case Kind::Gauge: created->gauge = std::make_unique<Gauge>(); break;
+        case Kind::Histogram: created->histogram = std::make_unique<LatencyHistogram>(); break;
+    }
+    family.series.push_back(std::move(created));
+    return *family.series.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                  const std::string& labels) {
+    return *series(name, help, labels, Kind::Counter).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const std::string& labels) {
+    return *series(name, help, labels, Kind::Gauge).gauge;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                             const std::string& labels) {
+    return *series(name, help, labels, Kind::Histogram).histogram;
+}
+
+std::string MetricsRegistry::render_prometheus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    for (const auto& [name, family] : families_) {
+        out += "# HELP " + name + " " + escape_help(family.help) + "\n";
+        out += "# TYPE " + name + " " + type_name(static_cast<int>(family.kind)) + "\n";
+        for (const auto& s : family.series) {
+            switch (family.kind) {
+                case Kind::Counter:
+                    out += series_name(name, s->labels) + " " +
+                           std::to_string(s->counter->value()) + "\n";
+                    break;
+                case Kind::Gauge:
+                    out += series_name(name, s->labels) + " " +
+                           std::to_string(s->gauge->value()) + "\n";
+                    break;
+                case Kind::Histogram: {
+                    Histogram h = s->histogram->snapshot();
+                    uint64_t cumulative = 0;
+                    size_t index = 0;
+                    for (int bit = kFirstBoundBit; bit <= kLastBoundBit; ++bit) {
+                        // Buckets below index(2^bit) hold only values < 2^bit.
+                        size_t end = Histogram::bucket_index(uint64_t{1} << bit);
+                        for (; index < end; ++index) cumulative += h.bucket_count(index);
+                        double bound = std::ldexp(1.0, bit) / 1e9;
+                        std::string le = "le=\"" + format_double(bound) + "\"";
+                        out += series_name(name + "_bucket", s->labels, le) + " " +
+                               std::to_string(cumulative) + "\n";
+                    }
+                    out += series_name(name + "_bucket", s->labels, "le=\"+Inf\"") + " " +
+                           std::to_string(h.count()) + "\n";
+                    out += series_name(name + "_sum", s->labels) + " " +
+                           format_double(static_cast<double>(h.sum()) * 1e-9) + "\n";
+                    out += series_name(name + "_count", s->labels) + " " +
+                           std::to_string(h.count()) + "\n";
+                    break;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+const CoreMetrics& core_metrics() {
+    static const CoreMetrics metrics = [] {
+        MetricsRegistry& r = MetricsRegistry::global();
+        return CoreMetrics{
+            r.histogram("ram_account_load_seconds", "Time to load the account file."),
+            r.counter("ram_account_load_failures_total", "Account file loads that failed."),
+            r.histogram("ram_account_save_seconds", "Time to save the account file."),
+            r.counter("ram_account_save_failures_total", "Account file saves that failed."),
+            r.histogram("ram_crypto_seconds", "Time spent in encrypt and decrypt.",
+                        "operation=\"encrypt\""),
+            r.histogram("ram_crypto_seconds", "Time spent in encrypt and decrypt.",
+                        "operation=\"decrypt\""),
+            r.histogram("ram_kdf_seconds", "Time spent deriving file keys with Argon2."),
+            r.counter("ram_crypto_failures_total", "Encryptions and decryptions that failed."),
+            r.histogram("ram_ini_load_seconds", "Time to parse an INI file."),
+            r.counter("ram_ini_load_bytes_total", "Bytes of INI text parsed."),
+            r.histogram("ram_hash_seconds", "Time spent hashing.", "algorithm=\"md5\""),
+            r.histogram("ram_hash_seconds", "Time spent hashing.", "algorithm=\"sha256\""),
+            r.counter("ram_hashed_bytes_total", "Bytes hashed by md5 and sha256."),
+        };
+    }();
+    return metrics;
+}
+
+}  // namespace ram
@@ -0,0 +1,247 @@
+#include "ram/nexus_protocol.h"
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+namespace ram {
+
+namespace {
+
+// Index + 1 is the wire id. Append only: ids are part of the protocol.
+constexpr std::string_view kCommands[] = {
+    "ping",          "Log",           "GetText",       "SetRelaunch", "SetAutoRelaunch",
+    "SetPlaceId",    "SetJobId",      "Echo",          "CreateButton", "CreateTextBox",
+    "CreateNumeric", "CreateLabel",   "NewLine",
+};
+constexpr std::string_view kKeys[] = {
+    "Content", "Name", "Seconds", "Margin", "Size", "DecimalPlaces", "Increment",
+};
+constexpr size_t kCommandCount = std::size(kCommands);
+constexpr size_t kKeyCount = std::size(kKeys);
+constexpr size_t kMaxLocalKeys = 32;
+
+template <size_t N>
+size_t find_known(const std::string_view (&table)[N], std::string_view name) {
+    for (size_t i = 0; i < N; ++i) {
+        if (table[i] == name) return i + 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+// --- JSON ---
+
+std::optional<NexusCommand> parse_json_command(std::string_view text) {
+    auto json = nlohmann::json::parse(text, nullptr, false);
+    if (json.is_discarded() || !json.is_object()) return std::nullopt;
+    auto name = json.find("Name");
+    if (name == json.end() || !name->is_string()) return std::nullopt;
+
+    NexusCommand command;
+    command.name = name->get<std::string>();
+    auto payload = json.find("Payload");
+    if (payload != json.end() && payload->is_object()) {
+        for (const auto& [key, value] : payload->items()) {
+            if (value.is_string()) command.payload.emplace(key, value.get<std::string>());
+        }
+    }
+    return command;
+}
+
+std::string serialize_json_command(const NexusCommand& command) {
+    nlohmann::json json = {{"Name", command.name}};
+    json["Payload"] = command.payload;
+    return json.dump();
+}
+
+// --- NexusArena ---
+
+void* NexusArena::allocate_bytes(size_t size, size_t align) {
+    if (!blocks_.empty()) {
+        size_t offset = (used_ + align - 1) & ~(align - 1);
+        if (offset + size <= blocks_.back().size) {
+            used_ = offset + size;
+            return blocks_.back().data.get() + offset;
+        }
+    }
+    size_t block = std::max(block_size_, size + align);
+    blocks_.push_back({std::make_unique<std::byte[]>(block), block});
+    used_ = size;
+    // operator new[] memory is aligned for any fundamental type.
+    return blocks_.back().data.get();
+}
+
+void NexusArena::reset() {
+    if (blocks_.size() > 1) {
+        // Coalesce so the next round of the same size fits in one block.
+        size_t total = capacity();
+        blocks_.clear();
+        blocks_.push_back({std::make_unique<std::byte[]>(total), total});
+    }
+    used_ = 0;
+}
+
+size_t NexusArena::capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) total += block.size;
+    return total;
+}
+
+std::optional<std::string_view> NexusCommandView::get(std::string_view key) const {
+    for (size_t i = 0; i < field_count; ++i) {
+        if (fields[i].key == key) return fields[i].value;
+    }
+    return std::nullopt;
+}
+
+// --- NexusBinaryEncoder ---
+
+void NexusBinaryEncoder::begin() {
+    buffer_.clear();
+    buffer_ += static_cast<char>(kVersion);
+    commands_ = 0;
+    local_key_count_ = 0;
+}
+
+void NexusBinaryEncoder::put_varint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer_ += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buffer_ += static_cast<char>(value);
+}
+
+void NexusBinaryEncoder::put_string(std::string_view text) {
+    put_varint(text.size());
+    buffer_.append(text);
+}
+
+void NexusBinaryEncoder::put_key(std::string_view key) {
+    if (size_t known = find_known(kKeys, key)) {
+        put_varint(known);
+        return;
+    }
+    for (size_t i = 0; i < local_key_count_; ++i) {
+        auto [offset, length] = local_keys_[i];
+        if (buffer_.compare(offset, length, key) == 0) {
+            put_varint(kKeyCount + 1 + i);
+            return;
+        }
+    }
+    put_varint(0);
+    put_varint(key.size());
+    if (local_key_count_ < kMaxLocalKeys) local_keys_[local_key_count_++] = {buffer_.size(), key.size()};
+    buffer_.append(key);
+}
+
+void NexusBinaryEncoder::add(std::string_view name, const NexusField* fields, size_t count) {
+    if (buffer_.empty()) begin();
+    if (size_t known = find_known(kCommands, name)) {
+        put_varint(known);
+    } else {
+        put_varint(0);
+        put_string(name);
+    }
+    put_varint(count);
+    for (size_t i = 0; i < count; ++i) {
+        put_key(fields[i].key);
+        put_string(fields[i].value);
+    }
+    ++commands_;
+}
+
+void NexusBinaryEncoder::add(const NexusCommand& command) {
+    if (buffer_.empty()) begin();
+    size_t known = find_known(kCommands, command.name);
+    if (known) {
+        put_varint(known);
+    } else {
+        put_varint(0);
+        put_string(command.name);
+    }
+    put_varint(command.payload.size());
+    for (const auto& [key, value] : command.payload) {
+        put_key(key);
+        put_string(value);
+    }
+    ++commands_;
+}
+
+// --- NexusFrameReader ---
+
+NexusFrameReader::NexusFrameReader(std::string_view frame) : data_(frame) {
+    if (data_.empty() || static_cast<uint8_t>(data_[0]) != NexusBinaryEncoder::kVersion) {
+        error_ = true;
+    } else {
+        pos_ = 1;
+    }
+}
+
+bool NexusFrameReader::get_varint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos_ >= data_.size()) return false;
+        auto byte = static_cast<uint8_t>(data_[pos_++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool NexusFrameReader::get_string(std::string_view& out) {
+    uint64_t length = 0;
+    if (!get_varint(length) || length > data_.size() - pos_) return false;
+    out = data_.substr(pos_, static_cast<size_t>(length));
+    pos_ += static_cast<size_t>(length);
+    return true;
+}
+
+bool NexusFrameReader::get_key(std::string_view& out) {
+    uint64_t ref = 0;
+    if (!get_varint(ref)) return false;
+    if (ref == 0) {
+        if (!get_string(out)) return false;
+        if (local_key_count_ < kMaxLocalKeys) local_keys_[local_key_count_++] = out;
+        return true;
+    }
+    if (ref <= kKeyCount) {
+        out = kKeys[ref - 1];
+        return true;
+    }
+    if (ref - kKeyCount - 1 >= local_key_count_) return false;
+    out = local_keys_[ref - kKeyCount - 1];
+    return true;
+}
+
+bool NexusFrameReader::next(NexusArena& arena, NexusCommandView& out) {
+    if (error_ || pos_ >= data_.size()) return false;
+    auto fail = [&] {
+        error_ = true;
+        return false;
+    };
+
+    uint64_t id = 0;
+    if (!get_varint(id)) return fail();
+    if (id == 0) {
+        if (!get_string(out.name)) return fail();
+    } else if (id <= kCommandCount) {
+        out.name = kCommands[id - 1];
+    } else {
+        return fail();
+    }
+
+    uint64_t count = 0;
+    // Every field takes at least two bytes, which bounds the allocation.
+    if (!get_varint(count) || count > (data_.size() - pos_) / 2) return fail();
+    auto* fields = count ? arena.allocate<NexusField>(static_cast<size_t>(count)) : nullptr;
+    for (size_t i = 0; i < count; ++i) {
+        if (!get_key(fields[i].key) || !get_string(fields[i].value)) return fail();
+    }
+    out.fields = fields;
+    out.field_count = static_cast<size_t>(count);
+    return true;
+}
+
+}  // namespace ram
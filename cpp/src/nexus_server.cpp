@@ -0,0 +1,535 @@
+#include "ram/nexus_server.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+#include "ram/http.h"
+
+namespace ram {
+
+namespace {
+
+constexpr uint64_t kListenerId = UINT64_MAX;
+constexpr uint64_t kWakeId = UINT64_MAX - 1;
+// Requests larger than this cannot be a WebSocket handshake.
+constexpr size_t kMaxHandshakeBytes = 16384;
+
+bool contains_token(const std::string* header, std::string_view token) {
+    if (header == nullptr) return false;
+    std::string value = *header;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value.find(token) != std::string::npos;
+}
+
+WebSocketFrame rejection(int status) {
+    HttpResponse response;
+    response.status = status;
+    response.headers.emplace_back("Connection", "close");
+    return std::make_shared<const std::string>(serialize_http_response(response));
+}
+
+const WebSocketFrame& ping_frame() {
+    static const WebSocketFrame kPing = encode_websocket_frame(WsOpcode::Ping, "");
+    return kPing;
+}
+
+}  // namespace
+
+NexusServer::NexusServer(NexusServerOptions options) : options_(std::move(options)) {}
+
+NexusServer::~NexusServer() { stop(); }
+
+void NexusServer::start() {
+    if (running_) return;
+    listener_ = Socket::listen(options_.host, options_.port);
+    listener_.set_nonblocking(true);
+    port_ = listener_.local_port();
+
+    auto [wake_write, wake_read] = Socket::pair();
+    wake_write_ = std::move(wake_write);
+    wake_read_ = std::move(wake_read);
+    wake_read_.set_nonblocking(true);
+
+    poller_ = std::make_unique<Poller>();
+    poller_->add(listener_.handle(), kListenerId);
+    poller_->add(wake_read_.handle(), kWakeId);
+
+    running_ = true;
+    loop_thread_ = std::thread([this] { event_loop(); });
+}
+
+void NexusServer::stop() {
+    if (!running_.exchange(false)) return;
+    wake();
+    if (loop_thread_.joinable()) loop_thread_.join();
+
+    clients_.clear();
+    flush_list_.clear();
+    outgoing_.clear();
+    poller_.reset();
+    listener_.close();
+    wake_read_.close();
+    wake_write_.close();
+
+    loop_stats_.clients = 0;
+    publish_stats();
+}
+
+NexusServerStats NexusServer::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void NexusServer::publish_stats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_ = loop_stats_;
+}
+
+// --- Sending ---
+
+void NexusServer::send(uint64_t client, std::string_view message) {
+    post({{client}, encode_websocket_frame(WsOpcode::Text, message)});
+}
+
+void NexusServer::send(std::vector<uint64_t> clients, std::string_view message) {
+    if (clients.empty()) return;
+    post({std::move(clients), encode_websocket_frame(WsOpcode::Text, message)});
+}
+
+void NexusServer::broadcast(std::string_view message) {
+    post({{}, encode_websocket_frame(WsOpcode::Text, message)});
+}
+
+void NexusServer::send_frame(std::vector<uint64_t> clients, WebSocketFrame frame) {
+    post({std::move(clients), std::move(frame)});
+}
+
+void NexusServer::disconnect(uint64_t client) {
+    Outgoing outgoing;
+    outgoing.targets.push_back(client);
+    outgoing.disconnect = true;
+    post(std::move(outgoing));
+}
+
+void NexusServer::post(Outgoing outgoing) {
+    // Handlers run on the event thread and can queue directly; the loop
+    // flushes once they return.
+    if (std::this_thread::get_id() == loop_id_.load()) {
+        dispatch(std::move(outgoing));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(outgoing_mutex_);
+        outgoing_.push_back(std::move(outgoing));
+    }
+    wake();
+}
+
+void NexusServer::wake() {
+    if (wake_pending_.exchange(true)) return;
+    char byte = 1;
+    ConstBuffer buf{&byte, 1};
+    wake_write_.send_nowait(&buf, 1);
+}
+
+void NexusServer::drain_outgoing() {
+    std::vector<Outgoing> pending;
+    {
+        std::lock_guard<std::mutex> lock(outgoing_mutex_);
+        pending.swap(outgoing_);
+    }
+    for (auto& outgoing : pending) dispatch(std::move(outgoing));
+}
+
+void NexusServer::dispatch(Outgoing outgoing) {
+    if (outgoing.disconnect) {
+        for (uint64_t id : outgoing.targets) {
+            auto it = clients_.find(id);
+            if (it == clients_.end()) continue;
+            it->second.closing = true;
+            if (!it->second.dirty) {
+                it->second.dirty = true;
+                flush_list_.push_back(id);
+            }
+        }
+        return;
+    }
+
+    size_t delivered = 0;
+    if (outgoing.targets.empty()) {
+        for (auto& [id, client] : clients_) delivered += enqueue(id, client, outgoing.frame);
+    } else {
+        for (uint64_t id : outgoing.targets) {
+            auto it = clients_.find(id);
+            if (it != clients_.end()) delivered += enqueue(id, it->second, outgoing.frame);
+        }
+    }
+    if (outgoing.targets.size() != 1) ++loop_stats_.broadcasts;
+    loop_stats_.frames_queued += delivered;
+}
+
+bool NexusServer::enqueue(uint64_t id, Client& client, const WebSocketFrame& frame) {
+    if (!client.upgraded || client.closing) return false;
+
+    if (client.queued_bytes + frame->size() > options_.max_queued_bytes) {
+        // Slow consumer: drop what it has not read and disconnect it.
+        client.out.clear();
+        client.out_offset = 0;
+        client.queued_bytes = 0;
+        client.closing = true;
+        ++loop_stats_.slow_consumers_evicted;
+    } else {
+        client.out.push_back(frame);
+        client.queued_bytes += frame->size();
+    }
+    if (!client.dirty) {
+        client.dirty = true;
+        flush_list_.push_back(id);
+    }
+    return !client.closing;
+}
+
+void NexusServer::queue_raw(uint64_t id, Client& client, WebSocketFrame frame) {
+    client.queued_bytes += frame->size();
+    client.out.push_back(std::move(frame));
+    if (!client.dirty) {
+        client.dirty = true;
+        flush_list_.push_back(id);
+    }
+}
+
+void NexusServer::flush() {
+    // Indexed loop: a disconnect handler may queue more work.
+    for (size_t i = 0; i < flush_list_.size(); ++i) {
+        auto it = clients_.find(flush_list_[i]);
+        if (it == clients_.end()) continue;
+        it->second.dirty = false;
+        write_ready(it->first, it->second);
+    }
+    flush_list_.clear();
+}
+
+void NexusServer::write_ready(uint64_t id, Client& client) {
+    while (!client.out.empty()) {
+        ConstBuffer buffers[16];
+        size_t count = 0;
+        for (auto it = client.out.begin(); it != client.out.end() && count < 16; ++it) {
+            size_t skip = count == 0 ? client.out_offset : 0;
+            buffers[count++] = {(*it)->data() + skip, (*it)->size() - skip};
+        }
+
+        ptrdiff_t sent = client.socket.send_nowait(buffers, count);
+        if (sent == Socket::kWouldBlock) {
+            if (!client.want_write) {
+                poller_->set_writable(client.socket.handle(), id, true);
+                client.want_write = true;
+            }
+            return;
+        }
+        if (sent < 0) {
+            close_client(id);
+            return;
+        }
+        ++loop_stats_.writes;
+        loop_stats_.bytes_sent += static_cast<uint64_t>(sent);
+
+        auto remaining = static_cast<size_t>(sent);
+        while (remaining > 0 && !client.out.empty()) {
+            size_t left = client.out.front()->size() - client.out_offset;
+            if (remaining < left) {
+                client.out_offset += remaining;
+                client.queued_bytes -= remaining;
+                remaining = 0;
+            } else {
+                remaining -= left;
+                client.queued_bytes -= left;
+                client.out_offset = 0;
+                client.out.pop_front();
+            }
+        }
+    }
+
+    if (client.want_write) {
+        poller_->set_writable(client.socket.handle(), id, false);
+        client.want_write = false;
+    }
+    if (client.closing) close_client(id);
+}
+
+// --- Event loop ---
+
+void NexusServer::event_loop() {
+    loop_id_.store(std::this_thread::get_id());
+    std::vector<Poller::Event> events;
+
+    auto period = std::min(options_.ping_interval, options_.timeout) / 4;
+    period = std::clamp(period, std::chrono::milliseconds(10), std::chrono::milliseconds(1000));
+    auto next_sweep = std::chrono::steady_clock::now() + period;
+
+    while (running_) {
+        poller_->wait(period, events);
+        for (const auto& ev : events) {
+            if (ev.id == kListenerId) {
+                accept_ready();
+                continue;
+            }
+            if (ev.id == kWakeId) {
+                char sink[64];
+                while (wake_read_.recv_nowait(sink, sizeof(sink)) > 0) {
+                }
+                wake_pending_ = false;
+                drain_outgoing();
+                continue;
+            }
+
+            auto it = clients_.find(ev.id);
+            if (it == clients_.end()) continue;
+            if (ev.writable) write_ready(ev.id, it->second);
+            it = clients_.find(ev.id);
+            if (it == clients_.end()) continue;
+            if (ev.readable || ev.error) read_ready(ev.id, it->second);
+        }
+        flush();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_sweep) {
+            sweep();
+            flush();
+            next_sweep = now + period;
+        }
+        publish_stats();
+    }
+}
+
+void NexusServer::accept_ready() {
+    for (;;) {
+        Socket socket = listener_.accept();
+        if (!socket.valid()) return;
+        socket.set_nonblocking(true);
+        socket.set_nodelay(true);
+
+        uint64_t id = next_id_++;
+        poller_->add(socket.handle(), id);
+        Client& client = clients_[id];
+        client.info.id = id;
+        client.info.from_loopback = socket.peer_is_loopback();
+        client.socket = std::move(socket);
+        client.last_received = std::chrono::steady_clock::now();
+        client.last_ping = client.last_received;
+        ++loop_stats_.connections_accepted;
+    }
+}
+
+void NexusServer::read_ready(uint64_t id, Client& client) {
+    char chunk[16384];
+    for (;;) {
+        ptrdiff_t got = client.socket.recv_nowait(chunk, sizeof(chunk));
+        if (got == Socket::kWouldBlock) break;
+        if (got <= 0) {
+            close_client(id);
+            return;
+        }
+        client.in.append(chunk, static_cast<size_t>(got));
+        if (static_cast<size_t>(got) < sizeof(chunk)) break;
+    }
+    if (client.closing) {
+        client.in.clear();
+        return;
+    }
+    client.last_received = std::chrono::steady_clock::now();
+
+    if (!client.upgraded && !handshake(id, client)) return;
+    if (client.upgraded) process_frames(id, client);
+}
+
+bool NexusServer::handshake(uint64_t id, Client& client) {
+    HttpRequest request;
+    size_t consumed = 0;
+    ParseStatus status = parse_http_request(client.in, request, consumed, kMaxHandshakeBytes);
+    if (status == ParseStatus::Incomplete && client.in.size() <= kMaxHandshakeBytes) return false;
+
+    auto reject = [&](int code) {
+        ++loop_stats_.handshakes_rejected;
+        client.in.clear();
+        client.closing = true;
+        queue_raw(id, client, rejection(code));
+        return false;
+    };
+    if (status != ParseStatus::Complete) return reject(400);
+
+    std::string_view target = request.url;
+    size_t qmark = target.find('?');
+    const std::string* key = request.header("Sec-WebSocket-Key");
+    if (request.method != "GET" || target.substr(0, qmark) != options_.path ||
+        !contains_token(request.header("Upgrade"), "websocket") || key == nullptr) {
+        return reject(400);
+    }
+
+    // Like WebsocketServer.OnOpen: name and id are required, a bad id
+    // reads as 0 and a missing jobId as UNKNOWN.
+    auto query = parse_query(qmark == std::string_view::npos ? std::string_view{}
+                                                             : target.substr(qmark + 1));
+    auto name = query.find("name");
+    auto user_id = query.find("id");
+    if (name == query.end() || name->second.empty() || user_id == query.end() ||
+        user_id->second.empty()) {
+        return reject(400);
+    }
+    client.info.name = name->second;
+    const std::string& id_text = user_id->second;
+    if (std::from_chars(id_text.data(), id_text.data() + id_text.size(), client.info.user_id)
+            .ec != std::errc{}) {
+        client.info.user_id = 0;
+    }
+    auto job = query.find("jobId");
+    if (job != query.end() && !job->second.empty()) client.info.job_id = job->second;
+
+    // Binary framing is opt-in; everything else keeps talking JSON.
+    bool offered = contains_token(request.header("Sec-WebSocket-Protocol"),
+                                  kNexusBinarySubprotocol);
+    auto protocol = query.find("protocol");
+    if (offered || (protocol != query.end() && protocol->second == "binary")) {
+        client.info.protocol = NexusProtocol::Binary;
+    }
+
+    if (on_connect_ && !on_connect_(client.info)) return reject(403);
+
+    std::string head = "HTTP/1.1 101 Switching Protocols\r\n"
+                       "Upgrade: websocket\r\n"
+                       "Connection: Upgrade\r\n"
+                       "Sec-WebSocket-Accept: " +
+                       websocket_accept_key(*key) + "\r\n";
+    if (offered) head += "Sec-WebSocket-Protocol: " + std::string(kNexusBinarySubprotocol) + "\r\n";
+    head += "\r\n";
+    queue_raw(id, client, std::make_shared<const std::string>(std::move(head)));
+    client.in.erase(0, consumed);
+    client.upgraded = true;
+    ++loop_stats_.clients;
+    return true;
+}
+
+bool NexusServer::process_frames(uint64_t id, Client& client) {
+    size_t offset = 0;
+    auto fail = [&] {
+        close_client(id);
+        return false;
+    };
+
+    while (!client.closing && offset < client.in.size()) {
+        WsFrame frame;
+        size_t consumed = 0;
+        ParseStatus status =
+            parse_websocket_frame(std::string_view(client.in).substr(offset), frame, consumed,
+                                  options_.max_message_bytes);
+        if (status == ParseStatus::Incomplete) break;
+        // Clients must mask every frame.
+        if (status == ParseStatus::Error || !frame.masked) return fail();
+        offset += consumed;
+
+        switch (frame.opcode) {
+            case WsOpcode::Text:
+            case WsOpcode::Binary:
+                if (client.message_opcode != WsOpcode::Continuation) return fail();
+                client.message = std::move(frame.payload);
+                client.message_opcode = frame.opcode;
+                break;
+            case WsOpcode::Continuation:
+                if (client.message_opcode == WsOpcode::Continuation) return fail();
+                if (client.message.size() + frame.payload.size() > options_.max_message_bytes) {
+                    return fail();
+                }
+                client.message += frame.payload;
+                break;
+            case WsOpcode::Ping:
+                queue_raw(id, client, encode_websocket_frame(WsOpcode::Pong, frame.payload));
+                continue;
+            case WsOpcode::Pong:
+                continue;
+            case WsOpcode::Close:
+                // Echo the status code and close once it is written.
+                client.closing = true;
+                queue_raw(id, client,
+                          encode_websocket_frame(WsOpcode::Close,
+                                                 std::string_view(frame.payload).substr(0, 2)));
+                continue;
+        }
+
+        if (!frame.fin) continue;
+        ++loop_stats_.messages_received;
+        std::string message = std::move(client.message);
+        client.message.clear();
+        client.message_opcode = WsOpcode::Continuation;
+        // Handlers cannot remove clients from the map (closes are deferred
+        // to the flush), so `client` stays valid.
+        if (on_message_) on_message_(client.info, message);
+        if (on_command_ && !dispatch_commands(client, message)) return fail();
+    }
+
+    client.in.erase(0, offset);
+    return true;
+}
+
+bool NexusServer::dispatch_commands(const Client& client, std::string_view message) {
+    command_arena_.reset();
+    NexusCommandView view;
+    if (client.info.protocol == NexusProtocol::Json) {
+        // Unparseable text is ignored, as ControlledAccount.HandleMessage did.
+        auto command = parse_json_command(message);
+        if (!command) return true;
+        auto* fields = command_arena_.allocate<NexusField>(command->payload.size());
+        size_t count = 0;
+        for (const auto& [key, value] : command->payload) fields[count++] = {key, value};
+        view.name = command->name;
+        view.fields = fields;
+        view.field_count = count;
+        ++loop_stats_.commands_received;
+        on_command_(client.info, view);
+        return true;
+    }
+
+    NexusFrameReader reader(message);
+    while (reader.next(command_arena_, view)) {
+        ++loop_stats_.commands_received;
+        on_command_(client.info, view);
+    }
+    // A malformed batch means the client is not speaking the protocol.
+    return !reader.error();
+}
+
+void NexusServer::close_client(uint64_t id) {
+    auto it = clients_.find(id);
+    if (it == clients_.end()) return;
+    poller_->remove(it->second.socket.handle());
+    NexusClient info = std::move(it->second.info);
+    bool was_open = it->second.upgraded;
+    clients_.erase(it);
+
+    if (was_open) {
+        --loop_stats_.clients;
+        if (on_disconnect_) on_disconnect_(info);
+    }
+}
+
+void NexusServer::sweep() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<uint64_t> expired;
+    for (auto& [id, client] : clients_) {
+        auto quiet = now - client.last_received;
+        if (quiet > options_.timeout) {
+            expired.push_back(id);
+        } else if (client.upgraded && !client.closing && quiet >= options_.ping_interval &&
+                   now - client.last_ping >= options_.ping_interval) {
+            client.last_ping = now;
+            ++loop_stats_.pings_sent;
+            enqueue(id, client, ping_frame());
+        }
+    }
+    for (uint64_t id : expired) {
+        ++loop_stats_.timed_out;
+        close_client(id);
+    }
+}
+
+}  // namespace ram
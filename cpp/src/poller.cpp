@@ -0,0 +1,95 @@
+#include "ram/poller.h"
+
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+namespace ram {
+
+#ifdef __linux__
+
+namespace {
+
+void control(int epoll, int op, native_socket_t fd, uint64_t id, bool writable) {
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | (writable ? EPOLLOUT : 0u);
+    ev.data.u64 = id;
+    epoll_ctl(epoll, op, fd, &ev);
+}
+
+}  // namespace
+
+Poller::Poller() : epoll_(epoll_create1(EPOLL_CLOEXEC)) {
+    if (epoll_ < 0) throw std::runtime_error("Cannot create epoll instance");
+}
+
+Poller::~Poller() { ::close(epoll_); }
+
+void Poller::add(native_socket_t fd, uint64_t id) { control(epoll_, EPOLL_CTL_ADD, fd, id, false); }
+
+void Poller::set_writable(native_socket_t fd, uint64_t id, bool want) {
+    control(epoll_, EPOLL_CTL_MOD, fd, id, want);
+}
+
+void Poller::remove(native_socket_t fd) { epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr); }
+
+void Poller::wait(std::chrono::milliseconds timeout, std::vector<Event>& out) {
+    epoll_event events[256];
+    int n = epoll_wait(epoll_, events, 256, static_cast<int>(timeout.count()));
+    out.clear();
+    for (int i = 0; i < n; ++i) {
+        out.push_back({events[i].data.u64, (events[i].events & EPOLLIN) != 0,
+                       (events[i].events & EPOLLOUT) != 0,
+                       (events[i].events & (EPOLLERR | EPOLLHUP)) != 0});
+    }
+}
+
+#else
+
+Poller::Poller() = default;
+Poller::~Poller() = default;
+
+void Poller::add(native_socket_t fd, uint64_t id) { fds_[fd] = {id, false}; }
+
+void Poller::set_writable(native_socket_t fd, uint64_t, bool want) { fds_[fd].writable = want; }
+
+void Poller::remove(native_socket_t fd) { fds_.erase(fd); }
+
+void Poller::wait(std::chrono::milliseconds timeout, std::vector<Event>& out) {
+#ifdef _WIN32
+    std::vector<WSAPOLLFD> pfds;
+#else
+    std::vector<pollfd> pfds;
+#endif
+    std::vector<uint64_t> ids;
+    for (const auto& [fd, entry] : fds_) {
+        pfds.push_back({});
+        pfds.back().fd = fd;
+        pfds.back().events = POLLIN | (entry.writable ? POLLOUT : 0);
+        ids.push_back(entry.id);
+    }
+#ifdef _WIN32
+    int n = WSAPoll(pfds.data(), static_cast<ULONG>(pfds.size()),
+                    static_cast<int>(timeout.count()));
+#else
+    int n = ::poll(pfds.data(), pfds.size(), static_cast<int>(timeout.count()));
+#endif
+    out.clear();
+    for (size_t i = 0; n > 0 && i < pfds.size(); ++i) {
+        if (pfds[i].revents == 0) continue;
+        out.push_back({ids[i], (pfds[i].revents & POLLIN) != 0,
+                       (pfds[i].revents & POLLOUT) != 0,
+                       (pfds[i].revents & (POLLERR | POLLHUP)) != 0});
+    }
+}
+
+#endif
+
+}  // namespace ram
@@ -0,0 +1,293 @@
+#include "ram/presence.h"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+
+namespace ram {
+
+namespace {
+
+std::optional<std::vector<UserPresence>> read_batch(std::future<HttpResponse>& pending) {
+    try {
+        HttpResponse response = pending.get();
+        if (!response.ok()) return std::nullopt;
+
+        auto data = nlohmann::json::parse(response.body, nullptr, false);
+        if (data.is_discarded() || !data.contains("userPresences") ||
+            !data["userPresences"].is_array()) {
+            return std::nullopt;
+        }
+
+        std::vector<UserPresence> out;
+        out.reserve(data["userPresences"].size());
+        for (const auto& entry : data["userPresences"]) {
+            if (entry.is_object()) out.push_back(UserPresence::from_json(entry));
+        }
+        return out;
+    } catch (const HttpError&) {
+        return std::nullopt;
+    }
+}
+
+}  // namespace
+
+UserPresence UserPresence::from_json(const nlohmann::json& j) {
+    auto get_id = [&](const char* key) -> int64_t {
+        auto it = j.find(key);
+        if (it == j.end() || !it->is_number_integer()) return 0;
+        return it->get<int64_t>();
+    };
+    auto get_str = [&](const char* key) -> std::string {
+        auto it = j.find(key);
+        if (it == j.end() || !it->is_string()) return {};
+        return it->get<std::string>();
+    };
+
+    UserPresence p;
+    p.user_id = get_id("userId");
+    p.type = static_cast<PresenceType>(
+        std::clamp<int64_t>(get_id("userPresenceType"), 0, 3));
+    p.last_location = get_str("lastLocation");
+    p.place_id = get_id("placeId");
+    p.root_place_id = get_id("rootPlaceId");
+    p.universe_id = get_id("universeId");
+    p.game_id = get_str("gameId");
+    return p;
+}
+
+bool UserPresence::same_state(const UserPresence& other) const {
+    return type == other.type && place_id == other.place_id &&
+           game_id == other.game_id;
+}
+
+PresenceEngine::PresenceEngine(HttpClient& client,
+                               PresenceEngineOptions options)
+    : client_(client),
+      options_(std::move(options)),
+      budget_(options_.requests_per_second, options_.burst) {
+    if (options_.batch_size == 0) options_.batch_size = 1;
+    if (options_.max_in_flight == 0) options_.max_in_flight = 1;
+}
+
+PresenceEngine::~PresenceEngine() { stop(); }
+
+void PresenceEngine::track(int64_t user_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = users_.try_emplace(user_id);
+        if (!inserted) return;
+        it->second.interval = options_.initial_interval;
+        it->second.next_due = Clock::now();
+    }
+    cv_.notify_all();
+}
+
+void PresenceEngine::untrack(int64_t user_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    users_.erase(user_id);
+}
+
+size_t PresenceEngine::tracked() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return users_.size();
+}
+
+size_t PresenceEngine::subscribe(Listener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t id = next_listener_id_++;
+    listeners_.emplace(id, std::move(listener));
+    return id;
+}
+
+void PresenceEngine::unsubscribe(size_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listeners_.erase(id);
+}
+
+size_t PresenceEngine::poll_due() {
+    std::vector<int64_t> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        std::vector<std::pair<Clock::time_point, int64_t>> soon;
+        for (const auto& [id, user] : users_) {
+            if (user.next_due <= now) {
+                due.push_back(id);
+            } else if (user.next_due <= now + options_.batch_slack) {
+                soon.emplace_back(user.next_due, id);
+            }
+        }
+
+        // Fill the last batch with the users due soonest; the request
+        // costs the same either way and they would otherwise need their
+        // own round moments later.
+        size_t room = (options_.batch_size - due.size() % options_.batch_size) %
+                      options_.batch_size;
+        if (!due.empty() && room > 0 && !soon.empty()) {
+            room = std::min(room, soon.size());
+            std::partial_sort(soon.begin(), soon.begin() + room, soon.end());
+            for (size_t i = 0; i < room; ++i) due.push_back(soon[i].second);
+        }
+    }
+    return poll(std::move(due));
+}
+
+size_t PresenceEngine::poll_all() {
+    std::vector<int64_t> all;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        all.reserve(users_.size());
+        for (const auto& [id, user] : users_) all.push_back(id);
+    }
+    return poll(std::move(all));
+}
+
+HttpRequest PresenceEngine::batch_request(const std::vector<int64_t>& user_ids) const {
+    HttpRequest request;
+    request.method = "POST";
+    request.url = options_.endpoint;
+    request.headers.emplace_back("Content-Type", "application/json");
+    request.body = nlohmann::json{{"userIds", user_ids}}.dump();
+    return request;
+}
+
+size_t PresenceEngine::poll(std::vector<int64_t> user_ids) {
+    if (user_ids.empty()) return 0;
+    std::lock_guard<std::mutex> round(poll_mutex_);
+
+    std::vector<std::vector<int64_t>> batches;
+    for (size_t i = 0; i < user_ids.size(); i += options_.batch_size) {
+        size_t end = std::min(user_ids.size(), i + options_.batch_size);
+        batches.emplace_back(user_ids.begin() + i, user_ids.begin() + end);
+    }
+
+    // Batches go out on the client's async workers, each paying for one
+    // token of the budget. Once max_in_flight are outstanding the oldest
+    // is collected before the next is sent.
+    std::vector<std::future<HttpResponse>> pending(batches.size());
+    std::vector<std::optional<std::vector<UserPresence>>> results(batches.size());
+    size_t collected = 0;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        if (i - collected == options_.max_in_flight) {
+            results[collected] = read_batch(pending[collected]);
+            ++collected;
+        }
+        budget_.acquire();
+        pending[i] = client_.send_async(batch_request(batches[i]));
+    }
+    for (; collected < batches.size(); ++collected) {
+        results[collected] = read_batch(pending[collected]);
+    }
+
+    std::vector<PresenceChange> changes;
+    std::vector<Listener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        ++stats_.polls;
+        stats_.requests += batches.size();
+        stats_.users_polled += user_ids.size();
+
+        for (size_t b = 0; b < batches.size(); ++b) {
+            if (!results[b]) {
+                ++stats_.failed_requests;
+                for (int64_t id : batches[b]) {
+                    auto it = users_.find(id);
+                    if (it != users_.end()) it->second.next_due = now + it->second.interval;
+                }
+                continue;
+            }
+
+            std::unordered_map<int64_t, const UserPresence*> by_id;
+            by_id.reserve(results[b]->size());
+            for (const auto& p : *results[b]) by_id[p.user_id] = &p;
+
+            for (int64_t id : batches[b]) {
+                auto it = users_.find(id);
+                if (it == users_.end()) continue;  // untracked mid-poll
+                Tracked& user = it->second;
+
+                auto found = by_id.find(id);
+                bool changed = found != by_id.end() &&
+                               (!user.last || !user.last->same_state(*found->second));
+                if (changed) {
+                    changes.push_back({user.last, *found->second});
+                    user.last = *found->second;
+                    user.interval = std::max(options_.min_interval, user.interval / 2);
+                } else {
+                    if (found != by_id.end()) user.last = *found->second;
+                    user.interval = std::min(options_.max_interval,
+                                             user.interval * 3 / 2);
+                }
+                user.next_due = now + user.interval;
+            }
+        }
+
+        stats_.changes += changes.size();
+        if (!changes.empty()) {
+            for (const auto& [id, listener] : listeners_) listeners.push_back(listener);
+        }
+    }
+
+    for (const auto& listener : listeners) listener(changes);
+    return changes.size();
+}
+
+void PresenceEngine::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    worker_ = std::thread([this] { run(); });
+}
+
+void PresenceEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void PresenceEngine::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        auto next = Clock::time_point::max();
+        for (const auto& [id, user] : users_) next = std::min(next, user.next_due);
+
+        if (next > Clock::now()) {
+            if (next == Clock::time_point::max()) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, next);
+            }
+            continue;
+        }
+
+        lock.unlock();
+        poll_due();
+        lock.lock();
+    }
+}
+
+std::optional<UserPresence> PresenceEngine::presence(int64_t user_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = users_.find(user_id);
+    if (it == users_.end()) return std::nullopt;
+    return it->second.last;
+}
+
+std::chrono::milliseconds PresenceEngine::interval(int64_t user_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = users_.find(user_id);
+    return it == users_.end() ? std::chrono::milliseconds(0) : it->second.interval;
+}
+
+PresenceStats PresenceEngine::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace ram
@@ -0,0 +1,311 @@
+#include "ram/process_monitor.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace ram {
+
+namespace {
+
+// Identifies one instance of a /proc/<pid> entry: a process that reuses
+// the pid gets a new entry, with a new inode and creation time. 0 if
+// unknown.
+uint64_t entry_identity(const fs::path& path) {
+#ifdef _WIN32
+    (void)path;
+    return 0;
+#else
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) return 0;
+    uint64_t ctime = static_cast<uint64_t>(st.st_ctime);
+#ifdef __linux__
+    ctime = ctime * 1000000000u + static_cast<uint64_t>(st.st_ctim.tv_nsec);
+#endif
+    return static_cast<uint64_t>(st.st_ino) * 0x9E3779B97F4A7C15ull ^ ctime;
+#endif
+}
+
+// Split a Windows-style command line on whitespace, with double quotes
+// grouping (and removed).
+std::vector<std::string_view> split_windows(std::string_view line, std::string& storage) {
+    storage.clear();
+    storage.reserve(line.size());
+    std::vector<std::pair<size_t, size_t>> spans;
+    bool quoted = false;
+    bool in_token = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            if (!in_token) spans.emplace_back(storage.size(), storage.size());
+            in_token = true;
+            continue;
+        }
+        if (!quoted && (c == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+            in_token = false;
+            continue;
+        }
+        if (!in_token) spans.emplace_back(storage.size(), storage.size());
+        in_token = true;
+        storage += c;
+        spans.back().second = storage.size();
+    }
+    std::vector<std::string_view> out;
+    out.reserve(spans.size());
+    for (auto [begin, end] : spans) out.emplace_back(storage.data() + begin, end - begin);
+    return out;
+}
+
+std::vector<std::string_view> split_nul(std::string_view line) {
+    std::vector<std::string_view> out;
+    while (!line.empty()) {
+        size_t end = line.find('\0');
+        if (end != 0) out.push_back(line.substr(0, end));
+        if (end == std::string_view::npos) break;
+        line.remove_prefix(end + 1);
+    }
+    return out;
+}
+
+std::string_view leading_digits(std::string_view text) {
+    size_t n = 0;
+    while (n < text.size() && text[n] >= '0' && text[n] <= '9') ++n;
+    return text.substr(0, n);
+}
+
+// roblox-player:1+launchmode:play+gameinfo:<ticket>+...+browsertrackerid:<id>+...
+void parse_protocol_uri(std::string_view uri, ClientArgs& out) {
+    while (!uri.empty()) {
+        size_t end = uri.find('+');
+        std::string_view part = uri.substr(0, end);
+        size_t colon = part.find(':');
+        if (colon != std::string_view::npos) {
+            std::string_view key = part.substr(0, colon);
+            std::string_view value = part.substr(colon + 1);
+            if (key == "gameinfo" && !value.empty()) out.has_ticket = true;
+            if (key == "placelauncherurl" && !value.empty()) out.has_join_script = true;
+            if (key == "browsertrackerid") {
+                out.browser_tracker_id = std::string(leading_digits(value));
+            }
+        }
+        if (end == std::string_view::npos) break;
+        uri.remove_prefix(end + 1);
+    }
+}
+
+template <typename T>
+bool parse_number(std::string_view text, T& out) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+}  // namespace
+
+ClientArgs parse_client_args(std::string_view command_line) {
+    std::string storage;
+    std::vector<std::string_view> args = command_line.find('\0') != std::string_view::npos
+                                             ? split_nul(command_line)
+                                             : split_windows(command_line, storage);
+    ClientArgs out;
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string_view arg = args[i];
+        bool has_value = i + 1 < args.size();
+        if (arg == "-t" && has_value) {
+            out.has_ticket = true;
+        } else if (arg == "-j" && has_value) {
+            out.has_join_script = true;
+        } else if (arg == "-b" && has_value) {
+            out.browser_tracker_id = std::string(leading_digits(args[i + 1]));
+        } else if (arg.rfind("roblox-player:", 0) == 0) {
+            parse_protocol_uri(arg, out);
+        }
+    }
+    return out;
+}
+
+ProcessMonitor::ProcessMonitor(ProcessMonitorOptions options) : options_(std::move(options)) {
+#ifndef _WIN32
+    long ticks = sysconf(_SC_CLK_TCK);
+    if (ticks > 0) ticks_per_second_ = ticks;
+    long page = sysconf(_SC_PAGESIZE);
+    if (page > 0) page_size_ = page;
+#endif
+}
+
+void ProcessMonitor::sync_accounts(const AccountStore& store) {
+    uint64_t version = store.version();
+    if (indexed_version_ == version) return;
+    tracker_index_.clear();
+    store.for_each([&](const Account& account) {
+        if (!account.browser_tracker_id.empty()) {
+            tracker_index_.emplace(account.browser_tracker_id, account.username);
+        }
+    });
+    indexed_version_ = version;
+}
+
+std::optional<std::string> ProcessMonitor::read_file(const std::string& path,
+                                                     ScanCost& cost) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+    ++cost.file_reads;
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+std::optional<ProcessMonitor::Stat> ProcessMonitor::read_stat(int pid, ScanCost& cost) const {
+    auto text = read_file(options_.proc_root + "/" + std::to_string(pid) + "/stat", cost);
+    if (!text) return std::nullopt;
+
+    // "pid (comm) state ppid ...": comm may itself contain spaces and ')'.
+    size_t open = text->find('(');
+    size_t close = text->rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+        return std::nullopt;
+    }
+    Stat stat;
+    stat.comm = text->substr(open + 1, close - open - 1);
+
+    // Fields from state (field 3) on; starttime is field 22, rss field 24.
+    std::string_view rest(*text);
+    rest.remove_prefix(std::min(rest.size(), close + 2));
+    size_t field = 3;
+    while (!rest.empty() && field <= 24) {
+        size_t end = rest.find(' ');
+        std::string_view value = rest.substr(0, end);
+        if (field == 22 && !parse_number(value, stat.start_ticks)) return std::nullopt;
+        if (field == 24 && !parse_number(value, stat.rss_pages)) return std::nullopt;
+        if (end == std::string_view::npos) break;
+        rest.remove_prefix(end + 1);
+        ++field;
+    }
+    if (field < 24) return std::nullopt;
+    return stat;
+}
+
+bool ProcessMonitor::name_matches(std::string_view comm) const {
+    std::string_view name(options_.process_name);
+    return comm == name.substr(0, 15);
+}
+
+void ProcessMonitor::evaluate(const ClientProcess& client, ProcessScan& scan) {
+    const KillPolicy& policy = options_.policy;
+    if (client.age < policy.grace) return;
+
+    std::string reason;
+    if (policy.min_rss_bytes > 0 && client.rss_bytes < policy.min_rss_bytes) {
+        reason = "Low Memory (" + std::to_string(client.rss_bytes >> 20) + "MB < " +
+                 std::to_string(policy.min_rss_bytes >> 20) + "MB)";
+    } else if (policy.max_age.count() > 0 && client.age > policy.max_age) {
+        reason = "Running for " + std::to_string(client.age.count()) + "s";
+    } else if (!policy.expected_title.empty() && options_.title) {
+        std::optional<std::string> title = options_.title(client.pid);
+        if (title && *title != policy.expected_title) {
+            reason = "Window Title isn't " + policy.expected_title + ", got " + *title;
+        }
+    }
+    if (reason.empty()) return;
+
+    KillDecision decision{client.pid, client.username, std::move(reason), false};
+    if (options_.kill) {
+        decision.killed = options_.kill(client.pid);
+        if (decision.killed) ++stats_.kills;
+    }
+    scan.decisions.push_back(std::move(decision));
+}
+
+ProcessScan ProcessMonitor::scan() {
+    auto started = std::chrono::steady_clock::now();
+    ProcessScan out;
+    ScanCost& cost = out.cost;
+    uint64_t scan_id = ++scan_id_;
+
+    double uptime = 0;
+    if (auto text = read_file(options_.proc_root + "/uptime", cost)) {
+        uptime = std::strtod(text->c_str(), nullptr);
+    }
+    const auto now_ticks = static_cast<uint64_t>(uptime * static_cast<double>(ticks_per_second_));
+    const auto young_ticks = static_cast<uint64_t>(options_.recheck_young.count()) *
+                             static_cast<uint64_t>(ticks_per_second_);
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(options_.proc_root, ec)) {
+        int pid = 0;
+        if (!parse_number(entry.path().filename().string(), pid) || pid <= 0) continue;
+        ++cost.pids;
+
+        auto it = known_.find(pid);
+        uint64_t identity = entry_identity(entry.path());
+        if (it != known_.end()) {
+            it->second.seen = scan_id;
+            // Settled non-clients are not read again while their /proc
+            // entry is unchanged. Without an uptime nothing counts as
+            // settled.
+            bool settled = now_ticks > it->second.start_ticks &&
+                           now_ticks - it->second.start_ticks >= young_ticks;
+            if (!it->second.client && settled && it->second.identity == identity) continue;
+        }
+
+        std::optional<Stat> stat = read_stat(pid, cost);
+        if (!stat) continue;  // exited
+        if (it != known_.end() && it->second.start_ticks != stat->start_ticks) {
+            known_.erase(it);  // pid reused
+            it = known_.end();
+        }
+        if (it == known_.end()) {
+            ++cost.new_pids;
+            it = known_.emplace(pid, Known{stat->start_ticks, identity, scan_id, false, {}}).first;
+        }
+        Known& known = it->second;
+        known.identity = identity;
+        if (!name_matches(stat->comm)) {
+            known.client = false;
+            continue;
+        }
+        if (!known.client) {
+            auto cmdline = read_file(options_.proc_root + "/" + std::to_string(pid) + "/cmdline",
+                                     cost);
+            if (!cmdline) continue;
+            known.client = true;
+            known.args = parse_client_args(*cmdline);
+        }
+        // Helper processes and clients started by hand are left alone.
+        if (!known.args.launched()) continue;
+
+        ClientProcess client;
+        client.pid = pid;
+        client.args = known.args;
+        if (!client.args.browser_tracker_id.empty()) {
+            auto account = tracker_index_.find(client.args.browser_tracker_id);
+            if (account != tracker_index_.end()) client.username = account->second;
+        }
+        if (now_ticks > stat->start_ticks) {
+            client.age = std::chrono::seconds((now_ticks - stat->start_ticks) /
+                                              static_cast<uint64_t>(ticks_per_second_));
+        }
+        client.rss_bytes = stat->rss_pages * static_cast<uint64_t>(page_size_);
+        evaluate(client, out);
+        out.clients.push_back(std::move(client));
+    }
+
+    for (auto it = known_.begin(); it != known_.end();) {
+        it = it->second.seen == scan_id ? std::next(it) : known_.erase(it);
+    }
+
+    cost.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    ++stats_.scans;
+    stats_.file_reads += cost.file_reads;
+    stats_.elapsed += cost.elapsed;
+    return out;
+}
+
+}  // namespace ram
@@ -0,0 +1,47 @@
+#include "ram/rate_limiter.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace ram {
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : rate_(rate > 0 ? rate : 1.0),
+      burst_(burst > 0 ? burst : 1.0),
+      tokens_(burst_),
+      last_(Clock::now()) {}
+
+void TokenBucket::refill(Clock::time_point now) {
+    std::chrono::duration<double> elapsed = now - last_;
+    if (elapsed.count() > 0) {
+        tokens_ = std::min(burst_, tokens_ + elapsed.count() * rate_);
+        last_ = now;
+    }
+}
+
+bool TokenBucket::try_acquire(double tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill(Clock::now());
+    if (tokens_ < tokens) return false;
+    tokens_ -= tokens;
+    return true;
+}
+
+void TokenBucket::acquire(double tokens) {
+    for (;;) {
+        auto wait = time_until(tokens);
+        if (wait <= Clock::duration::zero() && try_acquire(tokens)) return;
+        std::this_thread::sleep_for(
+            std::max<Clock::duration>(wait, std::chrono::microseconds(100)));
+    }
+}
+
+TokenBucket::Clock::duration TokenBucket::time_until(double tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill(Clock::now());
+    if (tokens_ >= tokens) return Clock::duration::zero();
+    std::chrono::duration<double> wait((tokens - tokens_) / rate_);
+    return std::chrono::duration_cast<Clock::duration>(wait);
+}
+
+}  // namespace ram
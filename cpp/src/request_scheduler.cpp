@@ -0,0 +1,250 @@
+#include "ram/request_scheduler.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace ram {
+
+RequestScheduler::RequestScheduler(HttpClient& client,
+                                   RequestSchedulerOptions options)
+    : client_(client), options_(std::move(options)) {
+    if (options_.max_in_flight == 0) options_.max_in_flight = 1;
+    dispatcher_ = std::thread([this] { dispatch_loop(); });
+    for (size_t i = 0; i < options_.max_in_flight; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+RequestScheduler::~RequestScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    dispatch_cv_.notify_all();
+    worker_cv_.notify_all();
+    dispatcher_.join();
+    for (auto& worker : workers_) worker.join();
+
+    // Anything still queued is abandoned.
+    for (auto& [name, account] : accounts_) {
+        for (auto& job : account.queue) {
+            job->promise.set_exception(std::make_exception_ptr(
+                HttpError("Request scheduler stopped")));
+        }
+    }
+}
+
+RequestScheduler::EndpointState& RequestScheduler::endpoint_state(
+    const std::string& endpoint) {
+    auto [it, inserted] = endpoints_.try_emplace(endpoint);
+    if (inserted) {
+        auto limit = options_.per_endpoint.find(endpoint);
+        const RateLimit& rl = limit != options_.per_endpoint.end()
+                                  ? limit->second
+                                  : options_.default_endpoint;
+        it->second.bucket = std::make_unique<TokenBucket>(rl.rate, rl.burst);
+    }
+    return it->second;
+}
+
+void RequestScheduler::enqueue(std::unique_ptr<Job> job, bool front) {
+    auto [it, inserted] = accounts_.try_emplace(job->account);
+    AccountState& account = it->second;
+    if (inserted) {
+        account.bucket = std::make_unique<TokenBucket>(
+            options_.per_account.rate, options_.per_account.burst);
+    }
+    if (!account.in_ring) {
+        ring_.push_back(job->account);
+        account.in_ring = true;
+    }
+    if (front) {
+        account.queue.push_front(std::move(job));
+    } else {
+        account.queue.push_back(std::move(job));
+    }
+    ++queued_;
+}
+
+std::future<HttpResponse> RequestScheduler::submit(const std::string& account,
+                                                   const std::string& endpoint,
+                                                   HttpRequest request) {
+    auto job = std::make_unique<Job>();
+    job->account = account;
+    job->endpoint = endpoint;
+    if (job->endpoint.empty()) {
+        auto url = Url::parse(request.url);
+        job->endpoint = url ? url->host : request.url;
+    }
+    job->request = std::move(request);
+    job->enqueued = Clock::now();
+    auto future = job->promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.submitted;
+        queue_depths_.record(static_cast<uint64_t>(queued_));
+        enqueue(std::move(job), false);
+    }
+    dispatch_cv_.notify_one();
+    return future;
+}
+
+void RequestScheduler::dispatch_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        auto now = Clock::now();
+        auto next_wake = Clock::time_point::max();
+        bool dispatched = false;
+
+        // One round-robin pass: each account gets at most one dispatch.
+        for (size_t n = ring_.size(); n > 0 && in_flight_ < options_.max_in_flight; --n) {
+            std::string name = std::move(ring_.front());
+            ring_.pop_front();
+            AccountState& account = accounts_.at(name);
+            Job& job = *account.queue.front();
+            EndpointState& endpoint = endpoint_state(job.endpoint);
+
+            auto wait = std::max({endpoint.blocked_until - now,
+                                  endpoint.bucket->time_until(),
+                                  account.bucket->time_until()});
+            if (wait > Clock::duration::zero() ||
+                !account.bucket->try_acquire() ||
+                !endpoint.bucket->try_acquire()) {
+                next_wake = std::min(next_wake,
+                                     now + std::max<Clock::duration>(
+                                               wait, std::chrono::milliseconds(1)));
+                ring_.push_back(std::move(name));
+                continue;
+            }
+
+            auto ready = std::move(account.queue.front());
+            account.queue.pop_front();
+            --queued_;
+            ++in_flight_;
+            ++stats_.dispatched;
+            wait_times_.record(now - ready->enqueued);
+            ready_.push_back(std::move(ready));
+            dispatched = true;
+
+            if (account.queue.empty()) {
+                account.in_ring = false;
+            } else {
+                ring_.push_back(std::move(name));
+            }
+        }
+
+        if (dispatched) {
+            worker_cv_.notify_all();
+            continue;
+        }
+        if (ring_.empty() || in_flight_ >= options_.max_in_flight) {
+            dispatch_cv_.wait(lock);
+        } else {
+            dispatch_cv_.wait_until(lock, next_wake);
+        }
+    }
+}
+
+void RequestScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        worker_cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+        if (ready_.empty()) return;
+        auto job = std::move(ready_.front());
+        ready_.pop_front();
+        lock.unlock();
+
+        HttpResponse response;
+        try {
+            response = client_.send(job->request);
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                --in_flight_;
+                ++stats_.failed;
+            }
+            dispatch_cv_.notify_one();
+            job->promise.set_exception(std::current_exception());
+            lock.lock();
+            continue;
+        }
+        complete(std::move(job), std::move(response));
+
+        lock.lock();
+    }
+}
+
+RequestScheduler::Clock::duration RequestScheduler::backoff_for(
+    const HttpResponse& response, int attempt) {
+    std::uniform_real_distribution<double> jitter(0.5, 1.0);
+
+    if (const std::string* retry_after = response.header("Retry-After")) {
+        long seconds = 0;
+        auto [ptr, ec] = std::from_chars(
+            retry_after->data(), retry_after->data() + retry_after->size(), seconds);
+        if (ec == std::errc() && seconds >= 0) {
+            // Honor the server's delay; spread retries over an extra 0-10%.
+            std::chrono::duration<double> base(static_cast<double>(seconds));
+            return std::chrono::duration_cast<Clock::duration>(
+                base * (1.0 + (jitter(rng_) - 0.5) / 5.0));
+        }
+    }
+
+    std::chrono::milliseconds backoff =
+        options_.base_backoff * (int64_t{1} << std::min(attempt, 20));
+    backoff = std::min(backoff, options_.max_backoff);
+    return std::chrono::duration_cast<Clock::duration>(backoff * jitter(rng_));
+}
+
+void RequestScheduler::complete(std::unique_ptr<Job> job, HttpResponse response) {
+    bool throttled = response.status == 429 || response.status == 503;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --in_flight_;
+        EndpointState& endpoint = endpoint_state(job->endpoint);
+        if (throttled) {
+            ++stats_.throttled;
+            auto until = Clock::now() + backoff_for(response, endpoint.consecutive_throttles);
+            ++endpoint.consecutive_throttles;
+            endpoint.blocked_until = std::max(endpoint.blocked_until, until);
+
+            if (job->attempt < options_.max_retries && !stopping_) {
+                ++job->attempt;
+                ++stats_.retries;
+                enqueue(std::move(job), true);
+            }
+        } else {
+            endpoint.consecutive_throttles = 0;
+        }
+        if (job) ++stats_.completed;
+    }
+    dispatch_cv_.notify_one();
+    if (job) job->promise.set_value(std::move(response));
+}
+
+size_t RequestScheduler::queue_depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+size_t RequestScheduler::queue_depth(const std::string& account) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = accounts_.find(account);
+    return it == accounts_.end() ? 0 : it->second.queue.size();
+}
+
+Histogram RequestScheduler::wait_times() const {
+    return wait_times_;
+}
+
+Histogram RequestScheduler::queue_depths() const {
+    return queue_depths_;
+}
+
+RequestSchedulerStats RequestScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace ram
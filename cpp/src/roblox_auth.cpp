@@ -0,0 +1,212 @@
+#include "ram/roblox_auth.h"
+
+#include "ram/utilities.h"
+
+namespace ram {
+
+namespace {
+
+// Same referer the C# client sends with authentication-ticket requests.
+constexpr const char* kAuthReferer =
+    "https://www.roblox.com/games/4924922222/Brookhaven-RP";
+
+HttpRequest auth_ticket_request(const std::string& base_url,
+                                const Account& account) {
+    HttpRequest request;
+    request.method = "POST";
+    request.url = base_url + "/v1/authentication-ticket/";
+    request.headers.emplace_back("Referer", kAuthReferer);
+    request.cookies = CookieJar::for_security_token(account.security_token);
+    return request;
+}
+
+}  // namespace
+
+CsrfTokenCache::CsrfTokenCache(HttpClient& client, CsrfCacheOptions options)
+    : client_(client), options_(std::move(options)) {}
+
+std::string CsrfTokenCache::key_for(const Account& account) {
+    if (account.user_id != 0) return "u:" + std::to_string(account.user_id);
+    return "t:" + md5(account.security_token);
+}
+
+std::optional<std::string> CsrfTokenCache::get(const Account& account) {
+    const std::string key = key_for(account);
+    std::promise<std::optional<std::string>> promise;
+    std::shared_future<std::optional<std::string>> shared;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[key];
+        if (!entry.token.empty() &&
+            Clock::now() - entry.fetched_at < options_.ttl) {
+            ++stats_.hits;
+            return entry.token;
+        }
+        if (entry.in_flight.valid()) {
+            ++stats_.coalesced;
+            shared = entry.in_flight;
+        } else {
+            ++stats_.misses;
+            entry.in_flight = promise.get_future().share();
+        }
+    }
+
+    // Another caller is already fetching this account's token.
+    if (shared.valid()) return shared.get();
+
+    // Whatever fetch() does, the entry must stop pointing at this promise
+    // and the promise must be fulfilled, or every later get() for the
+    // account would wait on it forever.
+    std::optional<std::string> token;
+    try {
+        token = fetch(account);
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Entry& entry = entries_[key];
+            entry.in_flight = {};
+            ++stats_.fetch_failures;
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[key];
+        entry.in_flight = {};
+        ++generation_;
+        if (token) {
+            entry.token = *token;
+            entry.fetched_at = Clock::now();
+        } else {
+            entry.token.clear();
+            ++stats_.fetch_failures;
+        }
+    }
+    promise.set_value(token);
+    return token;
+}
+
+std::optional<std::string> CsrfTokenCache::fetch(const Account& account) {
+    // The endpoint rejects a POST without a token with 403 and hands out a
+    // fresh token in the x-csrf-token header.
+    try {
+        HttpResponse response =
+            client_.send(auth_ticket_request(options_.auth_base_url, account));
+        if (response.status != 403) return std::nullopt;
+        const std::string* token = response.header("x-csrf-token");
+        if (token == nullptr || token->empty()) return std::nullopt;
+        return *token;
+    } catch (const HttpError&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<std::string> CsrfTokenCache::peek(const Account& account) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key_for(account));
+    if (it == entries_.end() || it->second.token.empty() ||
+        Clock::now() - it->second.fetched_at >= options_.ttl) {
+        return std::nullopt;
+    }
+    return it->second.token;
+}
+
+void CsrfTokenCache::invalidate(const Account& account) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key_for(account));
+    if (it != entries_.end() && !it->second.token.empty()) {
+        it->second.token.clear();
+        ++stats_.invalidations;
+        ++generation_;
+    }
+}
+
+bool CsrfTokenCache::observe(const Account& account,
+                             const HttpResponse& response) {
+    if (response.status != 403) return false;
+    const std::string* token = response.header("x-csrf-token");
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[key_for(account)];
+    ++stats_.invalidations;
+    ++generation_;
+    if (token == nullptr || token->empty()) {
+        entry.token.clear();
+        return false;
+    }
+    entry.token = *token;
+    entry.fetched_at = Clock::now();
+    return true;
+}
+
+CsrfCacheStats CsrfTokenCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+namespace {
+
+// Send a request with the account's cached CSRF token, retrying once if the
+// server rejects the token and hands out a replacement.
+std::optional<HttpResponse> send_with_csrf(HttpClient& client,
+                                           CsrfTokenCache& csrf,
+                                           const Account& account,
+                                           const HttpRequest& base) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        auto token = csrf.get(account);
+        if (!token) return std::nullopt;
+
+        HttpRequest request = base;
+        request.headers.emplace_back("X-CSRF-TOKEN", *token);
+
+        HttpResponse response;
+        try {
+            response = client.send(request);
+        } catch (const HttpError&) {
+            return std::nullopt;
+        }
+        if (response.status != 403 || !csrf.observe(account, response)) {
+            return response;
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+std::optional<std::string> get_auth_ticket(HttpClient& client,
+                                           CsrfTokenCache& csrf,
+                                           const Account& account) {
+    auto response = send_with_csrf(
+        client, csrf, account,
+        auth_ticket_request(csrf.options().auth_base_url, account));
+    if (!response) return std::nullopt;
+    const std::string* ticket = response->header("rbx-authentication-ticket");
+    if (ticket == nullptr) return std::nullopt;
+    return *ticket;
+}
+
+std::optional<std::string> sign_out_other_sessions(HttpClient& client,
+                                                   CsrfTokenCache& csrf,
+                                                   const Account& account,
+                                                   const std::string& web_base_url) {
+    HttpRequest request;
+    request.method = "POST";
+    request.url = web_base_url + "/authentication/signoutfromallsessionsandreauthenticate";
+    request.headers.emplace_back("Referer", "https://www.roblox.com/");
+    request.headers.emplace_back("Content-Type", "application/x-www-form-urlencoded");
+    request.cookies = CookieJar::for_security_token(account.security_token);
+
+    auto response = send_with_csrf(client, csrf, account, request);
+    if (!response || response->status != 200) return std::nullopt;
+
+    CookieJar jar;
+    jar.update_from(response->headers);
+    auto token = jar.get(".ROBLOSECURITY");
+    if (!token || token->empty()) return std::nullopt;
+    return *token;
+}
+
+}  // namespace ram
@@ -0,0 +1,256 @@
+#include "ram/server_list.h"
+
+#include <algorithm>
+#include <cctype>
+#include <future>
+
+namespace ram {
+
+namespace {
+
+// Cursors are opaque base64-like tokens; escape anything outside the
+// unreserved set so '+', '/' and '=' survive the query string.
+std::string escape_query_value(const std::string& value) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(value.size());
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 15];
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+GameServer GameServer::from_json(const nlohmann::json& j) {
+    auto get_int = [&](const char* key) -> int {
+        auto it = j.find(key);
+        if (it == j.end() || !it->is_number()) return 0;
+        return it->get<int>();
+    };
+
+    GameServer s;
+    auto id = j.find("id");
+    if (id != j.end() && id->is_string()) s.id = id->get<std::string>();
+    s.max_players = get_int("maxPlayers");
+    s.playing = get_int("playing");
+    s.ping = get_int("ping");
+    auto fps = j.find("fps");
+    if (fps != j.end() && fps->is_number()) s.fps = fps->get<double>();
+    return s;
+}
+
+ServerRanking::ServerRanking(ServerOrder order, size_t capacity)
+    : order_(order), capacity_(std::max<size_t>(capacity, 1)) {
+    servers_.reserve(capacity_ + 1);
+}
+
+bool ServerRanking::better(const GameServer& a, const GameServer& b) const {
+    switch (order_) {
+        case ServerOrder::MostFreeSlots:
+            if (a.free_slots() != b.free_slots()) return a.free_slots() > b.free_slots();
+            if (a.ping != b.ping) return a.ping < b.ping;
+            break;
+        case ServerOrder::LowestPing:
+            if (a.ping != b.ping) return a.ping < b.ping;
+            if (a.free_slots() != b.free_slots()) return a.free_slots() > b.free_slots();
+            break;
+        case ServerOrder::MostPlayers:
+            if (a.playing != b.playing) return a.playing > b.playing;
+            if (a.ping != b.ping) return a.ping < b.ping;
+            break;
+        case ServerOrder::FewestPlayers:
+            if (a.playing != b.playing) return a.playing < b.playing;
+            if (a.ping != b.ping) return a.ping < b.ping;
+            break;
+    }
+    return a.id < b.id;
+}
+
+bool ServerRanking::offer(const GameServer& server) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The ranking holds a handful of servers, so a linear scan for the id
+    // and an insertion into a sorted vector beat a heap plus an index.
+    auto same = std::find_if(servers_.begin(), servers_.end(),
+                             [&](const GameServer& s) { return s.id == server.id; });
+    if (same != servers_.end()) servers_.erase(same);
+
+    if (servers_.size() == capacity_ && !better(server, servers_.back())) return false;
+    auto at = std::upper_bound(servers_.begin(), servers_.end(), server,
+                               [&](const GameServer& a, const GameServer& b) {
+                                   return better(a, b);
+                               });
+    servers_.insert(at, server);
+    if (servers_.size() > capacity_) servers_.pop_back();
+    return true;
+}
+
+std::optional<GameServer> ServerRanking::best() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (servers_.empty()) return std::nullopt;
+    return servers_.front();
+}
+
+std::vector<GameServer> ServerRanking::top() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return servers_;
+}
+
+size_t ServerRanking::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return servers_.size();
+}
+
+ServerCrawler::ServerCrawler(HttpClient& client, int64_t place_id, ServerCrawlOptions options)
+    : client_(client),
+      place_id_(place_id),
+      options_(std::move(options)),
+      ranking_(options_.order, options_.top_k) {
+    if (options_.attempts < 1) options_.attempts = 1;
+}
+
+ServerCrawler::~ServerCrawler() { cancel(); }
+
+HttpRequest ServerCrawler::page_request(const std::string& cursor) const {
+    HttpRequest request;
+    request.url = options_.base_url + "/v1/games/" + std::to_string(place_id_) +
+                  "/servers/public?sortOrder=Asc&limit=" + std::to_string(options_.page_size);
+    if (!cursor.empty()) request.url += "&cursor=" + escape_query_value(cursor);
+    request.headers.emplace_back("Accept", "application/json");
+    return request;
+}
+
+bool ServerCrawler::accepts(const GameServer& server) const {
+    if (server.id.empty() || server.max_players <= 1) return false;
+    if (server.free_slots() < options_.min_free_slots) return false;
+    if (server.playing < options_.min_players) return false;
+    return options_.max_ping <= 0 || server.ping <= options_.max_ping;
+}
+
+bool ServerCrawler::stop_requested() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+void ServerCrawler::run() {
+    std::string cursor;
+    std::future<HttpResponse> pending = client_.send_async(page_request(cursor));
+    size_t pages = 0;
+    int attempt = 1;
+
+    for (;;) {
+        std::optional<HttpResponse> response;
+        try {
+            response = pending.get();
+        } catch (const HttpError&) {
+        }
+        nlohmann::json page;
+        if (response && response->ok()) {
+            page = nlohmann::json::parse(response->body, nullptr, false);
+        }
+        if (page.is_discarded() || !page.is_object() || !page.contains("data") ||
+            !page["data"].is_array()) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++stats_.failed_requests;
+            if (attempt >= options_.attempts) stats_.failed = true;
+            if (stats_.failed ||
+                cv_.wait_for(lock, options_.retry_delay, [&] { return cancelled_; })) {
+                break;
+            }
+            lock.unlock();
+            ++attempt;
+            pending = client_.send_async(page_request(cursor));
+            continue;
+        }
+        attempt = 1;
+        ++pages;
+
+        // Ask for the next page before ranking this one.
+        auto next = page.find("nextPageCursor");
+        bool more = next != page.end() && next->is_string() && !next->get<std::string>().empty() &&
+                    (options_.max_pages == 0 || pages < options_.max_pages) && !stop_requested();
+        if (more) {
+            cursor = next->get<std::string>();
+            pending = client_.send_async(page_request(cursor));
+        }
+
+        uint64_t seen = 0;
+        uint64_t matched = 0;
+        for (const auto& entry : page["data"]) {
+            if (!entry.is_object()) continue;
+            GameServer server = GameServer::from_json(entry);
+            ++seen;
+            if (!accepts(server)) continue;
+            ++matched;
+            ranking_.offer(server);
+        }
+
+        bool satisfied;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.pages;
+            stats_.servers_seen += seen;
+            stats_.servers_matched += matched;
+            satisfied = options_.enough > 0 && stats_.servers_matched >= options_.enough;
+            if (satisfied && more) stats_.stopped_early = true;
+        }
+        cv_.notify_all();
+        // An abandoned request finishes on the client's worker and is dropped.
+        if (satisfied || !more) break;
+    }
+    finish();
+}
+
+void ServerCrawler::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    cv_.notify_all();
+}
+
+void ServerCrawler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_.joinable()) return;
+    worker_ = std::thread([this] { run(); });
+}
+
+void ServerCrawler::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool ServerCrawler::wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [&] { return done_; });
+}
+
+std::optional<GameServer> ServerCrawler::wait_best(std::chrono::milliseconds timeout) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, timeout, [&] { return done_ || stats_.servers_matched > 0; });
+    }
+    return ranking_.best();
+}
+
+bool ServerCrawler::done() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_;
+}
+
+ServerCrawlStats ServerCrawler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace ram
@@ -0,0 +1,300 @@
+#include "ram/socket.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace ram {
+
+namespace {
+
+#ifdef _WIN32
+using pollfd_t = WSAPOLLFD;
+int poll_one(pollfd_t* pfd, int timeout_ms) { return WSAPoll(pfd, 1, timeout_ms); }
+int close_handle(native_socket_t s) { return closesocket(static_cast<SOCKET>(s)); }
+bool would_block() {
+    int err = WSAGetLastError();
+    return err == WSAEWOULDBLOCK || err == WSAEINPROGRESS;
+}
+constexpr int kSendFlags = 0;
+
+struct WinsockInit {
+    WinsockInit() {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    }
+    ~WinsockInit() { WSACleanup(); }
+};
+
+void ensure_init() { static WinsockInit init; }
+#else
+using pollfd_t = pollfd;
+int poll_one(pollfd_t* pfd, int timeout_ms) { return ::poll(pfd, 1, timeout_ms); }
+int close_handle(native_socket_t s) { return ::close(s); }
+bool would_block() {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS;
+}
+constexpr int kSendFlags = MSG_NOSIGNAL;
+
+void ensure_init() {}
+#endif
+
+int to_ms(std::chrono::milliseconds timeout) {
+    return timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+}
+
+bool wait_for(native_socket_t handle, short events,
+              std::chrono::milliseconds timeout) {
+    pollfd_t pfd{};
+    pfd.fd = handle;
+    pfd.events = events;
+    int rc = poll_one(&pfd, to_ms(timeout));
+    return rc > 0 && (pfd.revents & (events | POLLERR | POLLHUP));
+}
+
+}  // namespace
+
+#ifdef _WIN32
+const native_socket_t Socket::kInvalid = static_cast<native_socket_t>(INVALID_SOCKET);
+#else
+const native_socket_t Socket::kInvalid = -1;
+#endif
+
+Socket::~Socket() { close(); }
+
+Socket::Socket(Socket&& other) noexcept : handle_(other.handle_) {
+    other.handle_ = kInvalid;
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle_ = other.handle_;
+        other.handle_ = kInvalid;
+    }
+    return *this;
+}
+
+Socket Socket::connect(const std::string& host, uint16_t port,
+                       std::chrono::milliseconds timeout) {
+    ensure_init();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    std::string port_str = std::to_string(port);
+    if (getaddrinfo(host.c_str(), port_str.c_str(), &hints, &result) != 0) {
+        throw std::runtime_error("Cannot resolve host: " + host);
+    }
+
+    Socket sock;
+    for (addrinfo* ai = result; ai != nullptr; ai = ai->ai_next) {
+        Socket candidate(static_cast<native_socket_t>(
+            ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)));
+        if (!candidate.valid()) continue;
+
+        candidate.set_nonblocking(true);
+        int rc = ::connect(candidate.handle_, ai->ai_addr,
+                           static_cast<int>(ai->ai_addrlen));
+        if (rc != 0 && !would_block()) continue;
+        if (rc != 0) {
+            if (!wait_for(candidate.handle_, POLLOUT, timeout)) continue;
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(candidate.handle_, SOL_SOCKET, SO_ERROR,
+                       reinterpret_cast<char*>(&err), &len);
+            if (err != 0) continue;
+        }
+        candidate.set_nonblocking(false);
+        candidate.set_nodelay(true);
+        sock = std::move(candidate);
+        break;
+    }
+    freeaddrinfo(result);
+
+    if (!sock.valid()) {
+        throw std::runtime_error("Cannot connect to " + host + ":" + port_str);
+    }
+    return sock;
+}
+
+Socket Socket::listen(const std::string& host, uint16_t port, int backlog) {
+    ensure_init();
+
+    Socket sock(static_cast<native_socket_t>(::socket(AF_INET, SOCK_STREAM, 0)));
+    if (!sock.valid()) throw std::runtime_error("Cannot create socket");
+
+    int yes = 1;
+    setsockopt(sock.handle_, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char*>(&yes), sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        throw std::runtime_error("Invalid listen address: " + host);
+    }
+    if (::bind(sock.handle_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(sock.handle_, backlog) != 0) {
+        throw std::runtime_error("Cannot listen on " + host + ":" +
+                                 std::to_string(port));
+    }
+    return sock;
+}
+
+std::pair<Socket, Socket> Socket::pair() {
+    Socket listener = listen("127.0.0.1", 0, 1);
+    Socket client = connect("127.0.0.1", listener.local_port(),
+                            std::chrono::milliseconds(2000));
+    Socket server = listener.accept();
+    if (!server.valid()) throw std::runtime_error("Cannot create socket pair");
+    server.set_nodelay(true);
+    return {std::move(client), std::move(server)};
+}
+
+Socket Socket::accept() const {
+    return Socket(static_cast<native_socket_t>(::accept(handle_, nullptr, nullptr)));
+}
+
+bool Socket::peer_is_loopback() const {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    if (getpeername(handle_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return false;
+    }
+    if (addr.ss_family == AF_INET) {
+        auto* in = reinterpret_cast<sockaddr_in*>(&addr);
+        return (ntohl(in->sin_addr.s_addr) >> 24) == 127;
+    }
+    if (addr.ss_family == AF_INET6) {
+        auto* in6 = reinterpret_cast<sockaddr_in6*>(&addr);
+        return IN6_IS_ADDR_LOOPBACK(&in6->sin6_addr);
+    }
+    return false;
+}
+
+ptrdiff_t Socket::recv_nowait(char* data, size_t size) const {
+    auto got = ::recv(handle_, data, static_cast<int>(size), 0);
+    if (got < 0) return would_block() ? kWouldBlock : -1;
+    return static_cast<ptrdiff_t>(got);
+}
+
+ptrdiff_t Socket::send_nowait(const ConstBuffer* buffers, size_t count) const {
+    constexpr size_t kMaxBuffers = 16;
+    count = std::min(count, kMaxBuffers);
+#ifdef _WIN32
+    WSABUF bufs[kMaxBuffers];
+    for (size_t i = 0; i < count; ++i) {
+        bufs[i].buf = const_cast<char*>(buffers[i].data);
+        bufs[i].len = static_cast<ULONG>(buffers[i].size);
+    }
+    DWORD sent = 0;
+    if (WSASend(static_cast<SOCKET>(handle_), bufs, static_cast<DWORD>(count), &sent,
+                0, nullptr, nullptr) != 0) {
+        return would_block() ? kWouldBlock : -1;
+    }
+    return static_cast<ptrdiff_t>(sent);
+#else
+    iovec iov[kMaxBuffers];
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<char*>(buffers[i].data);
+        iov[i].iov_len = buffers[i].size;
+    }
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    auto sent = ::sendmsg(handle_, &msg, kSendFlags);
+    if (sent < 0) return would_block() ? kWouldBlock : -1;
+    return static_cast<ptrdiff_t>(sent);
+#endif
+}
+
+bool Socket::send_all(const char* data, size_t size,
+                      std::chrono::milliseconds timeout) const {
+    while (size > 0) {
+        if (!wait_for(handle_, POLLOUT, timeout)) return false;
+        auto sent = ::send(handle_, data, static_cast<int>(size), kSendFlags);
+        if (sent < 0) {
+            if (would_block()) continue;
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+ptrdiff_t Socket::recv_some(char* data, size_t size,
+                            std::chrono::milliseconds timeout) const {
+    if (!wait_for(handle_, POLLIN, timeout)) return -1;
+    auto got = ::recv(handle_, data, static_cast<int>(size), 0);
+    return got < 0 ? -1 : static_cast<ptrdiff_t>(got);
+}
+
+bool Socket::wait_readable(std::chrono::milliseconds timeout) const {
+    return wait_for(handle_, POLLIN, timeout);
+}
+
+bool Socket::wait_writable(std::chrono::milliseconds timeout) const {
+    return wait_for(handle_, POLLOUT, timeout);
+}
+
+void Socket::set_nonblocking(bool enabled) const {
+#ifdef _WIN32
+    u_long mode = enabled ? 1 : 0;
+    ioctlsocket(static_cast<SOCKET>(handle_), FIONBIO, &mode);
+#else
+    int flags = fcntl(handle_, F_GETFL, 0);
+    fcntl(handle_, F_SETFL, enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+#endif
+}
+
+void Socket::set_nodelay(bool enabled) const {
+    int value = enabled ? 1 : 0;
+    setsockopt(handle_, IPPROTO_TCP, TCP_NODELAY,
+               reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+uint16_t Socket::local_port() const {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    if (getsockname(handle_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return 0;
+    }
+    return ntohs(addr.sin_port);
+}
+
+void Socket::shutdown() const {
+    if (!valid()) return;
+#ifdef _WIN32
+    ::shutdown(static_cast<SOCKET>(handle_), SD_BOTH);
+#else
+    ::shutdown(handle_, SHUT_RDWR);
+#endif
+}
+
+void Socket::close() {
+    if (valid()) {
+        close_handle(handle_);
+        handle_ = kInvalid;
+    }
+}
+
+}  // namespace ram
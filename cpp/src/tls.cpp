@@ -0,0 +1,281 @@
+#include "ram/tls.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+#if RAM_HAS_OPENSSL
+#include <mutex>
+#include <unordered_map>
+
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#endif
+
+namespace ram {
+
+#if RAM_HAS_OPENSSL
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string openssl_error(const std::string& what) {
+    unsigned long code = ERR_get_error();
+    ERR_clear_error();
+    if (code == 0) return what;
+    char buffer[256];
+    ERR_error_string_n(code, buffer, sizeof(buffer));
+    return what + ": " + buffer;
+}
+
+std::chrono::milliseconds remaining(Clock::time_point deadline) {
+    return std::max(std::chrono::milliseconds(0),
+                    std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()));
+}
+
+// OpenSSL talks to the socket through Socket's non-blocking calls rather
+// than its own fd BIO, so writes to a closed peer never raise SIGPIPE.
+int socket_bio_write(BIO* bio, const char* data, int size) {
+    BIO_clear_retry_flags(bio);
+    ConstBuffer buffer{data, static_cast<size_t>(size)};
+    ptrdiff_t sent = static_cast<const Socket*>(BIO_get_data(bio))->send_nowait(&buffer, 1);
+    if (sent == Socket::kWouldBlock) {
+        BIO_set_retry_write(bio);
+        return -1;
+    }
+    return static_cast<int>(sent);
+}
+
+int socket_bio_read(BIO* bio, char* data, int size) {
+    BIO_clear_retry_flags(bio);
+    ptrdiff_t got = static_cast<const Socket*>(BIO_get_data(bio))
+                        ->recv_nowait(data, static_cast<size_t>(size));
+    if (got == Socket::kWouldBlock) {
+        BIO_set_retry_read(bio);
+        return -1;
+    }
+    return static_cast<int>(got);
+}
+
+long socket_bio_ctrl(BIO*, int cmd, long, void*) { return cmd == BIO_CTRL_FLUSH ? 1 : 0; }
+
+const BIO_METHOD* socket_bio_method() {
+    static BIO_METHOD* method = [] {
+        BIO_METHOD* m = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "ram socket");
+        BIO_meth_set_write(m, socket_bio_write);
+        BIO_meth_set_read(m, socket_bio_read);
+        BIO_meth_set_ctrl(m, socket_bio_ctrl);
+        return m;
+    }();
+    return method;
+}
+
+}  // namespace
+
+struct TlsContext::Impl {
+    SSL_CTX* ctx = nullptr;
+    std::mutex mutex;
+    std::unordered_map<std::string, SSL_SESSION*> sessions;
+
+    ~Impl() {
+        for (auto& [key, session] : sessions) SSL_SESSION_free(session);
+        SSL_CTX_free(ctx);
+    }
+
+    // OpenSSL hands over each new session, including TLS 1.3 tickets that
+    // arrive after the handshake. Keep the latest one per host.
+    static int on_new_session(SSL* ssl, SSL_SESSION* session) {
+        auto* impl = static_cast<Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        auto* key = static_cast<const std::string*>(SSL_get_app_data(ssl));
+        if (impl == nullptr || key == nullptr) return 0;
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        SSL_SESSION*& slot = impl->sessions[*key];
+        if (slot != nullptr) SSL_SESSION_free(slot);
+        slot = session;
+        return 1;
+    }
+};
+
+struct TlsStream::State {
+    SSL* ssl = nullptr;
+    const Socket* socket = nullptr;
+    std::string session_key;  // referenced by the SSL's app data
+
+    ~State() {
+        if (ssl == nullptr) return;
+        SSL_shutdown(ssl);  // best-effort close_notify; the socket is non-blocking
+        SSL_free(ssl);
+    }
+
+    // Wait for whatever OpenSSL needs after a call returned `rc`. Returns
+    // false on timeout or when the error is not a retryable one.
+    bool wait(int rc, Clock::time_point deadline) const {
+        int error = SSL_get_error(ssl, rc);
+        if (error == SSL_ERROR_WANT_READ) return socket->wait_readable(remaining(deadline));
+        if (error == SSL_ERROR_WANT_WRITE) return socket->wait_writable(remaining(deadline));
+        return false;
+    }
+};
+
+TlsContext::TlsContext(TlsOptions options) : impl_(std::make_unique<Impl>()) {
+    impl_->ctx = SSL_CTX_new(TLS_client_method());
+    if (impl_->ctx == nullptr) throw std::runtime_error(openssl_error("Cannot create TLS context"));
+    SSL_CTX_set_min_proto_version(impl_->ctx, TLS1_2_VERSION);
+    if (options.verify_peer) {
+        SSL_CTX_set_verify(impl_->ctx, SSL_VERIFY_PEER, nullptr);
+        int loaded = options.ca_file.empty()
+                         ? SSL_CTX_set_default_verify_paths(impl_->ctx)
+                         : SSL_CTX_load_verify_locations(impl_->ctx, options.ca_file.c_str(),
+                                                         nullptr);
+        if (loaded != 1) {
+            throw std::runtime_error(openssl_error("Cannot load CA certificates " +
+                                                   options.ca_file));
+        }
+    }
+    SSL_CTX_set_session_cache_mode(impl_->ctx,
+                                   SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(impl_->ctx, &Impl::on_new_session);
+    SSL_CTX_set_app_data(impl_->ctx, impl_.get());
+}
+
+TlsContext::~TlsContext() = default;
+
+bool TlsContext::available() { return true; }
+
+TlsStream::TlsStream(std::unique_ptr<State> state) : state_(std::move(state)) {}
+
+TlsStream::~TlsStream() = default;
+
+std::unique_ptr<TlsStream> TlsStream::connect(TlsContext& context, const Socket& socket,
+                                              const std::string& host,
+                                              const std::string& session_key,
+                                              std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    auto state = std::make_unique<State>();
+    state->socket = &socket;
+    state->session_key = session_key;
+    state->ssl = SSL_new(context.impl_->ctx);
+    if (state->ssl == nullptr) throw std::runtime_error(openssl_error("Cannot create TLS session"));
+    SSL* ssl = state->ssl;
+    BIO* bio = BIO_new(socket_bio_method());
+    if (bio == nullptr) throw std::runtime_error(openssl_error("Cannot create TLS session"));
+    BIO_set_data(bio, const_cast<Socket*>(&socket));
+    BIO_set_init(bio, 1);
+    SSL_set_bio(ssl, bio, bio);
+    socket.set_nonblocking(true);
+    SSL_set_app_data(ssl, &state->session_key);
+
+    // IP literals are checked against the certificate's IP SANs and are
+    // not sent as SNI; names get both.
+    if (X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl), host.c_str()) != 1) {
+        SSL_set_tlsext_host_name(ssl, host.c_str());
+        SSL_set1_host(ssl, host.c_str());
+    }
+    {
+        std::lock_guard<std::mutex> lock(context.impl_->mutex);
+        auto it = context.impl_->sessions.find(session_key);
+        if (it != context.impl_->sessions.end()) SSL_set_session(ssl, it->second);
+    }
+
+    for (;;) {
+        int rc = SSL_connect(ssl);
+        if (rc == 1) break;
+        if (state->wait(rc, deadline)) continue;
+        std::string what = "TLS handshake with " + host + " failed";
+        long verify = SSL_get_verify_result(ssl);
+        if (verify != X509_V_OK) {
+            ERR_clear_error();
+            throw std::runtime_error(what + ": " + X509_verify_cert_error_string(verify));
+        }
+        throw std::runtime_error(openssl_error(what));
+    }
+    return std::unique_ptr<TlsStream>(new TlsStream(std::move(state)));
+}
+
+bool TlsStream::send_all(const char* data, size_t size, std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    while (size > 0) {
+        int rc = SSL_write(state_->ssl, data, static_cast<int>(std::min<size_t>(size, INT_MAX)));
+        if (rc > 0) {
+            data += rc;
+            size -= static_cast<size_t>(rc);
+            continue;
+        }
+        if (!state_->wait(rc, deadline)) {
+            ERR_clear_error();
+            return false;
+        }
+    }
+    return true;
+}
+
+ptrdiff_t TlsStream::recv_some(char* data, size_t size, std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    for (;;) {
+        int rc = SSL_read(state_->ssl, data, static_cast<int>(std::min<size_t>(size, INT_MAX)));
+        if (rc > 0) return rc;
+        int error = SSL_get_error(state_->ssl, rc);
+        // Many servers close without close_notify; treat it as a close.
+        if (error == SSL_ERROR_ZERO_RETURN || (error == SSL_ERROR_SYSCALL && rc == 0)) {
+            ERR_clear_error();
+            return 0;
+        }
+        if (!state_->wait(rc, deadline)) {
+            ERR_clear_error();
+            return -1;
+        }
+    }
+}
+
+bool TlsStream::reusable() {
+    if (SSL_pending(state_->ssl) > 0) return false;
+    while (state_->socket->wait_readable(std::chrono::milliseconds(0))) {
+        char byte;
+        int rc = SSL_read(state_->ssl, &byte, 1);
+        if (rc > 0) return false;  // unsolicited data
+        if (SSL_get_error(state_->ssl, rc) != SSL_ERROR_WANT_READ) {
+            ERR_clear_error();
+            return false;  // closed or failed
+        }
+    }
+    return true;
+}
+
+bool TlsStream::resumed() const { return SSL_session_reused(state_->ssl) == 1; }
+
+#else  // !RAM_HAS_OPENSSL
+
+struct TlsContext::Impl {};
+struct TlsStream::State {};
+
+TlsContext::TlsContext(TlsOptions) {
+    throw std::runtime_error("TLS is unavailable (built without OpenSSL)");
+}
+
+TlsContext::~TlsContext() = default;
+
+bool TlsContext::available() { return false; }
+
+TlsStream::TlsStream(std::unique_ptr<State> state) : state_(std::move(state)) {}
+
+TlsStream::~TlsStream() = default;
+
+std::unique_ptr<TlsStream> TlsStream::connect(TlsContext&, const Socket&, const std::string&,
+                                              const std::string&, std::chrono::milliseconds) {
+    throw std::runtime_error("TLS is unavailable (built without OpenSSL)");
+}
+
+bool TlsStream::send_all(const char*, size_t, std::chrono::milliseconds) { return false; }
+
+ptrdiff_t TlsStream::recv_some(char*, size_t, std::chrono::milliseconds) { return -1; }
+
+bool TlsStream::reusable() { return false; }
+
+bool TlsStream::resumed() const { return false; }
+
+#endif
+
+}  // namespace ram
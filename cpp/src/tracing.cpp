@@ -0,0 +1,140 @@
+#include "ram/tracing.h"
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/utilities.h"
+
+namespace ram {
+
+Tracer& Tracer::global() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::enable(size_t events_per_thread) {
+    events_per_thread = std::max<size_t>(events_per_thread, 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (events_per_thread != capacity_) {
+            capacity_ = events_per_thread;
+            buffers_.clear();
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+void Tracer::configure(const IniSection& developer) {
+    size_t events = kDefaultEventsPerThread;
+    if (developer.exists("TraceBufferEvents")) {
+        int configured = developer.get_as<int>("TraceBufferEvents");
+        if (configured > 0) events = static_cast<size_t>(configured);
+    }
+    if (developer.get_as<bool>("EnableTracing")) {
+        enable(events);
+    } else {
+        disable();
+    }
+}
+
+Tracer::ThreadBuffer& Tracer::thread_buffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    thread_local uint64_t generation = 0;
+    if (generation != generation_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = next_tid_++;
+        buffer->capacity = capacity_;
+        buffers_.push_back(buffer);
+        generation = generation_.load(std::memory_order_relaxed);
+    }
+    return *buffer;
+}
+
+void Tracer::record(const TraceEvent& event) {
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.ring.size() < buffer.capacity) {
+        buffer.ring.push_back(event);
+    } else {
+        buffer.ring[buffer.written % buffer.capacity] = event;
+    }
+    ++buffer.written;
+}
+
+std::vector<TraceEvent> Tracer::events() const {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers = buffers_;
+    }
+    std::vector<TraceEvent> out;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        // Once the ring has wrapped, the oldest event is at the write position.
+        size_t oldest = buffer->written > buffer->ring.size()
+                            ? static_cast<size_t>(buffer->written % buffer->capacity)
+                            : 0;
+        out.insert(out.end(), buffer->ring.begin() + static_cast<std::ptrdiff_t>(oldest),
+                   buffer->ring.end());
+        out.insert(out.end(), buffer->ring.begin(),
+                   buffer->ring.begin() + static_cast<std::ptrdiff_t>(oldest));
+    }
+    return out;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.clear();
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+std::string Tracer::to_chrome_json() const {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers = buffers_;
+    }
+
+    struct Row {
+        uint32_t tid;
+        TraceEvent event;
+    };
+    std::vector<Row> rows;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        for (const auto& event : buffer->ring) rows.push_back({buffer->tid, event});
+    }
+    auto origin = rows.empty() ? std::chrono::steady_clock::time_point{} : rows.front().event.start;
+    for (const auto& row : rows) origin = std::min(origin, row.event.start);
+
+    auto micros = [](std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1e3; };
+    nlohmann::json events = nlohmann::json::array();
+    for (const auto& buffer : buffers) {
+        events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", 1},
+                          {"tid", buffer->tid},
+                          {"args", {{"name", "thread " + std::to_string(buffer->tid)}}}});
+    }
+    for (const auto& row : rows) {
+        events.push_back({{"name", row.event.name},
+                          {"cat", row.event.category},
+                          {"ph", "X"},
+                          {"ts", micros(row.event.start - origin)},
+                          {"dur", micros(row.event.duration)},
+                          {"pid", 1},
+                          {"tid", row.tid}});
+    }
+    return nlohmann::json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}}.dump();
+}
+
+bool Tracer::write_chrome_json(const std::string& path) const {
+    return write_file_atomic(path, to_chrome_json());
+}
+
+}  // namespace ram
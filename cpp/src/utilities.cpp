@@ -1,12 +1,26 @@
 #include "ram/utilities.h"
 
 #include <array>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "ram/metrics.h"
+
 // Portable MD5 and SHA-256 implementations
 // Using simple public domain implementations for cross-platform support
 
@@ -311,6 +325,79 @@ void sha256_final(SHA256Context& ctx, uint8_t digest[32]) {
     }
 }
 
+// --- SHA-1 Implementation (RFC 3174) ---
+// Only used for the WebSocket handshake, so it hashes a whole buffer at once.
+
+constexpr uint32_t rotl32(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+void sha1_transform(uint32_t state[5], const uint8_t block[64]) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) |
+               (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+               (static_cast<uint32_t>(block[i * 4 + 2]) << 8) |
+               static_cast<uint32_t>(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl32(b, 30);
+        b = a;
+        a = t;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void sha1(const uint8_t* data, size_t len, uint8_t digest[20]) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) sha1_transform(state, data + i);
+
+    uint8_t tail[128] = {};
+    size_t rest = len - i;
+    std::memcpy(tail, data + i, rest);
+    tail[rest] = 0x80;
+    size_t tail_len = rest < 56 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(len) * 8;
+    for (int j = 0; j < 8; j++) {
+        tail[tail_len - 1 - j] = static_cast<uint8_t>(bits >> (j * 8));
+    }
+    for (size_t j = 0; j < tail_len; j += 64) sha1_transform(state, tail + j);
+
+    for (int j = 0; j < 5; j++) {
+        digest[j * 4] = static_cast<uint8_t>(state[j] >> 24);
+        digest[j * 4 + 1] = static_cast<uint8_t>(state[j] >> 16);
+        digest[j * 4 + 2] = static_cast<uint8_t>(state[j] >> 8);
+        digest[j * 4 + 3] = static_cast<uint8_t>(state[j]);
+    }
+}
+
 std::string to_hex_upper(const uint8_t* data, size_t len) {
     std::ostringstream oss;
     oss << std::uppercase << std::hex << std::setfill('0');
@@ -325,6 +412,9 @@ std::string to_hex_upper(const uint8_t* data, size_t len) {
 namespace ram {
 
 std::string md5(const std::string& input) {
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.md5);
+    metrics.hashed_bytes.add(input.size());
     MD5Context ctx;
     md5_init(ctx);
     md5_update(ctx, reinterpret_cast<const uint8_t*>(input.data()),
@@ -344,6 +434,8 @@ std::string file_sha256(const std::string& filename) {
         return "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855";
     }
 
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.sha256);
     SHA256Context ctx;
     sha256_init(ctx);
 
@@ -351,6 +443,7 @@ std::string file_sha256(const std::string& filename) {
     while (file.read(reinterpret_cast<char*>(buf.data()), buf.size()) ||
            file.gcount() > 0) {
         sha256_update(ctx, buf.data(), static_cast<size_t>(file.gcount()));
+        metrics.hashed_bytes.add(static_cast<uint64_t>(file.gcount()));
     }
 
     uint8_t digest[32];
@@ -358,6 +451,75 @@ std::string file_sha256(const std::string& filename) {
     return to_hex_upper(digest, 32);
 }
 
+std::string sha256_digest(const std::string& input) {
+    const CoreMetrics& metrics = core_metrics();
+    ScopedTimer timer(metrics.sha256);
+    metrics.hashed_bytes.add(input.size());
+    SHA256Context ctx;
+    sha256_init(ctx);
+    sha256_update(ctx, reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    uint8_t digest[32];
+    sha256_final(ctx, digest);
+    return std::string(reinterpret_cast<const char*>(digest), 32);
+}
+
+std::string sha1_digest(const std::string& input) {
+    uint8_t digest[20];
+    sha1(reinterpret_cast<const uint8_t*>(input.data()), input.size(), digest);
+    return std::string(reinterpret_cast<const char*>(digest), 20);
+}
+
+// Eight bytes per step with murmur-style mixing and a final avalanche;
+// a 900-byte cookie takes ~110 multiplies rather than 900.
+uint64_t fingerprint64(std::string_view bytes, uint64_t seed) {
+    uint64_t h = seed ^ (bytes.size() * 0x9e3779b97f4a7c15ull);
+    auto mix = [&h](uint64_t word) {
+        h ^= word * 0xff51afd7ed558ccdull;
+        h = ((h << 31) | (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+    };
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, 8);
+        mix(word);
+    }
+    if (i < bytes.size()) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+        mix(word);
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+std::string base64_encode(const std::string& input) {
+    static const char kAlphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((input.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= input.size(); i += 3) {
+        uint32_t n = (static_cast<uint8_t>(input[i]) << 16) |
+                     (static_cast<uint8_t>(input[i + 1]) << 8) |
+                     static_cast<uint8_t>(input[i + 2]);
+        out += kAlphabet[(n >> 18) & 63];
+        out += kAlphabet[(n >> 12) & 63];
+        out += kAlphabet[(n >> 6) & 63];
+        out += kAlphabet[n & 63];
+    }
+    if (i < input.size()) {
+        uint32_t n = static_cast<uint8_t>(input[i]) << 16;
+        if (i + 1 < input.size()) n |= static_cast<uint8_t>(input[i + 1]) << 8;
+        out += kAlphabet[(n >> 18) & 63];
+        out += kAlphabet[(n >> 12) & 63];
+        out += i + 1 < input.size() ? kAlphabet[(n >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
 double to_roblox_tick(
     const std::chrono::system_clock::time_point& time_point) {
     auto duration = time_point.time_since_epoch();
@@ -375,4 +537,121 @@ bool recursive_delete(const std::string& path) {
     return !ec;
 }
 
+namespace {
+
+#ifdef _WIN32
+int open_exclusive(const std::string& path) {
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                 _S_IREAD | _S_IWRITE);
+}
+ptrdiff_t write_some(int fd, const char* data, size_t size) {
+    return _write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+}
+bool sync_file(int fd) { return _commit(fd) == 0; }
+void close_file(int fd) { _close(fd); }
+int process_id() { return _getpid(); }
+void sync_directory_of(const std::string&) {}
+#else
+int open_exclusive(const std::string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+}
+ptrdiff_t write_some(int fd, const char* data, size_t size) {
+    ptrdiff_t written;
+    do {
+        written = ::write(fd, data, size);
+    } while (written < 0 && errno == EINTR);
+    return written;
+}
+bool sync_file(int fd) { return ::fsync(fd) == 0; }
+void close_file(int fd) { ::close(fd); }
+int process_id() { return static_cast<int>(::getpid()); }
+// Make the rename itself durable; best effort.
+void sync_directory_of(const std::string& path) {
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+#endif
+
+constexpr size_t kAtomicWriteBuffer = 64 * 1024;
+std::atomic<uint64_t> temp_file_counter{0};
+
+}  // namespace
+
+AtomicFileWriter::AtomicFileWriter(std::string path) : path_(std::move(path)) {
+    // The pid and counter keep concurrent writers, in this process or
+    // another, from sharing a temporary file; O_EXCL catches leftovers.
+    for (int attempt = 0; attempt < 8 && fd_ < 0; ++attempt) {
+        tmp_path_ = path_ + ".tmp." + std::to_string(process_id()) + "." +
+                    std::to_string(temp_file_counter++);
+        fd_ = open_exclusive(tmp_path_);
+        if (fd_ < 0 && errno != EEXIST) break;
+    }
+}
+
+AtomicFileWriter::~AtomicFileWriter() {
+    if (fd_ < 0) return;
+    close_file(fd_);
+    std::error_code ec;
+    std::filesystem::remove(tmp_path_, ec);
+}
+
+bool AtomicFileWriter::write(std::string_view data) {
+    if (fd_ < 0 || failed_) return false;
+    if (buffer_.size() + data.size() <= kAtomicWriteBuffer) {
+        buffer_.append(data);
+        return true;
+    }
+    flush_buffer();
+    while (!failed_ && !data.empty()) {
+        ptrdiff_t written = write_some(fd_, data.data(), data.size());
+        if (written <= 0) {
+            failed_ = true;
+        } else {
+            data.remove_prefix(static_cast<size_t>(written));
+        }
+    }
+    return !failed_;
+}
+
+void AtomicFileWriter::flush_buffer() {
+    std::string_view pending = buffer_;
+    while (!failed_ && !pending.empty()) {
+        ptrdiff_t written = write_some(fd_, pending.data(), pending.size());
+        if (written <= 0) {
+            failed_ = true;
+        } else {
+            pending.remove_prefix(static_cast<size_t>(written));
+        }
+    }
+    buffer_.clear();
+}
+
+bool AtomicFileWriter::commit() {
+    if (fd_ < 0) return false;
+    flush_buffer();
+    bool ok = !failed_ && sync_file(fd_);
+    close_file(fd_);
+    fd_ = -1;
+
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(tmp_path_, path_, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        std::filesystem::remove(tmp_path_, ec);
+        return false;
+    }
+    sync_directory_of(path_);
+    return true;
+}
+
+bool write_file_atomic(const std::string& path, const std::string& content) {
+    AtomicFileWriter file(path);
+    return file.write(content) && file.commit();
+}
+
 }  // namespace ram
@@ -0,0 +1,102 @@
+#include "ram/websocket.h"
+
+#include "ram/utilities.h"
+
+namespace ram {
+
+namespace {
+
+std::string encode_header(WsOpcode opcode, size_t length, bool masked) {
+    std::string out;
+    out += static_cast<char>(0x80 | static_cast<uint8_t>(opcode));
+    uint8_t mask_bit = masked ? 0x80 : 0;
+    if (length < 126) {
+        out += static_cast<char>(mask_bit | length);
+    } else if (length <= 0xFFFF) {
+        out += static_cast<char>(mask_bit | 126);
+        out += static_cast<char>(length >> 8);
+        out += static_cast<char>(length & 0xFF);
+    } else {
+        out += static_cast<char>(mask_bit | 127);
+        for (int i = 7; i >= 0; --i) out += static_cast<char>((length >> (i * 8)) & 0xFF);
+    }
+    return out;
+}
+
+bool known_opcode(uint8_t op) {
+    return op <= 0x2 || (op >= 0x8 && op <= 0xA);
+}
+
+}  // namespace
+
+WebSocketFrame encode_websocket_frame(WsOpcode opcode, std::string_view payload) {
+    std::string out = encode_header(opcode, payload.size(), false);
+    out.append(payload);
+    return std::make_shared<const std::string>(std::move(out));
+}
+
+std::string encode_masked_websocket_frame(WsOpcode opcode, std::string_view payload,
+                                          uint32_t mask) {
+    std::string out = encode_header(opcode, payload.size(), true);
+    uint8_t key[4] = {static_cast<uint8_t>(mask >> 24), static_cast<uint8_t>(mask >> 16),
+                      static_cast<uint8_t>(mask >> 8), static_cast<uint8_t>(mask)};
+    out.append(reinterpret_cast<const char*>(key), 4);
+    size_t start = out.size();
+    out.append(payload);
+    for (size_t i = 0; i < payload.size(); ++i) out[start + i] ^= static_cast<char>(key[i % 4]);
+    return out;
+}
+
+ParseStatus parse_websocket_frame(std::string_view data, WsFrame& out, size_t& consumed,
+                                  size_t max_payload) {
+    if (data.size() < 2) return ParseStatus::Incomplete;
+    auto byte = [&](size_t i) { return static_cast<uint8_t>(data[i]); };
+
+    uint8_t op = byte(0) & 0x0F;
+    if ((byte(0) & 0x70) != 0 || !known_opcode(op)) return ParseStatus::Error;
+    bool control = op >= 0x8;
+    bool fin = (byte(0) & 0x80) != 0;
+    bool masked = (byte(1) & 0x80) != 0;
+
+    uint64_t length = byte(1) & 0x7F;
+    size_t pos = 2;
+    if (length == 126) {
+        if (data.size() < 4) return ParseStatus::Incomplete;
+        length = (uint64_t{byte(2)} << 8) | byte(3);
+        pos = 4;
+    } else if (length == 127) {
+        if (data.size() < 10) return ParseStatus::Incomplete;
+        length = 0;
+        for (size_t i = 2; i < 10; ++i) length = (length << 8) | byte(i);
+        pos = 10;
+    }
+    // Control frames are never fragmented and carry at most 125 bytes.
+    if (control && (!fin || length > 125)) return ParseStatus::Error;
+    if (length > max_payload) return ParseStatus::Error;
+
+    uint8_t key[4] = {};
+    if (masked) {
+        if (data.size() < pos + 4) return ParseStatus::Incomplete;
+        for (int i = 0; i < 4; ++i) key[i] = byte(pos + i);
+        pos += 4;
+    }
+    if (data.size() - pos < length) return ParseStatus::Incomplete;
+
+    out.fin = fin;
+    out.opcode = static_cast<WsOpcode>(op);
+    out.masked = masked;
+    out.payload.assign(data.substr(pos, static_cast<size_t>(length)));
+    if (masked) {
+        for (size_t i = 0; i < out.payload.size(); ++i) {
+            out.payload[i] = static_cast<char>(out.payload[i] ^ key[i % 4]);
+        }
+    }
+    consumed = pos + static_cast<size_t>(length);
+    return ParseStatus::Complete;
+}
+
+std::string websocket_accept_key(const std::string& client_key) {
+    return base64_encode(sha1_digest(client_key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"));
+}
+
+}  // namespace ram
@@ -0,0 +1,140 @@
+#pragma once
+
+// Minimal local HTTP/1.1 server for tests that talk to Roblox-style APIs.
+// Each accepted connection is served on its own thread; keep-alive and
+// pipelined requests are answered in order. Also home to the other
+// fixtures shared between test files.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/http.h"
+#include "ram/socket.h"
+
+namespace ram::testing {
+
+class StubHttpServer {
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+    explicit StubHttpServer(Handler handler)
+        : handler_(std::move(handler)),
+          listener_(Socket::listen("127.0.0.1", 0)) {
+        accept_thread_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~StubHttpServer() {
+        stopping_ = true;
+        if (accept_thread_.joinable()) accept_thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& t : connection_threads_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    uint16_t port() const { return listener_.local_port(); }
+
+    /// Base URL without a trailing slash, e.g. "http://127.0.0.1:1234".
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port());
+    }
+
+    size_t requests() const { return requests_; }
+    size_t connections() const { return connections_; }
+
+private:
+    void accept_loop() {
+        while (!stopping_) {
+            if (!listener_.wait_readable(std::chrono::milliseconds(20))) continue;
+            Socket client = listener_.accept();
+            if (!client.valid()) continue;
+            ++connections_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            connection_threads_.emplace_back(
+                [this, sock = std::move(client)]() mutable { serve(sock); });
+        }
+    }
+
+    void serve(Socket& sock) {
+        std::string buffer;
+        char chunk[8192];
+        while (!stopping_) {
+            HttpRequest request;
+            size_t consumed = 0;
+            auto status = parse_http_request(buffer, request, consumed);
+            if (status == ParseStatus::Error) return;
+            if (status == ParseStatus::Complete) {
+                buffer.erase(0, consumed);
+                ++requests_;
+                HttpResponse response = handler_(request);
+                const std::string* conn = request.header("Connection");
+                bool close = conn != nullptr && *conn == "close";
+                if (close) response.headers.emplace_back("Connection", "close");
+                // Replies to HEAD keep the Content-Length but not the body.
+                std::string raw = request.method == "HEAD"
+                                      ? serialize_http_response_head(response)
+                                      : serialize_http_response(response);
+                if (!sock.send_all(raw.data(), raw.size(),
+                                   std::chrono::milliseconds(2000)) ||
+                    close) {
+                    return;
+                }
+                continue;
+            }
+
+            if (!sock.wait_readable(std::chrono::milliseconds(20))) continue;
+            ptrdiff_t got =
+                sock.recv_some(chunk, sizeof(chunk), std::chrono::milliseconds(0));
+            if (got <= 0) return;
+            buffer.append(chunk, static_cast<size_t>(got));
+        }
+    }
+
+    Handler handler_;
+    Socket listener_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> requests_{0};
+    std::atomic<size_t> connections_{0};
+    std::mutex mutex_;
+    std::vector<std::thread> connection_threads_;
+    std::thread accept_thread_;
+};
+
+/// Build a JSON response with the given status.
+inline HttpResponse json_response(const std::string& body, int status = 200) {
+    HttpResponse response;
+    response.status = status;
+    response.headers.emplace_back("Content-Type", "application/json");
+    response.body = body;
+    return response;
+}
+
+/// A fresh, empty directory under the system temp directory, removed with
+/// its contents afterwards. The name starts with `prefix` and is unique
+/// across the test processes ctest runs in parallel.
+struct TempDir {
+    std::filesystem::path path;
+
+    explicit TempDir(const std::string& prefix) {
+        path = std::filesystem::temp_directory_path() /
+               (prefix + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_" +
+                std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    std::string file(const std::string& name) const { return (path / name).string(); }
+};
+
+}  // namespace ram::testing
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+
+#include "ram/account_import.h"
+
+namespace {
+
+std::string cookie(const std::string& tail) {
+    return "_|WARNING:-DO-NOT-SHARE-THIS.--Sharing-this-will-allow-someone-to-log-in-as-you-"
+           "and-to-steal-your-ROBUX-and-items.|_" +
+           tail;
+}
+
+}  // namespace
+
+TEST(AccountImportTest, ParsesEachLineForm) {
+    ram::Account account;
+    std::string error;
+    ASSERT_TRUE(ram::parse_import_line(cookie("ABC123"), account, error));
+    EXPECT_EQ(account.security_token, cookie("ABC123"));
+
+    account = {};
+    ASSERT_TRUE(ram::parse_import_line(".ROBLOSECURITY=" + cookie("F00D") + "; path=/", account,
+                                       error));
+    EXPECT_EQ(account.security_token, cookie("F00D"));
+
+    account = {};
+    ASSERT_TRUE(ram::parse_import_line("Builder_1:hunter2:" + cookie("BEEF"), account, error));
+    EXPECT_EQ(account.username, "Builder_1");
+    EXPECT_EQ(account.password(), "hunter2");
+    EXPECT_EQ(account.security_token, cookie("BEEF"));
+
+    account = {};
+    ASSERT_TRUE(ram::parse_import_line("  alt_account:pa:ss word\r", account, error));
+    EXPECT_EQ(account.username, "alt_account");
+    EXPECT_EQ(account.password(), "pa:ss word");
+    EXPECT_TRUE(account.security_token.empty());
+}
+
+TEST(AccountImportTest, RejectsMalformedLines) {
+    ram::Account account;
+    std::string error;
+    EXPECT_FALSE(ram::parse_import_line("no separator", account, error));
+    EXPECT_FALSE(ram::parse_import_line("ab:password", account, error));  // name too short
+    EXPECT_FALSE(ram::parse_import_line("bad name:password", account, error));
+    EXPECT_FALSE(ram::parse_import_line("someone:", account, error));
+    EXPECT_FALSE(ram::parse_import_line(cookie(""), account, error));
+    EXPECT_FALSE(ram::parse_import_line(cookie("AB-CD"), account, error));
+    EXPECT_EQ(error, "malformed cookie");
+}
+
+TEST(AccountImportTest, ReportsErrorsWithLineNumbersAcrossChunks) {
+    std::string text;
+    for (int i = 0; i < 200; ++i) {
+        text += i % 50 == 7 ? "garbage\n" : "user_" + std::to_string(i) + ":pw\n";
+    }
+    text += "\n# comment\n";
+
+    ram::AccountStore store;
+    ram::ImportOptions options;
+    options.threads = 4;
+    options.chunk_bytes = 64;
+    ram::ImportResult result = ram::import_accounts(store, text, options);
+
+    EXPECT_EQ(result.added, 196u);
+    EXPECT_EQ(store.size(), 196u);
+    ASSERT_EQ(result.errors.size(), 4u);
+    EXPECT_EQ(result.errors[0].line, 8u);
+    EXPECT_EQ(result.errors[1].line, 58u);
+    EXPECT_EQ(result.errors[3].line, 158u);
+
+    // Input order is preserved.
+    std::vector<std::string> names;
+    store.for_each([&](const ram::Account& a) { names.push_back(a.username); });
+    EXPECT_EQ(names.front(), "user_0");
+    EXPECT_EQ(names.back(), "user_199");
+}
+
+TEST(AccountImportTest, DeduplicatesAgainstStoreAndBatch) {
+    ram::AccountStore store;
+    ram::Account existing(cookie("AAAA"));
+    existing.username = "Existing";
+    existing.user_id = 42;
+    ASSERT_TRUE(store.add(existing));
+    uint64_t version = store.version();
+
+    std::string text = cookie("AAAA") + "\n" +      // in the store
+                       "existing:pw\n" +            // same name, different case
+                       cookie("BBBB") + "\n" +
+                       cookie("BBBB") + "\n" +      // earlier line
+                       "fresh_one:pw\n" +
+                       "FRESH_ONE:other\n" +        // earlier line
+                       cookie("CCCC") + "\n";
+    ram::ImportOptions options;
+    options.group = "Imported";
+    options.validate = [](ram::Account& account) {
+        if (account.security_token == cookie("CCCC")) account.user_id = 42;  // same user
+        return true;
+    };
+    ram::ImportResult result = ram::import_accounts(store, text, options);
+
+    EXPECT_EQ(result.added, 2u);
+    EXPECT_EQ(result.duplicates, 5u);
+    EXPECT_TRUE(result.errors.empty());
+    EXPECT_EQ(store.size(), 3u);
+    EXPECT_EQ(store.version(), version + 1);  // one transaction
+    std::string group;
+    store.read("fresh_one", [&](const ram::Account& a) { group = a.group; });
+    EXPECT_EQ(group, "Imported");
+}
+
+TEST(AccountImportTest, ValidationRejectsLines) {
+    ram::AccountStore store;
+    ram::ImportOptions options;
+    options.threads = 2;
+    std::atomic<int> calls{0};
+    options.validate = [&](ram::Account& account) {
+        ++calls;
+        return account.security_token != cookie("DEAD");
+    };
+    auto result = ram::import_accounts(store, cookie("DEAD") + "\n" + cookie("F00D"), options);
+    EXPECT_EQ(calls.load(), 2);
+    EXPECT_EQ(result.added, 1u);
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_EQ(result.errors[0].line, 1u);
+}
+
+TEST(AccountImportTest, SavesOnceWhenAnythingWasAdded) {
+    auto path = std::filesystem::temp_directory_path() / "ram_account_import_test.json";
+    std::filesystem::remove(path);
+    ram::AccountStore store;
+    ram::ImportOptions options;
+    options.save_path = path.string();
+
+    auto result = ram::import_accounts(store, "nothing here\n", options);
+    EXPECT_FALSE(result.saved);
+    EXPECT_FALSE(std::filesystem::exists(path));
+
+    result = ram::import_accounts(store, "someone:pw\n" + cookie("ABCD") + "\n", options);
+    EXPECT_TRUE(result.saved);
+    ram::AccountStore loaded;
+    loaded.load(path.string());
+    EXPECT_EQ(loaded.size(), 2u);
+    std::filesystem::remove(path);
+}
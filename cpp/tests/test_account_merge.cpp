@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "ram/account_merge.h"
+#include "ram/account_store.h"
+
+namespace {
+
+using std::chrono::seconds;
+using std::chrono::system_clock;
+
+ram::Account make_account(const std::string& token, int64_t id, int64_t last_use) {
+    ram::Account acc(token);
+    acc.user_id = id;
+    acc.last_use = system_clock::time_point(seconds(last_use));
+    return acc;
+}
+
+}  // namespace
+
+TEST(AccountMergeTest, NewestLastUseWinsAndFieldsAreUnioned) {
+    ram::AccountMerger merger;
+    auto old_copy = make_account("cookie-old", 1, 100);
+    old_copy.username = "alpha";
+    old_copy.fields = {{"SavedPlaceId", "1"}, {"OnlyOld", "x"}};
+    auto new_copy = make_account("cookie-new", 1, 200);
+    new_copy.username = "alpha_renamed";
+    new_copy.fields = {{"SavedPlaceId", "2"}, {"OnlyNew", "y"}};
+
+    merger.add(old_copy);
+    merger.add(make_account("cookie-beta", 2, 50));
+    merger.add(new_copy);
+
+    ASSERT_EQ(merger.accounts().size(), 2u);
+    const ram::Account& merged = merger.accounts()[0];  // first-seen order
+    EXPECT_EQ(merged.username, "alpha_renamed");
+    EXPECT_EQ(merged.security_token, "cookie-new");
+    EXPECT_EQ(merged.fields.at("SavedPlaceId"), "2");
+    EXPECT_EQ(merged.fields.at("OnlyOld"), "x");
+    EXPECT_EQ(merged.fields.at("OnlyNew"), "y");
+
+    // An older copy arriving later loses, and the cookie it replaced still
+    // matches the record.
+    auto stale = make_account("cookie-old", 0, 10);
+    stale.username = "stale";
+    merger.add(stale);
+    EXPECT_EQ(merger.accounts().size(), 2u);
+    EXPECT_EQ(merger.accounts()[0].username, "alpha_renamed");
+
+    ram::MergeStats stats = merger.stats();
+    EXPECT_EQ(stats.read, 4u);
+    EXPECT_EQ(stats.merged, 2u);
+    EXPECT_EQ(stats.replaced, 1u);
+}
+
+TEST(AccountMergeTest, FallsBackToTokenWithoutUserId) {
+    ram::AccountMerger merger;
+    merger.add(make_account("cookie-a", 0, 100));
+    merger.add(make_account("cookie-a", 77, 50));  // same cookie, now with an ID
+    merger.add(make_account("cookie-b", 0, 100));
+    merger.add(ram::Account());                    // no keys: always kept
+    merger.add(ram::Account());
+
+    ASSERT_EQ(merger.accounts().size(), 4u);
+    EXPECT_EQ(merger.accounts()[0].user_id, 77);  // filled in from the loser
+    merger.add(make_account("cookie-c", 77, 300));
+    EXPECT_EQ(merger.accounts().size(), 4u);
+    EXPECT_EQ(merger.accounts()[0].security_token, "cookie-c");
+}
+
+TEST(AccountMergeTest, MergesFilesAndStreamsTheResult) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "ram_account_merge_test";
+    fs::create_directories(dir);
+
+    ram::AccountStore first;
+    first.add(make_account("cookie-1", 1, 100));
+    first.add(make_account("cookie-2", 2, 100));
+    ASSERT_TRUE(first.save((dir / "a.json").string()));
+    ram::AccountStore second;
+    auto newer = make_account("cookie-2b", 2, 200);
+    newer.fields["Note"] = "from b";
+    second.add(newer);
+    second.add(make_account("cookie-3", 3, 100));
+    ASSERT_TRUE(second.save((dir / "b.json").string()));
+
+    ram::AccountMerger merger;
+    merger.add_file((dir / "a.json").string());
+    merger.add_file((dir / "b.json").string());
+    merger.add_file((dir / "missing.json").string());
+    EXPECT_EQ(merger.stats().inputs, 3u);
+    ASSERT_TRUE(merger.save((dir / "merged.json").string()));
+
+    ram::AccountStore merged;
+    merged.load((dir / "merged.json").string());
+    ASSERT_EQ(merged.size(), 3u);
+    std::string note;
+    merged.read("2", [&](const ram::Account& a) { note = a.fields.at("Note"); });
+    EXPECT_EQ(note, "from b");
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        EXPECT_EQ(entry.path().string().find(".tmp"), std::string::npos) << entry.path();
+    }
+
+    // An empty merge still writes a valid, empty list.
+    ASSERT_TRUE(ram::AccountMerger().save((dir / "empty.json").string()));
+    merged.load((dir / "empty.json").string());
+    EXPECT_EQ(merged.size(), 0u);
+    fs::remove_all(dir);
+}
+
+TEST(AccountMergeTest, RejectsMalformedInput) {
+    ram::AccountMerger merger;
+    EXPECT_THROW(merger.add_json(R"({"not": "an array"})"), std::runtime_error);
+    EXPECT_THROW(merger.add_json("[1, 2"), std::runtime_error);
+    EXPECT_THROW(merger.add_json("[1]"), std::runtime_error);
+    merger.add_json("");
+    merger.add_json(R"([{"SecurityToken": "t", "UserID": 5, "Fields": {"A": "1"}}, {"UserID": 5}])");
+    ASSERT_EQ(merger.accounts().size(), 1u);
+    EXPECT_EQ(merger.accounts()[0].fields.at("A"), "1");
+
+    // A truncated file merges nothing, not just its leading accounts.
+    size_t read = merger.stats().read;
+    EXPECT_THROW(merger.add_json(R"([{"SecurityToken": "u", "UserID": 6}, {"UserID": )"),
+                 std::runtime_error);
+    EXPECT_THROW(merger.add_json(R"([{"SecurityToken": "u", "UserID": 6}, 7])"),
+                 std::runtime_error);
+    EXPECT_EQ(merger.accounts().size(), 1u);
+    EXPECT_EQ(merger.stats().read, read);
+}
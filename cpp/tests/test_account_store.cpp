@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "ram/account_store.h"
+#include "ram/utilities.h"
+
+namespace {
+
+ram::Account make_account(const std::string& name, int64_t id) {
+    ram::Account acc("cookie-" + name);
+    acc.username = name;
+    acc.user_id = id;
+    return acc;
+}
+
+}  // namespace
+
+TEST(AccountStoreTest, LooksUpByNameOrUserId) {
+    ram::AccountStore store;
+    ASSERT_TRUE(store.add(make_account("alpha", 1)));
+    ASSERT_TRUE(store.add(make_account("beta", 2)));
+
+    std::string seen;
+    EXPECT_TRUE(store.read("beta", [&](const ram::Account& a) { seen = a.username; }));
+    EXPECT_EQ(seen, "beta");
+    EXPECT_TRUE(store.read("1", [&](const ram::Account& a) { seen = a.username; }));
+    EXPECT_EQ(seen, "alpha");
+    EXPECT_FALSE(store.read("gamma", [](const ram::Account&) {}));
+}
+
+TEST(AccountStoreTest, FirstMatchInListOrderWins) {
+    ram::AccountStore store;
+    // An account named like another account's user ID.
+    store.add(make_account("2", 1));
+    store.add(make_account("beta", 2));
+
+    std::string seen;
+    store.read("2", [&](const ram::Account& a) { seen = a.username; });
+    EXPECT_EQ(seen, "2");
+}
+
+TEST(AccountStoreTest, AddRejectsDuplicates) {
+    ram::AccountStore store;
+    EXPECT_TRUE(store.add(make_account("alpha", 1)));
+    EXPECT_FALSE(store.add(make_account("alpha2", 1)));
+
+    ram::Account anonymous("token");
+    EXPECT_TRUE(store.add(anonymous));
+    EXPECT_FALSE(store.add(anonymous));
+    EXPECT_EQ(store.size(), 2u);
+}
+
+TEST(AccountStoreTest, MutationsBumpVersionAndReindex) {
+    ram::AccountStore store;
+    store.add(make_account("alpha", 1));
+    uint64_t v = store.version();
+
+    EXPECT_TRUE(store.update("alpha", [](ram::Account& a) { a.username = "renamed"; }));
+    EXPECT_GT(store.version(), v);
+    EXPECT_FALSE(store.read("alpha", [](const ram::Account&) {}));
+    EXPECT_TRUE(store.read("renamed", [](const ram::Account&) {}));
+
+    v = store.version();
+    EXPECT_TRUE(store.remove("1"));
+    EXPECT_GT(store.version(), v);
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_FALSE(store.remove("1"));
+}
+
+TEST(AccountStoreTest, SaveAndLoadRoundTrip) {
+    auto path = std::filesystem::temp_directory_path() / "ram_account_store_test.json";
+    ram::AccountStore store;
+    auto acc = make_account("alpha", 1);
+    acc.fields["SavedPlaceId"] = "123";
+    store.add(acc);
+    store.add(make_account("beta", 2));
+    ASSERT_TRUE(store.save(path.string()));
+
+    ram::AccountStore loaded;
+    loaded.load(path.string());
+    EXPECT_EQ(loaded.size(), 2u);
+    std::string place;
+    loaded.read("alpha", [&](const ram::Account& a) { place = a.fields.at("SavedPlaceId"); });
+    EXPECT_EQ(place, "123");
+    std::filesystem::remove(path);
+}
+
+TEST(AccountStoreTest, LoadRejectsMalformedData) {
+    ram::AccountStore store;
+    EXPECT_THROW(store.load_json("{\"not\": \"an array\"}"), std::runtime_error);
+    EXPECT_THROW(store.load_json("[1, 2"), std::runtime_error);
+
+    store.load_json("");
+    EXPECT_EQ(store.size(), 0u);
+}
+
+TEST(AccountStoreTest, TransactionBumpsVersionOnceForEdits) {
+    ram::AccountStore store;
+    store.add(make_account("alpha", 1));
+    store.add(make_account("beta", 2));
+    uint64_t v = store.version();
+
+    EXPECT_FALSE(store.transact([](ram::AccountStore::Transaction& tx) {
+        EXPECT_NE(tx.find("alpha"), nullptr);
+        EXPECT_EQ(tx.find("nobody"), nullptr);
+    }));
+    EXPECT_EQ(store.version(), v);
+
+    EXPECT_TRUE(store.transact([](ram::AccountStore::Transaction& tx) {
+        tx.find("alpha")->group = "Main";
+        tx.find("2")->group = "Main";
+        tx.touch();
+    }));
+    EXPECT_EQ(store.version(), v + 1);
+    store.for_each([](const ram::Account& a) { EXPECT_EQ(a.group, "Main"); });
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/client_settings.h"
+#include "stub_http_server.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A fake Roblox versions folder, removed afterwards.
+struct TempDir : ram::testing::TempDir {
+    TempDir() : ram::testing::TempDir("ram_client_settings_") {}
+
+    std::string install(const std::string& name) const {
+        fs::path dir = path / name;
+        fs::create_directories(dir);
+        std::ofstream(dir / "RobloxPlayerBeta.exe") << "exe";
+        return dir.string();
+    }
+};
+
+std::string read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void write(const std::string& path, const std::string& content) {
+    fs::create_directories(fs::path(path).parent_path());
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+ram::ClientSettingsConfig unlock(int fps) {
+    ram::ClientSettingsConfig config;
+    config.unlock_fps = true;
+    config.max_fps = fps;
+    return config;
+}
+
+}  // namespace
+
+TEST(ClientSettingsTest, ReadsGeneralSection) {
+    ram::IniSection general("General");
+    general.set("UnlockFPS", "true");
+    general.set("MaxFPSValue", "144");
+    general.set("CustomClientSettings", "C:\\settings.json");
+    auto config = ram::ClientSettingsConfig::from_ini(general);
+    EXPECT_TRUE(config.unlock_fps);
+    EXPECT_EQ(config.max_fps, 144);
+    EXPECT_EQ(config.custom_file, "C:\\settings.json");
+
+    EXPECT_EQ(ram::ClientSettingsConfig::from_ini(ram::IniSection("General")).max_fps, 240);
+}
+
+TEST(ClientSettingsTest, WritesOnceThenSkipsUnchangedFiles) {
+    TempDir root;
+    std::string dir = root.install("version-abc");
+    ram::ClientSettingsPatcher patcher(unlock(144));
+
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    std::string target = ram::ClientSettingsPatcher::settings_path(dir);
+    EXPECT_EQ(nlohmann::json::parse(read(target))["DFIntTaskSchedulerTargetFps"], 144);
+    auto written_at = fs::last_write_time(target);
+
+    for (int i = 0; i < 20; ++i) EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Unchanged);
+    EXPECT_EQ(fs::last_write_time(target), written_at);
+
+    auto stats = patcher.stats();
+    EXPECT_EQ(stats.patches, 21u);
+    EXPECT_EQ(stats.writes, 1u);
+    EXPECT_EQ(stats.unchanged, 20u);
+    EXPECT_EQ(stats.generations, 1u);
+}
+
+TEST(ClientSettingsTest, MergesIntoExistingSettings) {
+    TempDir root;
+    std::string dir = root.install("version-abc");
+    std::string target = ram::ClientSettingsPatcher::settings_path(dir);
+    write(target, R"({"FFlagDebugGraphicsPreferVulkan":true,"DFIntTaskSchedulerTargetFps":60})");
+
+    ram::ClientSettingsPatcher patcher(unlock(240));
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    auto settings = nlohmann::json::parse(read(target));
+    EXPECT_EQ(settings["DFIntTaskSchedulerTargetFps"], 240);
+    EXPECT_EQ(settings["FFlagDebugGraphicsPreferVulkan"], true);
+
+    // Already at the desired value: left alone even on first sight.
+    ram::ClientSettingsPatcher fresh(unlock(240));
+    EXPECT_EQ(fresh.patch(dir), ram::PatchResult::Unchanged);
+
+    // Not JSON: replaced with just the FPS setting.
+    write(target, "garbage");
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    EXPECT_EQ(read(target), R"({"DFIntTaskSchedulerTargetFps":240})");
+}
+
+TEST(ClientSettingsTest, RepatchesAfterExternalEditsAndNewGenerations) {
+    TempDir root;
+    std::string dir = root.install("version-abc");
+    std::string target = ram::ClientSettingsPatcher::settings_path(dir);
+    ram::ClientSettingsPatcher patcher(unlock(144));
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+
+    // Something else rewrote the file: the hash no longer matches.
+    write(target, R"({"DFIntTaskSchedulerTargetFps":30})");
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    EXPECT_EQ(nlohmann::json::parse(read(target))["DFIntTaskSchedulerTargetFps"], 144);
+
+    uint64_t before = patcher.generation();
+    patcher.configure(unlock(360));
+    EXPECT_GT(patcher.generation(), before);
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    EXPECT_EQ(nlohmann::json::parse(read(target))["DFIntTaskSchedulerTargetFps"], 360);
+    EXPECT_EQ(patcher.stats().generations, 2u);
+
+    patcher.configure({});
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Skipped);
+}
+
+TEST(ClientSettingsTest, CopiesCustomSettingsFile) {
+    TempDir root;
+    std::string dir = root.install("version-abc");
+    std::string custom = (root.path / "custom.json").string();
+    write(custom, R"({"FIntDebugForceMSAASamples":4})");
+    std::string target = ram::ClientSettingsPatcher::settings_path(dir);
+    write(target, R"({"old":1})");
+
+    ram::ClientSettingsConfig config = unlock(240);
+    config.custom_file = custom;
+    ram::ClientSettingsPatcher patcher(config);
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    EXPECT_EQ(read(target), read(custom));
+
+    // A fresh patcher recognises the copy by its hash.
+    ram::ClientSettingsPatcher again(config);
+    EXPECT_EQ(again.patch(dir), ram::PatchResult::Unchanged);
+
+    // A missing custom file falls back to unlock_fps, as PatchSettings did.
+    config.custom_file = (root.path / "missing.json").string();
+    patcher.configure(config);
+    EXPECT_EQ(patcher.patch(dir), ram::PatchResult::Written);
+    EXPECT_EQ(nlohmann::json::parse(read(target))["DFIntTaskSchedulerTargetFps"], 240);
+}
+
+TEST(ClientSettingsTest, PatchesEveryInstallInParallel) {
+    TempDir root;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 6; ++i) expected.push_back(root.install("version-" + std::to_string(i)));
+    fs::create_directories(root.path / "version-empty");  // no executable
+    fs::create_directories(root.path / "Downloads");
+
+    auto dirs = ram::ClientSettingsPatcher::find_version_dirs(root.path.string());
+    EXPECT_EQ(dirs, expected);
+
+    ram::ClientSettingsPatcher patcher(unlock(144));
+    auto results = patcher.patch_all(dirs, 3);
+    ASSERT_EQ(results.size(), dirs.size());
+    for (auto result : results) EXPECT_EQ(result, ram::PatchResult::Written);
+
+    results = patcher.patch_all(dirs, 3);
+    for (auto result : results) EXPECT_EQ(result, ram::PatchResult::Unchanged);
+    EXPECT_EQ(patcher.stats().writes, dirs.size());
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/coalescer.h"
+
+namespace {
+
+// In-process stand-in for a multiget API: echoes "asset-<id>" for every
+// positive id and records each batch it receives.
+struct FakeBackend {
+    std::mutex mutex;
+    std::vector<std::vector<int64_t>> calls;
+
+    std::unordered_map<int64_t, std::string> operator()(
+        const std::vector<int64_t>& keys) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            calls.push_back(keys);
+        }
+        std::unordered_map<int64_t, std::string> out;
+        for (auto key : keys) {
+            if (key > 0) out[key] = "asset-" + std::to_string(key);
+        }
+        return out;
+    }
+};
+
+using IntCoalescer = ram::Coalescer<int64_t, std::string>;
+
+}  // namespace
+
+TEST(CoalescerTest, BatchesWithinWindow) {
+    FakeBackend backend;
+    IntCoalescer coalescer([&](const auto& keys) { return backend(keys); },
+                           {100, std::chrono::milliseconds(30)});
+
+    auto a = coalescer.submit(1);
+    auto b = coalescer.submit(2);
+    auto c = coalescer.submit(3);
+
+    EXPECT_EQ(a.get(), "asset-1");
+    EXPECT_EQ(b.get(), "asset-2");
+    EXPECT_EQ(c.get(), "asset-3");
+
+    std::lock_guard<std::mutex> lock(backend.mutex);
+    ASSERT_EQ(backend.calls.size(), 1);
+    EXPECT_EQ(backend.calls[0], (std::vector<int64_t>{1, 2, 3}));
+
+    auto stats = coalescer.stats();
+    EXPECT_EQ(stats.batches, 1);
+    EXPECT_EQ(stats.deadline_flushes, 1);
+}
+
+TEST(CoalescerTest, MergesDuplicateKeys) {
+    FakeBackend backend;
+    IntCoalescer coalescer([&](const auto& keys) { return backend(keys); },
+                           {100, std::chrono::milliseconds(30)});
+
+    auto first = coalescer.submit(7);
+    auto second = coalescer.submit(7);
+
+    EXPECT_EQ(first.get(), "asset-7");
+    EXPECT_EQ(second.get(), "asset-7");
+
+    auto stats = coalescer.stats();
+    EXPECT_EQ(stats.submitted, 2);
+    EXPECT_EQ(stats.merged, 1);
+    EXPECT_EQ(stats.batched_keys, 1);
+}
+
+TEST(CoalescerTest, FlushesWhenFull) {
+    FakeBackend backend;
+    // A long window so only the size limit can trigger the flush.
+    IntCoalescer coalescer([&](const auto& keys) { return backend(keys); },
+                           {4, std::chrono::milliseconds(10000)});
+
+    std::vector<std::shared_future<std::string>> futures;
+    for (int64_t i = 1; i <= 4; ++i) futures.push_back(coalescer.submit(i));
+
+    ASSERT_EQ(futures[3].wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    auto stats = coalescer.stats();
+    EXPECT_EQ(stats.size_flushes, 1);
+    EXPECT_DOUBLE_EQ(stats.fill_ratio(4), 1.0);
+}
+
+TEST(CoalescerTest, SplitsOversizedBatches) {
+    FakeBackend backend;
+    IntCoalescer coalescer([&](const auto& keys) { return backend(keys); },
+                           {3, std::chrono::milliseconds(20)});
+
+    std::vector<std::shared_future<std::string>> futures;
+    for (int64_t i = 1; i <= 7; ++i) futures.push_back(coalescer.submit(i));
+    for (size_t i = 0; i < futures.size(); ++i) {
+        EXPECT_EQ(futures[i].get(), "asset-" + std::to_string(i + 1));
+    }
+
+    std::lock_guard<std::mutex> lock(backend.mutex);
+    for (const auto& call : backend.calls) EXPECT_LE(call.size(), 3);
+}
+
+TEST(CoalescerTest, MissingResultFailsOnlyThatKey) {
+    FakeBackend backend;
+    IntCoalescer coalescer([&](const auto& keys) { return backend(keys); },
+                           {100, std::chrono::milliseconds(10)});
+
+    auto good = coalescer.submit(5);
+    auto missing = coalescer.submit(-1);
+
+    EXPECT_EQ(good.get(), "asset-5");
+    EXPECT_THROW(missing.get(), std::out_of_range);
+}
+
+TEST(CoalescerTest, BackendErrorPropagatesToBatch) {
+    IntCoalescer coalescer(
+        [](const std::vector<int64_t>&) -> IntCoalescer::ResultMap {
+            throw std::runtime_error("503 Batch request failed");
+        },
+        {100, std::chrono::milliseconds(10)});
+
+    auto a = coalescer.submit(1);
+    auto b = coalescer.submit(2);
+
+    EXPECT_THROW(a.get(), std::runtime_error);
+    EXPECT_THROW(b.get(), std::runtime_error);
+    EXPECT_EQ(coalescer.stats().failed_batches, 1);
+}
+
+TEST(CoalescerTest, ExplicitFlush) {
+    FakeBackend backend;
+    IntCoalescer coalescer([&](const auto& keys) { return backend(keys); },
+                           {100, std::chrono::milliseconds(10000)});
+
+    auto a = coalescer.submit(1);
+    coalescer.flush();
+    ASSERT_EQ(a.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(a.get(), "asset-1");
+}
+
+TEST(CoalescerTest, ConcurrentSubmitters) {
+    std::atomic<int> calls{0};
+    IntCoalescer coalescer(
+        [&](const std::vector<int64_t>& keys) {
+            ++calls;
+            IntCoalescer::ResultMap out;
+            for (auto key : keys) out[key] = std::to_string(key * 2);
+            return out;
+        },
+        {50, std::chrono::milliseconds(20)});
+
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong{0};
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int64_t i = 0; i < 25; ++i) {
+                int64_t key = t * 25 + i;
+                if (coalescer.submit(key).get() != std::to_string(key * 2)) {
+                    ++wrong;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(wrong.load(), 0);
+    EXPECT_EQ(coalescer.stats().batched_keys, 200);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ram/cookie_refresh.h"
+
+namespace {
+
+using Clock = ram::CookieRefreshScheduler::Clock;
+using std::chrono::hours;
+using std::chrono::milliseconds;
+
+ram::Account account_at(Clock::time_point last_use,
+                        Clock::time_point last_attempted = {}) {
+    ram::Account acc("cookie");
+    acc.last_use = last_use;
+    acc.last_attempted_refresh = last_attempted;
+    return acc;
+}
+
+// Poll until `pred` holds or the timeout passes.
+template <typename Pred>
+bool eventually(Pred pred, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    return pred();
+}
+
+}  // namespace
+
+TEST(CookieRefreshTest, EligibilityMatchesTimerRule) {
+    ram::CookieRefreshScheduler scheduler([](const std::string&, Clock::time_point) {
+        return true;
+    });
+    auto now = Clock::now();
+
+    // Unused for 20 days and not attempted for 7.
+    auto due = scheduler.eligible_at(account_at(now - hours(24), now - hours(24 * 30)));
+    ASSERT_TRUE(due.has_value());
+    EXPECT_EQ(*due, now - hours(24) + hours(24 * 20));
+
+    due = scheduler.eligible_at(account_at(now - hours(24 * 30), now - hours(24)));
+    EXPECT_EQ(*due, now - hours(24) + hours(24 * 7));
+
+    auto opted_out = account_at(now);
+    opted_out.fields["NoCookieRefresh"] = "true";
+    EXPECT_FALSE(scheduler.eligible_at(opted_out).has_value());
+}
+
+TEST(CookieRefreshTest, HeapTracksEarliestAcrossUpdates) {
+    ram::CookieRefreshScheduler scheduler([](const std::string&, Clock::time_point) {
+        return true;
+    });
+
+    constexpr int kAccounts = 100000;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> offset(0, 24 * 365);
+    auto base = Clock::now() - hours(24 * 400);
+    std::unordered_map<std::string, Clock::time_point> due;
+
+    auto set = [&](int i) {
+        std::string key = std::to_string(i);
+        auto acc = account_at(base + hours(offset(rng)));
+        scheduler.update(key, acc);
+        due[key] = *scheduler.eligible_at(acc);
+    };
+    for (int i = 0; i < kAccounts; ++i) set(i);
+    for (int i = 0; i < kAccounts; i += 3) set(i);  // reschedule a third
+    for (int i = 1; i < kAccounts; i += 7) {
+        scheduler.remove(std::to_string(i));
+        due.erase(std::to_string(i));
+    }
+
+    EXPECT_EQ(scheduler.scheduled(), due.size());
+    auto earliest = std::min_element(due.begin(), due.end(), [](auto& a, auto& b) {
+        return a.second < b.second;
+    });
+    EXPECT_EQ(scheduler.next_due(), earliest->second);
+    EXPECT_EQ(scheduler.due_at("0"), due["0"]);
+    EXPECT_FALSE(scheduler.due_at("1").has_value());
+
+    // Draining from the front yields due times in order.
+    std::vector<std::pair<Clock::time_point, std::string>> order;
+    for (auto& [key, when] : due) order.emplace_back(when, key);
+    std::sort(order.begin(), order.end());
+    for (size_t n = 0; n < 1000; ++n) {
+        EXPECT_EQ(scheduler.next_due(), order[n].first);
+        scheduler.remove(order[n].second);
+    }
+}
+
+TEST(CookieRefreshTest, RefreshesWhenDueAndReschedules) {
+    std::mutex mutex;
+    std::vector<std::pair<std::string, Clock::time_point>> refreshed;
+    ram::CookieRefreshOptions options;
+    options.stale_after = milliseconds(60);
+    options.retry_after = hours(1);
+    options.refreshes_per_second = 1000;
+    ram::CookieRefreshScheduler scheduler(
+        [&](const std::string& key, Clock::time_point at) {
+            std::lock_guard<std::mutex> lock(mutex);
+            refreshed.emplace_back(key, at);
+            return true;
+        },
+        options);
+
+    auto now = Clock::now();
+    scheduler.update("a", account_at(now));
+    auto opted_out = account_at(now);
+    opted_out.fields["NoCookieRefresh"] = "true";
+    scheduler.update("b", opted_out);
+    scheduler.start();
+
+    ASSERT_TRUE(eventually([&] { return scheduler.stats().succeeded == 1; }));
+    std::this_thread::sleep_for(milliseconds(50));
+    scheduler.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(refreshed.size(), 1u);
+    EXPECT_EQ(refreshed[0].first, "a");
+    EXPECT_GE(refreshed[0].second, now + milliseconds(60));
+    EXPECT_EQ(scheduler.due_at("a"), refreshed[0].second + hours(1));
+    EXPECT_FALSE(scheduler.due_at("b").has_value());
+}
+
+TEST(CookieRefreshTest, BoundsConcurrency) {
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    ram::CookieRefreshOptions options;
+    options.max_in_flight = 3;
+    options.refreshes_per_second = 1000;
+    options.burst = 100;
+    ram::CookieRefreshScheduler scheduler(
+        [&](const std::string&, Clock::time_point) {
+            int now = ++active;
+            int prev = peak.load();
+            while (now > prev && !peak.compare_exchange_weak(prev, now)) {
+            }
+            std::this_thread::sleep_for(milliseconds(20));
+            --active;
+            return false;
+        },
+        options);
+
+    for (int i = 0; i < 20; ++i) scheduler.update(std::to_string(i), account_at({}));
+    scheduler.start();
+    ASSERT_TRUE(eventually([&] { return scheduler.stats().attempted == 20; }));
+    scheduler.stop();
+
+    EXPECT_EQ(peak.load(), 3);
+    EXPECT_EQ(scheduler.stats().failed, 20u);
+    // A failed attempt still waits retry_after before the next one.
+    EXPECT_EQ(scheduler.scheduled(), 20u);
+    EXPECT_GT(*scheduler.next_due(), Clock::now() + hours(24));
+}
+
+TEST(CookieRefreshTest, RespectsRateBudget) {
+    ram::CookieRefreshOptions options;
+    options.max_in_flight = 4;
+    options.refreshes_per_second = 20;
+    options.burst = 1;
+    ram::CookieRefreshScheduler scheduler(
+        [](const std::string&, Clock::time_point) { return true; }, options);
+
+    for (int i = 0; i < 5; ++i) scheduler.update(std::to_string(i), account_at({}));
+    auto start = std::chrono::steady_clock::now();
+    scheduler.start();
+    ASSERT_TRUE(eventually([&] { return scheduler.stats().attempted == 5; }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, milliseconds(180));
+}
+
+TEST(CookieRefreshTest, SleepsWhileNothingIsDue) {
+    ram::CookieRefreshScheduler scheduler(
+        [](const std::string&, Clock::time_point) { return true; });
+    for (int i = 0; i < 1000; ++i) {
+        scheduler.update(std::to_string(i), account_at(Clock::now()));
+    }
+    scheduler.start();
+    std::this_thread::sleep_for(milliseconds(100));
+    EXPECT_LE(scheduler.stats().wakeups, 2u);
+    EXPECT_EQ(scheduler.stats().attempted, 0u);
+}
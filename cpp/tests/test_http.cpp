@@ -0,0 +1,477 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/http.h"
+#include "ram/socket.h"
+#include "stub_http_server.h"
+
+TEST(HttpTest, ParseUrl) {
+    auto url = ram::Url::parse("http://127.0.0.1:8080/v1/users?limit=10");
+    ASSERT_TRUE(url.has_value());
+    EXPECT_EQ(url->scheme, "http");
+    EXPECT_EQ(url->host, "127.0.0.1");
+    EXPECT_EQ(url->port, 8080);
+    EXPECT_EQ(url->target, "/v1/users?limit=10");
+    EXPECT_EQ(url->authority(), "127.0.0.1:8080");
+}
+
+TEST(HttpTest, ParseUrlDefaults) {
+    auto url = ram::Url::parse("https://presence.roblox.com");
+    ASSERT_TRUE(url.has_value());
+    EXPECT_EQ(url->port, 443);
+    EXPECT_EQ(url->target, "/");
+
+    EXPECT_FALSE(ram::Url::parse("not a url").has_value());
+    EXPECT_FALSE(ram::Url::parse("http://host:notaport/").has_value());
+}
+
+TEST(HttpTest, ParsePipelinedRequests) {
+    std::string data =
+        "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+        "GET /b HTTP/1.1\r\nHost: x\r\n\r\n";
+
+    ram::HttpRequest first;
+    size_t consumed = 0;
+    ASSERT_EQ(ram::parse_http_request(data, first, consumed),
+              ram::ParseStatus::Complete);
+    EXPECT_EQ(first.method, "POST");
+    EXPECT_EQ(first.url, "/a");
+    EXPECT_EQ(first.body, "abc");
+
+    ram::HttpRequest second;
+    std::string rest = data.substr(consumed);
+    ASSERT_EQ(ram::parse_http_request(rest, second, consumed),
+              ram::ParseStatus::Complete);
+    EXPECT_EQ(second.method, "GET");
+    EXPECT_EQ(*second.header("host"), "x");
+}
+
+TEST(HttpTest, ParseIncompleteRequest) {
+    ram::HttpRequest req;
+    size_t consumed = 0;
+    EXPECT_EQ(ram::parse_http_request("GET / HTTP/1.1\r\n", req, consumed),
+              ram::ParseStatus::Incomplete);
+    EXPECT_EQ(ram::parse_http_request(
+                  "POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nab", req,
+                  consumed),
+              ram::ParseStatus::Incomplete);
+    EXPECT_EQ(ram::parse_http_request("garbage\r\n\r\n", req, consumed),
+              ram::ParseStatus::Error);
+}
+
+// Sizes near SIZE_MAX used to wrap offset arithmetic: a chunked request
+// looped forever and a huge Content-Length completed with a bogus length.
+TEST(HttpTest, ParseRejectsOversizedBodies) {
+    ram::HttpRequest req;
+    size_t consumed = 0;
+    std::string huge_chunk =
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "FFFFFFFFFFFFFFEC\r\nab\r\n0\r\n\r\n";
+    std::string huge_length =
+        "POST / HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\nab";
+    EXPECT_EQ(ram::parse_http_request(huge_chunk, req, consumed, 1 << 20),
+              ram::ParseStatus::Error);
+    EXPECT_EQ(ram::parse_http_request(huge_length, req, consumed, 1 << 20),
+              ram::ParseStatus::Error);
+    // Without a limit they simply never complete.
+    EXPECT_EQ(ram::parse_http_request(huge_chunk, req, consumed), ram::ParseStatus::Incomplete);
+    EXPECT_EQ(ram::parse_http_request(huge_length, req, consumed), ram::ParseStatus::Incomplete);
+
+    std::string chunked =
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "4\r\nabcd\r\n4\r\nefgh\r\n0\r\n\r\n";
+    EXPECT_EQ(ram::parse_http_request(chunked, req, consumed, 8), ram::ParseStatus::Complete);
+    EXPECT_EQ(req.body, "abcdefgh");
+    EXPECT_EQ(ram::parse_http_request(chunked, req, consumed, 7), ram::ParseStatus::Error);
+    EXPECT_EQ(ram::parse_http_request("POST / HTTP/1.1\r\nContent-Length: 9\r\n\r\n",
+                                      req, consumed, 8),
+              ram::ParseStatus::Error);
+
+    // Chunk data must be followed by CRLF.
+    EXPECT_EQ(ram::parse_http_request(
+                  "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                  "2\r\nabcd\r\n0\r\n\r\n",
+                  req, consumed),
+              ram::ParseStatus::Error);
+
+    ram::HttpResponse resp;
+    EXPECT_NE(ram::parse_http_response(
+                  "HTTP/1.1 200 OK\r\nContent-Length: 18446744073709551615\r\n\r\nab",
+                  false, resp, consumed),
+              ram::ParseStatus::Complete);
+}
+
+TEST(HttpTest, ParseChunkedResponse) {
+    std::string data =
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n";
+    ram::HttpResponse resp;
+    size_t consumed = 0;
+    ASSERT_EQ(ram::parse_http_response(data, false, resp, consumed),
+              ram::ParseStatus::Complete);
+    EXPECT_EQ(resp.status, 200);
+    EXPECT_EQ(resp.body, "hello world");
+    EXPECT_EQ(consumed, data.size());
+}
+
+TEST(HttpTest, ParseResponseUntilClose) {
+    std::string data = "HTTP/1.1 200 OK\r\n\r\npartial";
+    ram::HttpResponse resp;
+    size_t consumed = 0;
+    EXPECT_EQ(ram::parse_http_response(data, false, resp, consumed),
+              ram::ParseStatus::Incomplete);
+    ASSERT_EQ(ram::parse_http_response(data, true, resp, consumed),
+              ram::ParseStatus::Complete);
+    EXPECT_EQ(resp.body, "partial");
+}
+
+TEST(HttpTest, ParseRejectsResponsesOverTheLimit) {
+    ram::HttpResponse resp;
+    size_t consumed = 0;
+    EXPECT_EQ(ram::parse_http_response("HTTP/1.1 200 OK\r\nContent-Length: 9\r\n\r\n",
+                                       false, resp, consumed, 8),
+              ram::ParseStatus::Error);
+    EXPECT_EQ(ram::parse_http_response("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                       "4\r\nabcd\r\n5\r\n",
+                                       false, resp, consumed, 8),
+              ram::ParseStatus::Error);
+    // A close-delimited body fails as soon as it outgrows the limit.
+    EXPECT_EQ(ram::parse_http_response("HTTP/1.1 200 OK\r\n\r\nabcdefghi", false, resp,
+                                       consumed, 8),
+              ram::ParseStatus::Error);
+    EXPECT_EQ(ram::parse_http_response("HTTP/1.1 200 OK\r\n\r\nabcdefgh", true, resp,
+                                       consumed, 8),
+              ram::ParseStatus::Complete);
+}
+
+TEST(HttpTest, ParseSkipsInterimResponses) {
+    std::string data =
+        "HTTP/1.1 100 Continue\r\n\r\n"
+        "HTTP/1.1 103 Early Hints\r\nLink: </a.css>\r\n\r\n"
+        "HTTP/1.1 201 Created\r\nContent-Length: 2\r\n\r\nok";
+    ram::HttpResponse resp;
+    size_t consumed = 0;
+    EXPECT_EQ(ram::parse_http_response(data.substr(0, data.size() - 1), false, resp, consumed),
+              ram::ParseStatus::Incomplete);
+    resp = {};
+    ASSERT_EQ(ram::parse_http_response(data, false, resp, consumed), ram::ParseStatus::Complete);
+    EXPECT_EQ(resp.status, 201);
+    EXPECT_EQ(resp.header("Link"), nullptr);
+    EXPECT_EQ(resp.body, "ok");
+    EXPECT_EQ(consumed, data.size());
+}
+
+TEST(HttpTest, ParseHeadResponseHasNoBody) {
+    std::string data = "HTTP/1.1 200 OK\r\nContent-Length: 42\r\n\r\n";
+    ram::HttpResponse resp;
+    size_t consumed = 0;
+    EXPECT_EQ(ram::parse_http_response(data, false, resp, consumed),
+              ram::ParseStatus::Incomplete);
+    resp = {};
+    ASSERT_EQ(ram::parse_http_response(data, false, resp, consumed, std::string_view::npos,
+                                       false),
+              ram::ParseStatus::Complete);
+    EXPECT_EQ(*resp.header("Content-Length"), "42");
+    EXPECT_TRUE(resp.body.empty());
+    EXPECT_EQ(consumed, data.size());
+}
+
+TEST(HttpTest, SerializeResponseRoundTrip) {
+    ram::HttpResponse out;
+    out.status = 403;
+    out.headers.emplace_back("x-csrf-token", "abc");
+    out.body = "{}";
+
+    std::string raw = ram::serialize_http_response(out);
+    ram::HttpResponse in;
+    size_t consumed = 0;
+    ASSERT_EQ(ram::parse_http_response(raw, false, in, consumed),
+              ram::ParseStatus::Complete);
+    EXPECT_EQ(in.status, 403);
+    EXPECT_EQ(in.reason, "Forbidden");
+    EXPECT_EQ(*in.header("X-CSRF-TOKEN"), "abc");
+    EXPECT_EQ(in.body, "{}");
+}
+
+TEST(HttpClientTest, SendAgainstStubServer) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest& req) {
+        return ram::testing::json_response(
+            "{\"method\":\"" + req.method + "\",\"body\":\"" + req.body + "\"}");
+    });
+
+    ram::HttpClient client;
+    ram::HttpRequest req;
+    req.method = "POST";
+    req.url = server.url() + "/echo";
+    req.body = "ping";
+
+    auto resp = client.send(req);
+    EXPECT_EQ(resp.status, 200);
+    EXPECT_EQ(resp.body, "{\"method\":\"POST\",\"body\":\"ping\"}");
+}
+
+TEST(HttpClientTest, HttpsToPlainServerThrows) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest&) {
+        return ram::testing::json_response("{}");
+    });
+    ram::HttpClientOptions options;
+    options.connect_timeout = std::chrono::milliseconds(500);
+    ram::HttpClient client(options);
+    ram::HttpRequest req;
+    req.url = "https://127.0.0.1:" + std::to_string(server.port()) + "/";
+    EXPECT_THROW(client.send(req), ram::HttpError);
+    EXPECT_EQ(server.requests(), 0u);
+
+    req.url = "ftp://127.0.0.1/";
+    EXPECT_THROW(client.send(req), ram::HttpError);
+}
+
+TEST(HttpClientTest, ConnectionRefused) {
+    uint16_t port;
+    {
+        auto sock = ram::Socket::listen("127.0.0.1", 0);
+        port = sock.local_port();
+    }
+    ram::HttpClient client({.connect_timeout = std::chrono::milliseconds(500),
+                            .request_timeout = std::chrono::milliseconds(500)});
+    ram::HttpRequest req;
+    req.url = "http://127.0.0.1:" + std::to_string(port) + "/";
+    EXPECT_THROW(client.send(req), ram::HttpError);
+}
+
+TEST(HttpClientTest, ReusesKeepAliveConnections) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest& req) {
+        return ram::testing::json_response("\"" + req.url + "\"");
+    });
+
+    ram::HttpClient client;
+    for (int i = 0; i < 5; ++i) {
+        ram::HttpRequest req;
+        req.url = server.url() + "/r" + std::to_string(i);
+        EXPECT_EQ(client.send(req).body, "\"/r" + std::to_string(i) + "\"");
+    }
+
+    EXPECT_EQ(server.connections(), 1);
+    auto stats = client.stats();
+    EXPECT_EQ(stats.connections_opened, 1);
+    EXPECT_EQ(stats.connections_reused, 4);
+}
+
+TEST(HttpClientTest, PipelinesRequestsOnOneConnection) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest& req) {
+        return ram::testing::json_response("\"" + req.url + "\"");
+    });
+
+    ram::HttpClient client;
+    std::vector<ram::HttpRequest> requests(3);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].url = server.url() + "/p" + std::to_string(i);
+    }
+
+    auto responses = client.send_pipelined(requests);
+    ASSERT_EQ(responses.size(), 3);
+    for (size_t i = 0; i < responses.size(); ++i) {
+        EXPECT_EQ(responses[i].body, "\"/p" + std::to_string(i) + "\"");
+    }
+    EXPECT_EQ(server.connections(), 1);
+    EXPECT_EQ(server.requests(), 3);
+}
+
+TEST(HttpClientTest, InjectsAccountCookies) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest& req) {
+        const std::string* cookie = req.header("Cookie");
+        auto resp = ram::testing::json_response(cookie ? *cookie : "");
+        if (req.url == "/rotate") {
+            resp.headers.emplace_back(
+                "Set-Cookie", ".ROBLOSECURITY=rotated; domain=.roblox.com; path=/");
+        }
+        return resp;
+    });
+
+    auto jar = ram::CookieJar::for_security_token("_|WARNING|_token");
+    ram::HttpClient client;
+
+    ram::HttpRequest req;
+    req.url = server.url() + "/rotate";
+    req.cookies = jar;
+    req.headers.emplace_back("Cookie", "RBXEventTrackerV2=1");
+    EXPECT_EQ(client.send(req).body,
+              "RBXEventTrackerV2=1; .ROBLOSECURITY=_|WARNING|_token");
+
+    EXPECT_EQ(*jar->get(".ROBLOSECURITY"), "rotated");
+    req.headers.clear();
+    req.url = server.url() + "/";
+    EXPECT_EQ(client.send(req).body, ".ROBLOSECURITY=rotated");
+}
+
+TEST(HttpClientTest, BoundsConnectionsPerHost) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return ram::testing::json_response("{}");
+    });
+
+    ram::HttpClientOptions options;
+    options.max_connections_per_host = 2;
+    options.async_threads = 6;
+    ram::HttpClient client(options);
+
+    std::vector<std::future<ram::HttpResponse>> futures;
+    for (int i = 0; i < 6; ++i) {
+        ram::HttpRequest req;
+        req.url = server.url() + "/";
+        futures.push_back(client.send_async(req));
+    }
+    for (auto& f : futures) EXPECT_EQ(f.get().status, 200);
+
+    EXPECT_LE(server.connections(), 2);
+    EXPECT_EQ(server.requests(), 6);
+}
+
+TEST(HttpClientTest, HeadRequestsDoNotWaitForABody) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest&) {
+        return ram::testing::json_response("{\"large\":true}");
+    });
+
+    ram::HttpClientOptions options;
+    options.request_timeout = std::chrono::milliseconds(2000);
+    ram::HttpClient client(options);
+    ram::HttpRequest head;
+    head.method = "HEAD";
+    head.url = server.url() + "/";
+    ram::HttpRequest get;
+    get.url = server.url() + "/";
+
+    auto responses = client.send_pipelined({head, get});
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_EQ(*responses[0].header("Content-Length"), "14");
+    EXPECT_TRUE(responses[0].body.empty());
+    EXPECT_EQ(responses[1].body, "{\"large\":true}");
+    EXPECT_EQ(server.connections(), 1u);
+}
+
+TEST(HttpClientTest, RejectsOversizedResponses) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest& req) {
+        return ram::testing::json_response("\"" + std::string(req.url == "/big" ? 4096 : 16, 'x') +
+                                           "\"");
+    });
+
+    ram::HttpClientOptions options;
+    options.max_response_bytes = 1024;
+    ram::HttpClient client(options);
+    ram::HttpRequest req;
+    req.url = server.url() + "/big";
+    EXPECT_THROW(client.send(req), ram::HttpError);
+    req.url = server.url() + "/small";
+    EXPECT_EQ(client.send(req).status, 200);
+}
+
+TEST(HttpClientTest, RequestTimeout) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return ram::testing::json_response("{}");
+    });
+
+    ram::HttpClientOptions options;
+    options.request_timeout = std::chrono::milliseconds(50);
+    ram::HttpClient client(options);
+
+    ram::HttpRequest req;
+    req.url = server.url() + "/slow";
+    EXPECT_THROW(client.send(req), ram::HttpError);
+}
+
+namespace {
+
+// Answers the first request on its first connection, then reads the second
+// and hangs up without replying, as a server that dropped a keep-alive
+// connection mid-request would. Later connections are answered normally.
+class DroppingServer {
+public:
+    DroppingServer() : listener_(ram::Socket::listen("127.0.0.1", 0)) {
+        thread_ = std::thread([this] { run(); });
+    }
+    ~DroppingServer() {
+        stopping_ = true;
+        thread_.join();
+    }
+
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(listener_.local_port()) + "/";
+    }
+    int requests() const { return requests_; }
+
+private:
+    bool read_request(const ram::Socket& sock, std::string& buffer) {
+        char chunk[4096];
+        for (;;) {
+            ram::HttpRequest request;
+            size_t consumed = 0;
+            if (ram::parse_http_request(buffer, request, consumed) == ram::ParseStatus::Complete) {
+                buffer.erase(0, consumed);
+                ++requests_;
+                return true;
+            }
+            ptrdiff_t got = sock.recv_some(chunk, sizeof(chunk), std::chrono::milliseconds(2000));
+            if (got <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(got));
+        }
+    }
+
+    void reply(const ram::Socket& sock) {
+        ram::HttpResponse response;
+        response.status = 200;
+        response.body = "ok";
+        std::string raw = ram::serialize_http_response(response);
+        sock.send_all(raw.data(), raw.size(), std::chrono::milliseconds(2000));
+    }
+
+    void run() {
+        for (int connection = 0; !stopping_;) {
+            if (!listener_.wait_readable(std::chrono::milliseconds(20))) continue;
+            ram::Socket sock = listener_.accept();
+            std::string buffer;
+            if (connection++ == 0) {
+                if (read_request(sock, buffer)) reply(sock);
+                read_request(sock, buffer);
+                continue;  // closed without a response
+            }
+            while (read_request(sock, buffer)) reply(sock);
+        }
+    }
+
+    ram::Socket listener_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> requests_{0};
+    std::thread thread_;
+};
+
+}  // namespace
+
+TEST(HttpClientTest, RetriesIdempotentRequestsOnDroppedConnections) {
+    DroppingServer server;
+    ram::HttpClient client;
+    ram::HttpRequest get;
+    get.url = server.url();
+    EXPECT_EQ(client.send(get).status, 200);
+    EXPECT_EQ(client.send(get).status, 200);  // retried on a new connection
+    EXPECT_EQ(client.stats().stale_retries, 1u);
+    EXPECT_EQ(server.requests(), 3);
+}
+
+TEST(HttpClientTest, DoesNotRepeatPostsOnDroppedConnections) {
+    DroppingServer server;
+    ram::HttpClient client;
+    ram::HttpRequest post;
+    post.method = "POST";
+    post.url = server.url();
+    EXPECT_EQ(client.send(post).status, 200);
+    EXPECT_THROW(client.send(post), ram::HttpError);
+    EXPECT_EQ(client.stats().stale_retries, 0u);
+    EXPECT_EQ(server.requests(), 2);  // the server saw it once
+}
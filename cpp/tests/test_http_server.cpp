@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/http.h"
+#include "ram/http_server.h"
+#include "ram/socket.h"
+
+namespace {
+
+using std::chrono::milliseconds;
+
+ram::HttpResponse text(int status, std::string body) {
+    ram::HttpResponse r;
+    r.status = status;
+    r.body = std::move(body);
+    return r;
+}
+
+// Read responses from `sock` until `count` have been parsed.
+std::vector<ram::HttpResponse> read_responses(const ram::Socket& sock, size_t count) {
+    std::vector<ram::HttpResponse> out;
+    std::string buffer;
+    char chunk[4096];
+    while (out.size() < count) {
+        ram::HttpResponse response;
+        size_t consumed = 0;
+        auto status = ram::parse_http_response(buffer, false, response, consumed);
+        if (status == ram::ParseStatus::Complete) {
+            buffer.erase(0, consumed);
+            out.push_back(std::move(response));
+            continue;
+        }
+        if (status == ram::ParseStatus::Error) break;
+        ptrdiff_t n = sock.recv_some(chunk, sizeof(chunk), milliseconds(2000));
+        if (n <= 0) break;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(PerfectHashRouterTest, FindsEveryNameAndRejectsOthers) {
+    std::vector<std::string> names = {"GetCookie", "GetAccounts", "GetAccountsJson",
+                                      "LaunchAccount", "FollowUser", "SetField"};
+    ram::PerfectHashRouter router(names);
+    for (size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(router.find(names[i]), static_cast<int>(i));
+    }
+    EXPECT_EQ(router.find("GetCookies"), ram::PerfectHashRouter::kNotFound);
+    EXPECT_EQ(router.find(""), ram::PerfectHashRouter::kNotFound);
+    EXPECT_GE(router.table_size(), names.size());
+
+    std::vector<std::string> many;
+    for (int i = 0; i < 200; ++i) many.push_back("Method" + std::to_string(i));
+    ram::PerfectHashRouter big(many);
+    for (size_t i = 0; i < many.size(); ++i) EXPECT_EQ(big.find(many[i]), static_cast<int>(i));
+}
+
+TEST(HttpServerTest, ServesKeepAliveRequests) {
+    ram::HttpServer server([](ram::ServerRequest& req, ram::Responder r) {
+        EXPECT_TRUE(req.from_loopback);
+        r.send(text(200, "echo " + req.http.url));
+    });
+    server.start();
+
+    ram::HttpClient client;
+    std::string base = "http://127.0.0.1:" + std::to_string(server.port());
+    for (int i = 0; i < 5; ++i) {
+        ram::HttpRequest req;
+        req.url = base + "/path" + std::to_string(i);
+        auto response = client.send(req);
+        EXPECT_EQ(response.status, 200);
+        EXPECT_EQ(response.body, "echo /path" + std::to_string(i));
+    }
+    EXPECT_EQ(client.stats().connections_opened, 1u);
+    EXPECT_EQ(server.stats().connections_accepted, 1u);
+    EXPECT_EQ(server.stats().requests, 5u);
+    server.stop();
+}
+
+TEST(HttpServerTest, AnswersPipelinedRequestsInOrder) {
+    // Odd requests are deferred and finish later than the even ones after
+    // them would; responses must still come back in request order.
+    ram::HttpServer server([](ram::ServerRequest& req, ram::Responder r) {
+        std::string url = req.http.url;
+        if (url.back() % 2 == 1) {
+            r.defer([url](ram::Responder later) {
+                std::this_thread::sleep_for(milliseconds(10));
+                later.send(text(200, url));
+            });
+        } else {
+            r.send(text(200, url));
+        }
+    });
+    server.start();
+
+    ram::Socket sock = ram::Socket::connect("127.0.0.1", server.port(), milliseconds(2000));
+    ASSERT_TRUE(sock.valid());
+    std::string batch;
+    for (int i = 0; i < 6; ++i) {
+        batch += "GET /" + std::to_string(i) + " HTTP/1.1\r\nHost: x\r\n\r\n";
+    }
+    ASSERT_TRUE(sock.send_all(batch.data(), batch.size(), milliseconds(2000)));
+
+    auto responses = read_responses(sock, 6);
+    ASSERT_EQ(responses.size(), 6u);
+    for (int i = 0; i < 6; ++i) EXPECT_EQ(responses[i].body, "/" + std::to_string(i));
+    EXPECT_EQ(server.stats().deferred, 3u);
+    server.stop();
+}
+
+TEST(HttpServerTest, SharesPreformattedResponses) {
+    auto canned = ram::preformat(text(404, "missing"));
+    ram::HttpServer server([canned](ram::ServerRequest&, ram::Responder r) { r.send(canned); });
+    server.start();
+
+    ram::HttpClient client;
+    ram::HttpRequest req;
+    req.url = "http://127.0.0.1:" + std::to_string(server.port()) + "/x";
+    for (int i = 0; i < 3; ++i) {
+        auto response = client.send(req);
+        EXPECT_EQ(response.status, 404);
+        EXPECT_EQ(response.body, "missing");
+    }
+    EXPECT_EQ(server.stats().preformatted, 3u);
+    server.stop();
+}
+
+TEST(HttpServerTest, RejectsMalformedRequests) {
+    ram::HttpServer server([](ram::ServerRequest&, ram::Responder r) { r.send(text(200, "")); });
+    server.start();
+
+    ram::Socket sock = ram::Socket::connect("127.0.0.1", server.port(), milliseconds(2000));
+    ASSERT_TRUE(sock.valid());
+    std::string garbage = "NOT HTTP\r\n\r\n";
+    ASSERT_TRUE(sock.send_all(garbage.data(), garbage.size(), milliseconds(2000)));
+
+    auto responses = read_responses(sock, 1);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0].status, 400);
+    EXPECT_EQ(server.stats().parse_errors, 1u);
+    server.stop();
+}
+
+TEST(HttpServerTest, RejectsBodiesOverTheRequestLimit) {
+    ram::HttpServer server([](ram::ServerRequest&, ram::Responder r) { r.send(text(200, "")); });
+    server.start();
+
+    for (std::string probe : {
+             std::string("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                         "FFFFFFFFFFFFFFEC\r\nab\r\n"),
+             std::string("POST / HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\nab"),
+         }) {
+        ram::Socket sock = ram::Socket::connect("127.0.0.1", server.port(), milliseconds(2000));
+        ASSERT_TRUE(sock.send_all(probe.data(), probe.size(), milliseconds(2000)));
+        auto responses = read_responses(sock, 1);
+        ASSERT_EQ(responses.size(), 1u);
+        EXPECT_EQ(responses[0].status, 400);
+    }
+    EXPECT_EQ(server.stats().parse_errors, 2u);
+
+    // The event loop is still serving.
+    ram::HttpClient client;
+    ram::HttpRequest req;
+    req.url = "http://127.0.0.1:" + std::to_string(server.port()) + "/";
+    EXPECT_EQ(client.send(req).status, 200);
+    server.stop();
+}
+
+TEST(HttpServerTest, HandlerExceptionsBecome500) {
+    ram::HttpServer server([](ram::ServerRequest&, ram::Responder) {
+        throw std::runtime_error("boom");
+    });
+    server.start();
+
+    ram::HttpClient client;
+    ram::HttpRequest req;
+    req.url = "http://127.0.0.1:" + std::to_string(server.port()) + "/";
+    EXPECT_EQ(client.send(req).status, 500);
+    server.stop();
+}
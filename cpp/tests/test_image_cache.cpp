@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/image_cache.h"
+#include "stub_http_server.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A fresh cache directory, removed afterwards.
+struct TempDir : ram::testing::TempDir {
+    TempDir() : ram::testing::TempDir("ram_image_cache_") {}
+};
+
+// Serves "image:<url>" and counts downloads.
+struct FakeCdn {
+    std::atomic<int> fetches{0};
+
+    ram::ImageCache::Fetcher fetcher() {
+        return [this](const std::string& url) -> std::optional<std::string> {
+            ++fetches;
+            return "image:" + url;
+        };
+    }
+};
+
+size_t count_blobs(const fs::path& dir) {
+    size_t count = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().filename() != "index") ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(ImageCacheTest, ServesRepeatLookupsFromMemory) {
+    FakeCdn cdn;
+    ram::ImageCache cache(cdn.fetcher());
+    auto first = cache.get("https://tr.rbxcdn.com/a/420/420/Image/Png");
+    auto second = cache.get("https://tr.rbxcdn.com/a/420/420/Image/Png");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(*first, "image:https://tr.rbxcdn.com/a/420/420/Image/Png");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(cdn.fetches.load(), 1);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.memory_hits, 1u);
+    EXPECT_EQ(stats.fetches, 1u);
+    EXPECT_DOUBLE_EQ(stats.hit_ratio(), 0.5);
+    EXPECT_EQ(cache.peek("https://tr.rbxcdn.com/other"), nullptr);
+}
+
+TEST(ImageCacheTest, SurvivesRestarts) {
+    TempDir dir;
+    FakeCdn cdn;
+    {
+        ram::ImageCache cache(cdn.fetcher(), {dir.path.string()});
+        cache.get("a");
+        cache.get("b");
+    }
+    ram::ImageCache reopened(
+        [](const std::string&) -> std::optional<std::string> { return std::nullopt; },
+        {dir.path.string()});
+    EXPECT_EQ(reopened.stats().disk_entries, 2u);
+    auto a = reopened.get("a");
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(*a, "image:a");
+    EXPECT_EQ(reopened.get("a"), a);
+
+    auto stats = reopened.stats();
+    EXPECT_EQ(stats.disk_hits, 1u);
+    EXPECT_EQ(stats.memory_hits, 1u);
+    EXPECT_EQ(stats.fetches, 0u);
+    EXPECT_EQ(cdn.fetches.load(), 2);
+}
+
+TEST(ImageCacheTest, StoresIdenticalImagesOnce) {
+    TempDir dir;
+    ram::ImageCache cache(
+        [](const std::string&) -> std::optional<std::string> { return std::string(100, 'p'); },
+        {dir.path.string()});
+    cache.get("https://thumbnails/1");
+    cache.get("https://thumbnails/2");
+    EXPECT_EQ(count_blobs(dir.path), 1u);
+    EXPECT_EQ(cache.stats().disk_entries, 2u);
+    EXPECT_EQ(cache.stats().disk_bytes, 100u);
+}
+
+TEST(ImageCacheTest, ConcurrentLookupsShareOneDownload) {
+    ram::ImageCache* cache_ptr = nullptr;
+    std::atomic<int> fetches{0};
+    ram::ImageCache cache([&](const std::string&) -> std::optional<std::string> {
+        ++fetches;
+        // Hold the download until every other thread is waiting on it.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (cache_ptr->stats().joined < 7 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return std::string("pixels");
+    });
+    cache_ptr = &cache;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            auto image = cache.get("same");
+            if (image && *image == "pixels") ++ok;
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(ok.load(), 8);
+    EXPECT_EQ(fetches.load(), 1);
+    EXPECT_EQ(cache.stats().joined, 7u);
+}
+
+TEST(ImageCacheTest, FailedDownloadsAreRetried) {
+    int calls = 0;
+    ram::ImageCache cache([&](const std::string&) -> std::optional<std::string> {
+        if (++calls == 1) return std::nullopt;
+        return std::string("ok");
+    });
+    EXPECT_EQ(cache.get("x"), nullptr);
+    ASSERT_NE(cache.get("x"), nullptr);
+    EXPECT_EQ(cache.stats().fetch_failures, 1u);
+    EXPECT_EQ(cache.stats().fetches, 2u);
+}
+
+TEST(ImageCacheTest, FetcherThrowingAnythingIsAFailedDownload) {
+    int calls = 0;
+    ram::ImageCache cache([&](const std::string&) -> std::optional<std::string> {
+        if (++calls == 1) throw 42;
+        return std::string("ok");
+    });
+    EXPECT_EQ(cache.get("x"), nullptr);
+    ASSERT_NE(cache.get("x"), nullptr);  // not left waiting on the first load
+    EXPECT_EQ(cache.stats().fetch_failures, 1u);
+}
+
+TEST(ImageCacheTest, EvictsByBytesInBothTiers) {
+    TempDir dir;
+    ram::ImageCacheOptions options{dir.path.string(), 250, 250};
+    auto fetch = [](const std::string& url) -> std::optional<std::string> {
+        return std::string(100, url[0]);
+    };
+    {
+        ram::ImageCache cache(fetch, options);
+        cache.get("a");
+        cache.get("b");
+        cache.get("c");
+        auto stats = cache.stats();
+        EXPECT_EQ(stats.memory_evictions, 1u);
+        EXPECT_LE(stats.memory_bytes, 250u);
+        EXPECT_GE(stats.disk_evictions, 1u);
+        EXPECT_LE(stats.disk_bytes, 250u);
+        EXPECT_EQ(count_blobs(dir.path), stats.disk_entries);
+    }
+
+    // The rewritten index no longer lists the evicted image.
+    ram::ImageCache reopened(fetch, options);
+    EXPECT_LE(reopened.stats().disk_bytes, 250u);
+    EXPECT_NE(reopened.get("c"), nullptr);
+    EXPECT_EQ(reopened.stats().fetches, 0u);
+    EXPECT_NE(reopened.get("a"), nullptr);
+    EXPECT_EQ(reopened.stats().fetches, 1u);
+}
+
+TEST(ImageCacheTest, ToleratesDamagedFiles) {
+    TempDir dir;
+    FakeCdn cdn;
+    {
+        ram::ImageCache cache(cdn.fetcher(), {dir.path.string()});
+        cache.get("a");
+        cache.get("b");
+    }
+    // A torn index append and a blob truncated behind the cache's back.
+    {
+        std::ofstream index(dir.path / "index", std::ios::binary | std::ios::app);
+        index << "partial";
+    }
+    for (const auto& entry : fs::recursive_directory_iterator(dir.path)) {
+        if (entry.is_regular_file() && entry.path().filename() != "index") {
+            fs::resize_file(entry.path(), 1);
+            break;
+        }
+    }
+
+    ram::ImageCache reopened(cdn.fetcher(), {dir.path.string()});
+    ASSERT_NE(reopened.get("a"), nullptr);
+    ASSERT_NE(reopened.get("b"), nullptr);
+    EXPECT_EQ(*reopened.get("a"), "image:a");
+    EXPECT_EQ(*reopened.get("b"), "image:b");
+    EXPECT_EQ(reopened.stats().fetches, 1u);  // only the damaged one
+}
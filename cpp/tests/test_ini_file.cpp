@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <sstream>
 
 #include "ram/ini_file.h"
@@ -235,3 +238,126 @@ TEST(IniFileTest, ValueWithEqualsSign) {
     EXPECT_EQ(ini.section("Section").get("url"),
               "https://example.com?a=1&b=2");
 }
+
+// --- Lossless save ---
+
+TEST(IniFileTest, LosslessRoundTripUnchanged) {
+    const std::string source =
+        "; settings file\n"
+        "[General]\n"
+        "  key1 = value1   # not a comment\n"
+        "\n"
+        "# note\n"
+        "key2=value2\n"
+        "garbage line\n"
+        "[Other]\n"
+        "x=1";
+    std::istringstream input(source);
+    ram::IniFile ini(input);
+    ini.set_preserve_formatting(true);
+
+    EXPECT_FALSE(ini.dirty());
+    EXPECT_EQ(ini.to_string(), source);
+}
+
+TEST(IniFileTest, LosslessRewritesOnlyChangedLine) {
+    std::istringstream input(
+        "# header comment\n"
+        "[General]\n"
+        "key1 = value1\n"
+        "; keep me\n"
+        "key2=value2\n");
+    ram::IniFile ini(input);
+    ini.set_preserve_formatting(true);
+
+    ini.section("General").set("key1", "changed");
+    EXPECT_TRUE(ini.dirty());
+    EXPECT_EQ(ini.to_string(),
+              "# header comment\n"
+              "[General]\n"
+              "key1 = changed\n"
+              "; keep me\n"
+              "key2=value2\n");
+}
+
+TEST(IniFileTest, LosslessAddAndRemove) {
+    std::istringstream input(
+        "[A]\n"
+        "a1=1\n"
+        "a2=2\n"
+        "\n"
+        "[B]\n"
+        "b1=1\n"
+        "\n"
+        "[C]\n"
+        "c1=1\n");
+    ram::IniFile ini(input);
+    ini.set_preserve_formatting(true);
+
+    ini.section("A").remove_property("a1");
+    ini.section("A").set("a3", "3");
+    ini.remove_section("B");
+    ini.section("D").set("d1", "1");
+
+    EXPECT_EQ(ini.to_string(),
+              "[A]\n"
+              "a2=2\n"
+              "a3=3\n"
+              "\n"
+              "[C]\n"
+              "c1=1\n"
+              "\n"
+              "[D]\n"
+              "d1=1\n");
+}
+
+TEST(IniFileTest, LosslessPreservesCrlf) {
+    std::istringstream input("[A]\r\nkey=old\r\n");
+    ram::IniFile ini(input);
+    ini.set_preserve_formatting(true);
+
+    ini.section("A").set("key", "new");
+    ini.section("A").set("added", "yes");
+    EXPECT_EQ(ini.to_string(), "[A]\r\nkey=new\r\nadded=yes\r\n");
+}
+
+TEST(IniFileTest, SettingSameValueIsNotDirty) {
+    std::istringstream input("[A]\nkey=value\n");
+    ram::IniFile ini(input);
+
+    ini.section("A").set("key", "value");
+    EXPECT_FALSE(ini.dirty());
+}
+
+TEST(IniFileTest, SaveSkipsWriteWhenUnchanged) {
+    auto tmp = std::filesystem::temp_directory_path() / "ram_test_lossless.ini";
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        f << "# comment\n[General]\nkey=value\n";
+    }
+
+    ram::IniFile ini(tmp.string());
+    ini.set_preserve_formatting(true);
+    EXPECT_FALSE(ini.save(tmp.string()));
+
+    ini.section("General").set("key", "other");
+    EXPECT_TRUE(ini.save(tmp.string()));
+    EXPECT_FALSE(ini.dirty());
+    EXPECT_FALSE(ini.save(tmp.string()));
+
+    std::ifstream f(tmp, std::ios::binary);
+    std::string written{std::istreambuf_iterator<char>(f),
+                        std::istreambuf_iterator<char>()};
+    f.close();
+    EXPECT_EQ(written, "# comment\n[General]\nkey=other\n");
+    EXPECT_FALSE(std::filesystem::exists(tmp.string() + ".tmp"));
+
+    // A second edit after a save diffs against the newly written layout.
+    ini.section("General").set("key2", "v2");
+    EXPECT_TRUE(ini.save(tmp.string()));
+    EXPECT_EQ(ini.to_string(), "# comment\n[General]\nkey=other\nkey2=v2\n");
+
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    EXPECT_FALSE(ec) << "Failed to clean up test file: " << ec.message();
+}
@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/launcher.h"
+#include "stub_http_server.h"
+
+namespace {
+
+// auth.roblox.com stand-in: 403 + token without X-CSRF-TOKEN, a ticket
+// with it. Cookies starting with "expired" are rejected outright.
+ram::HttpResponse auth_handler(const ram::HttpRequest& req) {
+    const std::string* cookie = req.header("Cookie");
+    if (cookie == nullptr || cookie->find("expired") != std::string::npos) {
+        return ram::testing::json_response("{}", 401);
+    }
+    if (req.header("X-CSRF-TOKEN") == nullptr) {
+        auto resp = ram::testing::json_response("{}", 403);
+        resp.headers.emplace_back("x-csrf-token", "csrf");
+        return resp;
+    }
+    auto resp = ram::testing::json_response("{}");
+    resp.headers.emplace_back("rbx-authentication-ticket", "ticket:" + *cookie);
+    return resp;
+}
+
+std::vector<ram::Account> make_accounts(size_t n) {
+    std::vector<ram::Account> accounts;
+    for (size_t i = 0; i < n; ++i) {
+        ram::Account acc("cookie" + std::to_string(i));
+        acc.username = "user" + std::to_string(i);
+        acc.user_id = static_cast<int64_t>(i + 1);
+        accounts.push_back(acc);
+    }
+    return accounts;
+}
+
+ram::LaunchOrchestratorOptions fast_options() {
+    ram::LaunchOrchestratorOptions options;
+    options.starts_per_second = 1000.0;
+    options.start_burst = 100.0;
+    return options;
+}
+
+struct Harness {
+    ram::testing::StubHttpServer server{auth_handler};
+    ram::HttpClient client;
+    ram::CsrfTokenCache csrf{client, {server.url()}};
+};
+
+}  // namespace
+
+TEST(LaunchTargetTest, FieldsOverridePlaceAndJob) {
+    ram::Account acc("cookie");
+    acc.fields["SavedPlaceId"] = "606849621";
+    acc.fields["SavedJobId"] = "abc-123";
+
+    ram::LaunchTarget target{142823291, "", false, false, false};
+    auto resolved = ram::resolve_launch_target(acc, target);
+    EXPECT_EQ(resolved.place_id, 606849621);
+    EXPECT_EQ(resolved.job_id, "abc-123");
+
+    acc.fields["SavedPlaceId"] = "not a number";
+    EXPECT_EQ(ram::resolve_launch_target(acc, target).place_id, 142823291);
+
+    target.follow_user = true;
+    resolved = ram::resolve_launch_target(acc, target);
+    EXPECT_EQ(resolved.place_id, 142823291);
+    EXPECT_EQ(resolved.job_id, "");
+}
+
+TEST(LaunchTargetTest, ProtocolUri) {
+    ram::LaunchSpec spec;
+    spec.ticket = "TICKET";
+    spec.browser_tracker_id = "123";
+    spec.place_id = 42;
+    spec.job_id = "job";
+
+    std::string uri = spec.uri(1000);
+    EXPECT_EQ(uri.rfind("roblox-player:1+launchmode:play+gameinfo:TICKET+launchtime:1000+", 0), 0u);
+    EXPECT_NE(uri.find("placelauncherurl:https%3a%2f%2fassetgame.roblox.com%2fgame%2f"
+                       "PlaceLauncher.ashx%3frequest%3dRequestGameJob%26browserTrackerId%3d123"
+                       "%26placeId%3d42%26gameId%3djob%26isPlayTogetherGame%3dfalse+"),
+              std::string::npos);
+    EXPECT_NE(uri.find("+browsertrackerid:123+"), std::string::npos);
+
+    spec.follow_user = true;
+    EXPECT_NE(spec.uri(0).find("RequestFollowUser%26userId%3d42"), std::string::npos);
+}
+
+TEST(LaunchOrchestratorTest, LaunchesInOrderWithOverrides) {
+    Harness h;
+    std::mutex mutex;
+    std::vector<ram::LaunchSpec> launched;
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf,
+        [&](const ram::LaunchSpec& spec) {
+            std::lock_guard<std::mutex> lock(mutex);
+            launched.push_back(spec);
+            return true;
+        },
+        fast_options());
+
+    auto accounts = make_accounts(6);
+    accounts[2].fields["SavedPlaceId"] = "999";
+    accounts[3].browser_tracker_id = "555";
+
+    auto summary = orchestrator.run(accounts, {100, "", false, false, false});
+    EXPECT_EQ(summary.launched, 6u);
+    EXPECT_EQ(summary.failed, 0u);
+    ASSERT_EQ(launched.size(), 6u);
+    for (size_t i = 0; i < launched.size(); ++i) {
+        EXPECT_EQ(launched[i].index, i);
+        EXPECT_EQ(launched[i].ticket, "ticket:.ROBLOSECURITY=cookie" + std::to_string(i));
+        EXPECT_FALSE(launched[i].browser_tracker_id.empty());
+        EXPECT_EQ(summary.browser_tracker_ids[i], launched[i].browser_tracker_id);
+    }
+    EXPECT_EQ(launched[1].place_id, 100);
+    EXPECT_EQ(launched[2].place_id, 999);
+    EXPECT_EQ(launched[3].browser_tracker_id, "555");
+}
+
+TEST(LaunchOrchestratorTest, PrefetchesWhileLaunching) {
+    Harness h;
+    std::mutex mutex;
+    std::vector<std::pair<size_t, ram::LaunchStage>> events;
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf,
+        [](const ram::LaunchSpec&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return true;
+        },
+        fast_options());
+    orchestrator.on_progress([&](const ram::LaunchEvent& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.emplace_back(e.index, e.stage);
+    });
+
+    auto summary = orchestrator.run(make_accounts(3), {1, "", false, false, false});
+    EXPECT_EQ(summary.launched, 3u);
+
+    auto position = [&](size_t index, ram::LaunchStage stage) {
+        auto it = std::find(events.begin(), events.end(), std::make_pair(index, stage));
+        return it - events.begin();
+    };
+    // Later tickets are ready before the first client finished starting.
+    EXPECT_LT(position(2, ram::LaunchStage::Ready),
+              position(0, ram::LaunchStage::Launched));
+    EXPECT_LT(position(0, ram::LaunchStage::Launched),
+              position(1, ram::LaunchStage::Launching));
+}
+
+TEST(LaunchOrchestratorTest, BoundsConcurrency) {
+    Harness h;
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    auto options = fast_options();
+    options.max_concurrent = 2;
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf,
+        [&](const ram::LaunchSpec&) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            }
+            int now = ++active;
+            int prev = peak.load();
+            while (now > prev && !peak.compare_exchange_weak(prev, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            --active;
+            return true;
+        },
+        options);
+
+    auto summary = orchestrator.run(make_accounts(8), {1, "", false, false, false});
+    EXPECT_EQ(summary.launched, 8u);
+    EXPECT_EQ(peak.load(), 2);
+    EXPECT_EQ(threads.size(), 2u);  // a worker per slot, not per account
+}
+
+TEST(LaunchOrchestratorTest, StartRate) {
+    Harness h;
+    auto options = fast_options();
+    options.starts_per_second = 20.0;
+    options.start_burst = 1.0;
+    options.max_concurrent = 4;
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf, [](const ram::LaunchSpec&) { return true; }, options);
+
+    auto start = std::chrono::steady_clock::now();
+    orchestrator.run(make_accounts(4), {1, "", false, false, false});
+    // Burst of one, then three more at 50ms intervals.
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(140));
+}
+
+TEST(LaunchOrchestratorTest, ExpiredSessionFailsOnlyThatAccount) {
+    Harness h;
+    std::atomic<int> calls{0};
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf,
+        [&](const ram::LaunchSpec&) {
+            ++calls;
+            return true;
+        },
+        fast_options());
+
+    auto accounts = make_accounts(3);
+    accounts[1].security_token = "expired";
+    auto summary = orchestrator.run(accounts, {1, "", false, false, false});
+    EXPECT_EQ(summary.launched, 2u);
+    EXPECT_EQ(summary.failed, 1u);
+    EXPECT_EQ(calls.load(), 2);
+    EXPECT_EQ(summary.results[1].stage, ram::LaunchStage::Failed);
+    EXPECT_NE(summary.results[1].message.find("X-CSRF-Token"), std::string::npos);
+}
+
+TEST(LaunchOrchestratorTest, CancelStopsRemainingLaunches) {
+    Harness h;
+    std::atomic<int> calls{0};
+    ram::LaunchOrchestrator* self = nullptr;
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf,
+        [&](const ram::LaunchSpec&) {
+            ++calls;
+            self->cancel();
+            return true;
+        },
+        fast_options());
+    self = &orchestrator;
+
+    std::atomic<int> cancelled_events{0};
+    orchestrator.on_progress([&](const ram::LaunchEvent& e) {
+        if (e.stage == ram::LaunchStage::Cancelled) ++cancelled_events;
+    });
+
+    auto summary = orchestrator.run(make_accounts(10), {1, "", false, false, false});
+    EXPECT_TRUE(orchestrator.cancelled());
+    EXPECT_EQ(summary.launched, static_cast<size_t>(calls.load()));
+    EXPECT_GE(summary.cancelled, 1u);
+    EXPECT_EQ(summary.launched + summary.cancelled, 10u);
+    EXPECT_EQ(static_cast<size_t>(cancelled_events.load()), summary.cancelled);
+}
+
+TEST(LaunchOrchestratorTest, CancelBeforeRunIsNotLost) {
+    Harness h;
+    std::atomic<int> calls{0};
+    ram::LaunchOrchestrator orchestrator(
+        h.client, h.csrf,
+        [&](const ram::LaunchSpec&) {
+            ++calls;
+            return true;
+        },
+        fast_options());
+
+    orchestrator.cancel();
+    auto summary = orchestrator.run(make_accounts(3), {1, "", false, false, false});
+    EXPECT_TRUE(orchestrator.cancelled());
+    EXPECT_EQ(summary.cancelled, 3u);
+    EXPECT_EQ(calls.load(), 0);
+
+    // The cancel was consumed by that run; the next one goes ahead.
+    summary = orchestrator.run(make_accounts(3), {1, "", false, false, false});
+    EXPECT_FALSE(orchestrator.cancelled());
+    EXPECT_EQ(summary.launched, 3u);
+}
@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/local_api.h"
+#include "stub_http_server.h"
+
+namespace {
+
+class LocalApiTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ram::Account alpha("cookie-alpha");
+        alpha.username = "alpha";
+        alpha.user_id = 1;
+        alpha.group = "Main";
+        store.add(alpha);
+        ram::Account beta("cookie-beta");
+        beta.username = "beta";
+        beta.user_id = 2;
+        store.add(beta);
+
+        settings.port = 0;
+        settings.password = "hunter22";
+        settings.allow_get_cookie = true;
+        settings.allow_get_accounts = true;
+        settings.allow_launch_account = true;
+        settings.allow_account_editing = true;
+    }
+
+    void start() {
+        api = std::make_unique<ram::LocalApi>(store, settings, csrf);
+        if (configure) configure(*api);
+        api->start();
+    }
+
+    ram::HttpResponse get(const std::string& target, const std::string& body = {}) {
+        ram::HttpRequest req;
+        req.method = body.empty() ? "GET" : "POST";
+        req.url = "http://127.0.0.1:" + std::to_string(api->port()) + target;
+        req.body = body;
+        return client.send(req);
+    }
+
+    ram::AccountStore store;
+    ram::LocalApiSettings settings;
+    ram::CsrfTokenCache* csrf = nullptr;
+    std::function<void(ram::LocalApi&)> configure;
+    ram::HttpClient client;
+    std::unique_ptr<ram::LocalApi> api;
+};
+
+}  // namespace
+
+TEST_F(LocalApiTest, RunningAndNotFound) {
+    start();
+    auto running = get("/Running");
+    EXPECT_EQ(running.status, 200);
+    EXPECT_EQ(running.body, "true");
+
+    auto v2 = get("/v2/Running");
+    auto json = nlohmann::json::parse(v2.body);
+    EXPECT_TRUE(json["Success"].get<bool>());
+    EXPECT_EQ(json["Message"], "Roblox Account Manager is running");
+
+    auto missing = get("/Nope?Account=alpha");
+    EXPECT_EQ(missing.status, 404);
+    EXPECT_NE(missing.header("ws-error"), nullptr);
+}
+
+TEST_F(LocalApiTest, ProtectedMethodsNeedStrongPassword) {
+    settings.password = "short";
+    start();
+    EXPECT_EQ(get("/GetCookie?Account=alpha").status, 401);
+    // Unprotected methods still work with a weak password.
+    EXPECT_EQ(get("/GetAlias?Account=alpha").status, 200);
+}
+
+TEST_F(LocalApiTest, WrongPasswordIsRejectedButOmittedIsAllowed) {
+    start();
+    EXPECT_EQ(get("/GetCookie?Account=alpha&Password=wrong").status, 401);
+    auto ok = get("/GetCookie?Account=alpha");
+    EXPECT_EQ(ok.status, 200);
+    EXPECT_EQ(ok.body, "cookie-alpha");
+    EXPECT_EQ(get("/GetCookie?Account=2&Password=hunter22").body, "cookie-beta");
+}
+
+TEST_F(LocalApiTest, EveryRequestRequiresPassword) {
+    settings.every_request_requires_password = true;
+    start();
+    EXPECT_EQ(get("/GetAlias?Account=alpha").status, 401);
+    EXPECT_EQ(get("/GetAlias?Account=alpha&Password=hunter22").status, 200);
+}
+
+TEST_F(LocalApiTest, DisabledMethodsAreRefused) {
+    settings.allow_get_cookie = false;
+    settings.allow_account_editing = false;
+    start();
+    auto cookie = get("/GetCookie?Account=alpha");
+    EXPECT_EQ(cookie.status, 401);
+    EXPECT_EQ(cookie.body, "Method not allowed");
+    EXPECT_EQ(get("/SetAlias?Account=alpha", "new alias").status, 400);
+    EXPECT_EQ(get("/SetField?Account=alpha&Field=a&Value=b").status, 401);
+}
+
+TEST_F(LocalApiTest, AccountLookupErrors) {
+    start();
+    EXPECT_EQ(get("/GetAlias").body, "Empty Account");
+    auto invalid = get("/v2/GetAlias?Account=nobody");
+    EXPECT_EQ(invalid.status, 400);
+    EXPECT_FALSE(nlohmann::json::parse(invalid.body)["Success"].get<bool>());
+}
+
+TEST_F(LocalApiTest, GetAccountsFiltersByGroup) {
+    start();
+    EXPECT_EQ(get("/GetAccounts").body, "alpha,beta");
+    EXPECT_EQ(get("/GetAccounts?Group=Main").body, "alpha");
+
+    auto json = nlohmann::json::parse(get("/GetAccountsJson").body);
+    ASSERT_EQ(json.size(), 2u);
+    EXPECT_EQ(json[0]["Username"], "alpha");
+    EXPECT_TRUE(json[0]["Cookie"].is_null());
+
+    json = nlohmann::json::parse(get("/GetAccountsJson?IncludeCookies=true&Password=hunter22").body);
+    EXPECT_EQ(json[1]["Cookie"], "cookie-beta");
+}
+
+TEST_F(LocalApiTest, EditsAccountsAndNotifies) {
+    std::atomic<int> saves{0};
+    configure = [&](ram::LocalApi& api) { api.set_on_modified([&] { ++saves; }); };
+    start();
+
+    EXPECT_EQ(get("/SetField?Account=alpha&Field=Server&Value=EU%20West").body,
+              "Set Field Server to EU West for alpha");
+    EXPECT_EQ(get("/GetField?Account=alpha&Field=Server").body, "EU West");
+    EXPECT_EQ(get("/SetAlias?Account=alpha", "main").body, "Set Alias of alpha to main");
+    EXPECT_EQ(get("/AppendDescription?Account=alpha", "!").status, 200);
+    EXPECT_EQ(get("/RemoveField?Account=alpha&Field=Server").status, 200);
+
+    std::string alias;
+    size_t fields = 1;
+    store.read("alpha", [&](const ram::Account& a) {
+        alias = a.alias();
+        fields = a.fields.size();
+    });
+    EXPECT_EQ(alias, "main");
+    EXPECT_EQ(fields, 0u);
+    EXPECT_EQ(saves.load(), 4);
+}
+
+TEST_F(LocalApiTest, NetworkMethodsRunRegisteredActions) {
+    configure = [](ram::LocalApi& api) {
+        api.on("LaunchAccount", [](const ram::ApiCall& call) {
+            return ram::ApiReply{
+                .message = "Launched " + call.account.username + " to " + call.param("PlaceId"),
+                .success = true,
+                .raw = std::nullopt};
+        });
+    };
+    start();
+    EXPECT_EQ(get("/LaunchAccount?Account=alpha&PlaceId=123").body, "Launched alpha to 123");
+    EXPECT_EQ(get("/LaunchAccount?Account=alpha&PlaceId=abc").body, "Invalid PlaceId");
+    EXPECT_EQ(get("/SetServer?Account=alpha&PlaceId=1&JobId=x").status, 404);
+    EXPECT_GE(api->stats().deferred, 1u);
+}
+
+TEST_F(LocalApiTest, ValidatesAccountsWithCsrfCache) {
+    ram::testing::StubHttpServer auth([](const ram::HttpRequest& req) {
+        const std::string* cookie = req.header("Cookie");
+        bool valid = cookie != nullptr && cookie->find("cookie-alpha") != std::string::npos;
+        auto resp = ram::testing::json_response("{}", valid ? 403 : 401);
+        if (valid) resp.headers.emplace_back("x-csrf-token", "csrf-alpha");
+        return resp;
+    });
+    ram::HttpClient auth_client;
+    ram::CsrfTokenCache cache(auth_client, {auth.url()});
+    csrf = &cache;
+    start();
+
+    EXPECT_EQ(get("/GetCSRFToken?Account=alpha").body, "csrf-alpha");
+    EXPECT_EQ(get("/GetCSRFToken?Account=alpha").body, "csrf-alpha");
+    EXPECT_EQ(cache.stats().misses, 1u);
+    EXPECT_EQ(get("/GetAlias?Account=beta").body, "Invalid Account");
+    api->stop();
+}
+
+TEST_F(LocalApiTest, AccountListsAreCachedPerVersion) {
+    start();
+    auto first = get("/GetAccountsJson");
+    auto second = get("/GetAccountsJson");
+    EXPECT_EQ(first.body, second.body);
+    ASSERT_NE(first.header("ETag"), nullptr);
+    EXPECT_EQ(*first.header("ETag"), *second.header("ETag"));
+    EXPECT_EQ(get("/GetAccountsJson?Group=Main").body.find("beta"), std::string::npos);
+
+    auto stats = api->accounts_cache_stats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.hits, 1u);
+
+    store.update("beta", [](ram::Account& a) { a.set_alias("changed"); });
+    auto third = get("/GetAccountsJson");
+    EXPECT_NE(third.body.find("changed"), std::string::npos);
+    EXPECT_NE(*third.header("ETag"), *first.header("ETag"));
+    EXPECT_EQ(api->accounts_cache_stats().misses, 3u);
+}
+
+TEST_F(LocalApiTest, UnchangedPollsGet304) {
+    start();
+    auto first = get("/GetAccounts");
+    ASSERT_NE(first.header("ETag"), nullptr);
+    std::string etag = *first.header("ETag");
+
+    ram::HttpRequest req;
+    req.url = "http://127.0.0.1:" + std::to_string(api->port()) + "/GetAccounts";
+    req.headers.emplace_back("If-None-Match", "\"other\", W/" + etag);
+    auto cached = client.send(req);
+    EXPECT_EQ(cached.status, 304);
+    EXPECT_TRUE(cached.body.empty());
+    EXPECT_EQ(api->accounts_cache_stats().not_modified, 1u);
+
+    // The tag of one variant does not validate another.
+    ram::HttpRequest other_group = req;
+    other_group.url += "?Group=Main";
+    EXPECT_EQ(client.send(other_group).status, 200);
+    ram::HttpRequest other_format = req;
+    other_format.url = "http://127.0.0.1:" + std::to_string(api->port()) + "/GetAccountsJson";
+    EXPECT_EQ(client.send(other_format).status, 200);
+
+    ram::Account gamma("cookie-gamma");
+    gamma.username = "gamma";
+    gamma.user_id = 3;
+    store.add(gamma);
+    auto changed = client.send(req);
+    EXPECT_EQ(changed.status, 200);
+    EXPECT_EQ(changed.body, "alpha,beta,gamma");
+}
+
+TEST_F(LocalApiTest, BatchRunsOperationsInOrderAndSavesOnce) {
+    std::atomic<int> saves{0};
+    configure = [&](ram::LocalApi& api) { api.set_on_modified([&] { ++saves; }); };
+    start();
+    uint64_t version = store.version();
+
+    auto response = get("/Batch?Password=hunter22", R"([
+        {"Method": "SetField", "Account": "alpha", "Params": {"Field": "Server", "Value": "EU"}},
+        {"Method": "GetField", "Account": "alpha", "Params": {"Field": "Server"}},
+        {"Method": "SetAlias", "Account": "2", "Body": "second"},
+        {"Method": "GetAlias", "Account": "beta"},
+        {"Method": "GetCookie", "Account": "alpha"},
+        {"Method": "GetAlias", "Account": "nobody"},
+        {"Method": "LaunchAccount", "Account": "alpha"},
+        {"Method": "Nope"},
+        42
+    ])");
+    ASSERT_EQ(response.status, 200);
+    auto results = nlohmann::json::parse(response.body);
+    ASSERT_EQ(results.size(), 9u);
+    EXPECT_EQ(results[0]["Message"], "Set Field Server to EU for alpha");
+    EXPECT_EQ(results[1]["Message"], "EU");
+    EXPECT_EQ(results[2]["Message"], "Set Alias of beta to second");
+    EXPECT_EQ(results[3]["Message"], "second");
+    EXPECT_EQ(results[4]["Message"], "cookie-alpha");
+    for (size_t i = 0; i < 5; ++i) EXPECT_TRUE(results[i]["Success"].get<bool>()) << i;
+    EXPECT_EQ(results[5]["Success"], false);
+    EXPECT_EQ(results[6]["Message"], "Method `LaunchAccount` cannot be batched");
+    EXPECT_EQ(results[7]["Message"], "404 not found");
+    EXPECT_EQ(results[8]["Success"], false);
+
+    EXPECT_EQ(saves.load(), 1);
+    EXPECT_EQ(store.version(), version + 1);
+}
+
+TEST_F(LocalApiTest, BatchKeepsPerMethodGating) {
+    settings.allow_account_editing = false;
+    start();
+    auto results = nlohmann::json::parse(get("/v2/Batch?Password=wrong", R"([
+        {"Method": "SetField", "Account": "alpha", "Params": {"Field": "a", "Value": "b"}},
+        {"Method": "GetCookie", "Account": "alpha"},
+        {"Method": "GetField", "Account": "alpha", "Params": {"Field": "a"}}
+    ])").body);
+    EXPECT_EQ(results[0]["Message"], "Method `SetField` not allowed");
+    EXPECT_EQ(results[1]["Success"], false);
+    EXPECT_EQ(results[2]["Success"], true);
+
+    EXPECT_EQ(get("/Batch", "{}").status, 400);
+    EXPECT_EQ(get("/Batch", "not json").status, 400);
+}
+
+TEST_F(LocalApiTest, BatchFetchesMissingCsrfTokensFirst) {
+    ram::testing::StubHttpServer auth([](const ram::HttpRequest& req) {
+        const std::string* cookie = req.header("Cookie");
+        bool valid = cookie != nullptr && cookie->find("cookie-alpha") != std::string::npos;
+        auto resp = ram::testing::json_response("{}", valid ? 403 : 401);
+        if (valid) resp.headers.emplace_back("x-csrf-token", "csrf-alpha");
+        return resp;
+    });
+    ram::HttpClient auth_client;
+    ram::CsrfTokenCache cache(auth_client, {auth.url()});
+    csrf = &cache;
+    start();
+
+    const std::string body = R"([
+        {"Method": "GetCSRFToken", "Account": "alpha"},
+        {"Method": "GetCSRFToken", "Account": "1"},
+        {"Method": "GetAlias", "Account": "beta"}
+    ])";
+    for (int round = 0; round < 2; ++round) {
+        auto results = nlohmann::json::parse(get("/Batch", body).body);
+        EXPECT_EQ(results[0]["Message"], "csrf-alpha");
+        EXPECT_EQ(results[1]["Message"], "csrf-alpha");
+        EXPECT_EQ(results[2]["Success"], false);
+    }
+    EXPECT_EQ(cache.stats().misses, 3u);  // alpha once, beta (invalid) every round
+    api->stop();
+}
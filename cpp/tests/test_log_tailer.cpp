@@ -0,0 +1,317 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ram/log_tailer.h"
+#include "stub_http_server.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A fresh logs directory, removed afterwards.
+struct TempDir : ram::testing::TempDir {
+    TempDir() : ram::testing::TempDir("ram_log_tailer_") {}
+};
+
+void append(const std::string& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary | std::ios::app) << text;
+}
+
+void overwrite(const std::string& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+}
+
+const std::string kJobId = "a3f1c2d4-5b6e-4f70-8a9b-0c1d2e3f4a5b";
+
+std::string join_line() {
+    return "2024-01-01T00:00:00.000Z,1.5,abcd,6 [FLog::Output] ! Joining game '" + kJobId +
+           "' place 1818 at 10.0.0.1\n";
+}
+
+std::string disconnect_line() {
+    return "2024-01-01T00:00:09.000Z,9.5,abcd,6 [FLog::Network] Sending disconnect with "
+           "reason: 277\r\n";
+}
+
+std::string noise(size_t lines) {
+    std::string out;
+    for (size_t i = 0; i < lines; ++i) {
+        out += "2024-01-01T00:00:01.000Z,2.0,abcd,6 [FLog::Graphics] frame " +
+               std::to_string(i) + " took 16ms\n";
+    }
+    return out;
+}
+
+// Collects published events.
+struct Recorder {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<ram::LogEvent> events;
+
+    ram::LogTailer::Listener listener() {
+        return [this](const ram::LogEvent& e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(e);
+            cv.notify_all();
+        };
+    }
+
+    std::vector<std::string> markers() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::string> out;
+        for (const auto& e : events) out.push_back(e.marker + "=" + e.value);
+        return out;
+    }
+};
+
+std::vector<ram::MarkerMatcher::Hit> naive_scan(const std::vector<std::string>& patterns,
+                                                const std::string& text) {
+    std::vector<ram::MarkerMatcher::Hit> out;
+    for (size_t i = 0; i < text.size(); ++i) {
+        for (size_t p = 0; p < patterns.size(); ++p) {
+            if (!patterns[p].empty() && text.compare(i, patterns[p].size(), patterns[p]) == 0) {
+                out.push_back({i, p});
+            }
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(LogTailerTest, MatcherAgreesWithNaiveSearch) {
+    // Overlapping patterns, shared prefixes, one- and two-byte patterns
+    // and more patterns than buckets.
+    std::vector<std::string> patterns = {"abc", "abd",    "aXc", "b",  "ca", "",
+                                         "cab", "abcabc", "dX",  "Xd", "bcd"};
+    ram::MarkerMatcher matcher(patterns);
+    std::mt19937 rng(7);
+    for (size_t length : {0u, 1u, 5u, 15u, 16u, 17u, 31u, 64u, 1000u}) {
+        std::string text;
+        for (size_t i = 0; i < length; ++i) text += "abcdX"[rng() % 5];
+        std::vector<ram::MarkerMatcher::Hit> hits;
+        matcher.scan(text, hits);
+        auto expected = naive_scan(patterns, text);
+        ASSERT_EQ(hits.size(), expected.size()) << "length " << length;
+        for (size_t i = 0; i < hits.size(); ++i) {
+            EXPECT_EQ(hits[i].offset, expected[i].offset);
+            EXPECT_EQ(hits[i].pattern, expected[i].pattern);
+        }
+    }
+}
+
+TEST(LogTailerTest, ExtractsJoinAndDisconnectDetails) {
+    TempDir dir;
+    std::string log = dir.file("0.600_abcd_Player_1_last.log");
+    overwrite(log, noise(50) + join_line() + noise(50) + disconnect_line());
+
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log, true);
+    EXPECT_EQ(tailer.poll_now(), 3u);
+
+    EXPECT_EQ(recorder.markers(),
+              (std::vector<std::string>{"job_id=" + kJobId, "place_id=1818", "disconnect=277"}));
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    EXPECT_EQ(recorder.events[0].line + "\n", join_line());
+    EXPECT_EQ(recorder.events[0].offset, noise(50).size());
+    EXPECT_EQ(recorder.events[2].file, log);
+}
+
+TEST(LogTailerTest, ReadsOnlyAppendedBytes) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, join_line() + noise(100));
+
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);  // existing content is history
+    EXPECT_EQ(tailer.poll_now(), 0u);
+    EXPECT_EQ(tailer.stats().bytes, 0u);
+
+    std::string appended = noise(3) + disconnect_line();
+    append(log, appended.substr(0, 20));  // half a line: nothing yet
+    tailer.poll(std::chrono::milliseconds(1000));
+    EXPECT_TRUE(recorder.markers().empty());
+    append(log, appended.substr(20));
+    EXPECT_EQ(tailer.poll(std::chrono::milliseconds(1000)), 1u);
+    EXPECT_EQ(recorder.markers(), (std::vector<std::string>{"disconnect=277"}));
+    EXPECT_EQ(tailer.stats().bytes, appended.size());
+
+    // No changes: nothing is read.
+    auto reads = tailer.stats().reads;
+    EXPECT_EQ(tailer.poll(std::chrono::milliseconds(20)), 0u);
+    EXPECT_EQ(tailer.stats().reads, reads);
+}
+
+TEST(LogTailerTest, HandlesTruncationAndRotation) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, noise(20));
+
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);
+    tailer.poll_now();
+
+    // Truncated and rewritten shorter than the old offset.
+    overwrite(log, join_line());
+    tailer.poll(std::chrono::milliseconds(1000));
+    EXPECT_EQ(tailer.stats().truncations, 1u);
+    EXPECT_EQ(recorder.markers().size(), 2u);
+
+    // Renamed away after one last line, and a new file takes its name.
+    append(log, disconnect_line());
+    fs::rename(log, dir.file("player.log.1"));
+    overwrite(log, noise(5) + join_line());
+    for (int i = 0; i < 5 && recorder.markers().size() < 5; ++i) {
+        tailer.poll(std::chrono::milliseconds(200));
+    }
+    EXPECT_EQ(recorder.markers(),
+              (std::vector<std::string>{"job_id=" + kJobId, "place_id=1818", "disconnect=277",
+                                        "job_id=" + kJobId, "place_id=1818"}));
+    EXPECT_GE(tailer.stats().rotations, 1u);
+}
+
+TEST(LogTailerTest, FollowsNewFilesInADirectory) {
+    TempDir dir;
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch_directory(dir.path.string());
+
+    overwrite(dir.file("notes.txt"), join_line());
+    overwrite(dir.file("1.log"), join_line());
+    for (int i = 0; i < 5 && recorder.markers().size() < 2; ++i) {
+        tailer.poll(std::chrono::milliseconds(300));
+    }
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    ASSERT_EQ(recorder.events.size(), 2u);
+    EXPECT_EQ(recorder.events[0].file, dir.file("1.log"));
+}
+
+TEST(LogTailerTest, KeepsLinesAppendedBeforeTheFirstPoll) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, join_line());
+
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);  // the join is history; what follows is not
+    append(log, disconnect_line());
+    EXPECT_EQ(tailer.poll_now(), 1u);
+    EXPECT_EQ(recorder.markers(), (std::vector<std::string>{"disconnect=277"}));
+}
+
+TEST(LogTailerTest, ReadsFilesCreatedAfterWatchFromTheStart) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);
+    overwrite(log, join_line());
+    EXPECT_EQ(tailer.poll_now(), 2u);
+    EXPECT_EQ(recorder.markers(),
+              (std::vector<std::string>{"job_id=" + kJobId, "place_id=1818"}));
+}
+
+TEST(LogTailerTest, ListenersMayUnsubscribeThemselves) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, join_line());
+
+    ram::LogTailer tailer;
+    int calls = 0;
+    size_t id = 0;
+    id = tailer.subscribe([&](const ram::LogEvent&) {
+        ++calls;
+        tailer.unsubscribe(id);  // used to deadlock on the listener lock
+    });
+    tailer.watch(log, true);
+    EXPECT_EQ(tailer.poll_now(), 2u);
+    EXPECT_EQ(calls, 2);  // the round's listeners were fixed when it started
+
+    append(log, disconnect_line());
+    EXPECT_EQ(tailer.poll_now(), 1u);
+    EXPECT_EQ(calls, 2);
+}
+
+#ifdef __linux__
+TEST(LogTailerTest, RecoversFromInotifyQueueOverflow) {
+    size_t limit = 16384;
+    std::ifstream("/proc/sys/fs/inotify/max_queued_events") >> limit;
+    if (limit > 65536) GTEST_SKIP() << "inotify queue too large to overflow quickly";
+
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, noise(1));
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);
+    tailer.poll_now();
+
+    // Fill the queue, so the append below is never reported.
+    for (size_t i = 0; i < limit + 16; ++i) overwrite(dir.file(std::to_string(i) + ".txt"), "");
+    append(log, join_line());
+
+    EXPECT_EQ(tailer.poll(std::chrono::milliseconds(1000)), 2u);
+    EXPECT_GE(tailer.stats().overflows, 1u);
+}
+#endif
+
+TEST(LogTailerTest, DropsOverlongLines) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, "");
+
+    ram::LogTailerOptions options;
+    options.read_chunk = 64;
+    options.max_line = 256;
+    ram::LogTailer tailer(ram::roblox_log_markers(), options);
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);
+    tailer.poll_now();
+
+    append(log, std::string(1000, 'x') + "Sending disconnect with reason: 1\n" + join_line());
+    tailer.poll_now();
+    EXPECT_EQ(recorder.markers(),
+              (std::vector<std::string>{"job_id=" + kJobId, "place_id=1818"}));
+}
+
+TEST(LogTailerTest, BackgroundThreadPublishesPromptly) {
+    TempDir dir;
+    std::string log = dir.file("player.log");
+    overwrite(log, noise(10));
+
+    ram::LogTailer tailer;
+    Recorder recorder;
+    tailer.subscribe(recorder.listener());
+    tailer.watch(log);
+    tailer.start();
+
+    auto written = std::chrono::steady_clock::now();
+    append(log, disconnect_line());
+    std::unique_lock<std::mutex> lock(recorder.mutex);
+    ASSERT_TRUE(recorder.cv.wait_for(lock, std::chrono::seconds(2),
+                                     [&] { return !recorder.events.empty(); }));
+    // Far below the old 250ms timer, with room for a loaded machine.
+    EXPECT_LT(recorder.events[0].read_at - written, std::chrono::milliseconds(200));
+    lock.unlock();
+    tailer.stop();
+}
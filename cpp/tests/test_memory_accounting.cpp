@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/account_store.h"
+#include "ram/ini_file.h"
+#include "ram/memory_accounting.h"
+#include "ram/ttl_cache.h"
+
+// ram_tests links ram_memory_hook, so live bytes are counted here.
+
+namespace {
+
+int64_t live(ram::MemoryTag tag) { return ram::memory_report()[tag].live_bytes; }
+
+}  // namespace
+
+TEST(MemoryAccountingTest, ChargesBlocksToTheirScopeUntilFreed) {
+    ASSERT_TRUE(ram::memory_report().hooked);
+    int64_t before = live(ram::MemoryTag::Crypto);
+    std::unique_ptr<char[]> block;
+    {
+        ram::MemoryScope scope(ram::MemoryTag::Crypto);
+        block.reset(new char[4096]);
+        {
+            ram::MemoryScope inner(ram::MemoryTag::Untagged);
+            EXPECT_EQ(ram::current_memory_tag(), ram::MemoryTag::Untagged);
+        }
+        EXPECT_EQ(ram::current_memory_tag(), ram::MemoryTag::Crypto);
+    }
+    EXPECT_EQ(ram::current_memory_tag(), ram::MemoryTag::Untagged);
+    EXPECT_EQ(live(ram::MemoryTag::Crypto), before + 4096);
+
+    // Freed on another thread, outside any scope.
+    std::thread([&] { block.reset(); }).join();
+    EXPECT_EQ(live(ram::MemoryTag::Crypto), before);
+}
+
+TEST(MemoryAccountingTest, OverAlignedAllocations) {
+    struct alignas(256) Wide {
+        char bytes[256];
+    };
+    int64_t before = live(ram::MemoryTag::Caches);
+    Wide* wide = nullptr;
+    {
+        ram::MemoryScope scope(ram::MemoryTag::Caches);
+        wide = new Wide;
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(wide) % 256, 0u);
+    EXPECT_EQ(live(ram::MemoryTag::Caches), before + 256);
+    delete wide;
+    EXPECT_EQ(live(ram::MemoryTag::Caches), before);
+}
+
+TEST(MemoryAccountingTest, AttributesAccountsFieldsAndIni) {
+    int64_t accounts = live(ram::MemoryTag::Accounts);
+    int64_t fields = live(ram::MemoryTag::Fields);
+    int64_t ini_before = live(ram::MemoryTag::Ini);
+    {
+        ram::AccountStore store;
+        store.load_json(R"([
+            {"Username": "alpha", "UserID": 1, "SecurityToken": "cookie-alpha-with-some-length",
+             "Fields": {"SavedPlaceId": "1818", "Note": "a note long enough to need the heap"}},
+            {"Username": "beta", "UserID": 2}
+        ])");
+        EXPECT_GT(live(ram::MemoryTag::Accounts), accounts);
+        EXPECT_GT(live(ram::MemoryTag::Fields), fields);
+
+        std::istringstream text("[General]\nSomeRatherLongPropertyName=SomeRatherLongValue\n");
+        ram::IniFile ini(text);
+        EXPECT_GT(live(ram::MemoryTag::Ini), ini_before);
+    }
+    EXPECT_EQ(live(ram::MemoryTag::Accounts), accounts);
+    EXPECT_EQ(live(ram::MemoryTag::Fields), fields);
+    EXPECT_EQ(live(ram::MemoryTag::Ini), ini_before);
+}
+
+TEST(MemoryAccountingTest, CacheEntriesAreCharged) {
+    int64_t before = live(ram::MemoryTag::Caches);
+    {
+        ram::TtlCache<int, std::string> cache;
+        for (int i = 0; i < 100; ++i) cache.put(i, std::string(100, 'x'));
+        EXPECT_GT(live(ram::MemoryTag::Caches), before);
+    }
+    EXPECT_EQ(live(ram::MemoryTag::Caches), before);
+}
+
+TEST(MemoryAccountingTest, ReportListsEveryTag) {
+    ram::MemoryReport report = ram::memory_report();
+    ASSERT_EQ(report.tags.size(), static_cast<size_t>(ram::MemoryTag::Count));
+    std::string text = report.to_string();
+    for (const char* name : {"untagged", "accounts", "fields", "ini", "crypto", "caches"}) {
+        EXPECT_NE(text.find(name), std::string::npos) << name;
+    }
+    EXPECT_GT(report.live_bytes(), 0);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/local_api.h"
+#include "ram/metrics.h"
+#include "ram/utilities.h"
+
+namespace {
+
+bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+}  // namespace
+
+TEST(MetricsTest, CounterSumsAcrossThreads) {
+    ram::Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) counter.add();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(counter.value(), 80000u);
+    counter.reset();
+    EXPECT_EQ(counter.value(), 0u);
+}
+
+TEST(MetricsTest, HistogramShardsMerge) {
+    ram::LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) histogram.record(std::chrono::microseconds(t + 1));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    ram::Histogram merged = histogram.snapshot();
+    EXPECT_EQ(merged.count(), 4000u);
+    EXPECT_EQ(merged.sum(), 1000u * (1000 + 2000 + 3000 + 4000));
+    EXPECT_EQ(merged.max(), 4000u);
+}
+
+TEST(MetricsTest, RegistryReturnsSameMetricAndChecksKinds) {
+    ram::MetricsRegistry registry;
+    ram::Counter& a = registry.counter("requests_total", "Requests.", "code=\"200\"");
+    ram::Counter& b = registry.counter("requests_total", "Requests.", "code=\"200\"");
+    ram::Counter& c = registry.counter("requests_total", "Requests.", "code=\"404\"");
+    EXPECT_EQ(&a, &b);
+    EXPECT_NE(&a, &c);
+    EXPECT_THROW(registry.gauge("requests_total", "Requests."), std::invalid_argument);
+    EXPECT_THROW(registry.counter("9lives", "Bad."), std::invalid_argument);
+    EXPECT_THROW(registry.counter("has-dash", "Bad."), std::invalid_argument);
+    EXPECT_THROW(registry.counter("", "Bad."), std::invalid_argument);
+}
+
+TEST(MetricsTest, RendersPrometheusText) {
+    ram::MetricsRegistry registry;
+    registry.counter("jobs_total", "Jobs run.\nAll of them.", "queue=\"a\"").add(3);
+    registry.counter("jobs_total", "Jobs run.", "queue=\"b\"").add(4);
+    registry.gauge("queue_depth", "Depth.").set(-2);
+    auto& latency = registry.histogram("job_seconds", "Job latency.", "queue=\"a\"");
+    latency.record(std::chrono::nanoseconds(500));       // below the first bound
+    latency.record(std::chrono::microseconds(3));        // le 4.096us
+    latency.record(std::chrono::milliseconds(100));      // le 0.134s
+    latency.record(std::chrono::seconds(60));            // only +Inf
+
+    std::string text = registry.render_prometheus();
+    EXPECT_TRUE(contains(text, "# HELP jobs_total Jobs run.\\nAll of them.\n"
+                               "# TYPE jobs_total counter\n"
+                               "jobs_total{queue=\"a\"} 3\n"
+                               "jobs_total{queue=\"b\"} 4\n"));
+    EXPECT_TRUE(contains(text, "# TYPE queue_depth gauge\nqueue_depth -2\n"));
+    EXPECT_TRUE(contains(text, "# TYPE job_seconds histogram\n"
+                               "job_seconds_bucket{queue=\"a\",le=\"1.024e-06\"} 1\n"
+                               "job_seconds_bucket{queue=\"a\",le=\"2.048e-06\"} 1\n"
+                               "job_seconds_bucket{queue=\"a\",le=\"4.096e-06\"} 2\n"));
+    EXPECT_TRUE(contains(text, "job_seconds_bucket{queue=\"a\",le=\"0.067108864\"} 2\n"
+                               "job_seconds_bucket{queue=\"a\",le=\"0.134217728\"} 3\n"));
+    EXPECT_TRUE(contains(text, "job_seconds_bucket{queue=\"a\",le=\"17.179869184\"} 3\n"
+                               "job_seconds_bucket{queue=\"a\",le=\"+Inf\"} 4\n"
+                               "job_seconds_sum{queue=\"a\"} 60.1000035\n"
+                               "job_seconds_count{queue=\"a\"} 4\n"));
+}
+
+TEST(MetricsTest, CoreOperationsAreRecorded) {
+    const ram::CoreMetrics& metrics = ram::core_metrics();
+    uint64_t md5_before = metrics.md5.snapshot().count();
+    uint64_t sha_before = metrics.sha256.snapshot().count();
+    uint64_t bytes_before = metrics.hashed_bytes.value();
+    uint64_t ini_before = metrics.ini_load.snapshot().count();
+
+    ram::md5("hello");
+    ram::sha256_digest(std::string(100, 'x'));
+    std::istringstream ini_text("[General]\nKey=Value\n");
+    ram::IniFile ini(ini_text);
+
+    EXPECT_EQ(metrics.md5.snapshot().count(), md5_before + 1);
+    EXPECT_EQ(metrics.sha256.snapshot().count(), sha_before + 1);
+    EXPECT_GE(metrics.hashed_bytes.value(), bytes_before + 105);
+    EXPECT_EQ(metrics.ini_load.snapshot().count(), ini_before + 1);
+
+    uint64_t failures = metrics.account_load_failures.value();
+    ram::AccountStore store;
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("ram_metrics_" + std::to_string(reinterpret_cast<uintptr_t>(&store))))
+                           .string();
+    std::ofstream(path) << "not json";
+    EXPECT_THROW(store.load(path), std::runtime_error);
+    std::filesystem::remove(path);
+    EXPECT_EQ(metrics.account_load_failures.value(), failures + 1);
+}
+
+TEST(MetricsTest, LocalApiServesMetrics) {
+    ram::core_metrics();
+    ram::AccountStore store;
+    ram::LocalApiSettings settings;
+    settings.port = 0;
+    ram::LocalApi api(store, settings);
+    api.start();
+
+    ram::HttpClient client;
+    ram::HttpRequest request;
+    request.url = "http://127.0.0.1:" + std::to_string(api.port()) + "/metrics";
+    auto response = client.send(request);
+    api.stop();
+
+    EXPECT_EQ(response.status, 200);
+    ASSERT_NE(response.header("Content-Type"), nullptr);
+    EXPECT_TRUE(contains(*response.header("Content-Type"), "version=0.0.4"));
+    EXPECT_TRUE(contains(response.body, "# TYPE ram_hash_seconds histogram\n"));
+    EXPECT_TRUE(contains(response.body, "ram_account_save_failures_total "));
+}
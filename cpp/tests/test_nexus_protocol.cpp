@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ram/nexus_protocol.h"
+
+namespace {
+
+std::vector<ram::NexusCommand> decode_all(std::string_view frame, bool* error = nullptr) {
+    ram::NexusArena arena;
+    ram::NexusFrameReader reader(frame);
+    std::vector<ram::NexusCommand> commands;
+    ram::NexusCommandView view;
+    while (reader.next(arena, view)) {
+        ram::NexusCommand command{std::string(view.name), {}};
+        for (size_t i = 0; i < view.field_count; ++i) {
+            command.payload.emplace(view.fields[i].key, view.fields[i].value);
+        }
+        commands.push_back(std::move(command));
+    }
+    if (error) *error = reader.error();
+    return commands;
+}
+
+}  // namespace
+
+TEST(NexusProtocolTest, JsonMatchesCommandClass) {
+    auto command = ram::parse_json_command(
+        R"({"Name":"Log","Payload":{"Content":"hello","Count":3}})");
+    ASSERT_TRUE(command.has_value());
+    EXPECT_EQ(command->name, "Log");
+    ASSERT_EQ(command->payload.size(), 1u);
+    EXPECT_EQ(command->payload["Content"], "hello");
+
+    auto ping = ram::parse_json_command(R"({"Name":"ping"})");
+    ASSERT_TRUE(ping.has_value());
+    EXPECT_TRUE(ping->payload.empty());
+
+    EXPECT_FALSE(ram::parse_json_command("not json").has_value());
+    EXPECT_FALSE(ram::parse_json_command(R"({"Payload":{}})").has_value());
+
+    auto again = ram::parse_json_command(ram::serialize_json_command(*command));
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(again->payload, command->payload);
+}
+
+TEST(NexusProtocolTest, BatchRoundTrips) {
+    ram::NexusBinaryEncoder encoder;
+    encoder.begin();
+    encoder.add("ping");
+    encoder.add("Log", {{"Content", "first"}});
+    encoder.add("Custom", {{"Status", "ok"}, {"Job", "abc"}});
+    encoder.add("Custom", {{"Status", std::string(300, 's')}, {"Job", ""}});
+    encoder.add(ram::NexusCommand{"SetRelaunch", {{"Seconds", "30"}}});
+    EXPECT_EQ(encoder.commands(), 5u);
+
+    bool error = true;
+    auto commands = decode_all(encoder.frame(), &error);
+    EXPECT_FALSE(error);
+    ASSERT_EQ(commands.size(), 5u);
+    EXPECT_EQ(commands[0].name, "ping");
+    EXPECT_TRUE(commands[0].payload.empty());
+    EXPECT_EQ(commands[1].payload.at("Content"), "first");
+    EXPECT_EQ(commands[2].name, "Custom");
+    EXPECT_EQ(commands[2].payload.at("Status"), "ok");
+    EXPECT_EQ(commands[3].payload.at("Status"), std::string(300, 's'));
+    EXPECT_EQ(commands[3].payload.at("Job"), "");
+    EXPECT_EQ(commands[4].payload.at("Seconds"), "30");
+}
+
+TEST(NexusProtocolTest, KnownNamesAndRepeatedKeysAreCompact) {
+    ram::NexusBinaryEncoder encoder;
+    encoder.begin();
+    encoder.add("ping");
+    // Version byte, command id, field count.
+    EXPECT_EQ(encoder.frame().size(), 3u);
+
+    encoder.begin();
+    encoder.add("Custom", {{"Status", "a"}});
+    size_t first = encoder.frame().size();
+    EXPECT_EQ(first, 20u);
+    encoder.add("Custom", {{"Status", "a"}});
+    // The second time the key is a one byte reference instead of eight.
+    EXPECT_EQ(encoder.frame().size() - first, 12u);
+}
+
+TEST(NexusProtocolTest, RejectsMalformedFrames) {
+    ram::NexusBinaryEncoder encoder;
+    encoder.begin();
+    encoder.add("Log", {{"Content", "hello"}});
+    std::string frame(encoder.frame());
+
+    bool error = false;
+    EXPECT_TRUE(decode_all("", &error).empty());
+    EXPECT_TRUE(error);
+    EXPECT_TRUE(decode_all(std::string("\x02\x01\x00", 3), &error).empty());
+    EXPECT_TRUE(error);
+
+    // Just the version byte is an empty batch; any other cut is an error.
+    EXPECT_TRUE(decode_all(frame.substr(0, 1), &error).empty());
+    EXPECT_FALSE(error);
+    for (size_t cut = 2; cut < frame.size(); ++cut) {
+        decode_all(std::string_view(frame).substr(0, cut), &error);
+        EXPECT_TRUE(error) << cut;
+    }
+
+    // Unknown command id, local key reference before any key was spelled,
+    // and a field count larger than the frame.
+    EXPECT_TRUE(decode_all(std::string("\x01\x7f\x00", 3), &error).empty() && error);
+    EXPECT_TRUE(decode_all(std::string("\x01\x02\x01\x10\x00", 5), &error).empty() && error);
+    EXPECT_TRUE(decode_all(std::string("\x01\x02\xff\xff\x03", 5), &error).empty() && error);
+    // An overlong varint.
+    EXPECT_TRUE(decode_all(std::string("\x01") + std::string(11, '\xff'), &error).empty() && error);
+}
+
+TEST(NexusProtocolTest, ArenaStopsGrowingForSteadyFrames) {
+    ram::NexusBinaryEncoder encoder;
+    encoder.begin();
+    for (int i = 0; i < 400; ++i) encoder.add("Log", {{"Content", "x"}, {"Name", "y"}});
+
+    ram::NexusArena arena(256);
+    size_t capacity = 0;
+    for (int round = 0; round < 3; ++round) {
+        arena.reset();
+        ram::NexusFrameReader reader(encoder.frame());
+        ram::NexusCommandView view;
+        size_t count = 0;
+        while (reader.next(arena, view)) ++count;
+        EXPECT_EQ(count, 400u);
+        if (round == 1) capacity = arena.capacity();
+        if (round == 2) {
+            EXPECT_EQ(arena.capacity(), capacity);
+        }
+    }
+}
@@ -0,0 +1,339 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/nexus_server.h"
+#include "ram/websocket.h"
+
+namespace {
+
+using std::chrono::milliseconds;
+
+// Poll until `pred` holds or the timeout passes.
+template <typename Pred>
+bool eventually(Pred pred, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    return pred();
+}
+
+// Blocking client speaking just enough of RFC 6455 for the tests.
+struct WsClient {
+    ram::Socket sock;
+    std::string buffer;
+    int status = 0;
+
+    WsClient(uint16_t port, const std::string& query, const std::string& headers = "") {
+        sock = ram::Socket::connect("127.0.0.1", port, milliseconds(2000));
+        std::string req = "GET /Nexus" + query +
+                          " HTTP/1.1\r\nHost: x\r\nUpgrade: websocket\r\n"
+                          "Connection: Upgrade\r\nSec-WebSocket-Version: 13\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n" +
+                          headers + "\r\n";
+        sock.send_all(req.data(), req.size(), milliseconds(2000));
+
+        ram::HttpResponse response;
+        size_t consumed = 0;
+        while (ram::parse_http_response(buffer, false, response, consumed) !=
+               ram::ParseStatus::Complete) {
+            if (!read_more()) return;
+            // A 101 has no body or length; stop at the end of the head.
+            size_t end = buffer.find("\r\n\r\n");
+            if (end != std::string::npos && buffer.rfind("HTTP/1.1 101", 0) == 0) {
+                status = 101;
+                accept = buffer.substr(0, end);
+                buffer.erase(0, end + 4);
+                return;
+            }
+        }
+        status = response.status;
+        buffer.erase(0, consumed);
+    }
+
+    bool read_more() {
+        char chunk[65536];
+        ptrdiff_t n = sock.recv_some(chunk, sizeof(chunk), milliseconds(2000));
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    void send(ram::WsOpcode op, const std::string& payload) {
+        std::string frame = ram::encode_masked_websocket_frame(op, payload, 0x12345678);
+        sock.send_all(frame.data(), frame.size(), milliseconds(2000));
+    }
+
+    // Next frame from the server, or nullopt if the connection closed.
+    std::optional<ram::WsFrame> next() {
+        for (;;) {
+            ram::WsFrame frame;
+            size_t consumed = 0;
+            if (ram::parse_websocket_frame(buffer, frame, consumed, 1 << 24) ==
+                ram::ParseStatus::Complete) {
+                buffer.erase(0, consumed);
+                return frame;
+            }
+            if (!read_more()) return std::nullopt;
+        }
+    }
+
+    std::string accept;
+};
+
+}  // namespace
+
+TEST(WebSocketTest, AcceptKeyMatchesRfcExample) {
+    EXPECT_EQ(ram::websocket_accept_key("dGhlIHNhbXBsZSBub25jZQ=="),
+              "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+TEST(WebSocketTest, FramesRoundTrip) {
+    for (size_t size : {0u, 5u, 125u, 126u, 65535u, 65536u}) {
+        std::string payload(size, 'x');
+        std::string masked = ram::encode_masked_websocket_frame(ram::WsOpcode::Text, payload, 7);
+        ram::WsFrame frame;
+        size_t consumed = 0;
+        ASSERT_EQ(ram::parse_websocket_frame(masked, frame, consumed, 1 << 20),
+                  ram::ParseStatus::Complete);
+        EXPECT_EQ(consumed, masked.size());
+        EXPECT_TRUE(frame.masked);
+        EXPECT_EQ(frame.payload, payload);
+
+        auto plain = ram::encode_websocket_frame(ram::WsOpcode::Binary, payload);
+        ASSERT_EQ(ram::parse_websocket_frame(*plain, frame, consumed, 1 << 20),
+                  ram::ParseStatus::Complete);
+        EXPECT_EQ(frame.opcode, ram::WsOpcode::Binary);
+        EXPECT_EQ(frame.payload, payload);
+
+        EXPECT_EQ(ram::parse_websocket_frame(std::string_view(*plain).substr(0, plain->size() - 1),
+                                             frame, consumed, 1 << 20),
+                  ram::ParseStatus::Incomplete);
+    }
+
+    auto big = ram::encode_websocket_frame(ram::WsOpcode::Text, std::string(100, 'x'));
+    ram::WsFrame frame;
+    size_t consumed = 0;
+    EXPECT_EQ(ram::parse_websocket_frame(*big, frame, consumed, 99), ram::ParseStatus::Error);
+}
+
+TEST(NexusServerTest, HandshakeRequiresNameAndId) {
+    ram::NexusServer server;
+    std::vector<ram::NexusClient> connected;
+    std::mutex mutex;
+    server.on_connect([&](const ram::NexusClient& c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        connected.push_back(c);
+        return c.name != "stranger";
+    });
+    server.start();
+
+    WsClient ok(server.port(), "?name=alpha&id=42");
+    EXPECT_EQ(ok.status, 101);
+    EXPECT_NE(ok.accept.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="), std::string::npos);
+
+    EXPECT_EQ(WsClient(server.port(), "?name=alpha").status, 400);
+    EXPECT_EQ(WsClient(server.port(), "?name=stranger&id=1").status, 403);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(connected.size(), 2u);
+    EXPECT_EQ(connected[0].user_id, 42);
+    EXPECT_EQ(connected[0].job_id, "UNKNOWN");
+    EXPECT_TRUE(connected[0].from_loopback);
+    EXPECT_TRUE(eventually([&] { return server.stats().handshakes_rejected == 2; }));
+}
+
+TEST(NexusServerTest, DeliversMessagesAndReplies) {
+    ram::NexusServer server;
+    server.on_message([&](const ram::NexusClient& c, std::string_view message) {
+        server.send(c.id, "echo:" + std::string(message));
+    });
+    server.start();
+
+    WsClient client(server.port(), "?name=alpha&id=1&jobId=job");
+    ASSERT_EQ(client.status, 101);
+    client.send(ram::WsOpcode::Text, R"({"Name":"ping"})");
+    auto reply = client.next();
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->payload, R"(echo:{"Name":"ping"})");
+
+    // A fragmented message is reassembled before delivery.
+    std::string first = ram::encode_masked_websocket_frame(ram::WsOpcode::Text, "hel", 1);
+    first[0] = static_cast<char>(first[0] & 0x7F);  // clear FIN
+    std::string second = ram::encode_masked_websocket_frame(ram::WsOpcode::Continuation, "lo", 2);
+    std::string both = first + second;
+    client.sock.send_all(both.data(), both.size(), milliseconds(2000));
+    reply = client.next();
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->payload, "echo:hello");
+
+    client.send(ram::WsOpcode::Ping, "p");
+    reply = client.next();
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->opcode, ram::WsOpcode::Pong);
+    EXPECT_EQ(reply->payload, "p");
+}
+
+TEST(NexusServerTest, BroadcastFramesOnceForEveryClient) {
+    ram::NexusServer server;
+    server.start();
+
+    std::vector<std::unique_ptr<WsClient>> clients;
+    for (int i = 0; i < 5; ++i) {
+        clients.push_back(
+            std::make_unique<WsClient>(server.port(), "?name=c" + std::to_string(i) + "&id=1"));
+        ASSERT_EQ(clients.back()->status, 101);
+    }
+    ASSERT_TRUE(eventually([&] { return server.stats().clients == 5; }));
+
+    server.broadcast("execute print(1)");
+    server.broadcast("second");
+    for (auto& c : clients) {
+        auto first = c->next();
+        auto second = c->next();
+        ASSERT_TRUE(first && second);
+        EXPECT_EQ(first->payload, "execute print(1)");
+        EXPECT_EQ(second->payload, "second");
+    }
+    // Stats are published after each loop iteration.
+    EXPECT_TRUE(eventually([&] { return server.stats().frames_queued == 10; }));
+    EXPECT_EQ(server.stats().broadcasts, 2u);
+}
+
+TEST(NexusServerTest, GroupSendReachesOnlyTargets) {
+    ram::NexusServer server;
+    std::vector<uint64_t> ids;
+    std::mutex mutex;
+    server.on_connect([&](const ram::NexusClient& c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.push_back(c.id);
+        return true;
+    });
+    server.start();
+
+    WsClient a(server.port(), "?name=a&id=1");
+    WsClient b(server.port(), "?name=b&id=2");
+    WsClient c(server.port(), "?name=c&id=3");
+    std::vector<uint64_t> targets;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        targets = {ids[0], ids[2]};
+    }
+    server.send(targets, "group");
+    server.send(ids[1], "solo");
+
+    EXPECT_EQ(a.next()->payload, "group");
+    EXPECT_EQ(b.next()->payload, "solo");
+    EXPECT_EQ(c.next()->payload, "group");
+}
+
+TEST(NexusServerTest, EvictsSlowConsumers) {
+    ram::NexusServerOptions options;
+    options.max_queued_bytes = 64 * 1024;
+    ram::NexusServer server(options);
+    std::atomic<int> disconnects{0};
+    server.on_disconnect([&](const ram::NexusClient&) { ++disconnects; });
+    server.start();
+
+    // Never reads, so the kernel buffers fill and the queue grows.
+    WsClient stalled(server.port(), "?name=slow&id=1");
+    ASSERT_EQ(stalled.status, 101);
+    ASSERT_TRUE(eventually([&] { return server.stats().clients == 1; }));
+
+    std::string chunk(16 * 1024, 'x');
+    for (int i = 0; i < 2000 && server.stats().slow_consumers_evicted == 0; ++i) {
+        server.broadcast(chunk);
+        if (i % 50 == 0) std::this_thread::sleep_for(milliseconds(1));
+    }
+    EXPECT_TRUE(eventually([&] { return server.stats().slow_consumers_evicted == 1; }));
+    EXPECT_TRUE(eventually([&] { return disconnects.load() == 1; }));
+    EXPECT_TRUE(eventually([&] { return server.stats().clients == 0; }));
+}
+
+TEST(NexusServerTest, PingsQuietClientsAndTimesThemOut) {
+    ram::NexusServerOptions options;
+    options.ping_interval = milliseconds(40);
+    options.timeout = milliseconds(200);
+    ram::NexusServer server(options);
+    server.start();
+
+    WsClient client(server.port(), "?name=quiet&id=1");
+    ASSERT_EQ(client.status, 101);
+    auto ping = client.next();
+    ASSERT_TRUE(ping.has_value());
+    EXPECT_EQ(ping->opcode, ram::WsOpcode::Ping);
+
+    // No pong: the server gives up after the timeout.
+    EXPECT_TRUE(eventually([&] { return server.stats().timed_out == 1; }));
+    EXPECT_GE(server.stats().pings_sent, 1u);
+}
+
+TEST(NexusServerTest, CloseHandshake) {
+    ram::NexusServer server;
+    std::atomic<int> disconnects{0};
+    server.on_disconnect([&](const ram::NexusClient&) { ++disconnects; });
+    server.start();
+
+    WsClient client(server.port(), "?name=a&id=1");
+    client.send(ram::WsOpcode::Close, std::string("\x03\xe8", 2));
+    auto reply = client.next();
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->opcode, ram::WsOpcode::Close);
+    EXPECT_EQ(reply->payload, std::string("\x03\xe8", 2));
+    EXPECT_FALSE(client.next().has_value());
+    EXPECT_TRUE(eventually([&] { return disconnects.load() == 1; }));
+}
+
+TEST(NexusServerTest, NegotiatesBinaryCommands) {
+    ram::NexusServer server;
+    std::mutex mutex;
+    std::vector<std::string> seen;
+    server.on_command([&](const ram::NexusClient& c, const ram::NexusCommandView& command) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.push_back(c.name + ":" + std::string(command.name) + ":" +
+                       std::string(command.get("Content").value_or("")));
+    });
+    server.start();
+
+    WsClient json(server.port(), "?name=old&id=1");
+    WsClient binary(server.port(), "?name=new&id=2",
+                    "Sec-WebSocket-Protocol: ram-nexus-binary.v1\r\n");
+    ASSERT_EQ(json.status, 101);
+    ASSERT_EQ(binary.status, 101);
+    EXPECT_EQ(json.accept.find("Sec-WebSocket-Protocol"), std::string::npos);
+    EXPECT_NE(binary.accept.find("Sec-WebSocket-Protocol: ram-nexus-binary.v1"), std::string::npos);
+
+    json.send(ram::WsOpcode::Text, R"({"Name":"Log","Payload":{"Content":"a"}})");
+    ASSERT_TRUE(eventually([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen.size() == 1;
+    }));
+
+    ram::NexusBinaryEncoder encoder;
+    encoder.begin();
+    encoder.add("ping");
+    encoder.add("Log", {{"Content", "b"}});
+    binary.send(ram::WsOpcode::Binary, std::string(encoder.frame()));
+    ASSERT_TRUE(eventually([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen.size() == 3;
+    }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(seen[0], "old:Log:a");
+        EXPECT_EQ(seen[1], "new:ping:");
+        EXPECT_EQ(seen[2], "new:Log:b");
+    }
+    EXPECT_TRUE(eventually([&] { return server.stats().commands_received == 3; }));
+
+    // A batch that does not decode drops the connection.
+    binary.send(ram::WsOpcode::Binary, "\x01\x7f");
+    EXPECT_FALSE(binary.next().has_value());
+}
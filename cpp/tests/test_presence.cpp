@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/presence.h"
+#include "stub_http_server.h"
+
+namespace {
+
+// Stand-in for presence.roblox.com backed by a mutable state table.
+struct PresenceStub {
+    std::mutex mutex;
+    std::map<int64_t, int> states;
+    std::atomic<int> max_batch{0};
+    std::atomic<bool> fail{false};
+
+    ram::HttpResponse handle(const ram::HttpRequest& req) {
+        if (fail) return ram::testing::json_response("{}", 503);
+        if (req.method != "POST" || req.url != "/v1/presence/users") {
+            return ram::testing::json_response("{}", 404);
+        }
+        auto body = nlohmann::json::parse(req.body);
+        auto ids = body["userIds"].get<std::vector<int64_t>>();
+        max_batch = std::max<int>(max_batch, static_cast<int>(ids.size()));
+
+        nlohmann::json out = nlohmann::json::array();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto id : ids) {
+            out.push_back({{"userId", id},
+                           {"userPresenceType", states[id]},
+                           {"lastLocation", "Website"},
+                           {"placeId", states[id] == 2 ? 1818 : 0}});
+        }
+        return ram::testing::json_response(
+            nlohmann::json{{"userPresences", out}}.dump());
+    }
+};
+
+ram::PresenceEngineOptions test_options(const std::string& base) {
+    ram::PresenceEngineOptions options;
+    options.endpoint = base + "/v1/presence/users";
+    options.batch_size = 2;
+    options.max_in_flight = 3;
+    options.requests_per_second = 1000;
+    options.burst = 1000;
+    options.initial_interval = std::chrono::milliseconds(1000);
+    options.min_interval = std::chrono::milliseconds(250);
+    options.max_interval = std::chrono::milliseconds(4000);
+    return options;
+}
+
+}  // namespace
+
+TEST(PresenceTest, ParseUserPresence) {
+    auto p = ram::UserPresence::from_json(nlohmann::json::parse(
+        R"({"userPresenceType":2,"lastLocation":"Game","placeId":1818,)"
+        R"("rootPlaceId":1818,"gameId":"abc","universeId":null,"userId":5})"));
+    EXPECT_EQ(p.user_id, 5);
+    EXPECT_EQ(p.type, ram::PresenceType::InGame);
+    EXPECT_EQ(p.place_id, 1818);
+    EXPECT_EQ(p.universe_id, 0);
+    EXPECT_EQ(p.game_id, "abc");
+}
+
+TEST(PresenceTest, ShardsIntoBatchesAndPublishesDeltas) {
+    PresenceStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::PresenceEngine engine(client, test_options(server.url()));
+
+    std::vector<ram::PresenceChange> published;
+    engine.subscribe([&](const std::vector<ram::PresenceChange>& changes) {
+        published.insert(published.end(), changes.begin(), changes.end());
+    });
+
+    for (int64_t id = 1; id <= 5; ++id) engine.track(id);
+
+    // First sighting of every user is a change.
+    EXPECT_EQ(engine.poll_all(), 5);
+    EXPECT_EQ(published.size(), 5);
+    EXPECT_EQ(engine.stats().requests, 3);
+    EXPECT_LE(stub.max_batch.load(), 2);
+
+    // Nothing changed: no events.
+    published.clear();
+    EXPECT_EQ(engine.poll_all(), 0);
+    EXPECT_TRUE(published.empty());
+
+    {
+        std::lock_guard<std::mutex> lock(stub.mutex);
+        stub.states[3] = 2;
+    }
+    EXPECT_EQ(engine.poll_all(), 1);
+    ASSERT_EQ(published.size(), 1);
+    EXPECT_EQ(published[0].current.user_id, 3);
+    EXPECT_EQ(published[0].current.type, ram::PresenceType::InGame);
+    ASSERT_TRUE(published[0].previous.has_value());
+    EXPECT_EQ(published[0].previous->type, ram::PresenceType::Offline);
+
+    EXPECT_EQ(engine.presence(3)->place_id, 1818);
+}
+
+TEST(PresenceTest, AdaptsIntervalToChangeRate) {
+    PresenceStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::PresenceEngine engine(client, test_options(server.url()));
+
+    engine.track(1);
+    engine.track(2);
+    engine.poll_all();  // both seen for the first time: interval halves
+    EXPECT_EQ(engine.interval(1), std::chrono::milliseconds(500));
+
+    for (int i = 0; i < 3; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(stub.mutex);
+            stub.states[1] = stub.states[1] == 1 ? 0 : 1;
+        }
+        engine.poll_all();
+    }
+    EXPECT_EQ(engine.interval(1), std::chrono::milliseconds(250));
+    EXPECT_EQ(engine.interval(2), std::chrono::milliseconds(1687));
+
+    // Only users whose interval elapsed are polled.
+    EXPECT_EQ(engine.poll_due(), 0);
+    EXPECT_EQ(engine.stats().users_polled, 8);
+}
+
+TEST(PresenceTest, SlackFillsTheLastBatch) {
+    PresenceStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    auto options = test_options(server.url());
+    options.batch_size = 4;
+    options.batch_slack = std::chrono::milliseconds(2000);
+    ram::PresenceEngine engine(client, options);
+
+    for (int64_t id = 1; id <= 3; ++id) engine.track(id);
+    engine.poll_all();  // next due in 500ms, inside the slack window
+
+    // Nobody is due yet, so the slack alone does not start a round.
+    EXPECT_EQ(engine.poll_due(), 0);
+    EXPECT_EQ(engine.stats().requests, 1);
+
+    // A newly tracked user is due now and brings the others along in the
+    // same request instead of leaving them for a round of their own.
+    engine.track(4);
+    EXPECT_EQ(engine.poll_due(), 1);
+    EXPECT_EQ(engine.stats().requests, 2);
+    EXPECT_EQ(engine.stats().users_polled, 7);
+    EXPECT_EQ(stub.max_batch.load(), 4);
+}
+
+TEST(PresenceTest, FailedBatchesAreCounted) {
+    PresenceStub stub;
+    stub.fail = true;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::PresenceEngine engine(client, test_options(server.url()));
+
+    for (int64_t id = 1; id <= 3; ++id) engine.track(id);
+    EXPECT_EQ(engine.poll_all(), 0);
+    EXPECT_EQ(engine.stats().failed_requests, 2);
+    EXPECT_FALSE(engine.presence(1).has_value());
+}
+
+TEST(PresenceTest, BackgroundPolling) {
+    PresenceStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::PresenceEngine engine(client, test_options(server.url()));
+
+    std::atomic<int> events{0};
+    engine.subscribe([&](const auto& changes) {
+        events += static_cast<int>(changes.size());
+    });
+    engine.start();
+    engine.track(42);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (events == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    engine.stop();
+    EXPECT_EQ(events.load(), 1);
+}
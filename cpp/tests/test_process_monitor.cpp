@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "ram/process_monitor.h"
+#include "stub_http_server.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+uint64_t ticks_per_second() {
+#ifndef _WIN32
+    return static_cast<uint64_t>(sysconf(_SC_CLK_TCK));
+#else
+    return 100;
+#endif
+}
+
+uint64_t page_size() {
+#ifndef _WIN32
+    return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+}
+
+// A fake /proc tree, removed afterwards.
+struct FakeProc : ram::testing::TempDir {
+    double uptime = 1000;
+
+    FakeProc() : ram::testing::TempDir("ram_proc_") {
+        set_uptime(uptime);
+        // Entries that are not processes.
+        fs::create_directories(path / "sys");
+        std::ofstream(path / "meminfo") << "MemTotal: 1 kB\n";
+    }
+
+    void set_uptime(double seconds) {
+        uptime = seconds;
+        std::ofstream(path / "uptime") << std::to_string(seconds) << " 12345.67\n";
+    }
+
+    // A process started `age` seconds ago with `rss_mb` resident.
+    void spawn(int pid, const std::string& comm, const std::vector<std::string>& argv,
+               double age = 60, uint64_t rss_mb = 500) {
+        fs::path dir = path / std::to_string(pid);
+        fs::create_directories(dir);
+        auto start = static_cast<uint64_t>((uptime - age) * static_cast<double>(ticks_per_second()));
+        std::ofstream(dir / "stat") << pid << " (" << comm << ") S 1 " << pid << " " << pid
+                                    << " 0 -1 4194560 100 0 0 0 5 3 0 0 20 0 12 0 " << start
+                                    << " 123456789 " << (rss_mb << 20) / page_size()
+                                    << " 18446744073709551615 1 1 0 0 0 0\n";
+        std::string cmdline;
+        for (const auto& arg : argv) cmdline += arg + '\0';
+        std::ofstream(dir / "cmdline", std::ios::binary) << cmdline;
+    }
+
+    void exit(int pid) { fs::remove_all(path / std::to_string(pid)); }
+};
+
+ram::ProcessMonitorOptions options_for(const FakeProc& proc) {
+    ram::ProcessMonitorOptions options;
+    options.proc_root = proc.path.string();
+    options.policy.grace = std::chrono::seconds(30);
+    return options;
+}
+
+std::vector<std::string> client_argv(const std::string& tracker) {
+    return {"RobloxPlayerBeta.exe", "--app", "-t", "TICKET", "-j",
+            "https://assetgame.roblox.com/game/PlaceLauncher.ashx?placeId=1", "-b", tracker};
+}
+
+ram::Account make_account(const std::string& name, const std::string& tracker) {
+    ram::Account acc("cookie-" + name);
+    acc.username = name;
+    acc.browser_tracker_id = tracker;
+    return acc;
+}
+
+}  // namespace
+
+TEST(ProcessMonitorTest, ParsesClientArguments) {
+    auto args = ram::parse_client_args(
+        "\"C:\\Program Files\\Roblox\\RobloxPlayerBeta.exe\" --app -t ABC -j "
+        "\"https://x/PlaceLauncher.ashx?a=1&b=2\" -b 123456789012 --rloc en_us");
+    EXPECT_TRUE(args.has_ticket);
+    EXPECT_TRUE(args.has_join_script);
+    EXPECT_TRUE(args.launched());
+    EXPECT_EQ(args.browser_tracker_id, "123456789012");
+
+    const char nul_form_text[] = "RobloxPlayerBeta\0-t\0T\0-b\0""42";
+    std::string nul_form(nul_form_text, sizeof(nul_form_text));
+    args = ram::parse_client_args(nul_form);
+    EXPECT_TRUE(args.has_ticket);
+    EXPECT_FALSE(args.has_join_script);
+    EXPECT_EQ(args.browser_tracker_id, "42");
+
+    args = ram::parse_client_args(
+        "RobloxPlayerBeta.exe roblox-player:1+launchmode:play+gameinfo:TICKET+launchtime:1+"
+        "placelauncherurl:https%3A%2F%2Fx+browsertrackerid:987+robloxLocale:en_us");
+    EXPECT_TRUE(args.has_ticket);
+    EXPECT_TRUE(args.has_join_script);
+    EXPECT_EQ(args.browser_tracker_id, "987");
+
+    // The helper process and a client opened by hand.
+    EXPECT_FALSE(ram::parse_client_args("\\??\\C:\\Roblox\\RobloxPlayerBeta.exe").launched());
+    EXPECT_FALSE(ram::parse_client_args("RobloxPlayerBeta.exe --app").launched());
+    // A flag with no value after it.
+    EXPECT_FALSE(ram::parse_client_args("RobloxPlayerBeta.exe -t").launched());
+}
+
+TEST(ProcessMonitorTest, FindsClientsAndResolvesAccounts) {
+    FakeProc proc;
+    proc.spawn(1, "systemd", {"/sbin/init"});
+    proc.spawn(100, "RobloxPlayerBet", client_argv("111"), 60, 800);
+    proc.spawn(101, "RobloxPlayerBet", client_argv("222"));
+    proc.spawn(102, "RobloxPlayerBet", {"RobloxPlayerBeta.exe", "--app"});  // not ours
+    proc.spawn(103, "bash", client_argv("111"));
+
+    ram::AccountStore store;
+    store.add(make_account("alpha", "111"));
+    ram::ProcessMonitor monitor(options_for(proc));
+    monitor.sync_accounts(store);
+    auto scan = monitor.scan();
+
+    ASSERT_EQ(scan.clients.size(), 2u);
+    std::sort(scan.clients.begin(), scan.clients.end(),
+              [](const auto& a, const auto& b) { return a.pid < b.pid; });
+    EXPECT_EQ(scan.clients[0].pid, 100);
+    EXPECT_EQ(scan.clients[0].username, "alpha");
+    EXPECT_EQ(scan.clients[0].rss_bytes, 800ull << 20);
+    EXPECT_NEAR(static_cast<double>(scan.clients[0].age.count()), 60, 1);
+    EXPECT_EQ(scan.clients[1].username, "");
+    EXPECT_TRUE(scan.decisions.empty());
+    EXPECT_EQ(scan.cost.pids, 5u);
+    EXPECT_EQ(scan.cost.new_pids, 5u);
+
+    // The index follows the store only when it changes.
+    store.add(make_account("beta", "222"));
+    monitor.sync_accounts(store);
+    scan = monitor.scan();
+    ASSERT_EQ(scan.clients.size(), 2u);
+    for (const auto& client : scan.clients) {
+        EXPECT_EQ(client.username, client.pid == 100 ? "alpha" : "beta");
+    }
+}
+
+TEST(ProcessMonitorTest, RescansReadOnlyWhatChanged) {
+    FakeProc proc;
+    for (int pid = 1; pid <= 50; ++pid) proc.spawn(pid, "worker", {"worker"});
+    proc.spawn(100, "RobloxPlayerBet", client_argv("1"));
+    proc.spawn(101, "RobloxPlayerBet", client_argv("2"));
+
+    ram::ProcessMonitor monitor(options_for(proc));
+    auto first = monitor.scan();
+    // uptime + 52 stat + 2 cmdline.
+    EXPECT_EQ(first.cost.file_reads, 55u);
+
+    // Settled: uptime plus one stat per client.
+    auto second = monitor.scan();
+    EXPECT_EQ(second.clients.size(), 2u);
+    EXPECT_EQ(second.cost.new_pids, 0u);
+    EXPECT_EQ(second.cost.file_reads, 3u);
+
+    // A new client, an exit.
+    proc.spawn(102, "RobloxPlayerBet", client_argv("3"), 1);
+    proc.exit(101);
+    auto third = monitor.scan();
+    EXPECT_EQ(third.clients.size(), 2u);
+    EXPECT_EQ(third.cost.new_pids, 1u);
+    EXPECT_EQ(third.cost.file_reads, 4u);  // uptime, 100, 102 stat + cmdline
+    EXPECT_EQ(monitor.stats().scans, 3u);
+    EXPECT_EQ(monitor.stats().file_reads, 62u);
+}
+
+TEST(ProcessMonitorTest, RechecksYoungProcessesAndReusedPids) {
+    FakeProc proc;
+    proc.spawn(200, "launcher", {"launcher"}, 2);
+    ram::ProcessMonitor monitor(options_for(proc));
+    EXPECT_TRUE(monitor.scan().clients.empty());
+
+    // The young launcher execs into the client under the same pid.
+    proc.spawn(200, "RobloxPlayerBet", client_argv("1"), 2);
+    EXPECT_EQ(monitor.scan().clients.size(), 1u);
+
+    // The pid is reused by something else started later.
+    proc.set_uptime(proc.uptime + 100);
+    proc.spawn(200, "bash", {"bash"}, 1);
+    auto scan = monitor.scan();
+    EXPECT_TRUE(scan.clients.empty());
+    EXPECT_EQ(scan.cost.new_pids, 1u);
+
+    // And again by a client with different arguments.
+    proc.set_uptime(proc.uptime + 100);
+    proc.spawn(200, "RobloxPlayerBet", {"RobloxPlayerBeta.exe", "--app"}, 1);
+    EXPECT_TRUE(monitor.scan().clients.empty());
+
+    // A settled non-client exits and a client takes its pid between scans.
+    proc.spawn(300, "worker", {"worker"}, 600);
+    EXPECT_TRUE(monitor.scan().clients.empty());
+    proc.exit(300);
+    proc.spawn(300, "RobloxPlayerBet", client_argv("1"), 1);
+    ASSERT_EQ(monitor.scan().clients.size(), 1u);
+    EXPECT_EQ(monitor.scan().clients.size(), 1u);
+}
+
+TEST(ProcessMonitorTest, RechecksEverythingWithoutUptime) {
+    FakeProc proc;
+    proc.spawn(400, "worker", {"worker"}, 600);
+    ram::ProcessMonitor monitor(options_for(proc));
+    EXPECT_TRUE(monitor.scan().clients.empty());
+
+    // Without /proc/uptime no process can be judged settled, so one that
+    // execs into a client under the same pid is still noticed.
+    fs::remove(proc.path / "uptime");
+    proc.spawn(400, "RobloxPlayerBet", client_argv("1"), 600);
+    EXPECT_EQ(monitor.scan().clients.size(), 1u);
+}
+
+TEST(ProcessMonitorTest, AppliesKillPolicy) {
+    FakeProc proc;
+    proc.set_uptime(100000);
+    proc.spawn(10, "RobloxPlayerBet", client_argv("1"), 10, 50);    // in grace
+    proc.spawn(11, "RobloxPlayerBet", client_argv("1"), 60, 50);    // low memory
+    proc.spawn(12, "RobloxPlayerBet", client_argv("2"), 4000, 900);  // too old
+    proc.spawn(13, "RobloxPlayerBet", client_argv("3"), 60, 900);   // wrong title
+    proc.spawn(14, "RobloxPlayerBet", client_argv("4"), 60, 900);   // fine
+
+    ram::AccountStore store;
+    store.add(make_account("alpha", "1"));
+    std::vector<int> killed;
+    auto options = options_for(proc);
+    options.policy.min_rss_bytes = 200ull << 20;
+    options.policy.max_age = std::chrono::hours(1);
+    options.policy.expected_title = "Roblox";
+    options.title = [](int pid) -> std::optional<std::string> {
+        return pid == 13 ? "Crash" : "Roblox";
+    };
+    options.kill = [&](int pid) {
+        killed.push_back(pid);
+        return pid != 12;
+    };
+    ram::ProcessMonitor monitor(options);
+    monitor.sync_accounts(store);
+    auto scan = monitor.scan();
+
+    EXPECT_EQ(scan.clients.size(), 5u);
+    ASSERT_EQ(scan.decisions.size(), 3u);
+    std::sort(scan.decisions.begin(), scan.decisions.end(),
+              [](const auto& a, const auto& b) { return a.pid < b.pid; });
+    EXPECT_EQ(scan.decisions[0].pid, 11);
+    EXPECT_EQ(scan.decisions[0].username, "alpha");
+    EXPECT_EQ(scan.decisions[0].reason, "Low Memory (50MB < 200MB)");
+    EXPECT_TRUE(scan.decisions[0].killed);
+    EXPECT_EQ(scan.decisions[1].pid, 12);
+    EXPECT_FALSE(scan.decisions[1].killed);
+    EXPECT_EQ(scan.decisions[2].reason, "Window Title isn't Roblox, got Crash");
+    std::sort(killed.begin(), killed.end());
+    EXPECT_EQ(killed, (std::vector<int>{11, 12, 13}));
+    EXPECT_EQ(monitor.stats().kills, 2u);
+}
+
+TEST(ProcessMonitorTest, MissingProcRootYieldsNothing) {
+    ram::ProcessMonitorOptions options;
+    options.proc_root = (fs::temp_directory_path() / "ram_no_such_proc_root").string();
+    ram::ProcessMonitor monitor(options);
+    auto scan = monitor.scan();
+    EXPECT_TRUE(scan.clients.empty());
+    EXPECT_EQ(scan.cost.pids, 0u);
+}
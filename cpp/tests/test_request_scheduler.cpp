@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ram/histogram.h"
+#include "ram/request_scheduler.h"
+#include "stub_http_server.h"
+
+namespace {
+
+ram::HttpRequest get(const std::string& url) {
+    ram::HttpRequest req;
+    req.url = url;
+    return req;
+}
+
+}  // namespace
+
+TEST(HistogramTest, BucketBoundsAreContiguous) {
+    for (size_t i = 0; i + 1 < ram::Histogram::kBuckets; ++i) {
+        EXPECT_EQ(ram::Histogram::bucket_upper_bound(i) + 1,
+                  ram::Histogram::bucket_lower_bound(i + 1));
+    }
+    for (uint64_t v : {0ull, 7ull, 8ull, 1000ull, 123456789ull}) {
+        size_t idx = ram::Histogram::bucket_index(v);
+        EXPECT_LE(ram::Histogram::bucket_lower_bound(idx), v);
+        EXPECT_GE(ram::Histogram::bucket_upper_bound(idx), v);
+    }
+}
+
+TEST(HistogramTest, Percentiles) {
+    ram::Histogram h;
+    for (uint64_t v = 1; v <= 1000; ++v) h.record(v);
+
+    EXPECT_EQ(h.count(), 1000);
+    EXPECT_EQ(h.max(), 1000);
+    EXPECT_DOUBLE_EQ(h.mean(), 500.5);
+    EXPECT_NEAR(static_cast<double>(h.percentile(50)), 500.0, 500 * 0.13);
+    EXPECT_NEAR(static_cast<double>(h.percentile(99)), 990.0, 990 * 0.13);
+    EXPECT_EQ(h.percentile(100), 1000);
+}
+
+TEST(RequestSchedulerTest, RoundRobinAcrossAccounts) {
+    std::mutex mutex;
+    std::vector<std::string> order;
+    ram::testing::StubHttpServer server([&](const ram::HttpRequest& req) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(req.url.substr(1, 1));
+        return ram::testing::json_response("{}");
+    });
+
+    ram::HttpClient client;
+    ram::RequestSchedulerOptions options;
+    options.max_in_flight = 1;
+    options.per_account = {1000, 1000};
+    options.default_endpoint = {50, 1};  // serialize dispatch
+    ram::RequestScheduler scheduler(client, options);
+
+    std::vector<std::future<ram::HttpResponse>> futures;
+    for (int i = 0; i < 6; ++i) {
+        futures.push_back(scheduler.submit("A", "", get(server.url() + "/A")));
+    }
+    for (int i = 0; i < 2; ++i) {
+        futures.push_back(scheduler.submit("B", "", get(server.url() + "/B")));
+    }
+    for (auto& f : futures) EXPECT_EQ(f.get().status, 200);
+
+    // B must not wait behind all of A's backlog.
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(order.size(), 8);
+    size_t last_b = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (order[i] == "B") last_b = i;
+    }
+    EXPECT_LE(last_b, 4);
+    EXPECT_EQ(scheduler.queue_depth(), 0);
+}
+
+TEST(RequestSchedulerTest, EnforcesPerAccountRate) {
+    ram::testing::StubHttpServer server(
+        [](const ram::HttpRequest&) { return ram::testing::json_response("{}"); });
+
+    ram::HttpClient client;
+    ram::RequestSchedulerOptions options;
+    options.per_account = {20, 1};
+    options.default_endpoint = {1000, 1000};
+    ram::RequestScheduler scheduler(client, options);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<ram::HttpResponse>> futures;
+    for (int i = 0; i < 5; ++i) {
+        futures.push_back(scheduler.submit("A", "presence", get(server.url() + "/")));
+    }
+    for (auto& f : futures) f.get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Burst of 1, then one token every 50ms.
+    EXPECT_GE(elapsed, std::chrono::milliseconds(180));
+    auto waits = scheduler.wait_times();
+    EXPECT_EQ(waits.count(), 5);
+    EXPECT_GE(waits.max(), 150'000'000u);
+}
+
+TEST(RequestSchedulerTest, HonorsRetryAfter) {
+    std::atomic<int> calls{0};
+    ram::testing::StubHttpServer server([&](const ram::HttpRequest&) {
+        if (calls++ == 0) {
+            auto resp = ram::testing::json_response("{}", 429);
+            resp.headers.emplace_back("Retry-After", "0");
+            return resp;
+        }
+        return ram::testing::json_response("{\"ok\":true}");
+    });
+
+    ram::HttpClient client;
+    ram::RequestScheduler scheduler(client);
+
+    auto resp = scheduler.submit("A", "auth", get(server.url() + "/")).get();
+    EXPECT_EQ(resp.status, 200);
+    auto stats = scheduler.stats();
+    EXPECT_EQ(stats.throttled, 1);
+    EXPECT_EQ(stats.retries, 1);
+    EXPECT_EQ(stats.completed, 1);
+}
+
+TEST(RequestSchedulerTest, GivesUpAfterMaxRetries) {
+    ram::testing::StubHttpServer server(
+        [](const ram::HttpRequest&) { return ram::testing::json_response("{}", 429); });
+
+    ram::HttpClient client;
+    ram::RequestSchedulerOptions options;
+    options.max_retries = 2;
+    options.base_backoff = std::chrono::milliseconds(5);
+    ram::RequestScheduler scheduler(client, options);
+
+    auto resp = scheduler.submit("A", "auth", get(server.url() + "/")).get();
+    EXPECT_EQ(resp.status, 429);
+    EXPECT_EQ(scheduler.stats().throttled, 3);
+    EXPECT_EQ(scheduler.stats().retries, 2);
+    EXPECT_EQ(server.requests(), 3);
+}
+
+TEST(RequestSchedulerTest, TransportErrorsReachCaller) {
+    uint16_t port;
+    {
+        auto sock = ram::Socket::listen("127.0.0.1", 0);
+        port = sock.local_port();
+    }
+    ram::HttpClient client({.connect_timeout = std::chrono::milliseconds(200),
+                            .request_timeout = std::chrono::milliseconds(200)});
+    ram::RequestScheduler scheduler(client);
+
+    auto future = scheduler.submit(
+        "A", "", get("http://127.0.0.1:" + std::to_string(port) + "/"));
+    EXPECT_THROW(future.get(), ram::HttpError);
+    EXPECT_EQ(scheduler.stats().failed, 1);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/roblox_auth.h"
+#include "stub_http_server.h"
+
+namespace {
+
+// Stand-in for auth.roblox.com: issues "token-N" on every CSRF probe and a
+// ticket when the current token is presented.
+struct AuthStub {
+    std::atomic<int> probes{0};
+    std::atomic<int> generation{1};
+    std::chrono::milliseconds delay{0};
+
+    ram::HttpResponse handle(const ram::HttpRequest& req) {
+        std::this_thread::sleep_for(delay);
+        std::string current = "token-" + std::to_string(generation.load());
+        const std::string* cookie = req.header("Cookie");
+        if (cookie == nullptr || cookie->find(".ROBLOSECURITY=") == std::string::npos) {
+            return ram::testing::json_response("{}", 401);
+        }
+
+        const std::string* sent = req.header("X-CSRF-TOKEN");
+        if (sent == nullptr || *sent != current) {
+            if (sent == nullptr) ++probes;
+            auto resp = ram::testing::json_response("{}", 403);
+            resp.headers.emplace_back("x-csrf-token", current);
+            return resp;
+        }
+        auto resp = ram::testing::json_response("{}");
+        resp.headers.emplace_back("rbx-authentication-ticket", "ticket-for-" + current);
+        return resp;
+    }
+};
+
+ram::Account make_account(int64_t user_id) {
+    ram::Account acc("cookie-" + std::to_string(user_id));
+    acc.user_id = user_id;
+    return acc;
+}
+
+}  // namespace
+
+TEST(CsrfTokenCacheTest, ReusesTokenUntilTtl) {
+    AuthStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url(), std::chrono::milliseconds(100)});
+
+    auto acc = make_account(1);
+    EXPECT_EQ(cache.get(acc), "token-1");
+    EXPECT_EQ(cache.get(acc), "token-1");
+    EXPECT_EQ(stub.probes.load(), 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    EXPECT_EQ(cache.get(acc), "token-1");
+    EXPECT_EQ(stub.probes.load(), 2);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+}
+
+TEST(CsrfTokenCacheTest, SingleFlightPerAccount) {
+    AuthStub stub;
+    stub.delay = std::chrono::milliseconds(50);
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url()});
+
+    auto acc = make_account(7);
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            if (cache.get(acc) == "token-1") ++ok;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(ok.load(), 8);
+    EXPECT_EQ(stub.probes.load(), 1);
+    EXPECT_EQ(cache.stats().misses, 1);
+    EXPECT_EQ(cache.stats().coalesced + cache.stats().hits, 7);
+}
+
+TEST(CsrfTokenCacheTest, AccountsAreIndependent) {
+    AuthStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url()});
+
+    ram::Account anonymous("cookie-without-user-id");
+    cache.get(make_account(1));
+    cache.get(make_account(2));
+    cache.get(anonymous);
+    EXPECT_EQ(stub.probes.load(), 3);
+    EXPECT_NE(ram::CsrfTokenCache::key_for(anonymous),
+              ram::CsrfTokenCache::key_for(make_account(1)));
+}
+
+TEST(CsrfTokenCacheTest, AuthTicketRefreshesRejectedToken) {
+    AuthStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url()});
+
+    auto acc = make_account(3);
+    EXPECT_EQ(ram::get_auth_ticket(client, cache, acc), "ticket-for-token-1");
+
+    // Server rotates the token: the cached one is rejected with a 403 that
+    // carries the replacement, and the ticket request is retried once.
+    stub.generation = 2;
+    EXPECT_EQ(ram::get_auth_ticket(client, cache, acc), "ticket-for-token-2");
+    EXPECT_EQ(stub.probes.load(), 1);
+    EXPECT_EQ(cache.get(acc), "token-2");
+}
+
+TEST(CsrfTokenCacheTest, FailedFetchIsNotCached) {
+    AuthStub stub;
+    ram::testing::StubHttpServer server([&](const ram::HttpRequest&) {
+        return ram::testing::json_response("{}", 401);
+    });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url()});
+
+    auto acc = make_account(4);
+    EXPECT_FALSE(cache.get(acc).has_value());
+    EXPECT_FALSE(cache.get(acc).has_value());
+    EXPECT_EQ(cache.stats().fetch_failures, 2);
+    EXPECT_FALSE(ram::get_auth_ticket(client, cache, acc).has_value());
+}
+
+TEST(CsrfTokenCacheTest, Invalidate) {
+    AuthStub stub;
+    ram::testing::StubHttpServer server(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url()});
+
+    auto acc = make_account(5);
+    cache.get(acc);
+    cache.invalidate(acc);
+    cache.get(acc);
+    EXPECT_EQ(stub.probes.load(), 2);
+    EXPECT_EQ(cache.stats().invalidations, 1);
+}
+
+TEST(CsrfTokenCacheTest, SignOutOtherSessionsReturnsNewCookie) {
+    ram::testing::StubHttpServer server([](const ram::HttpRequest& req) {
+        if (req.header("X-CSRF-TOKEN") == nullptr) {
+            auto resp = ram::testing::json_response("{}", 403);
+            resp.headers.emplace_back("x-csrf-token", "csrf");
+            return resp;
+        }
+        auto resp = ram::testing::json_response("{}");
+        if (req.url == "/authentication/signoutfromallsessionsandreauthenticate") {
+            resp.headers.emplace_back(
+                "Set-Cookie", ".ROBLOSECURITY=refreshed; domain=.roblox.com; HttpOnly");
+        }
+        return resp;
+    });
+    ram::HttpClient client;
+    ram::CsrfTokenCache cache(client, {server.url()});
+
+    EXPECT_EQ(ram::sign_out_other_sessions(client, cache, make_account(9), server.url()),
+              "refreshed");
+}
@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/server_list.h"
+#include "stub_http_server.h"
+
+namespace {
+
+// Stand-in for games.roblox.com's servers/public listing. Cursors are the
+// page number spelled with characters that need escaping.
+struct ServerListStub {
+    std::vector<ram::GameServer> servers;
+    std::atomic<int> page_requests{0};
+    std::atomic<int> fail_next{0};
+    std::vector<std::string> cursors;  // as received
+    std::mutex mutex;
+    std::condition_variable released_cv;
+    int hold_from_page = -1;  // pages at or past this wait for release()
+    bool released = false;
+
+    static std::string cursor_for(size_t page) { return "p/" + std::to_string(page) + "=="; }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        released_cv.notify_all();
+    }
+
+    ram::HttpResponse handle(const ram::HttpRequest& req) {
+        auto query_at = req.url.find('?');
+        if (req.url.compare(0, query_at, "/v1/games/1818/servers/public") != 0) {
+            return ram::testing::json_response("{}", 404);
+        }
+        ++page_requests;
+        auto query = ram::parse_query(std::string_view(req.url).substr(query_at + 1));
+        size_t limit = std::stoul(query["limit"]);
+        size_t page = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (query.count("cursor")) {
+                cursors.push_back(query["cursor"]);
+                page = std::stoul(query["cursor"].substr(2));
+            }
+            if (hold_from_page >= 0 && static_cast<int>(page) >= hold_from_page) {
+                released_cv.wait_for(lock, std::chrono::seconds(5), [&] { return released; });
+            }
+        }
+        if (fail_next > 0) {
+            --fail_next;
+            return ram::testing::json_response("{}", 503);
+        }
+
+        nlohmann::json data = nlohmann::json::array();
+        for (size_t i = page * limit; i < servers.size() && i < (page + 1) * limit; ++i) {
+            const auto& s = servers[i];
+            data.push_back({{"id", s.id},
+                            {"maxPlayers", s.max_players},
+                            {"playing", s.playing},
+                            {"fps", s.fps},
+                            {"ping", s.ping}});
+        }
+        nlohmann::json body{{"previousPageCursor", nullptr}, {"data", data}};
+        if ((page + 1) * limit < servers.size()) {
+            body["nextPageCursor"] = cursor_for(page + 1);
+        } else {
+            body["nextPageCursor"] = nullptr;
+        }
+        return ram::testing::json_response(body.dump());
+    }
+};
+
+ram::GameServer server(std::string id, int max_players, int playing, int ping) {
+    ram::GameServer s;
+    s.id = std::move(id);
+    s.max_players = max_players;
+    s.playing = playing;
+    s.fps = 60;
+    s.ping = ping;
+    return s;
+}
+
+// 50 half-full servers with one roomier server on the fourth page.
+std::vector<ram::GameServer> fifty_servers() {
+    std::vector<ram::GameServer> out;
+    for (int i = 0; i < 50; ++i) {
+        out.push_back(server("job-" + std::to_string(i), 20, 10, 50 + i));
+    }
+    out[37] = server("roomy", 20, 2, 120);
+    return out;
+}
+
+ram::ServerCrawlOptions test_options(const std::string& base) {
+    ram::ServerCrawlOptions options;
+    options.base_url = base;
+    options.page_size = 10;
+    options.top_k = 3;
+    options.retry_delay = std::chrono::milliseconds(10);
+    return options;
+}
+
+}  // namespace
+
+TEST(ServerListTest, ParseGameServer) {
+    auto s = ram::GameServer::from_json(nlohmann::json::parse(
+        R"({"id":"abc","maxPlayers":12,"playing":5,"playerTokens":[],)"
+        R"("fps":59.9,"ping":87,"players":[]})"));
+    EXPECT_EQ(s.id, "abc");
+    EXPECT_EQ(s.max_players, 12);
+    EXPECT_EQ(s.playing, 5);
+    EXPECT_EQ(s.free_slots(), 7);
+    EXPECT_DOUBLE_EQ(s.fps, 59.9);
+    EXPECT_EQ(s.ping, 87);
+
+    auto bad = ram::GameServer::from_json(nlohmann::json::parse(R"({"ping":"fast"})"));
+    EXPECT_TRUE(bad.id.empty());
+    EXPECT_EQ(bad.ping, 0);
+}
+
+TEST(ServerListTest, RankingKeepsBestAndReplacesDuplicates) {
+    ram::ServerRanking ranking(ram::ServerOrder::LowestPing, 2);
+    EXPECT_TRUE(ranking.offer(server("a", 10, 5, 80)));
+    EXPECT_TRUE(ranking.offer(server("b", 10, 5, 40)));
+    EXPECT_FALSE(ranking.offer(server("c", 10, 5, 90)));
+    EXPECT_TRUE(ranking.offer(server("d", 10, 5, 60)));
+
+    auto top = ranking.top();
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].id, "b");
+    EXPECT_EQ(top[1].id, "d");
+
+    // The same server seen again with a worse ping moves down, not twice.
+    EXPECT_TRUE(ranking.offer(server("b", 10, 5, 70)));
+    top = ranking.top();
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].id, "d");
+    EXPECT_EQ(top[1].id, "b");
+
+    ram::ServerRanking fewest(ram::ServerOrder::FewestPlayers, 1);
+    fewest.offer(server("busy", 10, 8, 10));
+    fewest.offer(server("quiet", 10, 1, 90));
+    EXPECT_EQ(fewest.best()->id, "quiet");
+}
+
+TEST(ServerListTest, CrawlsEveryPageAndRanksAsItGoes) {
+    ServerListStub stub;
+    stub.servers = fifty_servers();
+    ram::testing::StubHttpServer http(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::ServerCrawler crawler(client, 1818, test_options(http.url()));
+    crawler.run();
+
+    auto stats = crawler.stats();
+    EXPECT_EQ(stats.pages, 5u);
+    EXPECT_EQ(stats.servers_seen, 50u);
+    EXPECT_EQ(stats.servers_matched, 50u);
+    EXPECT_FALSE(stats.stopped_early);
+    EXPECT_FALSE(stats.failed);
+    EXPECT_TRUE(crawler.done());
+
+    auto top = crawler.top();
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_EQ(top[0].id, "roomy");
+    // Ties on free slots go to the lower ping.
+    EXPECT_EQ(top[1].id, "job-0");
+    EXPECT_EQ(top[2].id, "job-1");
+
+    // Cursors made it through the query string intact.
+    std::lock_guard<std::mutex> lock(stub.mutex);
+    ASSERT_EQ(stub.cursors.size(), 4u);
+    EXPECT_EQ(stub.cursors[0], ServerListStub::cursor_for(1));
+}
+
+TEST(ServerListTest, SkipsFullAndEmptyServers) {
+    ServerListStub stub;
+    stub.servers = {server("full", 10, 10, 20), server("empty", 10, 0, 20),
+                    server("solo", 1, 0, 20), server("slow", 10, 3, 400),
+                    server("ok", 10, 9, 90)};
+    ram::testing::StubHttpServer http(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    auto options = test_options(http.url());
+    options.max_ping = 200;
+    ram::ServerCrawler crawler(client, 1818, options);
+    crawler.run();
+
+    auto top = crawler.top();
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].id, "ok");
+    EXPECT_EQ(crawler.stats().servers_seen, 5u);
+}
+
+TEST(ServerListTest, StopsOnceEnoughServersMatch) {
+    ServerListStub stub;
+    stub.servers = fifty_servers();
+    ram::testing::StubHttpServer http(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    auto options = test_options(http.url());
+    options.enough = 15;
+    ram::ServerCrawler crawler(client, 1818, options);
+    crawler.run();
+
+    auto stats = crawler.stats();
+    EXPECT_EQ(stats.pages, 2u);
+    EXPECT_TRUE(stats.stopped_early);
+    // At most the one page requested ahead goes unused.
+    EXPECT_LE(stub.page_requests.load(), 3);
+    EXPECT_EQ(crawler.best()->id, "job-0");
+
+    ServerListStub capped;
+    capped.servers = fifty_servers();
+    ram::testing::StubHttpServer capped_http(
+        [&](const ram::HttpRequest& req) { return capped.handle(req); });
+    options = test_options(capped_http.url());
+    options.max_pages = 1;
+    ram::ServerCrawler one_page(client, 1818, options);
+    one_page.run();
+    EXPECT_EQ(one_page.stats().pages, 1u);
+    EXPECT_EQ(capped.page_requests.load(), 1);
+}
+
+TEST(ServerListTest, AnswersWhileTheCrawlContinues) {
+    ServerListStub stub;
+    stub.servers = fifty_servers();
+    stub.hold_from_page = 2;
+    ram::testing::StubHttpServer http(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::ServerCrawler crawler(client, 1818, test_options(http.url()));
+    crawler.start();
+
+    auto early = crawler.wait_best(std::chrono::seconds(5));
+    ASSERT_TRUE(early.has_value());
+    EXPECT_EQ(early->id, "job-0");
+    EXPECT_FALSE(crawler.done());
+
+    stub.release();
+    ASSERT_TRUE(crawler.wait(std::chrono::seconds(5)));
+    EXPECT_EQ(crawler.best()->id, "roomy");
+    EXPECT_EQ(crawler.stats().pages, 5u);
+}
+
+TEST(ServerListTest, RetriesFailedPages) {
+    ServerListStub stub;
+    stub.servers = fifty_servers();
+    stub.fail_next = 2;
+    ram::testing::StubHttpServer http(
+        [&](const ram::HttpRequest& req) { return stub.handle(req); });
+    ram::HttpClient client;
+    ram::ServerCrawler crawler(client, 1818, test_options(http.url()));
+    crawler.run();
+
+    auto stats = crawler.stats();
+    EXPECT_EQ(stats.failed_requests, 2u);
+    EXPECT_EQ(stats.pages, 5u);
+    EXPECT_FALSE(stats.failed);
+
+    ServerListStub down;
+    down.servers = fifty_servers();
+    down.fail_next = 100;
+    ram::testing::StubHttpServer down_http(
+        [&](const ram::HttpRequest& req) { return down.handle(req); });
+    auto options = test_options(down_http.url());
+    options.attempts = 2;
+    ram::ServerCrawler gives_up(client, 1818, options);
+    gives_up.run();
+    EXPECT_TRUE(gives_up.stats().failed);
+    EXPECT_EQ(gives_up.stats().failed_requests, 2u);
+    EXPECT_FALSE(gives_up.best().has_value());
+}
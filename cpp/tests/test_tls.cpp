@@ -0,0 +1,209 @@
+#include "ram/tls.h"
+
+#include <gtest/gtest.h>
+
+#if RAM_HAS_OPENSSL
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+#include "ram/http.h"
+#include "ram/socket.h"
+#include "stub_http_server.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A self-signed certificate for 127.0.0.1, written to a PEM file that the
+// client can trust through TlsOptions::ca_file.
+struct TestCertificate {
+    EVP_PKEY* key = nullptr;
+    X509* cert = nullptr;
+    ram::testing::TempDir dir{"ram_tls_test_"};
+    fs::path pem = dir.path / "ca.pem";
+
+    TestCertificate() {
+        key = EVP_EC_gen("P-256");
+        cert = X509_new();
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), -60);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("ram test"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509V3_CTX ctx;
+        X509V3_set_ctx_nodb(&ctx);
+        X509V3_set_ctx(&ctx, cert, cert, nullptr, nullptr, 0);
+        for (auto [nid, value] : {std::pair{NID_subject_alt_name, "IP:127.0.0.1,DNS:localhost"},
+                                  std::pair{NID_basic_constraints, "critical,CA:TRUE"}}) {
+            X509_EXTENSION* ext = X509V3_EXT_conf_nid(nullptr, &ctx, nid, value);
+            X509_add_ext(cert, ext, -1);
+            X509_EXTENSION_free(ext);
+        }
+        X509_sign(cert, key, EVP_sha256());
+
+        FILE* file = std::fopen(pem.string().c_str(), "wb");
+        PEM_write_X509(file, cert);
+        std::fclose(file);
+    }
+
+    ~TestCertificate() {
+        X509_free(cert);
+        EVP_PKEY_free(key);
+    }
+};
+
+// HTTPS server answering every request with 200 "ok" on keep-alive
+// connections, one thread per connection.
+class TlsTestServer {
+public:
+    explicit TlsTestServer(const TestCertificate& certificate)
+        : listener_(ram::Socket::listen("127.0.0.1", 0)) {
+        ctx_ = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_use_certificate(ctx_, certificate.cert);
+        SSL_CTX_use_PrivateKey(ctx_, certificate.key);
+        accept_thread_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~TlsTestServer() {
+        stopping_ = true;
+        accept_thread_.join();
+        for (auto& t : connection_threads_) t.join();
+        SSL_CTX_free(ctx_);
+    }
+
+    std::string url() const {
+        return "https://127.0.0.1:" + std::to_string(listener_.local_port());
+    }
+
+    size_t requests() const { return requests_; }
+
+private:
+    void accept_loop() {
+        while (!stopping_) {
+            if (!listener_.wait_readable(std::chrono::milliseconds(20))) continue;
+            ram::Socket client = listener_.accept();
+            if (!client.valid()) continue;
+            connection_threads_.emplace_back(
+                [this, sock = std::move(client)]() mutable { serve(sock); });
+        }
+    }
+
+    void serve(ram::Socket& sock) {
+        SSL* ssl = SSL_new(ctx_);
+        SSL_set_fd(ssl, sock.handle());
+        if (SSL_accept(ssl) == 1) {
+            std::string buffer;
+            char chunk[8192];
+            while (!stopping_) {
+                ram::HttpRequest request;
+                size_t consumed = 0;
+                auto status = ram::parse_http_request(buffer, request, consumed);
+                if (status == ram::ParseStatus::Error) break;
+                if (status == ram::ParseStatus::Complete) {
+                    buffer.erase(0, consumed);
+                    ++requests_;
+                    ram::HttpResponse response;
+                    response.status = 200;
+                    response.body = "ok";
+                    std::string raw = ram::serialize_http_response(response);
+                    if (SSL_write(ssl, raw.data(), static_cast<int>(raw.size())) <= 0) break;
+                    continue;
+                }
+                if (SSL_pending(ssl) == 0 &&
+                    !sock.wait_readable(std::chrono::milliseconds(20))) {
+                    continue;
+                }
+                int got = SSL_read(ssl, chunk, sizeof(chunk));
+                if (got <= 0) break;
+                buffer.append(chunk, static_cast<size_t>(got));
+            }
+        }
+        SSL_free(ssl);
+    }
+
+    SSL_CTX* ctx_ = nullptr;
+    ram::Socket listener_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> requests_{0};
+    std::thread accept_thread_;
+    std::vector<std::thread> connection_threads_;  // accept thread only
+};
+
+ram::HttpRequest get(const std::string& url) {
+    ram::HttpRequest req;
+    req.url = url;
+    return req;
+}
+
+}  // namespace
+
+TEST(TlsTest, HttpsReusesConnectionsAndResumesSessions) {
+    TestCertificate certificate;
+    TlsTestServer server(certificate);
+    ram::HttpClientOptions options;
+    options.tls.ca_file = certificate.pem.string();
+    ram::HttpClient client(options);
+
+    EXPECT_EQ(client.send(get(server.url() + "/a")).body, "ok");
+    EXPECT_EQ(client.send(get(server.url() + "/b")).body, "ok");
+    auto stats = client.stats();
+    EXPECT_EQ(stats.tls_handshakes, 1u);
+    EXPECT_EQ(stats.tls_resumed, 0u);
+    EXPECT_EQ(stats.connections_reused, 1u);
+
+    // A new connection resumes the session cached from the first one.
+    client.close_idle();
+    EXPECT_EQ(client.send(get(server.url() + "/c")).body, "ok");
+    stats = client.stats();
+    EXPECT_EQ(stats.tls_handshakes, 2u);
+    EXPECT_EQ(stats.tls_resumed, 1u);
+    EXPECT_EQ(server.requests(), 3u);
+}
+
+TEST(TlsTest, RejectsUntrustedCertificates) {
+    TestCertificate certificate;
+    TlsTestServer server(certificate);
+    ram::HttpClient client;  // system CA store only
+    EXPECT_THROW(client.send(get(server.url() + "/")), ram::HttpError);
+    EXPECT_EQ(server.requests(), 0u);
+
+    ram::HttpClientOptions insecure;
+    insecure.tls.verify_peer = false;
+    ram::HttpClient unchecked(insecure);
+    EXPECT_EQ(unchecked.send(get(server.url() + "/")).body, "ok");
+}
+
+TEST(TlsTest, RejectsCertificatesForAnotherHost) {
+    TestCertificate certificate;
+    TlsTestServer server(certificate);
+    ram::TlsContext context({true, certificate.pem.string()});
+    auto url = ram::Url::parse(server.url());
+    ram::Socket sock = ram::Socket::connect(url->host, url->port, std::chrono::seconds(2));
+    EXPECT_THROW(ram::TlsStream::connect(context, sock, "example.com", url->origin(),
+                                         std::chrono::seconds(2)),
+                 std::runtime_error);
+}
+
+#else
+
+TEST(TlsTest, UnavailableWithoutOpenSsl) {
+    EXPECT_FALSE(ram::TlsContext::available());
+    EXPECT_THROW(ram::TlsContext{}, std::runtime_error);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ram/account_store.h"
+#include "ram/ini_file.h"
+#include "ram/tracing.h"
+
+namespace {
+
+// Leaves the global tracer disabled and empty.
+class TracingTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        ram::Tracer::global().disable();
+        ram::Tracer::global().clear();
+    }
+
+    static std::vector<std::string> names() {
+        std::vector<std::string> out;
+        for (const auto& event : ram::Tracer::global().events()) out.push_back(event.name);
+        return out;
+    }
+};
+
+}  // namespace
+
+TEST_F(TracingTest, DisabledSpansAreNotRecorded) {
+    ram::Tracer::global().clear();
+    { ram::TraceSpan span("ignored"); }
+    EXPECT_TRUE(ram::Tracer::global().events().empty());
+
+    ram::Tracer::global().enable();
+    { ram::TraceSpan span("kept"); }
+    // A span that began while disabled stays unrecorded.
+    {
+        ram::Tracer::global().disable();
+        ram::TraceSpan span("late");
+        ram::Tracer::global().enable();
+    }
+    EXPECT_EQ(names(), (std::vector<std::string>{"kept"}));
+}
+
+TEST_F(TracingTest, RingKeepsNewestEventsPerThread) {
+    ram::Tracer::global().enable(4);
+    const char* const kNames[] = {"s0", "s1", "s2", "s3", "s4", "s5"};
+    for (const char* name : kNames) ram::TraceSpan span(name);
+    EXPECT_EQ(names(), (std::vector<std::string>{"s2", "s3", "s4", "s5"}));
+
+    std::thread other([] { ram::TraceSpan span("other"); });
+    other.join();
+    EXPECT_EQ(names().size(), 5u);
+
+    ram::Tracer::global().clear();
+    { ram::TraceSpan span("fresh"); }
+    EXPECT_EQ(names(), (std::vector<std::string>{"fresh"}));
+}
+
+TEST_F(TracingTest, ExportsChromeTraceEvents) {
+    ram::Tracer::global().enable();
+    {
+        ram::TraceSpan outer("outer", "test");
+        std::thread worker([] { ram::TraceSpan inner("worker", "test"); });
+        worker.join();
+        ram::TraceSpan inner("inner", "test");
+    }
+
+    auto trace = nlohmann::json::parse(ram::Tracer::global().to_chrome_json());
+    std::set<std::string> spans;
+    std::set<int> tids;
+    int metadata = 0;
+    double outer_end = 0;
+    double inner_end = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M") {
+            ++metadata;
+            continue;
+        }
+        EXPECT_EQ(event["ph"], "X");
+        EXPECT_EQ(event["cat"], "test");
+        EXPECT_GE(event["ts"].get<double>(), 0.0);
+        EXPECT_GE(event["dur"].get<double>(), 0.0);
+        spans.insert(event["name"].get<std::string>());
+        tids.insert(event["tid"].get<int>());
+        double end = event["ts"].get<double>() + event["dur"].get<double>();
+        if (event["name"] == "outer") outer_end = end;
+        if (event["name"] == "inner") inner_end = end;
+    }
+    EXPECT_EQ(spans, (std::set<std::string>{"outer", "inner", "worker"}));
+    EXPECT_EQ(tids.size(), 2u);
+    EXPECT_EQ(metadata, 2);
+    EXPECT_GE(outer_end, inner_end);
+}
+
+TEST_F(TracingTest, ConfiguredFromDeveloperSection) {
+    ram::IniSection developer("Developer");
+    developer.set("EnableTracing", "true");
+    developer.set("TraceBufferEvents", "2");
+    ram::Tracer::global().configure(developer);
+    EXPECT_TRUE(ram::Tracer::enabled());
+    for (int i = 0; i < 5; ++i) ram::TraceSpan span("span");
+    EXPECT_EQ(names().size(), 2u);
+
+    developer.set("EnableTracing", "false");
+    ram::Tracer::global().configure(developer);
+    EXPECT_FALSE(ram::Tracer::enabled());
+}
+
+TEST_F(TracingTest, CoreOperationsEmitSpans) {
+    ram::Tracer::global().clear();
+    ram::Tracer::global().enable();
+    ram::AccountStore store;
+    store.load_json(R"([{"Username": "alpha", "UserID": 1}])");
+    std::istringstream text("[General]\nKey=Value\n");
+    ram::IniFile ini(text);
+
+    auto recorded = names();
+    EXPECT_NE(std::find(recorded.begin(), recorded.end(), "account.parse"), recorded.end());
+    EXPECT_NE(std::find(recorded.begin(), recorded.end(), "ini.load"), recorded.end());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ram/ttl_cache.h"
+
+namespace {
+
+// Steady clock the tests move by hand.
+struct FakeClock {
+    using duration = std::chrono::steady_clock::duration;
+    using time_point = std::chrono::steady_clock::time_point;
+    static inline std::atomic<int64_t> offset_ms{0};
+
+    static time_point now() { return time_point{} + std::chrono::milliseconds(offset_ms.load()); }
+    static void advance(std::chrono::milliseconds d) { offset_ms += d.count(); }
+};
+
+struct PlaceDetails {
+    int64_t universe_id = 0;
+    std::string name;
+};
+
+using PlaceCache = ram::TtlCache<int64_t, PlaceDetails, std::hash<int64_t>, FakeClock>;
+
+ram::TtlCacheOptions options(size_t capacity, size_t shards = 1) {
+    ram::TtlCacheOptions o;
+    o.capacity = capacity;
+    o.shards = shards;
+    o.ttl = std::chrono::seconds(60);
+    o.negative_ttl = std::chrono::seconds(5);
+    return o;
+}
+
+}  // namespace
+
+TEST(TtlCacheTest, ValuesExpireAfterTtl) {
+    PlaceCache cache(options(16));
+    cache.put(1818, {13058, "Crossroads"});
+    ASSERT_TRUE(cache.get(1818).has_value());
+    EXPECT_EQ(cache.get(1818)->name, "Crossroads");
+
+    FakeClock::advance(std::chrono::seconds(59));
+    EXPECT_TRUE(cache.get(1818).has_value());
+    FakeClock::advance(std::chrono::seconds(2));
+    EXPECT_FALSE(cache.get(1818).has_value());
+
+    cache.put(1818, {13058, "Short"}, std::chrono::milliseconds(10));
+    FakeClock::advance(std::chrono::milliseconds(10));
+    EXPECT_FALSE(cache.get(1818).has_value());
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.expired, 2u);
+}
+
+TEST(TtlCacheTest, NegativeEntriesUseTheirOwnTtl) {
+    PlaceCache cache(options(16));
+    int loads = 0;
+    auto load = [&](int64_t) -> std::optional<PlaceDetails> {
+        ++loads;
+        return std::nullopt;
+    };
+    EXPECT_FALSE(cache.get_or_load(404, load).has_value());
+    EXPECT_FALSE(cache.get_or_load(404, load).has_value());
+    EXPECT_EQ(loads, 1);
+
+    PlaceDetails out;
+    EXPECT_EQ(cache.lookup(404, out), PlaceCache::Found::Negative);
+    FakeClock::advance(std::chrono::seconds(6));
+    EXPECT_EQ(cache.lookup(404, out), PlaceCache::Found::Missing);
+    cache.get_or_load(404, load);
+    EXPECT_EQ(loads, 2);
+    EXPECT_EQ(cache.stats().negative_hits, 2u);
+}
+
+TEST(TtlCacheTest, ClockKeepsRecentlyReadEntries) {
+    PlaceCache cache(options(4));
+    for (int64_t id = 1; id <= 4; ++id) cache.put(id, {id, "p"});
+    // Reading 1..3 sets their reference bits; 4 is the victim.
+    for (int64_t id = 1; id <= 3; ++id) EXPECT_TRUE(cache.get(id).has_value());
+    cache.put(5, {5, "p"});
+    EXPECT_FALSE(cache.get(4).has_value());
+    for (int64_t id : {1, 2, 3, 5}) EXPECT_TRUE(cache.get(id).has_value()) << id;
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_EQ(cache.stats().evictions, 1u);
+}
+
+TEST(TtlCacheTest, ExpiredEntriesAreReusedBeforeLiveOnes) {
+    PlaceCache cache(options(2));
+    cache.put(1, {1, "old"}, std::chrono::milliseconds(1));
+    cache.put(2, {2, "live"});
+    FakeClock::advance(std::chrono::milliseconds(5));
+    cache.put(3, {3, "new"});
+    EXPECT_TRUE(cache.get(2).has_value());
+    EXPECT_TRUE(cache.get(3).has_value());
+    EXPECT_EQ(cache.stats().evictions, 0u);
+}
+
+TEST(TtlCacheTest, EraseAndClear) {
+    PlaceCache cache(options(8, 4));
+    cache.put(1, {1, "a"});
+    cache.put(2, {2, "b"});
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_FALSE(cache.get(1).has_value());
+    cache.put(1, {1, "again"});
+    EXPECT_EQ(cache.get(1)->name, "again");
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.get(2).has_value());
+}
+
+TEST(TtlCacheTest, ConcurrentReadersAndWriters) {
+    ram::TtlCache<int64_t, int64_t> cache(options(256, 8));
+    std::vector<std::thread> threads;
+    std::atomic<bool> wrong{false};
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int64_t i = 0; i < 20000; ++i) {
+                int64_t key = (i * 31 + t) % 512;
+                if (i % 4 == 0) {
+                    cache.put(key, key * 2);
+                } else if (auto v = cache.get(key); v && *v != key * 2) {
+                    wrong = true;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_FALSE(wrong.load());
+    EXPECT_LE(cache.size(), 256u);
+}
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <string>
 
 #include "ram/utilities.h"
@@ -32,6 +33,24 @@ TEST(UtilitiesTest, MD5LongString) {
 
 // --- SHA-256 Tests ---
 
+TEST(UtilitiesTest, SHA256Digest) {
+    EXPECT_EQ(ram::base64_encode(ram::sha256_digest("abc")),
+              "ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=");
+    EXPECT_EQ(ram::sha256_digest(std::string(100000, 'a')).size(), 32u);
+}
+
+TEST(UtilitiesTest, SHA1AndBase64) {
+    EXPECT_EQ(ram::base64_encode(ram::sha1_digest("abc")), "qZk+NkcGgWq6PiVxeFDCbJzQ2J0=");
+    EXPECT_EQ(ram::base64_encode(ram::sha1_digest("")), "2jmj7l5rSw0yVb/vlWAYkK/YBwk=");
+    // 56 bytes: the padding spills into a second block.
+    EXPECT_EQ(ram::base64_encode(ram::sha1_digest(
+                  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+              "hJg+RBw70m66rkqh+VEp5eVGcPE=");
+    EXPECT_EQ(ram::base64_encode("f"), "Zg==");
+    EXPECT_EQ(ram::base64_encode("fo"), "Zm8=");
+    EXPECT_EQ(ram::base64_encode("foo"), "Zm9v");
+}
+
 TEST(UtilitiesTest, FileSHA256NonExistent) {
     std::string hash = ram::file_sha256("/nonexistent/path/file.txt");
     EXPECT_EQ(hash,
@@ -152,3 +171,63 @@ TEST(UtilitiesTest, RecursiveDeleteNonExistent) {
     auto tmp = std::filesystem::temp_directory_path() / "nonexistent_path_ram_test_xyz";
     EXPECT_TRUE(ram::recursive_delete(tmp.string()));
 }
+
+// --- Atomic Write Tests ---
+
+TEST(UtilitiesTest, WriteFileAtomicReplacesContent) {
+    auto tmp = std::filesystem::temp_directory_path() / "ram_test_atomic.txt";
+    {
+        std::ofstream f(tmp);
+        f << "old";
+    }
+
+    EXPECT_TRUE(ram::write_file_atomic(tmp.string(), "hello"));
+    EXPECT_EQ(ram::file_sha256(tmp.string()),
+              "2CF24DBA5FB0A30E26E83B2AC5B9E29E1B161E5C1FA7425E73043362938B9824");
+    for (const auto& entry : std::filesystem::directory_iterator(tmp.parent_path())) {
+        EXPECT_NE(entry.path().filename().string().rfind("ram_test_atomic.txt.tmp", 0), 0u)
+            << entry.path();
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    EXPECT_FALSE(ec) << "Failed to clean up test file: " << ec.message();
+}
+
+TEST(UtilitiesTest, AtomicFileWriterCommitsOrLeavesTargetAlone) {
+    auto dir = std::filesystem::temp_directory_path() / "ram_test_atomic_writer";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto target = (dir / "out.txt").string();
+    ASSERT_TRUE(ram::write_file_atomic(target, "old"));
+
+    {
+        // Abandoned writers leave the target untouched and clean up.
+        ram::AtomicFileWriter abandoned(target);
+        ASSERT_TRUE(abandoned.is_open());
+        EXPECT_TRUE(abandoned.write("never committed"));
+    }
+    {
+        ram::AtomicFileWriter first(target);
+        ram::AtomicFileWriter second(target);  // concurrent writers never share a file
+        ASSERT_TRUE(first.is_open() && second.is_open());
+        EXPECT_TRUE(first.write("first"));
+        EXPECT_TRUE(second.write(std::string(100000, 'x')));  // larger than the buffer
+        EXPECT_TRUE(second.write("y"));
+        EXPECT_TRUE(first.commit());
+        EXPECT_TRUE(second.commit());
+    }
+    std::ifstream in(target, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(content, std::string(100000, 'x') + "y");
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir),
+                            std::filesystem::directory_iterator()),
+              1);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(UtilitiesTest, WriteFileAtomicMissingDirectory) {
+    auto tmp = std::filesystem::temp_directory_path() /
+               "nonexistent_dir_ram_test_xyz" / "file.txt";
+    EXPECT_FALSE(ram::write_file_atomic(tmp.string(), "data"));
+}